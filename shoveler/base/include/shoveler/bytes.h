@@ -0,0 +1,49 @@
+#ifndef SHOVELER_BYTES_H
+#define SHOVELER_BYTES_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+typedef void (ShovelerBytesFreeFunction)(unsigned char *data, void *userData);
+
+/**
+ * Immutable, reference counted byte buffer.
+ *
+ * A bytes instance can be shared between multiple owners without copying its contents by taking
+ * additional references with shovelerBytesRef. Consumers that only need to read the contents for
+ * the duration of a call can borrow the data pointer without taking a reference.
+ */
+typedef struct ShovelerBytesStruct {
+	const unsigned char *data;
+	size_t size;
+	int refCount;
+	ShovelerBytesFreeFunction *freeFunction;
+	void *freeUserData;
+} ShovelerBytes;
+
+/** Creates a new bytes instance holding a copy of the passed data. */
+ShovelerBytes *shovelerBytesCreate(const unsigned char *data, size_t size);
+/** Creates a new bytes instance taking ownership of data allocated with malloc. */
+ShovelerBytes *shovelerBytesCreateTake(unsigned char *data, size_t size);
+/**
+ * Creates a new bytes instance wrapping externally owned data without copying it.
+ *
+ * The passed free function is called with the data once the last reference is dropped, and can be
+ * NULL if the data outlives the bytes instance.
+ */
+ShovelerBytes *shovelerBytesCreateWrap(const unsigned char *data, size_t size, ShovelerBytesFreeFunction *freeFunction, void *freeUserData);
+ShovelerBytes *shovelerBytesRef(ShovelerBytes *bytes);
+void shovelerBytesUnref(ShovelerBytes *bytes);
+bool shovelerBytesEqual(const ShovelerBytes *a, const ShovelerBytes *b);
+
+static inline const unsigned char *shovelerBytesGetData(const ShovelerBytes *bytes)
+{
+	return bytes->data;
+}
+
+static inline size_t shovelerBytesGetSize(const ShovelerBytes *bytes)
+{
+	return bytes->size;
+}
+
+#endif
@@ -25,5 +25,11 @@ ShovelerFont *shovelerFontsLoadFontFile(ShovelerFonts *fonts, const char *name,
 ShovelerFont *shovelerFontsLoadFontBuffer(ShovelerFonts *fonts, const char *name, const unsigned char *buffer, int bufferSize);
 bool shovelerFontsUnloadFont(ShovelerFonts *fonts, const char *name);
 void shovelerFontsFree(ShovelerFonts *fonts);
+/**
+ * Converts a rendered 8-bit glyph coverage bitmap into a signed distance field with a border of spread pixels around it.
+ * Values encode the distance to the glyph outline, falling from 255 at spread pixels inside to 0 at spread pixels
+ * outside, with the outline itself at half intensity. The returned bitmap's buffer must be freed by the caller.
+ */
+FT_Bitmap shovelerFontCreateSignedDistanceField(FT_Bitmap bitmap, int spread);
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef SHOVELER_FONT_ATLAS_H
 #define SHOVELER_FONT_ATLAS_H
 
+#include <stdbool.h> // bool
 #include <stdint.h> // uint32_t
 
 #include <glib.h>
@@ -8,6 +9,16 @@
 typedef struct ShovelerFontStruct ShovelerFont; // forward declaration: font.h
 typedef struct ShovelerImageStruct ShovelerImage; // forward declaration: image.h
 
+/** printable ASCII characters, which are typically worth prewarming an atlas with */
+#define SHOVELER_FONT_ATLAS_PRINTABLE_ASCII " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~"
+
+typedef enum {
+	/** glyphs are stored as their antialiased coverage, which looks best when rendered at the atlas font size */
+	SHOVELER_FONT_ATLAS_MODE_COVERAGE,
+	/** glyphs are stored as signed distance fields to their outline, which stay sharp when rendered at any scale */
+	SHOVELER_FONT_ATLAS_MODE_SIGNED_DISTANCE_FIELD,
+} ShovelerFontAtlasMode;
+
 typedef struct ShovelerFontAtlasSkylineEdgeStruct {
 	int minX;
 	int width;
@@ -30,15 +41,34 @@ typedef struct ShovelerFontAtlasStruct {
 	ShovelerFont *font;
 	int fontSize;
 	int padding;
+	ShovelerFontAtlasMode mode;
+	/** distance in pixels covered by the distance field on either side of a glyph outline, zero in coverage mode */
+	int spread;
 	ShovelerImage *image;
-	/** list of (ShovelerFontAtlasRectangle *) representing rectangles above the skyline */
-	GQueue *skylineEdges;
+	/** array of (ShovelerFontAtlasSkylineEdge) from left to right representing rectangles above the skyline */
+	GArray *skylineEdges;
 	/** map from glyph index (unsigned int) to (ShovelerFontAtlasGlyph *) */
 	GHashTable *glyphs;
+	/** rectangle of the image changed since the last call to shovelerFontAtlasClearDirty, empty if zero sized */
+	int dirtyX;
+	int dirtyY;
+	int dirtyWidth;
+	int dirtyHeight;
 } ShovelerFontAtlas;
 
 ShovelerFontAtlas *shovelerFontAtlasCreate(ShovelerFont *font, int fontSize, int padding);
+/**
+ * Creates a font atlas that rasterizes each glyph once as a signed distance field extending spread pixels around its
+ * outline, so that text can be rendered from it crisply at any scale using an alpha threshold.
+ */
+ShovelerFontAtlas *shovelerFontAtlasCreateSignedDistanceField(ShovelerFont *font, int fontSize, int padding, int spread);
 ShovelerFontAtlasGlyph *shovelerFontAtlasGetGlyph(ShovelerFontAtlas *fontAtlas, uint32_t codePoint);
+/**
+ * Rasterizes the glyphs of all passed characters that aren't in the atlas yet, packing them together tallest first and
+ * growing the image to their total area up front. Returns the number of glyphs added.
+ */
+int shovelerFontAtlasPrewarm(ShovelerFontAtlas *fontAtlas, const char *characters);
+void shovelerFontAtlasClearDirty(ShovelerFontAtlas *fontAtlas);
 void shovelerFontAtlasValidateState(ShovelerFontAtlas *fontAtlas);
 void shovelerFontAtlasFree(ShovelerFontAtlas *fontAtlas);
 
@@ -24,5 +24,7 @@ typedef struct {
 
 /** Returns true if the passed frustums intersect. */
 bool shovelerFrustumIntersectFrustum(const ShovelerFrustum *frustum, const ShovelerFrustum *otherFrustum);
+/** Returns true if the passed sphere is not entirely outside of any of the frustum's planes. */
+bool shovelerFrustumIntersectSphere(const ShovelerFrustum *frustum, ShovelerVector3 center, float radius);
 
 #endif
@@ -0,0 +1,91 @@
+#include <assert.h> // assert
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcpy, memcmp
+
+#include "shoveler/bytes.h"
+
+static void freeMallocData(unsigned char *data, void *unused);
+
+ShovelerBytes *shovelerBytesCreate(const unsigned char *data, size_t size)
+{
+	unsigned char *copy = NULL;
+	if(size > 0) {
+		copy = malloc(size * sizeof(unsigned char));
+		memcpy(copy, data, size * sizeof(unsigned char));
+	}
+
+	return shovelerBytesCreateTake(copy, size);
+}
+
+ShovelerBytes *shovelerBytesCreateTake(unsigned char *data, size_t size)
+{
+	return shovelerBytesCreateWrap(data, size, freeMallocData, NULL);
+}
+
+ShovelerBytes *shovelerBytesCreateWrap(const unsigned char *data, size_t size, ShovelerBytesFreeFunction *freeFunction, void *freeUserData)
+{
+	assert(data != NULL || size == 0);
+
+	ShovelerBytes *bytes = malloc(sizeof(ShovelerBytes));
+	bytes->data = data;
+	bytes->size = size;
+	bytes->refCount = 1;
+	bytes->freeFunction = freeFunction;
+	bytes->freeUserData = freeUserData;
+
+	return bytes;
+}
+
+ShovelerBytes *shovelerBytesRef(ShovelerBytes *bytes)
+{
+	assert(bytes->refCount > 0);
+
+	bytes->refCount++;
+	return bytes;
+}
+
+void shovelerBytesUnref(ShovelerBytes *bytes)
+{
+	if(bytes == NULL) {
+		return;
+	}
+
+	assert(bytes->refCount > 0);
+
+	bytes->refCount--;
+	if(bytes->refCount > 0) {
+		return;
+	}
+
+	if(bytes->freeFunction != NULL) {
+		bytes->freeFunction((unsigned char *) bytes->data, bytes->freeUserData);
+	}
+
+	free(bytes);
+}
+
+bool shovelerBytesEqual(const ShovelerBytes *a, const ShovelerBytes *b)
+{
+	if(a == b) {
+		return true;
+	}
+
+	if(a == NULL || b == NULL) {
+		return false;
+	}
+
+	if(a->size != b->size) {
+		return false;
+	}
+
+	if(a->data == b->data || a->size == 0) {
+		return true;
+	}
+
+	return memcmp(a->data, b->data, a->size * sizeof(unsigned char)) == 0;
+}
+
+static void freeMallocData(unsigned char *data, void *unused)
+{
+	free(data);
+}
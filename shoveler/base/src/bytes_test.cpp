@@ -0,0 +1,75 @@
+#include <cstring> // memcmp
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/bytes.h"
+}
+
+static void countFree(unsigned char *data, void *counterPointer);
+
+TEST(bytes, createCopiesData)
+{
+	unsigned char input[] = {1, 2, 3, 4};
+
+	ShovelerBytes *bytes = shovelerBytesCreate(input, sizeof(input));
+	ASSERT_NE(shovelerBytesGetData(bytes), input) << "data should have been copied";
+	ASSERT_EQ(shovelerBytesGetSize(bytes), sizeof(input));
+	ASSERT_EQ(memcmp(shovelerBytesGetData(bytes), input, sizeof(input)), 0);
+
+	input[0] = 42;
+	ASSERT_EQ(shovelerBytesGetData(bytes)[0], 1) << "bytes should not observe changes to the input";
+
+	shovelerBytesUnref(bytes);
+}
+
+TEST(bytes, refSharesData)
+{
+	int numFrees = 0;
+	unsigned char input[] = {5, 6, 7};
+
+	ShovelerBytes *bytes = shovelerBytesCreateWrap(input, sizeof(input), countFree, &numFrees);
+	ASSERT_EQ(shovelerBytesGetData(bytes), input) << "wrapped data should not be copied";
+
+	ShovelerBytes *reference = shovelerBytesRef(bytes);
+	ASSERT_EQ(reference, bytes);
+	ASSERT_EQ(bytes->refCount, 2);
+
+	shovelerBytesUnref(bytes);
+	ASSERT_EQ(numFrees, 0) << "data should be kept alive by remaining reference";
+	ASSERT_EQ(shovelerBytesGetData(reference), input);
+
+	shovelerBytesUnref(reference);
+	ASSERT_EQ(numFrees, 1) << "data should be freed when dropping the last reference";
+}
+
+TEST(bytes, equal)
+{
+	unsigned char input[] = {1, 2, 3};
+	unsigned char otherInput[] = {1, 2, 4};
+
+	ShovelerBytes *bytes = shovelerBytesCreate(input, sizeof(input));
+	ShovelerBytes *sameBytes = shovelerBytesCreate(input, sizeof(input));
+	ShovelerBytes *otherBytes = shovelerBytesCreate(otherInput, sizeof(otherInput));
+	ShovelerBytes *shorterBytes = shovelerBytesCreate(input, sizeof(input) - 1);
+	ShovelerBytes *emptyBytes = shovelerBytesCreate(NULL, 0);
+
+	ASSERT_TRUE(shovelerBytesEqual(bytes, bytes));
+	ASSERT_TRUE(shovelerBytesEqual(bytes, sameBytes));
+	ASSERT_FALSE(shovelerBytesEqual(bytes, otherBytes));
+	ASSERT_FALSE(shovelerBytesEqual(bytes, shorterBytes));
+	ASSERT_FALSE(shovelerBytesEqual(bytes, emptyBytes));
+	ASSERT_FALSE(shovelerBytesEqual(bytes, NULL));
+
+	shovelerBytesUnref(emptyBytes);
+	shovelerBytesUnref(shorterBytes);
+	shovelerBytesUnref(otherBytes);
+	shovelerBytesUnref(sameBytes);
+	shovelerBytesUnref(bytes);
+}
+
+static void countFree(unsigned char *data, void *counterPointer)
+{
+	int *counter = (int *) counterPointer;
+	(*counter)++;
+}
@@ -1,9 +1,16 @@
+#include <assert.h> // assert
+#include <math.h> // sqrtf
 #include <stdlib.h> // malloc free
 #include <string.h> // strdup
 
 #include "shoveler/font.h"
 #include "shoveler/log.h"
 
+/** squared distance standing in for infinity, chosen such that sums with it stay finite */
+#define DISTANCE_INFINITY 1e20f
+
+static void transformDistances(float *distances, int width, int height);
+static void transformDistances1d(const float *input, int length, float *output, int *parabolas, float *boundaries);
 static void freeFont(void *fontPointer);
 
 ShovelerFonts *shovelerFontsCreate()
@@ -85,6 +92,156 @@ void shovelerFontsFree(ShovelerFonts *fonts)
 	free(fonts);
 }
 
+FT_Bitmap shovelerFontCreateSignedDistanceField(FT_Bitmap bitmap, int spread)
+{
+	assert(spread > 0);
+	assert(bitmap.pixel_mode == FT_PIXEL_MODE_GRAY);
+
+	int bitmapWidth = (int) bitmap.width;
+	int bitmapHeight = (int) bitmap.rows;
+	int width = bitmapWidth + 2 * spread;
+	int height = bitmapHeight + 2 * spread;
+	size_t numPixels = (size_t) width * (size_t) height;
+
+	// coverage of each pixel of the bordered field, which is empty outside the glyph bitmap
+	float *coverages = malloc(numPixels * sizeof(float));
+	for(int y = 0; y < height; y++) {
+		for(int x = 0; x < width; x++) {
+			int bitmapX = x - spread;
+			int bitmapY = y - spread;
+			float coverage = 0.0f;
+			if(bitmapX >= 0 && bitmapX < bitmapWidth && bitmapY >= 0 && bitmapY < bitmapHeight) {
+				coverage = bitmap.buffer[bitmapY * bitmap.pitch + bitmapX] / 255.0f;
+			}
+
+			coverages[y * width + x] = coverage;
+		}
+	}
+
+	// squared distances of every pixel to the closest pixel inside and outside of the glyph
+	float *insideDistances = malloc(numPixels * sizeof(float));
+	float *outsideDistances = malloc(numPixels * sizeof(float));
+	for(size_t i = 0; i < numPixels; i++) {
+		bool inside = coverages[i] >= 0.5f;
+		insideDistances[i] = inside ? 0.0f : DISTANCE_INFINITY;
+		outsideDistances[i] = inside ? DISTANCE_INFINITY : 0.0f;
+	}
+
+	transformDistances(insideDistances, width, height);
+	transformDistances(outsideDistances, width, height);
+
+	FT_Bitmap field = bitmap;
+	field.width = (unsigned int) width;
+	field.rows = (unsigned int) height;
+	field.pitch = width;
+	field.num_grays = 256;
+	field.buffer = malloc(numPixels);
+
+	for(size_t i = 0; i < numPixels; i++) {
+		// signed distance from the pixel center to the outline in pixels, positive inside
+		float distance;
+		if(insideDistances[i] == 0.0f) {
+			distance = sqrtf(outsideDistances[i]) - 0.5f;
+		} else {
+			distance = 0.5f - sqrtf(insideDistances[i]);
+		}
+
+		// right next to the outline, the antialiased coverage tells us more precisely where it crosses the pixel
+		if(distance > -1.0f && distance < 1.0f) {
+			distance = coverages[i] - 0.5f;
+		}
+
+		float value = 0.5f + 0.5f * distance / (float) spread;
+		if(value < 0.0f) {
+			value = 0.0f;
+		} else if(value > 1.0f) {
+			value = 1.0f;
+		}
+
+		field.buffer[i] = (unsigned char) (255.0f * value + 0.5f);
+	}
+
+	free(outsideDistances);
+	free(insideDistances);
+	free(coverages);
+
+	return field;
+}
+
+/**
+ * Replaces squared distances of zero (inside the feature) or infinity (outside) with the exact squared euclidean
+ * distance to the closest feature pixel, by transforming all columns and then all rows.
+ * See "Distance Transforms of Sampled Functions" by Felzenszwalb and Huttenlocher.
+ */
+static void transformDistances(float *distances, int width, int height)
+{
+	int maxLength = width > height ? width : height;
+	float *input = malloc((size_t) maxLength * sizeof(float));
+	float *output = malloc((size_t) maxLength * sizeof(float));
+	int *parabolas = malloc((size_t) maxLength * sizeof(int));
+	float *boundaries = malloc((size_t) (maxLength + 1) * sizeof(float));
+
+	for(int x = 0; x < width; x++) {
+		for(int y = 0; y < height; y++) {
+			input[y] = distances[y * width + x];
+		}
+
+		transformDistances1d(input, height, output, parabolas, boundaries);
+
+		for(int y = 0; y < height; y++) {
+			distances[y * width + x] = output[y];
+		}
+	}
+
+	for(int y = 0; y < height; y++) {
+		transformDistances1d(&distances[y * width], width, output, parabolas, boundaries);
+
+		for(int x = 0; x < width; x++) {
+			distances[y * width + x] = output[x];
+		}
+	}
+
+	free(boundaries);
+	free(parabolas);
+	free(output);
+	free(input);
+}
+
+/** Computes the lower envelope of the parabolas rooted at each input sample, and samples it into the output. */
+static void transformDistances1d(const float *input, int length, float *output, int *parabolas, float *boundaries)
+{
+	int numParabolas = 0;
+	parabolas[0] = 0;
+	boundaries[0] = -DISTANCE_INFINITY;
+	boundaries[1] = DISTANCE_INFINITY;
+
+	for(int q = 1; q < length; q++) {
+		// since the first boundary is far below any intersection, this never pops the first parabola
+		int p = parabolas[numParabolas];
+		float intersection = ((input[q] + (float) (q * q)) - (input[p] + (float) (p * p))) / (float) (2 * q - 2 * p);
+		while(intersection <= boundaries[numParabolas]) {
+			numParabolas--;
+			p = parabolas[numParabolas];
+			intersection = ((input[q] + (float) (q * q)) - (input[p] + (float) (p * p))) / (float) (2 * q - 2 * p);
+		}
+
+		numParabolas++;
+		parabolas[numParabolas] = q;
+		boundaries[numParabolas] = intersection;
+		boundaries[numParabolas + 1] = DISTANCE_INFINITY;
+	}
+
+	int currentParabola = 0;
+	for(int q = 0; q < length; q++) {
+		while(boundaries[currentParabola + 1] < (float) q) {
+			currentParabola++;
+		}
+
+		int p = parabolas[currentParabola];
+		output[q] = (float) ((q - p) * (q - p)) + input[p];
+	}
+}
+
 static void freeFont(void *fontPointer)
 {
 	ShovelerFont *font = (ShovelerFont *) fontPointer;
@@ -1,16 +1,34 @@
 #include <assert.h> // assert
 #include <limits.h> // UINT_MAX INT_MAX
-#include <stdlib.h> // malloc free
+#include <stdlib.h> // abs malloc free qsort
+#include <string.h> // memcpy memmove
 
 #include "shoveler/font.h"
 #include "shoveler/font_atlas.h"
 #include "shoveler/log.h"
 #include "shoveler/image.h"
 
+typedef struct {
+	unsigned int index;
+	/** copy of the rendered bitmap, whose buffer is owned by this struct */
+	FT_Bitmap bitmap;
+	int bearingX;
+	int bearingY;
+	int advance;
+} PrewarmGlyph;
+
+static bool loadGlyph(ShovelerFontAtlas *fontAtlas, unsigned int glyphIndex, uint32_t codePoint);
+static FT_Bitmap copyGlyphBitmap(ShovelerFontAtlas *fontAtlas, int *outputBearingX, int *outputBearingY);
+static ShovelerFontAtlasGlyph *addGlyph(ShovelerFontAtlas *fontAtlas, unsigned int glyphIndex, FT_Bitmap bitmap, int bearingX, int bearingY, int advance);
 static void insertGlyph(ShovelerFontAtlas *fontAtlas, FT_Bitmap glyph, int *outputPositionX, int *outputPositionY, bool *outputIsRotated);
+static bool findSkylinePosition(ShovelerFontAtlas *fontAtlas, int placedWidth, int placedHeight, guint *outputStartIndex, guint *outputEndIndex, int *outputHeight, long *outputWastedArea);
+static void mergeSkylineEdges(ShovelerFontAtlas *fontAtlas, guint index);
+static void spliceSkylineEdges(ShovelerFontAtlas *fontAtlas, guint index, guint numRemoved, const ShovelerFontAtlasSkylineEdge *insertedSkylineEdges, guint numInserted);
 static void growImage(ShovelerFontAtlas *fontAtlas);
+static void markDirty(ShovelerFontAtlas *fontAtlas, int x, int y, int width, int height);
 static void addBitmapToImage(ShovelerImage *image, FT_Bitmap bitmap, int bottomLeftX, int bottomLeftY, bool isRotated);
-static ShovelerFontAtlasSkylineEdge *allocateSkylineEdge(int minX, int width, int height);
+static ShovelerFontAtlasSkylineEdge skylineEdge(int minX, int width, int height);
+static int comparePrewarmGlyphs(const void *firstGlyphPointer, const void *secondGlyphPointer);
 
 ShovelerFontAtlas *shovelerFontAtlasCreate(ShovelerFont *font, int fontSize, int padding)
 {
@@ -27,13 +45,32 @@ ShovelerFontAtlas *shovelerFontAtlasCreate(ShovelerFont *font, int fontSize, int
 	fontAtlas->font = font;
 	fontAtlas->fontSize = fontSize;
 	fontAtlas->padding = padding;
+	fontAtlas->mode = SHOVELER_FONT_ATLAS_MODE_COVERAGE;
+	fontAtlas->spread = 0;
 	fontAtlas->image = shovelerImageCreate(1, 1, 1);
 	shovelerImageClear(fontAtlas->image);
 
-	fontAtlas->skylineEdges = g_queue_new();
-	g_queue_push_tail(fontAtlas->skylineEdges, allocateSkylineEdge(0, 1, 0));
+	fontAtlas->skylineEdges = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerFontAtlasSkylineEdge));
+	ShovelerFontAtlasSkylineEdge initialSkylineEdge = skylineEdge(0, 1, 0);
+	g_array_append_val(fontAtlas->skylineEdges, initialSkylineEdge);
 
 	fontAtlas->glyphs = g_hash_table_new_full(g_int_hash, g_int_equal, NULL, free);
+	shovelerFontAtlasClearDirty(fontAtlas);
+
+	return fontAtlas;
+}
+
+ShovelerFontAtlas *shovelerFontAtlasCreateSignedDistanceField(ShovelerFont *font, int fontSize, int padding, int spread)
+{
+	assert(spread > 0);
+
+	ShovelerFontAtlas *fontAtlas = shovelerFontAtlasCreate(font, fontSize, padding);
+	if(fontAtlas == NULL) {
+		return NULL;
+	}
+
+	fontAtlas->mode = SHOVELER_FONT_ATLAS_MODE_SIGNED_DISTANCE_FIELD;
+	fontAtlas->spread = spread;
 
 	return fontAtlas;
 }
@@ -47,52 +84,92 @@ ShovelerFontAtlasGlyph *shovelerFontAtlasGetGlyph(ShovelerFontAtlas *fontAtlas,
 		return glyph;
 	}
 
-	FT_Error error = FT_Load_Glyph(fontAtlas->font->face, glyphIndex, FT_LOAD_RENDER);
-	if(error != FT_Err_Ok) {
-		shovelerLogError("Failed to load missing glyph for font '%s': %s", fontAtlas->font->name, FT_Error_String(error));
+	if(!loadGlyph(fontAtlas, glyphIndex, codePoint)) {
 		return NULL;
 	}
 
-	unsigned int bitmapWidth = fontAtlas->font->face->glyph->bitmap.width;
-	if(bitmapWidth > INT_MAX) {
-		shovelerLogError("Font face glyph bitmap width for code point %u out of bounds: %u", (unsigned int) codePoint, bitmapWidth);
-		return NULL;
+	int bearingX;
+	int bearingY;
+	FT_Bitmap bitmap = copyGlyphBitmap(fontAtlas, &bearingX, &bearingY);
+	glyph = addGlyph(fontAtlas, glyphIndex, bitmap, bearingX, bearingY, (int) fontAtlas->font->face->glyph->advance.x);
+	free(bitmap.buffer);
+
+	return glyph;
+}
+
+int shovelerFontAtlasPrewarm(ShovelerFontAtlas *fontAtlas, const char *characters)
+{
+	// Rasterize all missing glyphs first, so that they can be packed in an order that wastes less space than inserting
+	// them as they come.
+	GArray *prewarmGlyphs = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(PrewarmGlyph));
+	long requiredArea = 0;
+	for(const char *c = characters; *c != '\0'; c++) {
+		uint32_t codePoint = *((unsigned char *) c);
+		unsigned int glyphIndex = FT_Get_Char_Index(fontAtlas->font->face, codePoint);
+		if(g_hash_table_contains(fontAtlas->glyphs, &glyphIndex)) {
+			continue;
+		}
+
+		if(!loadGlyph(fontAtlas, glyphIndex, codePoint)) {
+			continue;
+		}
+
+		PrewarmGlyph prewarmGlyph;
+		prewarmGlyph.index = glyphIndex;
+		prewarmGlyph.bitmap = copyGlyphBitmap(fontAtlas, &prewarmGlyph.bearingX, &prewarmGlyph.bearingY);
+		prewarmGlyph.advance = (int) fontAtlas->font->face->glyph->advance.x;
+		g_array_append_val(prewarmGlyphs, prewarmGlyph);
+
+		requiredArea += (long) (2 * fontAtlas->padding + (int) prewarmGlyph.bitmap.width) * (2 * fontAtlas->padding + (int) prewarmGlyph.bitmap.rows);
 	}
 
-	unsigned int bitmapHeight = fontAtlas->font->face->glyph->bitmap.rows;
-	if(bitmapHeight > INT_MAX) {
-		shovelerLogError("Font face glyph bitmap rows for code point %u out of bounds: %u", (unsigned int) codePoint, bitmapHeight);
-		return NULL;
+	GHashTableIter iter;
+	g_hash_table_iter_init(&iter, fontAtlas->glyphs);
+	ShovelerFontAtlasGlyph *glyph;
+	while(g_hash_table_iter_next(&iter, NULL, (gpointer *) &glyph)) {
+		requiredArea += (long) (2 * fontAtlas->padding + glyph->width) * (2 * fontAtlas->padding + glyph->height);
 	}
 
-	long advanceX = fontAtlas->font->face->glyph->advance.x;
-	if(advanceX > INT_MAX) {
-		shovelerLogError("Font face glyph bitmap advance X for code point %u out of bounds: %lu", (unsigned int) codePoint, advanceX);
-		return NULL;
+	// grow to at least the total glyph area right away instead of finding out one failed insertion at a time
+	while((long) fontAtlas->image->width * fontAtlas->image->height < requiredArea) {
+		growImage(fontAtlas);
 	}
 
+	qsort(prewarmGlyphs->data, prewarmGlyphs->len, sizeof(PrewarmGlyph), comparePrewarmGlyphs);
 
-	glyph = malloc(sizeof(ShovelerFontAtlasGlyph));
-	glyph->index = glyphIndex;
-	glyph->width = (int) bitmapWidth;
-	glyph->height = (int) bitmapHeight;
-	glyph->bearingX = fontAtlas->font->face->glyph->bitmap_left;
-	glyph->bearingY = fontAtlas->font->face->glyph->bitmap_top;
-	glyph->advance = (int) advanceX;
-	insertGlyph(fontAtlas, fontAtlas->font->face->glyph->bitmap, &glyph->minX, &glyph->minY, &glyph->isRotated);
+	int numAddedGlyphs = 0;
+	for(guint i = 0; i < prewarmGlyphs->len; i++) {
+		PrewarmGlyph *prewarmGlyph = &g_array_index(prewarmGlyphs, PrewarmGlyph, i);
 
-	g_hash_table_insert(fontAtlas->glyphs, &glyph->index, glyph);
+		// the same glyph could have been requested by several characters
+		if(!g_hash_table_contains(fontAtlas->glyphs, &prewarmGlyph->index)) {
+			addGlyph(fontAtlas, prewarmGlyph->index, prewarmGlyph->bitmap, prewarmGlyph->bearingX, prewarmGlyph->bearingY, prewarmGlyph->advance);
+			numAddedGlyphs++;
+		}
 
-	return glyph;
+		free(prewarmGlyph->bitmap.buffer);
+	}
+
+	g_array_free(prewarmGlyphs, /* freeSegment */ true);
+
+	return numAddedGlyphs;
+}
+
+void shovelerFontAtlasClearDirty(ShovelerFontAtlas *fontAtlas)
+{
+	fontAtlas->dirtyX = 0;
+	fontAtlas->dirtyY = 0;
+	fontAtlas->dirtyWidth = 0;
+	fontAtlas->dirtyHeight = 0;
 }
 
 void shovelerFontAtlasValidateState(ShovelerFontAtlas *fontAtlas)
 {
 	int totalWidth = 0;
-	for(GList *iter = fontAtlas->skylineEdges->head; iter != NULL; iter = iter->next) {
-		ShovelerFontAtlasSkylineEdge *skylineEdge = iter->data;
+	for(guint i = 0; i < fontAtlas->skylineEdges->len; i++) {
+		ShovelerFontAtlasSkylineEdge *skylineEdge = &g_array_index(fontAtlas->skylineEdges, ShovelerFontAtlasSkylineEdge, i);
 
-		assert(skylineEdge->minX < fontAtlas->image->width);
+		assert(skylineEdge->minX == totalWidth);
 		assert(skylineEdge->width > 0);
 		assert(skylineEdge->height <= fontAtlas->image->height);
 
@@ -140,110 +217,132 @@ void shovelerFontAtlasFree(ShovelerFontAtlas *fontAtlas)
 	}
 
 	g_hash_table_destroy(fontAtlas->glyphs);
-	g_queue_free_full(fontAtlas->skylineEdges, free);
+	g_array_free(fontAtlas->skylineEdges, /* freeSegment */ true);
 	shovelerImageFree(fontAtlas->image);
 
 	free(fontAtlas);
 }
 
+static bool loadGlyph(ShovelerFontAtlas *fontAtlas, unsigned int glyphIndex, uint32_t codePoint)
+{
+	FT_Error error = FT_Load_Glyph(fontAtlas->font->face, glyphIndex, FT_LOAD_RENDER);
+	if(error != FT_Err_Ok) {
+		shovelerLogError("Failed to load missing glyph for font '%s': %s", fontAtlas->font->name, FT_Error_String(error));
+		return false;
+	}
+
+	unsigned int bitmapWidth = fontAtlas->font->face->glyph->bitmap.width;
+	if(bitmapWidth > INT_MAX) {
+		shovelerLogError("Font face glyph bitmap width for code point %u out of bounds: %u", (unsigned int) codePoint, bitmapWidth);
+		return false;
+	}
+
+	unsigned int bitmapHeight = fontAtlas->font->face->glyph->bitmap.rows;
+	if(bitmapHeight > INT_MAX) {
+		shovelerLogError("Font face glyph bitmap rows for code point %u out of bounds: %u", (unsigned int) codePoint, bitmapHeight);
+		return false;
+	}
+
+	long advanceX = fontAtlas->font->face->glyph->advance.x;
+	if(advanceX > INT_MAX) {
+		shovelerLogError("Font face glyph bitmap advance X for code point %u out of bounds: %lu", (unsigned int) codePoint, advanceX);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Copies the bitmap of the glyph currently loaded into the font face's glyph slot in the atlas' mode, returning a
+ * bitmap whose buffer is owned by the caller. Distance fields grow the bitmap by the spread on each side, which shifts
+ * the bearings accordingly.
+ */
+static FT_Bitmap copyGlyphBitmap(ShovelerFontAtlas *fontAtlas, int *outputBearingX, int *outputBearingY)
+{
+	FT_GlyphSlot slot = fontAtlas->font->face->glyph;
+
+	// empty glyphs like spaces don't have an outline to measure distances to
+	if(fontAtlas->mode == SHOVELER_FONT_ATLAS_MODE_SIGNED_DISTANCE_FIELD && slot->bitmap.width > 0 && slot->bitmap.rows > 0) {
+		*outputBearingX = slot->bitmap_left - fontAtlas->spread;
+		*outputBearingY = slot->bitmap_top + fontAtlas->spread;
+		return shovelerFontCreateSignedDistanceField(slot->bitmap, fontAtlas->spread);
+	}
+
+	size_t bufferSize = (size_t) slot->bitmap.rows * (size_t) abs(slot->bitmap.pitch);
+
+	FT_Bitmap bitmap = slot->bitmap;
+	bitmap.buffer = malloc(bufferSize);
+	memcpy(bitmap.buffer, slot->bitmap.buffer, bufferSize);
+	*outputBearingX = slot->bitmap_left;
+	*outputBearingY = slot->bitmap_top;
+
+	return bitmap;
+}
+
+static ShovelerFontAtlasGlyph *addGlyph(ShovelerFontAtlas *fontAtlas, unsigned int glyphIndex, FT_Bitmap bitmap, int bearingX, int bearingY, int advance)
+{
+	ShovelerFontAtlasGlyph *glyph = malloc(sizeof(ShovelerFontAtlasGlyph));
+	glyph->index = glyphIndex;
+	glyph->width = (int) bitmap.width;
+	glyph->height = (int) bitmap.rows;
+	glyph->bearingX = bearingX;
+	glyph->bearingY = bearingY;
+	glyph->advance = advance;
+	insertGlyph(fontAtlas, bitmap, &glyph->minX, &glyph->minY, &glyph->isRotated);
+
+	g_hash_table_insert(fontAtlas->glyphs, &glyph->index, glyph);
+
+	return glyph;
+}
+
 static void insertGlyph(ShovelerFontAtlas *fontAtlas, FT_Bitmap glyph, int *outputPositionX, int *outputPositionY, bool *outputIsRotated)
 {
 	assert(glyph.width <= INT_MAX);
 	assert(glyph.rows <= INT_MAX);
 
-	// Using the "skyline bottom left" algorithm, we try to place the glyph in a position such
-	// that its height is as low as possible while also having it touch the existing ones on its
-	// left. To do this, the only information we need to keep track of is the current skyline of
-	// existing glyphs represented as a list of edges.
+	// Using the "skyline" algorithm, we try to place the glyph in a position such that its top is
+	// as low as possible while also having it touch the existing ones on its left. To do this,
+	// the only information we need to keep track of is the current skyline of existing glyphs,
+	// represented as an array of edges from left to right.
 	// The skyline starts with a single edge, and every inserted glyph splits at most one edge
-	// into two. This means that we have to store at most O(n) edges, but since every inserted
-	// glyph can also remove any number of existing edges, there are typically fewer than n actual
-	// edges in practice.
-	// We find find the optimal position for the next rectangle by walking through the skyline
-	// edges and doing a forward scan until we have reached enough width to place the rectangle.
-	// While this is O(n^2) complexity worst case, making the overall algorithm O(n^3) worst case,
-	// as mentioned before the skyline rarely actually contains n edges.
-	// There exists a better algorithm to do this in O(n^2) complexity overall that also keeps
-	// track of the created holes, but it is much more complicated to implement:
-	// "The Bottom-Left Bin-Packing Heuristic" by Chazelle et al.
+	// into two, while neighboring edges of equal height are merged again. Among the positions
+	// with the lowest top, we pick the best fit, i.e. the one leaving the least area unusable
+	// below the glyph.
+	// We try rotated first because we expect glyphs to have a larger height than width, and only
+	// prefer the upright placement if it is strictly better.
 
 	int placedGlyphWidth = 2 * fontAtlas->padding + (int) glyph.width;
 	int placedGlyphHeight = 2 * fontAtlas->padding + (int) glyph.rows;
 
-	GList *bestStartSkylineEdgeIter = NULL;
-	GList *bestEndSkylineEdgeIter = NULL;
-	int bestHeight = INT_MAX;
-	bool isRotated = false;
-	for(GList *iter = fontAtlas->skylineEdges->head; iter != NULL; iter = iter->next) {
-		ShovelerFontAtlasSkylineEdge *skylineEdge = iter->data;
-
-		// Try to put the glyph rotated on top of this skyline edge. We try rotated first because
-		// we expect glyphs to have a larger height than width.
-		{
-			int maxEdgeHeight = skylineEdge->height;
-			// The glyph could be wider than this skyline edge, so we might have to extend across
-			// a few more as long as their height is lower.
-			GList *endIter = iter;
-			int currentEdgeWidth = skylineEdge->width;
-			while(currentEdgeWidth < placedGlyphHeight && endIter->next != NULL) {
-				endIter = endIter->next;
-				ShovelerFontAtlasSkylineEdge *additionalSkylineEdge = endIter->data;
-
-				if(additionalSkylineEdge->height > maxEdgeHeight) {
-					// This skyline edge is higher than the one we started with, so update our max
-					// height.
-					maxEdgeHeight = additionalSkylineEdge->height;
-				}
-
-				currentEdgeWidth += additionalSkylineEdge->width;
-			}
-
-			int candidateHeight = maxEdgeHeight + placedGlyphWidth;
-			if(candidateHeight < bestHeight && candidateHeight <= fontAtlas->image->height && currentEdgeWidth >= placedGlyphHeight) {
-				// We could put the glyph here, and this is the best we've found so far.
-				bestStartSkylineEdgeIter = iter;
-				bestEndSkylineEdgeIter = endIter;
-				bestHeight = candidateHeight;
-				isRotated = true;
-			}
+	guint startIndex;
+	guint endIndex;
+	int height;
+	bool isRotated;
+	while(true) {
+		guint rotatedStartIndex;
+		guint rotatedEndIndex;
+		int rotatedHeight;
+		long rotatedWastedArea;
+		bool rotatedFits = findSkylinePosition(fontAtlas, placedGlyphHeight, placedGlyphWidth, &rotatedStartIndex, &rotatedEndIndex, &rotatedHeight, &rotatedWastedArea);
+
+		long wastedArea;
+		bool fits = findSkylinePosition(fontAtlas, placedGlyphWidth, placedGlyphHeight, &startIndex, &endIndex, &height, &wastedArea);
+
+		if(rotatedFits && (!fits || rotatedHeight < height || (rotatedHeight == height && rotatedWastedArea <= wastedArea))) {
+			startIndex = rotatedStartIndex;
+			endIndex = rotatedEndIndex;
+			height = rotatedHeight;
+			isRotated = true;
+			break;
 		}
 
-		// Try to put the glyph on top of this skyline edge.
-		{
-			int maxEdgeHeight = skylineEdge->height;
-			// The glyph could be wider than this skyline edge, so we might have to extend across
-			// a few more as long as their height is lower.
-			GList *endIter = iter;
-			int currentEdgeWidth = skylineEdge->width;
-			while(currentEdgeWidth < placedGlyphWidth && endIter->next != NULL) {
-				endIter = endIter->next;
-				ShovelerFontAtlasSkylineEdge *additionalSkylineEdge = endIter->data;
-
-				if(additionalSkylineEdge->height > maxEdgeHeight) {
-					// This skyline edge is higher than the one we started with, so update our max
-					// height.
-					maxEdgeHeight = additionalSkylineEdge->height;
-				}
-
-				currentEdgeWidth += additionalSkylineEdge->width;
-			}
-
-			int candidateHeight = maxEdgeHeight + placedGlyphHeight;
-			if(candidateHeight < bestHeight && candidateHeight <= fontAtlas->image->height && currentEdgeWidth >= placedGlyphWidth) {
-				// We could put the glyph here, and this is the best we've found so far.
-				bestStartSkylineEdgeIter = iter;
-				bestEndSkylineEdgeIter = endIter;
-				bestHeight = candidateHeight;
-				isRotated = false;
-			}
+		if(fits) {
+			isRotated = false;
+			break;
 		}
-	}
 
-	if(bestStartSkylineEdgeIter == NULL) {
 		// doesn't fit, grow and retry
 		growImage(fontAtlas);
-		insertGlyph(fontAtlas, glyph, outputPositionX, outputPositionY, outputIsRotated);
-		return;
 	}
 
 	if(isRotated) {
@@ -252,48 +351,133 @@ static void insertGlyph(ShovelerFontAtlas *fontAtlas, FT_Bitmap glyph, int *outp
 		placedGlyphWidth = temp;
 	}
 
-	ShovelerFontAtlasSkylineEdge *bestStartSkylineEdge = bestStartSkylineEdgeIter->data;
-	*outputPositionX = fontAtlas->padding + bestStartSkylineEdge->minX;
-	*outputPositionY = fontAtlas->padding + bestHeight - placedGlyphHeight;
+	ShovelerFontAtlasSkylineEdge *startSkylineEdge = &g_array_index(fontAtlas->skylineEdges, ShovelerFontAtlasSkylineEdge, startIndex);
+	int minX = startSkylineEdge->minX;
+	*outputPositionX = fontAtlas->padding + minX;
+	*outputPositionY = fontAtlas->padding + height - placedGlyphHeight;
 	*outputIsRotated = isRotated;
 
 	// place the glyph here
 	addBitmapToImage(fontAtlas->image, glyph, *outputPositionX, *outputPositionY, *outputIsRotated);
+	markDirty(fontAtlas, *outputPositionX, *outputPositionY, placedGlyphWidth - 2 * fontAtlas->padding, placedGlyphHeight - 2 * fontAtlas->padding);
 
-	// Accumulate the width of all the skyline edges that we're going to combine by placing the
-	// glyph on top.
-	int accumulatedWidth = 0;
-	for(GList *iter = bestStartSkylineEdgeIter; iter != bestEndSkylineEdgeIter;) {
-		ShovelerFontAtlasSkylineEdge *currentSkylineEdge = iter->data;
+	// Replace the skyline edges covered by the glyph with a single one on top of it, keeping the
+	// part of the last covered edge that sticks out on the right.
+	ShovelerFontAtlasSkylineEdge *endSkylineEdge = &g_array_index(fontAtlas->skylineEdges, ShovelerFontAtlasSkylineEdge, endIndex);
+	int accumulatedWidth = endSkylineEdge->minX + endSkylineEdge->width - minX;
+	int endHeight = endSkylineEdge->height;
+	assert(accumulatedWidth >= placedGlyphWidth);
 
-		// update accumulated width
-		accumulatedWidth += currentSkylineEdge->width;
+	ShovelerFontAtlasSkylineEdge replacingSkylineEdges[2];
+	guint numReplacingSkylineEdges = 0;
+	replacingSkylineEdges[numReplacingSkylineEdges++] = skylineEdge(minX, placedGlyphWidth, height);
 
-		GList *currentNode = iter;
-		iter = iter->next;
-		free(currentSkylineEdge);
-		g_queue_delete_link(fontAtlas->skylineEdges, currentNode);
+	int remainingWidth = accumulatedWidth - placedGlyphWidth;
+	if(remainingWidth > 0) {
+		replacingSkylineEdges[numReplacingSkylineEdges++] = skylineEdge(minX + placedGlyphWidth, remainingWidth, endHeight);
 	}
 
-	// split the last edge into two
-	ShovelerFontAtlasSkylineEdge *bestEndSkylineEdge = bestEndSkylineEdgeIter->data;
-	accumulatedWidth += bestEndSkylineEdge->width;
+	spliceSkylineEdges(fontAtlas, startIndex, endIndex - startIndex + 1, replacingSkylineEdges, numReplacingSkylineEdges);
+	mergeSkylineEdges(fontAtlas, startIndex);
+}
 
-	assert(accumulatedWidth >= placedGlyphWidth);
+/**
+ * Finds the lowest position on the skyline to place a rectangle of the given size at, breaking ties by the area left
+ * unusable below it. Returns false if the rectangle doesn't fit anywhere.
+ */
+static bool findSkylinePosition(ShovelerFontAtlas *fontAtlas, int placedWidth, int placedHeight, guint *outputStartIndex, guint *outputEndIndex, int *outputHeight, long *outputWastedArea)
+{
+	ShovelerFontAtlasSkylineEdge *skylineEdges = (ShovelerFontAtlasSkylineEdge *) fontAtlas->skylineEdges->data;
+	guint numSkylineEdges = fontAtlas->skylineEdges->len;
+
+	bool found = false;
+	for(guint startIndex = 0; startIndex < numSkylineEdges; startIndex++) {
+		int minX = skylineEdges[startIndex].minX;
+		if(minX + placedWidth > fontAtlas->image->width) {
+			// edges further right have even less room left
+			break;
+		}
 
-	int remainingWidth = accumulatedWidth - placedGlyphWidth;
-	if(remainingWidth > 0) {
-		// If we don't fill the full edge, split off the remainder
-		ShovelerFontAtlasSkylineEdge *splitEndSkylineEdge = allocateSkylineEdge(
-			*outputPositionX - fontAtlas->padding + placedGlyphWidth,
-			remainingWidth,
-			bestEndSkylineEdge->height);
-		g_queue_insert_after(fontAtlas->skylineEdges, bestEndSkylineEdgeIter, splitEndSkylineEdge);
+		// The rectangle could be wider than this skyline edge, so we might have to extend across
+		// a few more, resting on the highest of them.
+		guint endIndex = startIndex;
+		int maxEdgeHeight = skylineEdges[startIndex].height;
+		while(skylineEdges[endIndex].minX + skylineEdges[endIndex].width < minX + placedWidth) {
+			endIndex++;
+			assert(endIndex < numSkylineEdges);
+
+			if(skylineEdges[endIndex].height > maxEdgeHeight) {
+				maxEdgeHeight = skylineEdges[endIndex].height;
+			}
+		}
+
+		int candidateHeight = maxEdgeHeight + placedHeight;
+		if(candidateHeight > fontAtlas->image->height || (found && candidateHeight > *outputHeight)) {
+			continue;
+		}
+
+		long wastedArea = 0;
+		for(guint index = startIndex; index <= endIndex; index++) {
+			int coveredMaxX = skylineEdges[index].minX + skylineEdges[index].width;
+			if(coveredMaxX > minX + placedWidth) {
+				coveredMaxX = minX + placedWidth;
+			}
+
+			wastedArea += (long) (coveredMaxX - skylineEdges[index].minX) * (maxEdgeHeight - skylineEdges[index].height);
+		}
+
+		if(found && candidateHeight == *outputHeight && wastedArea >= *outputWastedArea) {
+			continue;
+		}
+
+		found = true;
+		*outputStartIndex = startIndex;
+		*outputEndIndex = endIndex;
+		*outputHeight = candidateHeight;
+		*outputWastedArea = wastedArea;
+	}
+
+	return found;
+}
+
+/** Merges the skyline edge at the given index with its neighbors if they have the same height. */
+static void mergeSkylineEdges(ShovelerFontAtlas *fontAtlas, guint index)
+{
+	ShovelerFontAtlasSkylineEdge *skylineEdges = (ShovelerFontAtlasSkylineEdge *) fontAtlas->skylineEdges->data;
+
+	if(index + 1 < fontAtlas->skylineEdges->len && skylineEdges[index + 1].height == skylineEdges[index].height) {
+		ShovelerFontAtlasSkylineEdge mergedSkylineEdge = skylineEdge(skylineEdges[index].minX, skylineEdges[index].width + skylineEdges[index + 1].width, skylineEdges[index].height);
+		spliceSkylineEdges(fontAtlas, index, 2, &mergedSkylineEdge, 1);
+		skylineEdges = (ShovelerFontAtlasSkylineEdge *) fontAtlas->skylineEdges->data;
+	}
+
+	if(index > 0 && skylineEdges[index - 1].height == skylineEdges[index].height) {
+		ShovelerFontAtlasSkylineEdge mergedSkylineEdge = skylineEdge(skylineEdges[index - 1].minX, skylineEdges[index - 1].width + skylineEdges[index].width, skylineEdges[index].height);
+		spliceSkylineEdges(fontAtlas, index - 1, 2, &mergedSkylineEdge, 1);
+	}
+}
+
+/**
+ * Replaces a range of skyline edges with the passed ones, moving the edges behind them in place. This is done by hand
+ * because the insert and remove functions of the bundled fakeglib don't support moving overlapping elements.
+ */
+static void spliceSkylineEdges(ShovelerFontAtlas *fontAtlas, guint index, guint numRemoved, const ShovelerFontAtlasSkylineEdge *insertedSkylineEdges, guint numInserted)
+{
+	guint oldLength = fontAtlas->skylineEdges->len;
+	guint newLength = oldLength - numRemoved + numInserted;
+	assert(index + numRemoved <= oldLength);
+
+	if(newLength > oldLength) {
+		g_array_set_size(fontAtlas->skylineEdges, newLength);
 	}
 
-	bestEndSkylineEdge->minX = *outputPositionX - fontAtlas->padding;
-	bestEndSkylineEdge->width = placedGlyphWidth;
-	bestEndSkylineEdge->height = bestHeight;
+	ShovelerFontAtlasSkylineEdge *skylineEdges = (ShovelerFontAtlasSkylineEdge *) fontAtlas->skylineEdges->data;
+	memmove(&skylineEdges[index + numInserted], &skylineEdges[index + numRemoved], (oldLength - index - numRemoved) * sizeof(ShovelerFontAtlasSkylineEdge));
+	memcpy(&skylineEdges[index], insertedSkylineEdges, numInserted * sizeof(ShovelerFontAtlasSkylineEdge));
+
+	if(newLength < oldLength) {
+		g_array_set_size(fontAtlas->skylineEdges, newLength);
+	}
 }
 
 static void growImage(ShovelerFontAtlas *fontAtlas)
@@ -304,10 +488,37 @@ static void growImage(ShovelerFontAtlas *fontAtlas)
 	shovelerImageClear(fontAtlas->image);
 	shovelerImageAddSubImage(fontAtlas->image, 0, 0, oldImage);
 
-	g_queue_push_tail(fontAtlas->skylineEdges, allocateSkylineEdge(oldImage->width, oldImage->width, 0));
+	ShovelerFontAtlasSkylineEdge grownSkylineEdge = skylineEdge(oldImage->width, oldImage->width, 0);
+	g_array_append_val(fontAtlas->skylineEdges, grownSkylineEdge);
+	mergeSkylineEdges(fontAtlas, fontAtlas->skylineEdges->len - 1);
+
 	shovelerImageFree(oldImage);
 }
 
+static void markDirty(ShovelerFontAtlas *fontAtlas, int x, int y, int width, int height)
+{
+	if(width == 0 || height == 0) {
+		return;
+	}
+
+	if(fontAtlas->dirtyWidth == 0 || fontAtlas->dirtyHeight == 0) {
+		fontAtlas->dirtyX = x;
+		fontAtlas->dirtyY = y;
+		fontAtlas->dirtyWidth = width;
+		fontAtlas->dirtyHeight = height;
+		return;
+	}
+
+	int minX = x < fontAtlas->dirtyX ? x : fontAtlas->dirtyX;
+	int minY = y < fontAtlas->dirtyY ? y : fontAtlas->dirtyY;
+	int maxX = x + width > fontAtlas->dirtyX + fontAtlas->dirtyWidth ? x + width : fontAtlas->dirtyX + fontAtlas->dirtyWidth;
+	int maxY = y + height > fontAtlas->dirtyY + fontAtlas->dirtyHeight ? y + height : fontAtlas->dirtyY + fontAtlas->dirtyHeight;
+	fontAtlas->dirtyX = minX;
+	fontAtlas->dirtyY = minY;
+	fontAtlas->dirtyWidth = maxX - minX;
+	fontAtlas->dirtyHeight = maxY - minY;
+}
+
 static void addBitmapToImage(ShovelerImage *image, FT_Bitmap bitmap, int bottomLeftX, int bottomLeftY, bool isRotated)
 {
 	assert(bitmap.width <= INT_MAX);
@@ -330,11 +541,26 @@ static void addBitmapToImage(ShovelerImage *image, FT_Bitmap bitmap, int bottomL
 	}
 }
 
-static ShovelerFontAtlasSkylineEdge *allocateSkylineEdge(int minX, int width, int height)
+static ShovelerFontAtlasSkylineEdge skylineEdge(int minX, int width, int height)
 {
-	ShovelerFontAtlasSkylineEdge *skylineEdge = malloc(sizeof(ShovelerFontAtlasSkylineEdge));
-	skylineEdge->minX = minX;
-	skylineEdge->width = width;
-	skylineEdge->height = height;
+	ShovelerFontAtlasSkylineEdge skylineEdge;
+	skylineEdge.minX = minX;
+	skylineEdge.width = width;
+	skylineEdge.height = height;
 	return skylineEdge;
 }
+
+static int comparePrewarmGlyphs(const void *firstGlyphPointer, const void *secondGlyphPointer)
+{
+	const PrewarmGlyph *firstGlyph = firstGlyphPointer;
+	const PrewarmGlyph *secondGlyph = secondGlyphPointer;
+
+	// tallest first, then widest first
+	if(firstGlyph->bitmap.rows != secondGlyph->bitmap.rows) {
+		return firstGlyph->bitmap.rows > secondGlyph->bitmap.rows ? -1 : 1;
+	}
+	if(firstGlyph->bitmap.width != secondGlyph->bitmap.width) {
+		return firstGlyph->bitmap.width > secondGlyph->bitmap.width ? -1 : 1;
+	}
+	return 0;
+}
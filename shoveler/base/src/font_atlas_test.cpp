@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/font.h"
+#include "shoveler/font_atlas.h"
+#include "shoveler/image.h"
+}
+
+// At this font size, a font unit is exactly 1/64 pixels, so the boxes below rasterize to exact bitmaps.
+static const int fontSize = 16;
+static const int unitsPerEm = 64 * fontSize;
+static const int unitsPerPixel = unitsPerEm / fontSize;
+
+struct BoxGlyph {
+	char character;
+	int width;
+	int height;
+};
+
+/** characters of the test font, each of which is a filled box of the given size in pixels */
+static const BoxGlyph boxGlyphs[] = {{'A', 3, 2}, {'B', 5, 2}, {'C', 2, 2}, {'D', 1, 4}};
+static const int numBoxGlyphs = sizeof(boxGlyphs) / sizeof(boxGlyphs[0]);
+
+static std::string createBoxFont();
+
+class ShovelerFontAtlasTest : public ::testing::Test {
+public:
+	virtual void SetUp()
+	{
+		fontData = createBoxFont();
+		fonts = shovelerFontsCreate();
+		font = shovelerFontsLoadFontBuffer(fonts, "boxes", reinterpret_cast<const unsigned char *>(fontData.data()), (int) fontData.size());
+		ASSERT_NE(font, nullptr);
+		fontAtlas = shovelerFontAtlasCreate(font, fontSize, /* padding */ 0);
+		ASSERT_NE(fontAtlas, nullptr);
+	}
+
+	virtual void TearDown()
+	{
+		shovelerFontAtlasFree(fontAtlas);
+		shovelerFontsFree(fonts);
+	}
+
+	/** Replaces the atlas image with an empty one of the given size, resting on the given skyline. */
+	void setSkyline(int imageSize, const std::vector<ShovelerFontAtlasSkylineEdge> &skylineEdges)
+	{
+		shovelerImageFree(fontAtlas->image);
+		fontAtlas->image = shovelerImageCreate(imageSize, imageSize, 1);
+		shovelerImageClear(fontAtlas->image);
+
+		g_array_set_size(fontAtlas->skylineEdges, 0);
+		for(const ShovelerFontAtlasSkylineEdge &skylineEdge : skylineEdges) {
+			g_array_append_val(fontAtlas->skylineEdges, skylineEdge);
+		}
+	}
+
+	void assertSkyline(const std::vector<ShovelerFontAtlasSkylineEdge> &expectedSkylineEdges)
+	{
+		ASSERT_EQ(fontAtlas->skylineEdges->len, expectedSkylineEdges.size());
+		for(guint i = 0; i < fontAtlas->skylineEdges->len; i++) {
+			const ShovelerFontAtlasSkylineEdge &skylineEdge = g_array_index(fontAtlas->skylineEdges, ShovelerFontAtlasSkylineEdge, i);
+			ASSERT_EQ(skylineEdge.minX, expectedSkylineEdges[i].minX) << "skyline edge " << i;
+			ASSERT_EQ(skylineEdge.width, expectedSkylineEdges[i].width) << "skyline edge " << i;
+			ASSERT_EQ(skylineEdge.height, expectedSkylineEdges[i].height) << "skyline edge " << i;
+		}
+	}
+
+	std::string fontData;
+	ShovelerFonts *fonts;
+	ShovelerFont *font;
+	ShovelerFontAtlas *fontAtlas;
+};
+
+TEST_F(ShovelerFontAtlasTest, boxGlyphs)
+{
+	for(int i = 0; i < numBoxGlyphs; i++) {
+		ShovelerFontAtlasGlyph *glyph = shovelerFontAtlasGetGlyph(fontAtlas, boxGlyphs[i].character);
+		ASSERT_NE(glyph, nullptr);
+		ASSERT_EQ(glyph->width, boxGlyphs[i].width) << "glyph " << boxGlyphs[i].character;
+		ASSERT_EQ(glyph->height, boxGlyphs[i].height) << "glyph " << boxGlyphs[i].character;
+		ASSERT_EQ(shovelerFontAtlasGetGlyph(fontAtlas, boxGlyphs[i].character), glyph) << "glyph " << boxGlyphs[i].character << " should be cached";
+	}
+
+	shovelerFontAtlasValidateState(fontAtlas);
+}
+
+TEST_F(ShovelerFontAtlasTest, growSpliceAndMerge)
+{
+	ShovelerFontAtlasGlyph *first = shovelerFontAtlasGetGlyph(fontAtlas, 'A');
+	ASSERT_EQ(fontAtlas->image->width, 4) << "image should have doubled from a single pixel until the glyph fit";
+	ASSERT_EQ(fontAtlas->image->height, 4);
+	ASSERT_EQ(first->minX, 0);
+	ASSERT_EQ(first->minY, 0);
+	ASSERT_FALSE(first->isRotated);
+	assertSkyline({{0, 3, 2}, {3, 1, 0}});
+
+	ShovelerFontAtlasGlyph *second = shovelerFontAtlasGetGlyph(fontAtlas, 'B');
+	ASSERT_EQ(fontAtlas->image->width, 8) << "image should have grown to fit the wider glyph";
+	ASSERT_EQ(fontAtlas->image->height, 8);
+	ASSERT_EQ(second->minX, 3);
+	ASSERT_EQ(second->minY, 0);
+	ASSERT_FALSE(second->isRotated);
+	assertSkyline({{0, 8, 2}});
+
+	ASSERT_EQ(shovelerImageGet(fontAtlas->image, 0, 0, 0), 255) << "glyphs placed before growing should be kept";
+	ASSERT_EQ(shovelerImageGet(fontAtlas->image, 2, 1, 0), 255);
+	ASSERT_EQ(shovelerImageGet(fontAtlas->image, 7, 1, 0), 255);
+	ASSERT_EQ(shovelerImageGet(fontAtlas->image, 0, 2, 0), 0);
+	shovelerFontAtlasValidateState(fontAtlas);
+}
+
+TEST_F(ShovelerFontAtlasTest, bestFit)
+{
+	// Both x = 0 and x = 4 let a 2x2 glyph rest at height 1, but only x = 4 leaves no gap below it.
+	setSkyline(8, {{0, 1, 1}, {1, 1, 0}, {2, 2, 2}, {4, 2, 1}, {6, 2, 2}});
+
+	ShovelerFontAtlasGlyph *glyph = shovelerFontAtlasGetGlyph(fontAtlas, 'C');
+	ASSERT_EQ(glyph->minX, 4);
+	ASSERT_EQ(glyph->minY, 1);
+	assertSkyline({{0, 1, 1}, {1, 1, 0}, {2, 2, 2}, {4, 2, 3}, {6, 2, 2}});
+}
+
+TEST_F(ShovelerFontAtlasTest, rotateIfLower)
+{
+	// The glyph rotated into the gap on the right ends lower than upright on the flat part on the left.
+	setSkyline(8, {{0, 6, 2}, {6, 2, 0}});
+
+	ShovelerFontAtlasGlyph *glyph = shovelerFontAtlasGetGlyph(fontAtlas, 'A');
+	ASSERT_EQ(glyph->minX, 6);
+	ASSERT_EQ(glyph->minY, 0);
+	ASSERT_TRUE(glyph->isRotated);
+	assertSkyline({{0, 6, 2}, {6, 2, 3}});
+	shovelerFontAtlasValidateState(fontAtlas);
+}
+
+TEST_F(ShovelerFontAtlasTest, prewarm)
+{
+	int numAddedGlyphs = shovelerFontAtlasPrewarm(fontAtlas, "ABCDA");
+	ASSERT_EQ(numAddedGlyphs, numBoxGlyphs) << "repeated characters should only be added once";
+	ASSERT_EQ(g_hash_table_size(fontAtlas->glyphs), numBoxGlyphs);
+
+	long glyphArea = 0;
+	for(int i = 0; i < numBoxGlyphs; i++) {
+		unsigned int glyphIndex = FT_Get_Char_Index(font->face, boxGlyphs[i].character);
+		ASSERT_TRUE(g_hash_table_contains(fontAtlas->glyphs, &glyphIndex)) << "glyph " << boxGlyphs[i].character;
+		glyphArea += boxGlyphs[i].width * boxGlyphs[i].height;
+	}
+	ASSERT_GE((long) fontAtlas->image->width * fontAtlas->image->height, glyphArea);
+	shovelerFontAtlasValidateState(fontAtlas);
+
+	ShovelerImage *image = fontAtlas->image;
+	for(int i = 0; i < numBoxGlyphs; i++) {
+		shovelerFontAtlasGetGlyph(fontAtlas, boxGlyphs[i].character);
+	}
+	ASSERT_EQ(g_hash_table_size(fontAtlas->glyphs), numBoxGlyphs) << "prewarmed glyphs should be cached";
+	ASSERT_EQ(fontAtlas->image, image) << "looking up prewarmed glyphs shouldn't grow the image";
+	ASSERT_EQ(shovelerFontAtlasPrewarm(fontAtlas, "ABCD"), 0);
+}
+
+TEST_F(ShovelerFontAtlasTest, dirtyRectangle)
+{
+	shovelerFontAtlasFree(fontAtlas);
+	fontAtlas = shovelerFontAtlasCreate(font, fontSize, /* padding */ 1);
+	shovelerFontAtlasPrewarm(fontAtlas, "B");
+	shovelerFontAtlasClearDirty(fontAtlas);
+	ASSERT_EQ(fontAtlas->dirtyWidth, 0);
+	ASSERT_EQ(fontAtlas->dirtyHeight, 0);
+
+	ShovelerFontAtlasGlyph *first = shovelerFontAtlasGetGlyph(fontAtlas, 'C');
+	int placedFirstWidth = first->isRotated ? first->height : first->width;
+	int placedFirstHeight = first->isRotated ? first->width : first->height;
+	ASSERT_EQ(fontAtlas->dirtyX, first->minX) << "dirty rectangle should exclude the padding";
+	ASSERT_EQ(fontAtlas->dirtyY, first->minY);
+	ASSERT_EQ(fontAtlas->dirtyWidth, placedFirstWidth);
+	ASSERT_EQ(fontAtlas->dirtyHeight, placedFirstHeight);
+
+	ShovelerFontAtlasGlyph *second = shovelerFontAtlasGetGlyph(fontAtlas, 'D');
+	int placedSecondWidth = second->isRotated ? second->height : second->width;
+	int placedSecondHeight = second->isRotated ? second->width : second->height;
+	int minX = std::min(first->minX, second->minX);
+	int minY = std::min(first->minY, second->minY);
+	int maxX = std::max(first->minX + placedFirstWidth, second->minX + placedSecondWidth);
+	int maxY = std::max(first->minY + placedFirstHeight, second->minY + placedSecondHeight);
+	ASSERT_EQ(fontAtlas->dirtyX, minX) << "dirty rectangle should bound exactly both new glyphs";
+	ASSERT_EQ(fontAtlas->dirtyY, minY);
+	ASSERT_EQ(fontAtlas->dirtyWidth, maxX - minX);
+	ASSERT_EQ(fontAtlas->dirtyHeight, maxY - minY);
+
+	// like a font atlas texture after uploading the changed region
+	shovelerFontAtlasClearDirty(fontAtlas);
+	shovelerFontAtlasGetGlyph(fontAtlas, 'C');
+	shovelerFontAtlasPrewarm(fontAtlas, "BCD");
+	ASSERT_EQ(fontAtlas->dirtyWidth, 0) << "cached glyphs shouldn't mark anything dirty";
+	ASSERT_EQ(fontAtlas->dirtyHeight, 0);
+}
+
+static void appendUint16(std::string &data, int value)
+{
+	data.push_back((char) ((value >> 8) & 0xFF));
+	data.push_back((char) (value & 0xFF));
+}
+
+static void appendUint32(std::string &data, uint32_t value)
+{
+	appendUint16(data, (int) (value >> 16));
+	appendUint16(data, (int) (value & 0xFFFF));
+}
+
+/** Builds a minimal TrueType font in memory, mapping each box glyph's character to a single rectangular contour. */
+static std::string createBoxFont()
+{
+	int numGlyphs = numBoxGlyphs + 1; // glyph 0 is the empty .notdef glyph
+	int maxSize = 0;
+
+	std::string glyf;
+	std::string loca;
+	std::string hmtx;
+	appendUint32(loca, 0);
+	appendUint32(loca, 0); // .notdef has no outline
+	appendUint16(hmtx, unitsPerPixel);
+	appendUint16(hmtx, 0);
+	for(int i = 0; i < numBoxGlyphs; i++) {
+		int width = boxGlyphs[i].width * unitsPerPixel;
+		int height = boxGlyphs[i].height * unitsPerPixel;
+		maxSize = std::max(maxSize, std::max(width, height));
+
+		appendUint16(glyf, 1); // numberOfContours
+		appendUint16(glyf, 0); // xMin
+		appendUint16(glyf, 0); // yMin
+		appendUint16(glyf, width); // xMax
+		appendUint16(glyf, height); // yMax
+		appendUint16(glyf, 3); // endPtsOfContours
+		appendUint16(glyf, 0); // instructionLength
+		for(int point = 0; point < 4; point++) {
+			glyf.push_back(0x01); // on curve, with 16 bit coordinate deltas
+		}
+		// clockwise from the origin: (0, 0), (0, height), (width, height), (width, 0)
+		appendUint16(glyf, 0);
+		appendUint16(glyf, 0);
+		appendUint16(glyf, width);
+		appendUint16(glyf, 0);
+		appendUint16(glyf, 0);
+		appendUint16(glyf, height);
+		appendUint16(glyf, 0);
+		appendUint16(glyf, -height);
+		appendUint32(loca, (uint32_t) glyf.size());
+
+		appendUint16(hmtx, width + unitsPerPixel); // advanceWidth
+		appendUint16(hmtx, 0); // leftSideBearing
+	}
+
+	std::string head;
+	appendUint32(head, 0x00010000); // version
+	appendUint32(head, 0x00010000); // fontRevision
+	appendUint32(head, 0); // checkSumAdjustment
+	appendUint32(head, 0x5F0F3CF5); // magicNumber
+	appendUint16(head, 0x000B); // flags: baseline and left side bearing at zero, integer scaling
+	appendUint16(head, unitsPerEm);
+	appendUint32(head, 0); // created
+	appendUint32(head, 0);
+	appendUint32(head, 0); // modified
+	appendUint32(head, 0);
+	appendUint16(head, 0); // xMin
+	appendUint16(head, 0); // yMin
+	appendUint16(head, maxSize); // xMax
+	appendUint16(head, maxSize); // yMax
+	appendUint16(head, 0); // macStyle
+	appendUint16(head, 8); // lowestRecPPEM
+	appendUint16(head, 2); // fontDirectionHint
+	appendUint16(head, 1); // indexToLocFormat: long offsets
+	appendUint16(head, 0); // glyphDataFormat
+
+	std::string hhea;
+	appendUint32(hhea, 0x00010000); // version
+	appendUint16(hhea, unitsPerEm); // ascender
+	appendUint16(hhea, 0); // descender
+	appendUint16(hhea, 0); // lineGap
+	appendUint16(hhea, maxSize + unitsPerPixel); // advanceWidthMax
+	appendUint16(hhea, 0); // minLeftSideBearing
+	appendUint16(hhea, 0); // minRightSideBearing
+	appendUint16(hhea, maxSize); // xMaxExtent
+	appendUint16(hhea, 1); // caretSlopeRise
+	appendUint16(hhea, 0); // caretSlopeRun
+	appendUint16(hhea, 0); // caretOffset
+	for(int i = 0; i < 4; i++) {
+		appendUint16(hhea, 0); // reserved
+	}
+	appendUint16(hhea, 0); // metricDataFormat
+	appendUint16(hhea, numGlyphs); // numberOfHMetrics
+
+	std::string maxp;
+	appendUint32(maxp, 0x00010000); // version
+	appendUint16(maxp, numGlyphs);
+	appendUint16(maxp, 4); // maxPoints
+	appendUint16(maxp, 1); // maxContours
+	appendUint16(maxp, 0); // maxCompositePoints
+	appendUint16(maxp, 0); // maxCompositeContours
+	appendUint16(maxp, 2); // maxZones
+	for(int i = 0; i < 8; i++) {
+		appendUint16(maxp, 0); // twilight points, storage, definitions, stack, instructions and components
+	}
+
+	// a single format 12 group mapping the consecutive box characters to glyphs 1 and up
+	std::string cmap;
+	appendUint16(cmap, 0); // version
+	appendUint16(cmap, 1); // numTables
+	appendUint16(cmap, 3); // platformID: Windows
+	appendUint16(cmap, 10); // encodingID: Unicode full repertoire
+	appendUint32(cmap, 12); // offset
+	appendUint16(cmap, 12); // format
+	appendUint16(cmap, 0); // reserved
+	appendUint32(cmap, 28); // length
+	appendUint32(cmap, 0); // language
+	appendUint32(cmap, 1); // numGroups
+	appendUint32(cmap, (uint32_t) boxGlyphs[0].character); // startCharCode
+	appendUint32(cmap, (uint32_t) boxGlyphs[numBoxGlyphs - 1].character); // endCharCode
+	appendUint32(cmap, 1); // startGlyphID
+
+	// tables sorted by tag, as required for the table directory
+	std::vector<std::pair<std::string, std::string>> tables = {
+		{"cmap", cmap},
+		{"glyf", glyf},
+		{"head", head},
+		{"hhea", hhea},
+		{"hmtx", hmtx},
+		{"loca", loca},
+		{"maxp", maxp}};
+
+	std::string font;
+	appendUint32(font, 0x00010000); // sfntVersion
+	appendUint16(font, (int) tables.size()); // numTables
+	appendUint16(font, 64); // searchRange
+	appendUint16(font, 2); // entrySelector
+	appendUint16(font, (int) tables.size() * 16 - 64); // rangeShift
+
+	uint32_t offset = (uint32_t) (12 + 16 * tables.size());
+	for(const auto &table : tables) {
+		font.append(table.first);
+		appendUint32(font, 0); // checksum, which isn't verified
+		appendUint32(font, offset);
+		appendUint32(font, (uint32_t) table.second.size());
+		offset += (uint32_t) ((table.second.size() + 3) & ~3u);
+	}
+
+	for(const auto &table : tables) {
+		font.append(table.second);
+		font.append((4 - table.second.size() % 4) % 4, '\0');
+	}
+
+	return font;
+}
@@ -0,0 +1,76 @@
+#include <cstdlib> // free
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/font.h"
+}
+
+static const int squareSize = 4;
+static const int bitmapSize = 6;
+
+static FT_Bitmap createSquareBitmap(unsigned char *buffer);
+
+TEST(font, signedDistanceFieldAddsBorder)
+{
+	unsigned char buffer[bitmapSize * bitmapSize];
+	FT_Bitmap bitmap = createSquareBitmap(buffer);
+	int spread = 2;
+
+	FT_Bitmap field = shovelerFontCreateSignedDistanceField(bitmap, spread);
+	ASSERT_EQ(field.width, bitmapSize + 2 * spread);
+	ASSERT_EQ(field.rows, bitmapSize + 2 * spread);
+	ASSERT_EQ(field.pitch, bitmapSize + 2 * spread);
+	ASSERT_EQ(field.pixel_mode, FT_PIXEL_MODE_GRAY);
+
+	free(field.buffer);
+}
+
+TEST(font, signedDistanceFieldEncodesDistanceToOutline)
+{
+	unsigned char buffer[bitmapSize * bitmapSize];
+	FT_Bitmap bitmap = createSquareBitmap(buffer);
+	int spread = 2;
+
+	FT_Bitmap field = shovelerFontCreateSignedDistanceField(bitmap, spread);
+	int width = (int) field.width;
+	int center = width / 2;
+	int squareMin = spread + (bitmapSize - squareSize) / 2;
+	int squareMax = squareMin + squareSize - 1;
+
+	ASSERT_EQ(field.buffer[0], 0) << "pixels further than the spread outside the outline should be zero";
+
+	unsigned char insideEdge = field.buffer[center * width + squareMin];
+	unsigned char outsideEdge = field.buffer[center * width + squareMin - 1];
+	ASSERT_GT(field.buffer[center * width + center], insideEdge) << "values should grow further inside the outline";
+	ASSERT_GT(insideEdge, 127) << "pixels just inside the outline should be above half intensity";
+	ASSERT_LT(outsideEdge, 128) << "pixels just outside the outline should be below half intensity";
+	ASSERT_EQ(insideEdge + outsideEdge, 255) << "distances should be symmetric around the outline";
+
+	for(int i = 0; i < width; i++) {
+		ASSERT_EQ(field.buffer[center * width + i], field.buffer[i * width + center]) << "field should be symmetric like the square at " << i;
+	}
+	ASSERT_EQ(field.buffer[center * width + squareMin], field.buffer[center * width + squareMax]);
+
+	free(field.buffer);
+}
+
+static FT_Bitmap createSquareBitmap(unsigned char *buffer)
+{
+	int squareMin = (bitmapSize - squareSize) / 2;
+	for(int y = 0; y < bitmapSize; y++) {
+		for(int x = 0; x < bitmapSize; x++) {
+			bool inside = x >= squareMin && x < squareMin + squareSize && y >= squareMin && y < squareMin + squareSize;
+			buffer[y * bitmapSize + x] = inside ? 255 : 0;
+		}
+	}
+
+	FT_Bitmap bitmap = {};
+	bitmap.width = bitmapSize;
+	bitmap.rows = bitmapSize;
+	bitmap.pitch = bitmapSize;
+	bitmap.buffer = buffer;
+	bitmap.num_grays = 256;
+	bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+	return bitmap;
+}
@@ -84,3 +84,23 @@ bool shovelerFrustumIntersectFrustum(const ShovelerFrustum *frustum, const Shove
 
 	return true;
 }
+
+bool shovelerFrustumIntersectSphere(const ShovelerFrustum *frustum, ShovelerVector3 center, float radius)
+{
+	ShovelerPlane frustumPlanes[] = {
+		frustum->nearPlane,
+		frustum->farPlane,
+		frustum->leftPlane,
+		frustum->bottomPlane,
+		frustum->rightPlane,
+		frustum->topPlane,
+	};
+
+	for(int i = 0; i < 6; i++) {
+		if(shovelerPlaneVectorDistance(frustumPlanes[i], center) > radius + eps) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -118,3 +118,22 @@ TEST_F(ShovelerFrustumTest, intersectFrustumWithFrustumNegative)
 	ASSERT_FALSE(shovelerFrustumIntersectFrustum(&frustum, &otherFrustum));
 	ASSERT_FALSE(shovelerFrustumIntersectFrustum(&otherFrustum, &frustum));
 }
+
+TEST_F(ShovelerFrustumTest, intersectSphereInside)
+{
+	ASSERT_TRUE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 0.0f, 0.0f), 0.5f));
+}
+
+TEST_F(ShovelerFrustumTest, intersectSphereStraddlingPlane)
+{
+	ASSERT_TRUE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 0.0f, 5.5f), 1.0f));
+	ASSERT_TRUE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 0.0f, -4.5f), 1.0f));
+}
+
+TEST_F(ShovelerFrustumTest, intersectSphereOutside)
+{
+	ASSERT_FALSE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 0.0f, 7.0f), 1.0f));
+	ASSERT_FALSE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 0.0f, -6.0f), 0.5f));
+	ASSERT_FALSE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(20.0f, 0.0f, 0.0f), 1.0f));
+	ASSERT_FALSE(shovelerFrustumIntersectSphere(&frustum, shovelerVector3(0.0f, 20.0f, 0.0f), 1.0f));
+}
@@ -1,6 +1,8 @@
 #ifndef SHOVELER_CLIENT_SYSTEM_H
 #define SHOVELER_CLIENT_SYSTEM_H
 
+#include <glib.h>
+
 typedef struct ShovelerClientSystemStruct ShovelerClientSystem;
 typedef struct ShovelerCollidersStruct ShovelerColliders;
 typedef struct ShovelerComponentStruct ShovelerComponent;
@@ -13,11 +15,13 @@ typedef struct ShovelerFontsStruct ShovelerFonts;
 typedef struct ShovelerGameStruct ShovelerGame;
 typedef struct ShovelerInputStruct ShovelerInput;
 typedef struct ShovelerInputKeyCallbackStruct ShovelerInputKeyCallback;
+typedef struct ShovelerProfilerStruct ShovelerProfiler;
 typedef struct ShovelerRenderStateStruct ShovelerRenderState;
 typedef struct ShovelerSchemaStruct ShovelerSchema;
 typedef struct ShovelerSceneStruct ShovelerScene;
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache;
 typedef struct ShovelerSystemStruct ShovelerSystem;
+typedef struct ShovelerTextureUploaderStruct ShovelerTextureUploader;
 typedef struct ShovelerWorldStruct ShovelerWorld;
 
 typedef void(ShovelerClientSystemUpdateAuthoritativeComponentFunction)(
@@ -37,12 +41,16 @@ typedef struct ShovelerClientSystemStruct {
   ShovelerFonts* fonts;
   ShovelerController* controller;
   ShovelerShaderCache* shaderCache;
+  ShovelerTextureUploader* textureUploader;
   ShovelerScene* scene;
   ShovelerRenderState* renderState;
+  ShovelerProfiler* profiler;
   ShovelerClientSystemUpdateAuthoritativeComponentFunction* updateAuthoritativeComponent;
   void* updateAuthoritativeComponentUserData;
   ShovelerInputKeyCallback* keyCallback;
   ShovelerExecutorCallback* updateWorldCountersExecutorCallback;
+  /** set of (ShovelerTextTextureRenderer*) whose requested texts are rendered after each update */
+  GHashTable* textTextureRenderers;
   struct {
     unsigned int numEntities;
     unsigned int numComponents;
@@ -55,6 +63,11 @@ ShovelerClientSystem* shovelerClientSystemCreate(
     ShovelerGame* game,
     ShovelerClientSystemUpdateAuthoritativeComponentFunction* updateAuthoritativeComponent,
     void* updateAuthoritativeComponentUserData);
+/**
+ * Runs the per-frame work of the client systems, rendering all text textures requested since the
+ * last update in one batch per text texture renderer.
+ */
+void shovelerClientSystemUpdate(ShovelerClientSystem* clientSystem, double dt);
 void shovelerClientSystemFree(ShovelerClientSystem* clientSystem);
 
 #endif
@@ -5,15 +5,43 @@
 #include <shoveler/component.h>
 #include <shoveler/component_type.h>
 #include <shoveler/schema/opengl.h>
+#include <shoveler/text_texture_renderer.h>
+#include <shoveler/types.h>
 
 typedef struct ShovelerClientSystemStruct ShovelerClientSystem;
 typedef struct ShovelerTextureStruct ShovelerTexture;
 
 void shovelerClientSystemAddTextureSystem(ShovelerClientSystem* clientSystem);
 
+static inline bool shovelerComponentIsTextTexture(ShovelerComponent* component) {
+  return shovelerComponentGetFieldValueInt(component, SHOVELER_COMPONENT_TEXTURE_FIELD_ID_TYPE) ==
+      SHOVELER_COMPONENT_TEXTURE_TYPE_TEXT;
+}
+
+/** Returns the component's texture, which text textures share with other texts packed into the same atlas. */
 static inline ShovelerTexture* shovelerComponentGetTexture(ShovelerComponent* component) {
   assert(component->type->id == shovelerComponentTypeIdTexture);
+  if (shovelerComponentIsTextTexture(component)) {
+    ShovelerTextTexture* textTexture = component->systemData;
+    return textTexture->texture;
+  }
+
   return component->systemData;
 }
 
+/** Returns the region of the component's texture to sample from, in texture coordinates. */
+static inline void shovelerComponentGetTextureRegion(
+    ShovelerComponent* component, ShovelerVector2* outputPosition, ShovelerVector2* outputSize) {
+  assert(component->type->id == shovelerComponentTypeIdTexture);
+  if (shovelerComponentIsTextTexture(component)) {
+    ShovelerTextTexture* textTexture = component->systemData;
+    *outputPosition = shovelerTextTextureGetUvPosition(textTexture);
+    *outputSize = shovelerTextTextureGetUvSize(textTexture);
+    return;
+  }
+
+  *outputPosition = shovelerVector2(0.0f, 0.0f);
+  *outputSize = shovelerVector2(1.0f, 1.0f);
+}
+
 #endif
@@ -2,6 +2,7 @@
 #define SHOVELER_COMPONENT_TILEMAP_COLLIDERS_H
 
 #include <assert.h>
+#include <shoveler/bytes.h>
 #include <shoveler/component.h>
 #include <shoveler/component_type.h>
 #include <shoveler/schema/opengl.h>
@@ -10,9 +11,22 @@ typedef struct ShovelerClientSystemStruct ShovelerClientSystem;
 
 void shovelerClientSystemAddTilemapCollidersSystem(ShovelerClientSystem* clientSystem);
 
-static inline const bool* shovelerComponentGetTilemapColliders(ShovelerComponent* component) {
+/**
+ * Returns a read-only view of the colliders as one byte per tile that is nonzero for colliding
+ * tiles, borrowed from the shared bytes buffer of the component's colliders field.
+ *
+ * The view is replaced whenever the colliders field is updated, which is propagated to reverse
+ * dependencies so they can refresh any pointers they hold.
+ */
+static inline const unsigned char* shovelerComponentGetTilemapColliders(
+    ShovelerComponent* component) {
   assert(component->type->id == shovelerComponentTypeIdTilemapColliders);
-  return component->systemData;
+  ShovelerBytes* colliders = (ShovelerBytes*) component->systemData;
+  if (colliders == NULL) {
+    return NULL;
+  }
+
+  return shovelerBytesGetData(colliders);
 }
 
 #endif
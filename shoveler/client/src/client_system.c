@@ -35,6 +35,7 @@
 #include "shoveler/game.h"
 #include "shoveler/input.h"
 #include "shoveler/log.h"
+#include "shoveler/profiler.h"
 #include "shoveler/render_state.h"
 #include "shoveler/scene.h"
 #include "shoveler/schema.h"
@@ -42,6 +43,7 @@
 #include "shoveler/schema/opengl.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/system.h"
+#include "shoveler/text_texture_renderer.h"
 #include "shoveler/world.h"
 #include "shoveler/world_dependency_graph.h"
 
@@ -73,8 +75,10 @@ ShovelerClientSystem* shovelerClientSystemCreate(
   clientSystem->fonts = game->fonts;
   clientSystem->controller = game->controller;
   clientSystem->shaderCache = game->shaderCache;
+  clientSystem->textureUploader = game->textureUploader;
   clientSystem->scene = game->scene;
   clientSystem->renderState = &game->renderState;
+  clientSystem->profiler = game->profiler;
   clientSystem->updateAuthoritativeComponent = updateAuthoritativeComponent;
   clientSystem->updateAuthoritativeComponentUserData = updateAuthoritativeComponentUserData;
   clientSystem->keyCallback =
@@ -85,6 +89,7 @@ ShovelerClientSystem* shovelerClientSystemCreate(
       /* intervalMs */ 1000,
       clientSystemUpdateWorldCounters,
       clientSystem);
+  clientSystem->textTextureRenderers = g_hash_table_new(g_direct_hash, g_direct_equal);
   clientSystem->lastWorldCounters.numEntities = 0;
   clientSystem->lastWorldCounters.numComponents = 0;
   clientSystem->lastWorldCounters.numComponentDependencies = 0;
@@ -121,12 +126,24 @@ ShovelerClientSystem* shovelerClientSystemCreate(
   return clientSystem;
 }
 
+void shovelerClientSystemUpdate(ShovelerClientSystem* clientSystem, double dt) {
+  shovelerProfilerBeginScope(clientSystem->profiler, "text textures");
+  GHashTableIter iter;
+  ShovelerTextTextureRenderer* textTextureRenderer;
+  g_hash_table_iter_init(&iter, clientSystem->textTextureRenderers);
+  while (g_hash_table_iter_next(&iter, (gpointer*) &textTextureRenderer, NULL)) {
+    shovelerTextTextureRendererFlush(textTextureRenderer, clientSystem->renderState);
+  }
+  shovelerProfilerEndScope(clientSystem->profiler);
+}
+
 void shovelerClientSystemFree(ShovelerClientSystem* clientSystem) {
   shovelerExecutorRemoveCallback(
       clientSystem->executor, clientSystem->updateWorldCountersExecutorCallback);
   shovelerInputRemoveKeyCallback(clientSystem->input, clientSystem->keyCallback);
   shovelerWorldFree(clientSystem->world);
   shovelerSchemaFree(clientSystem->schema);
+  g_hash_table_destroy(clientSystem->textTextureRenderers);
   shovelerSystemFree(clientSystem->system);
   free(clientSystem);
 }
@@ -1,19 +1,31 @@
 #include "shoveler/component/drawable.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include "shoveler/client_system.h"
+#include "shoveler/component/tilemap_tiles.h"
 #include "shoveler/component_system.h"
 #include "shoveler/drawable/cube.h"
 #include "shoveler/drawable/point.h"
 #include "shoveler/drawable/quad.h"
 #include "shoveler/drawable/tiles.h"
+#include "shoveler/image.h"
 #include "shoveler/log.h"
 #include "shoveler/schema.h"
 #include "shoveler/system.h"
+#include "shoveler/texture.h"
 
 static void* activateDrawableComponent(ShovelerComponent* component, void* clientSystemPointer);
 static void deactivateDrawableComponent(ShovelerComponent* component, void* clientSystemPointer);
+static bool liveUpdateTilesDependency(
+    ShovelerComponent* component,
+    int fieldId,
+    const ShovelerComponentField* field,
+    ShovelerComponent* dependencyComponent,
+    void* clientSystemPointer);
+static bool updateTiles(
+    ShovelerComponent* component, ShovelerDrawable* tilesDrawable, bool onlyChanged);
 
 void shovelerClientSystemAddDrawableSystem(ShovelerClientSystem* clientSystem) {
   ShovelerComponentType* componentType =
@@ -24,6 +36,8 @@ void shovelerClientSystemAddDrawableSystem(ShovelerClientSystem* clientSystem) {
       shovelerSystemForComponentType(clientSystem->system, componentType);
   componentSystem->activateComponent = activateDrawableComponent;
   componentSystem->deactivateComponent = deactivateDrawableComponent;
+  componentSystem->fieldOptions[SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES]
+      .liveUpdateDependencyField = liveUpdateTilesDependency;
   componentSystem->callbackUserData = clientSystem;
 }
 
@@ -42,7 +56,13 @@ static void* activateDrawableComponent(ShovelerComponent* component, void* clien
         component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_WIDTH);
     int tilesHeight = shovelerComponentGetFieldValueInt(
         component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_HEIGHT);
-    return shovelerDrawableTilesCreate(tilesWidth, tilesHeight);
+    ShovelerDrawable* tilesDrawable = shovelerDrawableTilesCreate(tilesWidth, tilesHeight);
+    if (!updateTiles(component, tilesDrawable, /* onlyChanged */ false)) {
+      shovelerDrawableFree(tilesDrawable);
+      return NULL;
+    }
+
+    return tilesDrawable;
   }
   default:
     shovelerLogWarning("Failed to activate drawable with unknown type %d.", type);
@@ -53,3 +73,85 @@ static void* activateDrawableComponent(ShovelerComponent* component, void* clien
 static void deactivateDrawableComponent(ShovelerComponent* component, void* clientSystemPointer) {
   shovelerDrawableFree(component->systemData);
 }
+
+static bool liveUpdateTilesDependency(
+    ShovelerComponent* component,
+    int fieldId,
+    const ShovelerComponentField* field,
+    ShovelerComponent* dependencyComponent,
+    void* clientSystemPointer) {
+  ShovelerDrawable* tilesDrawable = component->systemData;
+  assert(tilesDrawable != NULL);
+
+  updateTiles(component, tilesDrawable, /* onlyChanged */ true);
+
+  return false; // don't propagate
+}
+
+static bool updateTiles(
+    ShovelerComponent* component, ShovelerDrawable* tilesDrawable, bool onlyChanged) {
+  if (!shovelerComponentHasFieldValue(component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES)) {
+    return true;
+  }
+
+  ShovelerComponent* tilesComponent =
+      shovelerComponentGetDependency(component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES);
+  assert(tilesComponent != NULL);
+  ShovelerTexture* tiles = shovelerComponentGetTilemapTiles(tilesComponent);
+  assert(tiles != NULL);
+
+  ShovelerImage* tilesImage = tiles->image;
+  int tilesWidth =
+      shovelerComponentGetFieldValueInt(component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_WIDTH);
+  int tilesHeight = shovelerComponentGetFieldValueInt(
+      component, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_HEIGHT);
+  if (tilesImage->width != tilesWidth || tilesImage->height != tilesHeight ||
+      tilesImage->channels < 3) {
+    shovelerLogWarning(
+        "Failed to update tiles drawable of entity %lld because dependency tiles don't match the "
+        "drawable's tiles width and height or lack tile channels.",
+        component->entityId);
+    return false;
+  }
+
+  // the tiles image stores a tile's tileset column, row and id in its first three channels
+  if (onlyChanged) {
+    // live updates usually change few tiles, so only upload the ones differing from the drawable's
+    bool success = true;
+    for (int row = 0; row < tilesHeight; row++) {
+      for (int column = 0; column < tilesWidth; column++) {
+        ShovelerDrawableTilesTile tile;
+        tile.tilesetColumn = shovelerImageGet(tilesImage, column, row, 0);
+        tile.tilesetRow = shovelerImageGet(tilesImage, column, row, 1);
+        tile.tilesetId = shovelerImageGet(tilesImage, column, row, 2);
+
+        ShovelerDrawableTilesTile currentTile =
+            shovelerDrawableTilesGetTile(tilesDrawable, /* chunk */ 0, column, row);
+        if (tile.tilesetColumn != currentTile.tilesetColumn ||
+            tile.tilesetRow != currentTile.tilesetRow || tile.tilesetId != currentTile.tilesetId) {
+          if (!shovelerDrawableTilesSetTile(tilesDrawable, /* chunk */ 0, column, row, tile)) {
+            success = false;
+          }
+        }
+      }
+    }
+
+    return success;
+  }
+
+  ShovelerDrawableTilesTile* chunkTiles =
+      malloc(tilesWidth * tilesHeight * sizeof(ShovelerDrawableTilesTile));
+  for (int row = 0; row < tilesHeight; row++) {
+    for (int column = 0; column < tilesWidth; column++) {
+      ShovelerDrawableTilesTile* tile = &chunkTiles[row * tilesWidth + column];
+      tile->tilesetColumn = shovelerImageGet(tilesImage, column, row, 0);
+      tile->tilesetRow = shovelerImageGet(tilesImage, column, row, 1);
+      tile->tilesetId = shovelerImageGet(tilesImage, column, row, 2);
+    }
+  }
+
+  bool success = shovelerDrawableTilesSetChunkTiles(tilesDrawable, /* chunk */ 0, chunkTiles);
+  free(chunkTiles);
+
+  return success;
+}
@@ -36,7 +36,15 @@ static void* activateFontAtlasComponent(ShovelerComponent* component, void* clie
   int padding = shovelerComponentGetFieldValueInt(
       component, SHOVELER_COMPONENT_FONT_ATLAS_FIELD_ID_PADDING);
 
-  return shovelerFontAtlasCreate(font, fontSize, padding);
+  ShovelerFontAtlas* fontAtlas = shovelerFontAtlasCreate(font, fontSize, padding);
+  if (fontAtlas == NULL) {
+    return NULL;
+  }
+
+  // rasterize the common characters right away instead of when they first show up in a text
+  shovelerFontAtlasPrewarm(fontAtlas, SHOVELER_FONT_ATLAS_PRINTABLE_ASCII);
+
+  return fontAtlas;
 }
 
 static void deactivateFontAtlasComponent(ShovelerComponent* component, void* clientSystemPointer) {
@@ -81,6 +81,8 @@ static void* activateLightComponent(ShovelerComponent* component, void* clientSy
     return NULL;
   }
 
+  // lights only skip checking their cached shadow maps once they actually move
+  light->dynamic = false;
   shovelerSceneAddLight(clientSystem->scene, light);
   return light;
 }
@@ -106,6 +108,7 @@ static bool liveUpdateLightPositionDependency(
   assert(positionComponent != NULL);
   const ShovelerVector3* position = shovelerComponentGetPosition(positionComponent);
 
+  light->dynamic = true;
   shovelerLightUpdatePosition(light, *position);
 
   return false; // don't propagate
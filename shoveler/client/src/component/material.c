@@ -8,6 +8,7 @@
 #include "shoveler/component/sampler.h"
 #include "shoveler/component/texture.h"
 #include "shoveler/component/tilemap.h"
+#include "shoveler/component/tileset.h"
 #include "shoveler/component_system.h"
 #include "shoveler/log.h"
 #include "shoveler/material.h"
@@ -19,6 +20,7 @@
 #include "shoveler/material/texture_sprite.h"
 #include "shoveler/material/tile_sprite.h"
 #include "shoveler/material/tilemap.h"
+#include "shoveler/material/tiles.h"
 #include "shoveler/schema.h"
 #include "shoveler/system.h"
 
@@ -104,6 +106,11 @@ static void* activateMaterialComponent(ShovelerComponent* component, void* clien
         sampler,
         false);
 
+    ShovelerVector2 textureRegionPosition;
+    ShovelerVector2 textureRegionSize;
+    shovelerComponentGetTextureRegion(textureComponent, &textureRegionPosition, &textureRegionSize);
+    shovelerMaterialTextureSetTextureRegion(material, textureRegionPosition, textureRegionSize);
+
     if (textureType == SHOVELER_MATERIAL_TEXTURE_TYPE_ALPHA_MASK) {
       ShovelerVector4 color = shovelerComponentGetFieldValueVector4(
           component, SHOVELER_COMPONENT_MATERIAL_FIELD_ID_COLOR);
@@ -194,6 +201,20 @@ static void* activateMaterialComponent(ShovelerComponent* component, void* clien
   case SHOVELER_COMPONENT_MATERIAL_TYPE_TEXT: {
     material = shovelerMaterialTextCreate(clientSystem->shaderCache, /* screenspace */ false);
   } break;
+  case SHOVELER_COMPONENT_MATERIAL_TYPE_TILES: {
+    if (!validateOptionalField(component, SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TILESET, "tiles")) {
+      return NULL;
+    }
+
+    ShovelerComponent* tilesetComponent =
+        shovelerComponentGetDependency(component, SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TILESET);
+    assert(tilesetComponent != NULL);
+    ShovelerTileset* tileset = shovelerComponentGetTileset(tilesetComponent);
+    assert(tileset != NULL);
+
+    material = shovelerMaterialTilesCreate(clientSystem->shaderCache, /* screenspace */ false);
+    shovelerMaterialTilesSetActiveTileset(material, tileset);
+  } break;
   default:
     shovelerLogWarning(
         "Trying to activate material with unknown material type %d, ignoring.", type);
@@ -71,6 +71,8 @@ static void* activateModelComponent(ShovelerComponent* component, void* clientSy
       component, SHOVELER_COMPONENT_MODEL_FIELD_ID_CASTS_SHADOW);
   model->polygonMode = convertPolygonMode(shovelerComponentGetFieldValueInt(
       component, SHOVELER_COMPONENT_MODEL_FIELD_ID_POLYGON_MODE));
+  // any other field change reactivates the component, which also invalidates cached shadow maps
+  model->dynamic = false;
   shovelerModelUpdateTransformation(model);
 
   shovelerSceneAddModel(clientSystem->scene, model);
@@ -99,6 +101,8 @@ static bool liveUpdateModelPositionDependency(
   assert(positionComponent != NULL);
   const ShovelerVector3* position = shovelerComponentGetPosition(positionComponent);
 
+  // models only start being tracked individually by cached shadow maps once they actually move
+  model->dynamic = true;
   model->translation = *position;
   shovelerModelUpdateTransformation(model);
 
@@ -1,6 +1,7 @@
 #include "shoveler/component/text_texture_renderer.h"
 
 #include <assert.h>
+#include <glib.h>
 
 #include "shoveler/client_system.h"
 #include "shoveler/component/font_atlas_texture.h"
@@ -37,12 +38,18 @@ static void* activateTextTextureRendererComponent(
       shovelerComponentGetFontAtlasTexture(fontAtlasTextureComponent);
   assert(fontAtlasTexture != NULL);
 
-  return shovelerTextTextureRendererCreate(fontAtlasTexture, clientSystem->shaderCache);
+  ShovelerTextTextureRenderer* textTextureRenderer =
+      shovelerTextTextureRendererCreate(fontAtlasTexture, clientSystem->shaderCache);
+  g_hash_table_add(clientSystem->textTextureRenderers, textTextureRenderer);
+
+  return textTextureRenderer;
 }
 
 static void deactivateTextTextureRendererComponent(
     ShovelerComponent* component, void* clientSystemPointer) {
+  ShovelerClientSystem* clientSystem = clientSystemPointer;
   ShovelerTextTextureRenderer* textTextureRenderer = component->systemData;
 
+  g_hash_table_remove(clientSystem->textTextureRenderers, textTextureRenderer);
   shovelerTextTextureRendererFree(textTextureRenderer);
 }
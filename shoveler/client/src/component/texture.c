@@ -11,6 +11,7 @@
 #include "shoveler/system.h"
 #include "shoveler/text_texture_renderer.h"
 #include "shoveler/texture.h"
+#include "shoveler/texture_uploader.h"
 
 static void* activateTextureComponent(ShovelerComponent* component, void* clientSystemPointer);
 static void deactivateTextureComponent(ShovelerComponent* component, void* clientSystemPointer);
@@ -50,8 +51,9 @@ static void* activateTextureComponent(ShovelerComponent* component, void* client
     ShovelerImage* image = shovelerComponentGetImage(imageComponent);
     assert(image != NULL);
 
+    // stream the image in over the next frames instead of stalling this one on a large upload
     texture = shovelerTextureCreate2d(image, false);
-    shovelerTextureUpdate(texture);
+    shovelerTextureUploaderEnqueue(clientSystem->textureUploader, texture);
   } break;
   case SHOVELER_COMPONENT_TEXTURE_TYPE_TEXT: {
     if (!shovelerComponentHasFieldValue(
@@ -82,8 +84,9 @@ static void* activateTextureComponent(ShovelerComponent* component, void* client
         component, SHOVELER_COMPONENT_TEXTURE_FIELD_ID_TEXT);
     assert(text != NULL);
 
-    texture = shovelerTextTextureRendererRender(textTextureRenderer, text, clientSystem->renderState);
-  } break;
+    // rendered together with all other texts requested this frame at the end of the client system update
+    return shovelerTextTextureRendererRequest(textTextureRenderer, text);
+  }
   default:
     shovelerLogWarning(
         "Failed to activate texture component of entity %lld: Unknown texture type %d",
@@ -96,7 +99,17 @@ static void* activateTextureComponent(ShovelerComponent* component, void* client
 }
 
 static void deactivateTextureComponent(ShovelerComponent* component, void* clientSystemPointer) {
-  ShovelerTexture* texture = (ShovelerTexture*) component->systemData;
+  if (shovelerComponentIsTextTexture(component)) {
+    // text textures are owned and cached by the renderer they were requested from
+    ShovelerComponent* textTextureRendererComponent = shovelerComponentGetDependency(
+        component, SHOVELER_COMPONENT_TEXTURE_FIELD_ID_TEXT_TEXTURE_RENDERER);
+    assert(textTextureRendererComponent != NULL);
+    ShovelerTextTextureRenderer* textTextureRenderer =
+        shovelerComponentGetTextTextureRenderer(textTextureRendererComponent);
+    shovelerTextTextureRendererRelease(
+        textTextureRenderer, (ShovelerTextTexture*) component->systemData);
+    return;
+  }
 
-  shovelerTextureFree(texture);
+  shovelerTextureFree((ShovelerTexture*) component->systemData);
 }
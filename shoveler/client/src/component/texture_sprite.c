@@ -49,14 +49,21 @@ static void* activateTextureSpriteComponent(ShovelerComponent* component, void*
   ShovelerSampler* sampler = shovelerComponentGetSampler(samplerComponent);
   assert(sampler != NULL);
 
+  ShovelerVector2 textureRegionPosition;
+  ShovelerVector2 textureRegionSize;
+  shovelerComponentGetTextureRegion(textureComponent, &textureRegionPosition, &textureRegionSize);
+
   ShovelerSprite* textureSprite = shovelerSpriteTextureCreate(material, texture, sampler);
+  shovelerSpriteTextureSetTextureRegion(textureSprite, textureRegionPosition, textureRegionSize);
 
   ShovelerVector2 scale = shovelerComponentGetFieldValueVector2(
       component, SHOVELER_COMPONENT_TEXTURE_SPRITE_FIELD_ID_SCALE);
 
   shovelerSpriteUpdateSize(
       textureSprite,
-      shovelerVector2(scale.values[0] * texture->width, scale.values[1] * texture->height));
+      shovelerVector2(
+          scale.values[0] * textureRegionSize.values[0] * texture->width,
+          scale.values[1] * textureRegionSize.values[1] * texture->height));
 
   return textureSprite;
 }
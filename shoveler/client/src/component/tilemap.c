@@ -15,6 +15,12 @@
 
 static void* activateTilemapComponent(ShovelerComponent* component, void* clientSystemPointer);
 static void deactivateTilemapComponent(ShovelerComponent* component, void* clientSystemPointer);
+static bool liveUpdateTilemapCollidersDependency(
+    ShovelerComponent* component,
+    int fieldId,
+    const ShovelerComponentField* field,
+    ShovelerComponent* dependencyComponent,
+    void* clientSystemPointer);
 
 void shovelerClientSystemAddTilemapSystem(ShovelerClientSystem* clientSystem) {
   ShovelerComponentType* componentType =
@@ -25,6 +31,11 @@ void shovelerClientSystemAddTilemapSystem(ShovelerClientSystem* clientSystem) {
       shovelerSystemForComponentType(clientSystem->system, componentType);
   componentSystem->activateComponent = activateTilemapComponent;
   componentSystem->deactivateComponent = deactivateTilemapComponent;
+  componentSystem->fieldOptions[SHOVELER_COMPONENT_TILEMAP_FIELD_ID_COLLIDERS]
+      .liveUpdateDependencyField = liveUpdateTilemapCollidersDependency;
+  // the tilemap samples the tiles texture that live updates already rewrote in place
+  componentSystem->fieldOptions[SHOVELER_COMPONENT_TILEMAP_FIELD_ID_TILES]
+      .liveUpdateDependencyField = shovelerComponentSystemLiveUpdateDependencyFieldNoop;
   componentSystem->callbackUserData = clientSystem;
 }
 
@@ -40,7 +51,7 @@ static void* activateTilemapComponent(ShovelerComponent* component, void* client
   ShovelerComponent* collidersComponent =
       shovelerComponentGetDependency(component, SHOVELER_COMPONENT_TILEMAP_FIELD_ID_COLLIDERS);
   assert(collidersComponent != NULL);
-  const bool* colliders = shovelerComponentGetTilemapColliders(collidersComponent);
+  const unsigned char* colliders = shovelerComponentGetTilemapColliders(collidersComponent);
   assert(colliders != NULL);
   int numCollidersColumns = shovelerComponentGetFieldValueInt(
       collidersComponent, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_NUM_COLUMNS);
@@ -78,3 +89,20 @@ static void deactivateTilemapComponent(ShovelerComponent* component, void* clien
 
   shovelerTilemapFree(tilemap);
 }
+
+static bool liveUpdateTilemapCollidersDependency(
+    ShovelerComponent* component,
+    int fieldId,
+    const ShovelerComponentField* field,
+    ShovelerComponent* dependencyComponent,
+    void* clientSystemPointer) {
+  ShovelerTilemap* tilemap = (ShovelerTilemap*) component->systemData;
+  assert(tilemap != NULL);
+
+  // the colliders component hands out a view into its shared buffer, which changes on update
+  const unsigned char* colliders = shovelerComponentGetTilemapColliders(dependencyComponent);
+  assert(colliders != NULL);
+  tilemap->collidingTiles = colliders;
+
+  return false; // don't propagate
+}
@@ -1,10 +1,11 @@
 #include "shoveler/component/tilemap_colliders.h"
 
 #include <assert.h>
-#include <stdlib.h>
 
+#include "shoveler/bytes.h"
 #include "shoveler/client_system.h"
 #include "shoveler/component_system.h"
+#include "shoveler/log.h"
 #include "shoveler/schema.h"
 #include "shoveler/system.h"
 
@@ -18,7 +19,7 @@ static bool liveUpdateCollidersOption(
     const ShovelerComponentField* field,
     ShovelerComponentFieldValue* fieldValue,
     void* clientSystemPointer);
-static void updateColliders(ShovelerComponent* component, bool* colliders);
+static ShovelerBytes* getColliders(ShovelerComponent* component);
 
 void shovelerClientSystemAddTilemapCollidersSystem(ShovelerClientSystem* clientSystem) {
   ShovelerComponentType* componentType =
@@ -36,22 +37,24 @@ void shovelerClientSystemAddTilemapCollidersSystem(ShovelerClientSystem* clientS
 
 static void* activateTilemapCollidersComponent(
     ShovelerComponent* component, void* clientSystemPointer) {
-  int numColumns = shovelerComponentGetFieldValueInt(
-      component, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_NUM_COLUMNS);
-  int numRows = shovelerComponentGetFieldValueInt(
-      component, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_NUM_ROWS);
-
-  bool* colliders = malloc(numColumns * numRows * sizeof(bool));
-  updateColliders(component, colliders);
+  ShovelerBytes* colliders = getColliders(component);
+  if (colliders == NULL) {
+    shovelerLogWarning(
+        "Failed to activate tilemap colliders of entity %lld because the colliders option doesn't "
+        "match the configured dimensions.",
+        component->entityId);
+    return NULL;
+  }
 
-  return colliders;
+  // share the field's buffer instead of copying it
+  return shovelerBytesRef(colliders);
 }
 
 static void deactivateTilemapCollidersComponent(
     ShovelerComponent* component, void* clientSystemPointer) {
-  bool* colliders = (bool*) component->systemData;
+  ShovelerBytes* colliders = (ShovelerBytes*) component->systemData;
 
-  free(colliders);
+  shovelerBytesUnref(colliders);
 }
 
 static bool liveUpdateCollidersOption(
@@ -60,34 +63,39 @@ static bool liveUpdateCollidersOption(
     const ShovelerComponentField* field,
     ShovelerComponentFieldValue* fieldValue,
     void* clientSystemPointer) {
-  bool* colliders = (bool*) component->systemData;
+  ShovelerBytes* colliders = (ShovelerBytes*) component->systemData;
   assert(colliders != NULL);
 
-  updateColliders(component, colliders);
+  ShovelerBytes* updatedColliders = getColliders(component);
+  if (updatedColliders == NULL) {
+    shovelerLogWarning(
+        "Ignoring colliders update of entity %lld because it doesn't match the configured "
+        "dimensions.",
+        component->entityId);
+    return false;
+  }
+
+  component->systemData = shovelerBytesRef(updatedColliders);
+  shovelerBytesUnref(colliders);
 
-  return false; // don't propagate
+  return true; // propagate so dependents pick up the new view
 }
 
-static void updateColliders(ShovelerComponent* component, bool* colliders) {
+static ShovelerBytes* getColliders(ShovelerComponent* component) {
   int numColumns = shovelerComponentGetFieldValueInt(
       component, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_NUM_COLUMNS);
   int numRows = shovelerComponentGetFieldValueInt(
       component, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_NUM_ROWS);
 
-  const unsigned char* collidersOption;
-  shovelerComponentGetFieldValueBytes(
-      component,
-      SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_COLLIDERS,
-      &collidersOption,
-      /* outputSize */ NULL);
-  assert(collidersOption != NULL);
-
-  for (int row = 0; row < numRows; ++row) {
-    int rowIndex = row * numColumns;
-    for (int column = 0; column < numColumns; ++column) {
-      int columnIndex = rowIndex + column;
-
-      colliders[columnIndex] = collidersOption[columnIndex];
-    }
+  ShovelerBytes* colliders = shovelerComponentGetFieldValueSharedBytes(
+      component, SHOVELER_COMPONENT_TILEMAP_COLLIDERS_OPTION_COLLIDERS);
+  if (colliders == NULL || numColumns <= 0 || numRows <= 0) {
+    return NULL;
+  }
+
+  if (shovelerBytesGetSize(colliders) < (size_t) numColumns * (size_t) numRows) {
+    return NULL;
   }
+
+  return colliders;
 }
@@ -21,6 +21,9 @@ static bool liveUpdateTilesField(
     ShovelerComponentFieldValue* fieldValue,
     void* userData);
 static void updateTiles(ShovelerComponent* component, ShovelerTexture* texture);
+static void updateTilesChannel(
+    ShovelerComponent* component, ShovelerTexture* texture, int fieldId, int channel);
+static int getTilesChannel(int fieldId);
 static bool isComponentImageResourceEntityDefinition(ShovelerComponent* component);
 static bool isComponentConfigurationOptionDefinition(ShovelerComponent* component);
 
@@ -55,7 +58,8 @@ static void* activateTilemapTilesComponent(
     ShovelerImage* image = shovelerComponentGetImage(imageComponent);
     assert(image != NULL);
 
-    texture = shovelerTextureCreate2d(image, false);
+    // tile indices are sampled with nearest filtering, so they never need mipmaps
+    texture = shovelerTextureCreate2dWithoutMipmaps(image, false);
     shovelerTextureUpdate(texture);
   } else if (!isImageResourceEntityDefinition && isConfigurationOptionDefinition) {
     int numColumns = shovelerComponentGetFieldValueInt(
@@ -64,7 +68,7 @@ static void* activateTilemapTilesComponent(
         component, SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_NUM_ROWS);
 
     ShovelerImage* tilemapImage = shovelerImageCreate(numColumns, numRows, /* channels */ 3);
-    texture = shovelerTextureCreate2d(tilemapImage, true);
+    texture = shovelerTextureCreate2dWithoutMipmaps(tilemapImage, true);
     updateTiles(component, texture);
   } else {
     shovelerLogWarning(
@@ -95,51 +99,75 @@ static bool liveUpdateTilesField(
 
   if (!isComponentImageResourceEntityDefinition(component) &&
       isComponentConfigurationOptionDefinition(component)) {
-    updateTiles(component, texture);
+    // each tiles field maps to its own channel, so only that channel needs to be rewritten, and
+    // only the tiles that actually changed uploaded again
+    updateTilesChannel(component, texture, fieldId, getTilesChannel(fieldId));
+    shovelerTextureUpdateDirty(texture);
   }
 
-  return false; // don't propagate
+  // tiles drawables copy the tiles out of the texture image, so they need to hear about the change
+  return true;
 }
 
 static void updateTiles(ShovelerComponent* component, ShovelerTexture* texture) {
-  const unsigned char* tilesetColumns;
-  const unsigned char* tilesetRows;
-  const unsigned char* tilesetIds;
-  shovelerComponentGetFieldValueBytes(
+  updateTilesChannel(
       component,
+      texture,
       SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_COLUMNS,
-      &tilesetColumns,
-      /* outputSize */ NULL);
-  shovelerComponentGetFieldValueBytes(
+      getTilesChannel(SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_COLUMNS));
+  updateTilesChannel(
       component,
+      texture,
       SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_ROWS,
-      &tilesetRows,
-      /* outputSize */ NULL);
-  shovelerComponentGetFieldValueBytes(
+      getTilesChannel(SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_ROWS));
+  updateTilesChannel(
       component,
+      texture,
       SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_IDS,
-      &tilesetIds,
-      /* outputSize */ NULL);
-  assert(tilesetColumns != NULL);
-  assert(tilesetRows != NULL);
-  assert(tilesetIds != NULL);
+      getTilesChannel(SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_IDS));
+
+  shovelerTextureUpdate(texture);
+}
+
+static void updateTilesChannel(
+    ShovelerComponent* component, ShovelerTexture* texture, int fieldId, int channel) {
+  // borrow the field's shared buffer instead of copying it out first
+  const unsigned char* tilesChannel;
+  int tilesChannelSize;
+  shovelerComponentGetFieldValueBytes(component, fieldId, &tilesChannel, &tilesChannelSize);
+  assert(tilesChannel != NULL);
 
   ShovelerImage* tilemapImage = texture->image;
   int numColumns = tilemapImage->width;
   int numRows = tilemapImage->height;
+  assert(tilesChannelSize >= numColumns * numRows);
 
   for (int row = 0; row < numRows; ++row) {
     int rowIndex = row * numColumns;
     for (int column = 0; column < numColumns; ++column) {
       int columnIndex = rowIndex + column;
 
-      shovelerImageGet(tilemapImage, column, row, 0) = tilesetColumns[columnIndex];
-      shovelerImageGet(tilemapImage, column, row, 1) = tilesetRows[columnIndex];
-      shovelerImageGet(tilemapImage, column, row, 2) = tilesetIds[columnIndex];
+      unsigned char* tile = &shovelerImageGet(tilemapImage, column, row, channel);
+      if (*tile != tilesChannel[columnIndex]) {
+        *tile = tilesChannel[columnIndex];
+        shovelerTextureMarkDirty(texture, column, row, /* width */ 1, /* height */ 1);
+      }
     }
   }
+}
 
-  shovelerTextureUpdate(texture);
+static int getTilesChannel(int fieldId) {
+  switch (fieldId) {
+  case SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_COLUMNS:
+    return 0;
+  case SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_ROWS:
+    return 1;
+  case SHOVELER_COMPONENT_TILEMAP_TILES_OPTION_TILESET_IDS:
+    return 2;
+  default:
+    assert(false);
+    return 0;
+  }
 }
 
 static bool isComponentImageResourceEntityDefinition(ShovelerComponent* component) {
@@ -25,6 +25,8 @@ void shovelerClientSystemAddTilesetSystem(ShovelerClientSystem* clientSystem) {
 }
 
 static void* activateTilesetComponent(ShovelerComponent* component, void* clientSystemPointer) {
+  ShovelerClientSystem* clientSystem = clientSystemPointer;
+
   ShovelerComponent* imageComponent =
       shovelerComponentGetDependency(component, SHOVELER_COMPONENT_TILESET_FIELD_ID_IMAGE);
   assert(imageComponent != NULL);
@@ -37,7 +39,8 @@ static void* activateTilesetComponent(ShovelerComponent* component, void* client
       component, SHOVELER_COMPONENT_TILESET_FIELD_ID_NUM_ROWS);
   int padding = shovelerComponentGetFieldValueInt(
       component, SHOVELER_COMPONENT_TILESET_FIELD_ID_PADDING);
-  ShovelerTileset* tileset = shovelerTilesetCreate(image, numColumns, numRows, padding);
+  ShovelerTileset* tileset = shovelerTilesetCreateStreamed(
+      image, numColumns, numRows, padding, clientSystem->textureUploader);
 
   return tileset;
 }
@@ -3,6 +3,7 @@
 
 #include <assert.h> // assert
 #include <glib.h>
+#include <shoveler/bytes.h>
 #include <shoveler/component_field.h>
 #include <shoveler/types.h>
 #include <stdbool.h> // bool
@@ -292,6 +293,23 @@ static inline bool shovelerComponentUpdateFieldBytes(
   value.isSet = true;
   value.bytesValue.data = (unsigned char*) data; // won't be modified
   value.bytesValue.size = size;
+  value.bytesValue.bytes = NULL;
+  return shovelerComponentUpdateField(component, id, &value, /* isCanonical */ false);
+}
+
+/**
+ * Updates a bytes field to share the passed buffer instead of copying its contents.
+ *
+ * The component takes its own reference, so the caller retains ownership of the passed reference.
+ */
+static inline bool shovelerComponentUpdateFieldSharedBytes(
+    ShovelerComponent* component, int id, ShovelerBytes* bytes) {
+  ShovelerComponentFieldValue value;
+  value.type = SHOVELER_COMPONENT_FIELD_TYPE_BYTES;
+  value.isSet = true;
+  value.bytesValue.data = (unsigned char*) shovelerBytesGetData(bytes); // won't be modified
+  value.bytesValue.size = (int) shovelerBytesGetSize(bytes);
+  value.bytesValue.bytes = bytes;
   return shovelerComponentUpdateField(component, id, &value, /* isCanonical */ false);
 }
 
@@ -384,6 +402,23 @@ static inline bool shovelerComponentUpdateCanonicalFieldBytes(
   value.isSet = true;
   value.bytesValue.data = (unsigned char*) data; // won't be modified
   value.bytesValue.size = size;
+  value.bytesValue.bytes = NULL;
+  return shovelerComponentUpdateField(component, id, &value, /* isCanonical */ true);
+}
+
+/**
+ * Updates a bytes field to share the passed buffer instead of copying its contents.
+ *
+ * The component takes its own reference, so the caller retains ownership of the passed reference.
+ */
+static inline bool shovelerComponentUpdateCanonicalFieldSharedBytes(
+    ShovelerComponent* component, int id, ShovelerBytes* bytes) {
+  ShovelerComponentFieldValue value;
+  value.type = SHOVELER_COMPONENT_FIELD_TYPE_BYTES;
+  value.isSet = true;
+  value.bytesValue.data = (unsigned char*) shovelerBytesGetData(bytes); // won't be modified
+  value.bytesValue.size = (int) shovelerBytesGetSize(bytes);
+  value.bytesValue.bytes = bytes;
   return shovelerComponentUpdateField(component, id, &value, /* isCanonical */ true);
 }
 
@@ -490,4 +525,19 @@ static inline void shovelerComponentGetFieldValueBytes(
   }
 }
 
+/**
+ * Returns the shared buffer backing a bytes field, or NULL if the field is empty.
+ *
+ * The returned buffer is borrowed from the component and only valid until the field is next
+ * updated. Callers that want to hold on to it beyond that must take their own reference.
+ */
+static inline ShovelerBytes* shovelerComponentGetFieldValueSharedBytes(
+    ShovelerComponent* component, int id) {
+  const ShovelerComponentFieldValue* fieldValue = shovelerComponentGetFieldValue(component, id);
+  assert(fieldValue->isSet);
+  assert(fieldValue->type == SHOVELER_COMPONENT_FIELD_TYPE_BYTES);
+
+  return fieldValue->bytesValue.bytes;
+}
+
 #endif
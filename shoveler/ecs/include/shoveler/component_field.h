@@ -2,6 +2,7 @@
 #define SHOVELER_COMPONENT_FIELD_H
 
 #include <glib.h>
+#include <shoveler/bytes.h>
 #include <shoveler/types.h>
 #include <stdbool.h> // bool
 
@@ -37,8 +38,12 @@ typedef struct ShovelerComponentFieldValueStruct {
     ShovelerVector3 vector3Value;
     ShovelerVector4 vector4Value;
     struct {
+      // read-only view of the value's contents
       unsigned char* data;
       int size;
+      // Shared buffer backing data, or NULL if data is borrowed from the caller. Values stored
+      // on a component hold a reference to it, transient values passed in borrow the caller's.
+      ShovelerBytes* bytes;
     } bytesValue;
   };
 } ShovelerComponentFieldValue;
@@ -1,6 +1,7 @@
 #ifndef SHOVELER_COMPONENT_SYSTEM_H
 #define SHOVELER_COMPONENT_SYSTEM_H
 
+#include <glib.h>
 #include <stdbool.h>
 
 typedef struct ShovelerComponentFieldStruct ShovelerComponentField;
@@ -45,6 +46,10 @@ typedef struct ShovelerComponentSystemStruct {
   ShovelerComponentSystemUpdateComponentFunction* updateComponent;
   ShovelerComponentSystemDeactivateComponentFunction* deactivateComponent;
   void* callbackUserData;
+  /** array of (ShovelerComponent *) currently active in this system */
+  GArray* activeComponents;
+  /** map from (ShovelerComponent *) to its index in activeComponents */
+  GHashTable* activeComponentIndices;
 } ShovelerComponentSystem;
 
 ShovelerComponentSystem* shovelerComponentSystemCreate(
@@ -52,6 +57,16 @@ ShovelerComponentSystem* shovelerComponentSystemCreate(
     ShovelerComponentType* componentType);
 void shovelerComponentSystemFree(ShovelerComponentSystem* componentSystem);
 
+static inline int shovelerComponentSystemGetNumActiveComponents(
+    ShovelerComponentSystem* componentSystem) {
+  return (int) componentSystem->activeComponents->len;
+}
+
+static inline ShovelerComponent* shovelerComponentSystemGetActiveComponent(
+    ShovelerComponentSystem* componentSystem, int index) {
+  return g_array_index(componentSystem->activeComponents, ShovelerComponent*, index);
+}
+
 /**
  * A ShovelerComponentSystemLiveUpdateFieldFunction that does nothing and doesn't propagate the
  * update to reverse dependencies.
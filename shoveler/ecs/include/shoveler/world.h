@@ -42,6 +42,10 @@ typedef struct ShovelerWorldStruct {
   ShovelerComponentWorldAdapter* componentWorldAdapter;
   int numComponentDependencies;
   int numComponents;
+  /** array of (ShovelerWorldRemoveEntitiesCallback) */
+  GArray* removeEntitiesCallbacks;
+  /** if true, the dependencies of components being freed have already been removed in bulk */
+  /* private */ bool isRemovingEntities;
 } ShovelerWorld;
 
 typedef struct ShovelerWorldEntityStruct {
@@ -66,6 +70,42 @@ typedef struct {
   void* userData;
 } ShovelerWorldDependencyCallback;
 
+/**
+ * Called once per shovelerWorldRemoveEntities call in place of the individual dependency callbacks,
+ * with the ids of the entities that were actually removed and the number of dependencies removed
+ * with their components.
+ */
+typedef void(ShovelerWorldRemoveEntitiesCallbackFunction)(
+    ShovelerWorld* world,
+    int numEntityIds,
+    const long long int* entityIds,
+    int numRemovedDependencies,
+    void* userData);
+
+typedef struct {
+  ShovelerWorldRemoveEntitiesCallbackFunction* function;
+  void* userData;
+} ShovelerWorldRemoveEntitiesCallback;
+
+/**
+ * Cursor over the dense per-type storage of active components, see shovelerWorldQueryComponents
+ * and shovelerWorldQueryEntities.
+ *
+ * Activating or deactivating components invalidates the cursor.
+ */
+typedef struct {
+  ShovelerWorld* world;
+  /** array of active (ShovelerComponent *) driving the query, or NULL if there are none */
+  /* private */ GArray* components;
+  /* private */ int index;
+  /* private */ int numComponentTypeIds;
+  /* private */ const char* const* componentTypeIds;
+  /** current component of the driving type, set by shovelerWorldQueryNext */
+  ShovelerComponent* component;
+  /** current entity for entity queries, set by shovelerWorldQueryNext */
+  ShovelerWorldEntity* entity;
+} ShovelerWorldQuery;
+
 ShovelerWorld* shovelerWorldCreate(
     ShovelerSchema* schema,
     ShovelerSystem* system,
@@ -74,6 +114,16 @@ ShovelerWorld* shovelerWorldCreate(
 ShovelerComponentWorldAdapter* shovelerWorldGetComponentAdapter(ShovelerWorld* world);
 ShovelerWorldEntity* shovelerWorldAddEntity(ShovelerWorld* world, long long int entityId);
 bool shovelerWorldRemoveEntity(ShovelerWorld* world, long long int entityId);
+/**
+ * Removes all given entities at once, returning the number of entities that existed.
+ *
+ * Each entity's components that have dependencies are deactivated first and their dependencies
+ * dropped directly, then the remaining components are deactivated, which cascades to anything still
+ * depending on them, before the entity is freed. The dependency callbacks aren't notified of these
+ * dependency removals, instead the remove entities callbacks are notified once at the end.
+ */
+int shovelerWorldRemoveEntities(
+    ShovelerWorld* world, int numEntityIds, const long long int* entityIds);
 ShovelerComponent* shovelerWorldEntityAddComponent(
     ShovelerWorldEntity* entity, const char* componentTypeId);
 bool shovelerWorldEntityRemoveComponent(ShovelerWorldEntity* entity, const char* componentTypeId);
@@ -85,6 +135,21 @@ const ShovelerWorldDependencyCallback* shovelerWorldAddDependencyCallback(
     ShovelerWorld* world, ShovelerWorldDependencyCallbackFunction* function, void* userData);
 bool shovelerWorldRemoveDependencyCallback(
     ShovelerWorld* world, const ShovelerWorldDependencyCallback* callback);
+const ShovelerWorldRemoveEntitiesCallback* shovelerWorldAddRemoveEntitiesCallback(
+    ShovelerWorld* world, ShovelerWorldRemoveEntitiesCallbackFunction* function, void* userData);
+bool shovelerWorldRemoveRemoveEntitiesCallback(
+    ShovelerWorld* world, const ShovelerWorldRemoveEntitiesCallback* callback);
+int shovelerWorldGetNumActiveComponents(ShovelerWorld* world, const char* componentTypeId);
+/** Returns a cursor over all active components of the given type. */
+ShovelerWorldQuery shovelerWorldQueryComponents(ShovelerWorld* world, const char* componentTypeId);
+/**
+ * Returns a cursor over all entities having active components of every given type, driven by the
+ * type with the fewest active components. The type id array must outlive the cursor.
+ */
+ShovelerWorldQuery shovelerWorldQueryEntities(
+    ShovelerWorld* world, int numComponentTypeIds, const char* const* componentTypeIds);
+/** Advances the cursor, returning false once it is exhausted. */
+bool shovelerWorldQueryNext(ShovelerWorldQuery* query);
 void shovelerWorldFree(ShovelerWorld* world);
 
 static inline ShovelerWorldEntity* shovelerWorldGetEntity(
@@ -0,0 +1,384 @@
+#include <glib.h>
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // atoi, malloc, free
+
+#include "shoveler/component.h"
+#include "shoveler/component_field.h"
+#include "shoveler/component_system.h"
+#include "shoveler/component_type.h"
+#include "shoveler/log.h"
+#include "shoveler/schema.h"
+#include "shoveler/system.h"
+#include "shoveler/world.h"
+#include "shoveler/world_dependency_graph.h"
+
+/** Longest dependency chain to build, since propagation along a chain recurses once per link. */
+#define MAX_CHAIN_LENGTH 1000
+/** Number of models sharing the position of a single entity, e.g. tiles sharing a tileset. */
+#define SHARED_DEPENDENCY_FAN_OUT 1000
+
+static const char* benchmarkPositionTypeId = "benchmark_position";
+static const char* benchmarkModelTypeId = "benchmark_model";
+static const char* benchmarkNodeTypeId = "benchmark_node";
+
+enum {
+  BENCHMARK_POSITION_FIELD_ID_VALUE,
+};
+
+enum {
+  BENCHMARK_MODEL_FIELD_ID_POSITION,
+  BENCHMARK_MODEL_FIELD_ID_COLOR,
+};
+
+enum {
+  BENCHMARK_NODE_FIELD_ID_VALUE,
+  BENCHMARK_NODE_FIELD_ID_PARENT,
+};
+
+typedef struct {
+  ShovelerSchema* schema;
+  ShovelerSystem* system;
+  ShovelerWorld* world;
+} Benchmark;
+
+typedef void(BenchmarkFunction)(Benchmark* benchmark, int numEntities);
+
+static void benchmarkAddEntities(Benchmark* benchmark, int numEntities);
+static void benchmarkRemoveEntities(Benchmark* benchmark, int numEntities);
+static void benchmarkRemoveEntitiesBulk(Benchmark* benchmark, int numEntities);
+static void benchmarkRemoveEntitiesShared(Benchmark* benchmark, int numEntities);
+static void benchmarkRemoveEntitiesSharedBulk(Benchmark* benchmark, int numEntities);
+static void benchmarkAddComponentsWithDependencies(Benchmark* benchmark, int numEntities);
+static void benchmarkUpdateFieldLive(Benchmark* benchmark, int numEntities);
+static void benchmarkUpdateFieldReactivate(Benchmark* benchmark, int numEntities);
+static void benchmarkPropagateDependencyChains(Benchmark* benchmark, int numEntities);
+static void benchmarkExportDependencyGraph(Benchmark* benchmark, int numEntities);
+static void setUp(Benchmark* benchmark);
+static void tearDown(Benchmark* benchmark);
+static void addEntities(Benchmark* benchmark, int numEntities);
+static void addModels(Benchmark* benchmark, int numEntities);
+static void addSharedModels(Benchmark* benchmark, int numEntities);
+static long long int* createEntityIds(int numEntities);
+static void addChains(Benchmark* benchmark, int numEntities);
+static void report(const char* name, int numEntities, int numOperations, gint64 elapsedUs);
+static void updateAuthoritativeComponent(
+    ShovelerWorld* world,
+    ShovelerComponent* component,
+    const ShovelerComponentField* field,
+    const ShovelerComponentFieldValue* value,
+    void* userData);
+
+static const struct {
+  const char* name;
+  BenchmarkFunction* function;
+} benchmarks[] = {
+    {"add_entities", benchmarkAddEntities},
+    {"remove_entities", benchmarkRemoveEntities},
+    {"remove_entities_bulk", benchmarkRemoveEntitiesBulk},
+    {"remove_entities_shared", benchmarkRemoveEntitiesShared},
+    {"remove_entities_shared_bulk", benchmarkRemoveEntitiesSharedBulk},
+    {"add_components_with_dependencies", benchmarkAddComponentsWithDependencies},
+    {"update_field_live", benchmarkUpdateFieldLive},
+    {"update_field_reactivate", benchmarkUpdateFieldReactivate},
+    {"propagate_dependency_chains", benchmarkPropagateDependencyChains},
+    {"export_dependency_graph", benchmarkExportDependencyGraph},
+};
+
+/**
+ * Runs the ECS micro-benchmarks for the entity counts given on the command line, defaulting to
+ * 1k, 10k and 100k. Each result is printed to stdout as one JSON object per line.
+ */
+int main(int argc, char** argv) {
+  shovelerLogInit("shoveler/", SHOVELER_LOG_LEVEL_WARNING_UP, stderr);
+
+  int defaultEntityCounts[] = {1000, 10000, 100000};
+  int numEntityCounts = 3;
+  int* entityCounts = defaultEntityCounts;
+  if (argc > 1) {
+    numEntityCounts = argc - 1;
+    entityCounts = malloc(numEntityCounts * sizeof(int));
+    for (int i = 0; i < numEntityCounts; i++) {
+      entityCounts[i] = atoi(argv[i + 1]);
+    }
+  }
+
+  for (int i = 0; i < numEntityCounts; i++) {
+    for (size_t j = 0; j < sizeof(benchmarks) / sizeof(benchmarks[0]); j++) {
+      Benchmark benchmark;
+      setUp(&benchmark);
+      benchmarks[j].function(&benchmark, entityCounts[i]);
+      tearDown(&benchmark);
+    }
+  }
+
+  if (entityCounts != defaultEntityCounts) {
+    free(entityCounts);
+  }
+
+  shovelerLogTerminate();
+  return EXIT_SUCCESS;
+}
+
+static void benchmarkAddEntities(Benchmark* benchmark, int numEntities) {
+  gint64 start = g_get_monotonic_time();
+  addEntities(benchmark, numEntities);
+  report("add_entities", numEntities, numEntities, g_get_monotonic_time() - start);
+}
+
+static void benchmarkRemoveEntities(Benchmark* benchmark, int numEntities) {
+  addModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < numEntities; i++) {
+    shovelerWorldRemoveEntity(benchmark->world, i + 1);
+  }
+  report("remove_entities", numEntities, numEntities, g_get_monotonic_time() - start);
+}
+
+static void benchmarkRemoveEntitiesBulk(Benchmark* benchmark, int numEntities) {
+  long long int* entityIds = createEntityIds(numEntities);
+  addModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  shovelerWorldRemoveEntities(benchmark->world, numEntities, entityIds);
+  report("remove_entities_bulk", numEntities, numEntities, g_get_monotonic_time() - start);
+
+  free(entityIds);
+}
+
+static void benchmarkRemoveEntitiesShared(Benchmark* benchmark, int numEntities) {
+  addSharedModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < numEntities; i++) {
+    shovelerWorldRemoveEntity(benchmark->world, i + 1);
+  }
+  report("remove_entities_shared", numEntities, numEntities, g_get_monotonic_time() - start);
+}
+
+static void benchmarkRemoveEntitiesSharedBulk(Benchmark* benchmark, int numEntities) {
+  long long int* entityIds = createEntityIds(numEntities);
+  addSharedModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  shovelerWorldRemoveEntities(benchmark->world, numEntities, entityIds);
+  report("remove_entities_shared_bulk", numEntities, numEntities, g_get_monotonic_time() - start);
+
+  free(entityIds);
+}
+
+static void benchmarkAddComponentsWithDependencies(Benchmark* benchmark, int numEntities) {
+  gint64 start = g_get_monotonic_time();
+  addModels(benchmark, numEntities);
+  report(
+      "add_components_with_dependencies",
+      numEntities,
+      /* numOperations */ 2 * numEntities,
+      g_get_monotonic_time() - start);
+}
+
+static void benchmarkUpdateFieldLive(Benchmark* benchmark, int numEntities) {
+  addModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < numEntities; i++) {
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, i + 1);
+    ShovelerComponent* position = shovelerWorldEntityGetComponent(entity, benchmarkPositionTypeId);
+    shovelerComponentUpdateCanonicalFieldInt(position, BENCHMARK_POSITION_FIELD_ID_VALUE, i);
+  }
+  report("update_field_live", numEntities, numEntities, g_get_monotonic_time() - start);
+}
+
+static void benchmarkUpdateFieldReactivate(Benchmark* benchmark, int numEntities) {
+  addModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < numEntities; i++) {
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, i + 1);
+    ShovelerComponent* model = shovelerWorldEntityGetComponent(entity, benchmarkModelTypeId);
+    shovelerComponentUpdateCanonicalFieldInt(model, BENCHMARK_MODEL_FIELD_ID_COLOR, i);
+  }
+  report("update_field_reactivate", numEntities, numEntities, g_get_monotonic_time() - start);
+}
+
+static void benchmarkPropagateDependencyChains(Benchmark* benchmark, int numEntities) {
+  addChains(benchmark, numEntities);
+
+  // updating each chain's root propagates along the whole chain
+  int numOperations = 0;
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < numEntities; i += MAX_CHAIN_LENGTH) {
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, i + 1);
+    ShovelerComponent* node = shovelerWorldEntityGetComponent(entity, benchmarkNodeTypeId);
+    shovelerComponentUpdateCanonicalFieldInt(node, BENCHMARK_NODE_FIELD_ID_VALUE, i);
+    numOperations++;
+  }
+  report(
+      "propagate_dependency_chains",
+      numEntities,
+      numOperations,
+      g_get_monotonic_time() - start);
+}
+
+static void benchmarkExportDependencyGraph(Benchmark* benchmark, int numEntities) {
+  addModels(benchmark, numEntities);
+
+  gint64 start = g_get_monotonic_time();
+  GString* graph = shovelerWorldDependencyGraphCreate(benchmark->world);
+  report("export_dependency_graph", numEntities, 1, g_get_monotonic_time() - start);
+
+  g_string_free(graph, true);
+}
+
+static void setUp(Benchmark* benchmark) {
+  ShovelerComponentField positionFields[1];
+  positionFields[BENCHMARK_POSITION_FIELD_ID_VALUE] =
+      shovelerComponentField("value", SHOVELER_COMPONENT_FIELD_TYPE_INT, /* isOptional */ false);
+
+  ShovelerComponentField modelFields[2];
+  modelFields[BENCHMARK_MODEL_FIELD_ID_POSITION] = shovelerComponentFieldDependency(
+      "position", benchmarkPositionTypeId, /* isArray */ false, /* isOptional */ false);
+  modelFields[BENCHMARK_MODEL_FIELD_ID_COLOR] =
+      shovelerComponentField("color", SHOVELER_COMPONENT_FIELD_TYPE_INT, /* isOptional */ false);
+
+  ShovelerComponentField nodeFields[2];
+  nodeFields[BENCHMARK_NODE_FIELD_ID_VALUE] =
+      shovelerComponentField("value", SHOVELER_COMPONENT_FIELD_TYPE_INT, /* isOptional */ false);
+  nodeFields[BENCHMARK_NODE_FIELD_ID_PARENT] = shovelerComponentFieldDependency(
+      "parent", benchmarkNodeTypeId, /* isArray */ false, /* isOptional */ true);
+
+  ShovelerComponentType* positionType =
+      shovelerComponentTypeCreate(benchmarkPositionTypeId, 1, positionFields);
+  ShovelerComponentType* modelType =
+      shovelerComponentTypeCreate(benchmarkModelTypeId, 2, modelFields);
+  ShovelerComponentType* nodeType = shovelerComponentTypeCreate(benchmarkNodeTypeId, 2, nodeFields);
+
+  benchmark->schema = shovelerSchemaCreate();
+  shovelerSchemaAddComponentType(benchmark->schema, positionType);
+  shovelerSchemaAddComponentType(benchmark->schema, modelType);
+  shovelerSchemaAddComponentType(benchmark->schema, nodeType);
+
+  benchmark->system = shovelerSystemCreate();
+  ShovelerComponentSystem* positionSystem =
+      shovelerSystemForComponentType(benchmark->system, positionType);
+  positionSystem->fieldOptions[BENCHMARK_POSITION_FIELD_ID_VALUE].liveUpdateField =
+      shovelerComponentSystemLiveUpdateFieldPropagate;
+
+  ShovelerComponentSystem* modelSystem =
+      shovelerSystemForComponentType(benchmark->system, modelType);
+  modelSystem->fieldOptions[BENCHMARK_MODEL_FIELD_ID_POSITION].liveUpdateDependencyField =
+      shovelerComponentSystemLiveUpdateDependencyFieldNoop;
+
+  ShovelerComponentSystem* nodeSystem = shovelerSystemForComponentType(benchmark->system, nodeType);
+  nodeSystem->fieldOptions[BENCHMARK_NODE_FIELD_ID_VALUE].liveUpdateField =
+      shovelerComponentSystemLiveUpdateFieldPropagate;
+  nodeSystem->fieldOptions[BENCHMARK_NODE_FIELD_ID_PARENT].liveUpdateDependencyField =
+      shovelerComponentSystemLiveUpdateDependencyFieldPropagate;
+
+  benchmark->world = shovelerWorldCreate(
+      benchmark->schema, benchmark->system, updateAuthoritativeComponent, NULL);
+}
+
+static void tearDown(Benchmark* benchmark) {
+  shovelerWorldFree(benchmark->world);
+  shovelerSystemFree(benchmark->system);
+  shovelerSchemaFree(benchmark->schema);
+}
+
+static void addEntities(Benchmark* benchmark, int numEntities) {
+  for (int i = 0; i < numEntities; i++) {
+    shovelerWorldAddEntity(benchmark->world, i + 1);
+  }
+}
+
+/** Adds entities with a model depending on a position of the same entity, all active. */
+static void addModels(Benchmark* benchmark, int numEntities) {
+  addEntities(benchmark, numEntities);
+
+  for (int i = 0; i < numEntities; i++) {
+    long long int entityId = i + 1;
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, entityId);
+
+    ShovelerComponent* model = shovelerWorldEntityAddComponent(entity, benchmarkModelTypeId);
+    shovelerComponentUpdateCanonicalFieldEntityId(
+        model, BENCHMARK_MODEL_FIELD_ID_POSITION, entityId);
+
+    ShovelerComponent* position = shovelerWorldEntityAddComponent(entity, benchmarkPositionTypeId);
+    shovelerComponentActivate(position);
+  }
+}
+
+/**
+ * Adds entities with a model depending on the position of the first entity of its group of
+ * SHARED_DEPENDENCY_FAN_OUT entities, all active.
+ */
+static void addSharedModels(Benchmark* benchmark, int numEntities) {
+  addEntities(benchmark, numEntities);
+
+  for (int i = 0; i < numEntities; i++) {
+    long long int entityId = i + 1;
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, entityId);
+
+    if (i % SHARED_DEPENDENCY_FAN_OUT == 0) {
+      ShovelerComponent* position =
+          shovelerWorldEntityAddComponent(entity, benchmarkPositionTypeId);
+      shovelerComponentActivate(position);
+    }
+
+    ShovelerComponent* model = shovelerWorldEntityAddComponent(entity, benchmarkModelTypeId);
+    shovelerComponentUpdateCanonicalFieldEntityId(
+        model, BENCHMARK_MODEL_FIELD_ID_POSITION, i - i % SHARED_DEPENDENCY_FAN_OUT + 1);
+    shovelerComponentActivate(model);
+  }
+}
+
+/**
+ * Returns the ids of the first numEntities entities, to be allocated before the world is populated
+ * so that the allocation doesn't skew the timed removal.
+ */
+static long long int* createEntityIds(int numEntities) {
+  long long int* entityIds = malloc(numEntities * sizeof(long long int));
+  for (int i = 0; i < numEntities; i++) {
+    entityIds[i] = i + 1;
+  }
+  return entityIds;
+}
+
+/** Adds entities with nodes forming chains of up to MAX_CHAIN_LENGTH, all active. */
+static void addChains(Benchmark* benchmark, int numEntities) {
+  addEntities(benchmark, numEntities);
+
+  for (int i = 0; i < numEntities; i++) {
+    long long int entityId = i + 1;
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(benchmark->world, entityId);
+
+    ShovelerComponent* node = shovelerWorldEntityAddComponent(entity, benchmarkNodeTypeId);
+    if (i % MAX_CHAIN_LENGTH != 0) {
+      shovelerComponentUpdateCanonicalFieldEntityId(
+          node, BENCHMARK_NODE_FIELD_ID_PARENT, entityId - 1);
+    }
+    shovelerComponentActivate(node);
+  }
+}
+
+static void report(const char* name, int numEntities, int numOperations, gint64 elapsedUs) {
+  double nsPerOperation = numOperations > 0 ? 1000.0 * elapsedUs / numOperations : 0.0;
+  printf(
+      "{\"benchmark\": \"%s\", \"entities\": %d, \"operations\": %d, \"elapsed_us\": %lld, "
+      "\"ns_per_operation\": %.1f}\n",
+      name,
+      numEntities,
+      numOperations,
+      (long long int) elapsedUs,
+      nsPerOperation);
+  fflush(stdout);
+}
+
+static void updateAuthoritativeComponent(
+    ShovelerWorld* world,
+    ShovelerComponent* component,
+    const ShovelerComponentField* field,
+    const ShovelerComponentFieldValue* value,
+    void* userData) {
+  // benchmark components are never authoritative
+}
@@ -144,9 +144,10 @@ void shovelerComponentFieldClearValue(ShovelerComponentFieldValue* fieldValue) {
     fieldValue->vector4Value = shovelerVector4(0.0f, 0.0f, 0.0f, 0.0f);
     break;
   case SHOVELER_COMPONENT_FIELD_TYPE_BYTES:
-    free(fieldValue->bytesValue.data);
+    shovelerBytesUnref(fieldValue->bytesValue.bytes);
     fieldValue->bytesValue.data = NULL;
     fieldValue->bytesValue.size = 0;
+    fieldValue->bytesValue.bytes = NULL;
     break;
   }
 }
@@ -165,9 +166,13 @@ void shovelerComponentFieldAssignValue(
   assert(
       source->type != SHOVELER_COMPONENT_FIELD_TYPE_STRING ||
       (source->stringValue != target->stringValue));
-  assert(
-      source->type != SHOVELER_COMPONENT_FIELD_TYPE_BYTES ||
-      (source->bytesValue.data != target->bytesValue.data));
+
+  // reference a shared source buffer before clearing the target, which might hold its last reference
+  ShovelerBytes* sourceBytes = NULL;
+  if (source->type == SHOVELER_COMPONENT_FIELD_TYPE_BYTES && source->isSet &&
+      source->bytesValue.bytes != NULL) {
+    sourceBytes = shovelerBytesRef(source->bytesValue.bytes);
+  }
 
   shovelerComponentFieldClearValue(target);
 
@@ -214,12 +219,20 @@ void shovelerComponentFieldAssignValue(
     target->vector4Value = source->vector4Value;
     break;
   case SHOVELER_COMPONENT_FIELD_TYPE_BYTES: {
-    if (source->entityIdArrayValue.size > 0) {
-      size_t numBytes = (size_t) source->bytesValue.size;
+    if (source->bytesValue.size > 0) {
+      // share the source buffer if there is one, and only copy borrowed data
+      ShovelerBytes* bytes;
+      if (sourceBytes != NULL) {
+        bytes = sourceBytes;
+      } else {
+        bytes = shovelerBytesCreate(source->bytesValue.data, (size_t) source->bytesValue.size);
+      }
 
-      target->bytesValue.data = malloc(numBytes * sizeof(unsigned char));
-      target->bytesValue.size = source->bytesValue.size;
-      memcpy(target->bytesValue.data, source->bytesValue.data, numBytes * sizeof(unsigned char));
+      target->bytesValue.data = (unsigned char*) shovelerBytesGetData(bytes); // won't be modified
+      target->bytesValue.size = (int) shovelerBytesGetSize(bytes);
+      target->bytesValue.bytes = bytes;
+    } else {
+      shovelerBytesUnref(sourceBytes);
     }
   } break;
   }
@@ -294,7 +307,7 @@ bool shovelerComponentFieldCompareValue(
       return false;
     }
 
-    if (a->bytesValue.size == 0) {
+    if (a->bytesValue.size == 0 || a->bytesValue.data == b->bytesValue.data) {
       return true;
     }
 
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/bytes.h"
+#include "shoveler/component_field.h"
+}
+
+static void countFree(unsigned char* data, void* counterPointer);
+
+TEST(componentField, assignBytesSharesSourceBuffer) {
+  int numFrees = 0;
+  unsigned char input[] = {1, 2, 3};
+  ShovelerBytes* bytes = shovelerBytesCreateWrap(input, sizeof(input), countFree, &numFrees);
+
+  ShovelerComponentFieldValue* source =
+      shovelerComponentFieldCreateValue(SHOVELER_COMPONENT_FIELD_TYPE_BYTES);
+  source->isSet = true;
+  source->bytesValue.data = (unsigned char*) shovelerBytesGetData(bytes);
+  source->bytesValue.size = (int) shovelerBytesGetSize(bytes);
+  source->bytesValue.bytes = bytes;
+
+  ShovelerComponentFieldValue* target =
+      shovelerComponentFieldCreateValue(SHOVELER_COMPONENT_FIELD_TYPE_BYTES);
+  shovelerComponentFieldAssignValue(target, source);
+  ASSERT_TRUE(target->isSet);
+  ASSERT_EQ(target->bytesValue.bytes, bytes) << "source buffer should be shared";
+  ASSERT_EQ(target->bytesValue.data, input);
+  ASSERT_EQ(target->bytesValue.size, sizeof(input));
+  ASSERT_EQ(bytes->refCount, 2);
+
+  // assign again while the target already shares the source's buffer
+  shovelerComponentFieldAssignValue(target, source);
+  ASSERT_TRUE(target->isSet);
+  ASSERT_EQ(target->bytesValue.bytes, bytes);
+  ASSERT_EQ(target->bytesValue.data, input);
+  ASSERT_EQ(bytes->refCount, 2);
+  ASSERT_EQ(numFrees, 0);
+
+  shovelerComponentFieldFreeValue(source);
+  ASSERT_EQ(numFrees, 0) << "buffer should be kept alive by the target";
+  ASSERT_EQ(target->bytesValue.data, input);
+
+  shovelerComponentFieldFreeValue(target);
+  ASSERT_EQ(numFrees, 1) << "buffer should be freed with its last field";
+}
+
+static void countFree(unsigned char* data, void* counterPointer) {
+  int* counter = (int*) counterPointer;
+  (*counter)++;
+}
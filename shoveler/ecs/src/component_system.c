@@ -1,5 +1,7 @@
 #include "shoveler/component_system.h"
 
+#include <assert.h>
+#include <stdint.h> // uintptr_t
 #include <stdlib.h> // malloc free
 
 #include "shoveler/component.h"
@@ -32,6 +34,10 @@ static bool liveUpdateDependencyField(
 static void* activateComponent(ShovelerComponent* component, void* componentSystemPointer);
 static bool updateComponent(ShovelerComponent* component, double dt, void* componentSystemPointer);
 static void deactivateComponent(ShovelerComponent* component, void* componentSystemPointer);
+static void addActiveComponent(
+    ShovelerComponentSystem* componentSystem, ShovelerComponent* component);
+static void removeActiveComponent(
+    ShovelerComponentSystem* componentSystem, ShovelerComponent* component);
 
 ShovelerComponentSystem* shovelerComponentSystemCreate(
     ShovelerSystem *system,
@@ -59,11 +65,17 @@ ShovelerComponentSystem* shovelerComponentSystemCreate(
   componentSystem->activateComponent = NULL;
   componentSystem->updateComponent = NULL;
   componentSystem->deactivateComponent = NULL;
+  componentSystem->callbackUserData = NULL;
+  componentSystem->activeComponents = g_array_new(
+      /* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerComponent*));
+  componentSystem->activeComponentIndices = g_hash_table_new(g_direct_hash, g_direct_equal);
 
   return componentSystem;
 }
 
 void shovelerComponentSystemFree(ShovelerComponentSystem* componentSystem) {
+  g_hash_table_destroy(componentSystem->activeComponentIndices);
+  g_array_free(componentSystem->activeComponents, /* freeSegment */ true);
   free(componentSystem->fieldOptions);
   free(componentSystem->componentAdapter);
   free(componentSystem);
@@ -140,10 +152,12 @@ static void* activateComponent(ShovelerComponent* component, void* componentSyst
         componentSystem->activateComponent(component, componentSystem->callbackUserData);
     if (activation) {
       componentSystem->system->numActiveComponents++;
+      addActiveComponent(componentSystem, component);
     }
     return activation;
   }
 
+  addActiveComponent(componentSystem, component);
   return component;
 }
 
@@ -160,8 +174,42 @@ static bool updateComponent(ShovelerComponent* component, double dt, void* compo
 static void deactivateComponent(ShovelerComponent* component, void* componentSystemPointer) {
   ShovelerComponentSystem* componentSystem = componentSystemPointer;
 
+  removeActiveComponent(componentSystem, component);
+
   if (componentSystem->deactivateComponent != NULL) {
     componentSystem->deactivateComponent(component, componentSystem->callbackUserData);
     componentSystem->system->numActiveComponents--;
   }
 }
+
+static void addActiveComponent(
+    ShovelerComponentSystem* componentSystem, ShovelerComponent* component) {
+  guint index = componentSystem->activeComponents->len;
+  g_array_append_val(componentSystem->activeComponents, component);
+
+  // store index + 1 so that the first component doesn't map to NULL
+  bool inserted = g_hash_table_insert(
+      componentSystem->activeComponentIndices, component, (gpointer) (uintptr_t) (index + 1));
+  assert(inserted);
+  (void) inserted;
+}
+
+static void removeActiveComponent(
+    ShovelerComponentSystem* componentSystem, ShovelerComponent* component) {
+  gpointer indexPointer = g_hash_table_lookup(componentSystem->activeComponentIndices, component);
+  if (indexPointer == NULL) {
+    return;
+  }
+
+  guint index = (guint) (uintptr_t) indexPointer - 1;
+  guint lastIndex = componentSystem->activeComponents->len - 1;
+  if (index != lastIndex) {
+    ShovelerComponent* lastComponent =
+        g_array_index(componentSystem->activeComponents, ShovelerComponent*, lastIndex);
+    g_hash_table_insert(
+        componentSystem->activeComponentIndices, lastComponent, (gpointer) (uintptr_t) (index + 1));
+  }
+
+  g_array_remove_index_fast(componentSystem->activeComponents, index);
+  g_hash_table_remove(componentSystem->activeComponentIndices, component);
+}
@@ -4,7 +4,9 @@
 #include <string>
 
 extern "C" {
+#include "shoveler/bytes.h"
 #include "shoveler/component.h"
+#include "shoveler/component_field.h"
 #include "shoveler/component_type.h"
 #include "shoveler/log.h"
 #include "test_component_types.h"
@@ -480,6 +482,53 @@ TEST_F(ShovelerComponentTest, dontPropagateLiveDependencyUpdate) {
   ASSERT_THAT(activateCalls, IsEmpty());
 }
 
+TEST_F(ShovelerComponentTest, assignBytesSharesBuffer) {
+  unsigned char contents[] = {1, 2, 3, 4};
+  ShovelerBytes* bytes = shovelerBytesCreate(contents, sizeof(contents));
+
+  ShovelerComponentFieldValue sharedValue;
+  shovelerComponentFieldInitValue(&sharedValue, SHOVELER_COMPONENT_FIELD_TYPE_BYTES);
+  sharedValue.isSet = true;
+  sharedValue.bytesValue.data = (unsigned char*) shovelerBytesGetData(bytes);
+  sharedValue.bytesValue.size = (int) shovelerBytesGetSize(bytes);
+  sharedValue.bytesValue.bytes = bytes;
+
+  ShovelerComponentFieldValue* target = shovelerComponentFieldCopyValue(&sharedValue);
+  ASSERT_EQ(target->bytesValue.bytes, bytes) << "shared buffer should be referenced, not copied";
+  ASSERT_EQ(target->bytesValue.data, shovelerBytesGetData(bytes));
+  ASSERT_EQ(bytes->refCount, 2);
+
+  ShovelerComponentFieldValue* copy = shovelerComponentFieldCopyValue(target);
+  ASSERT_EQ(copy->bytesValue.bytes, bytes);
+  ASSERT_EQ(bytes->refCount, 3);
+  ASSERT_TRUE(shovelerComponentFieldCompareValue(copy, target));
+
+  shovelerComponentFieldFreeValue(copy);
+  shovelerComponentFieldFreeValue(target);
+  ASSERT_EQ(bytes->refCount, 1);
+  shovelerBytesUnref(bytes);
+}
+
+TEST_F(ShovelerComponentTest, assignBorrowedBytesCopiesOnce) {
+  unsigned char contents[] = {5, 6, 7};
+
+  ShovelerComponentFieldValue borrowedValue;
+  shovelerComponentFieldInitValue(&borrowedValue, SHOVELER_COMPONENT_FIELD_TYPE_BYTES);
+  borrowedValue.isSet = true;
+  borrowedValue.bytesValue.data = contents;
+  borrowedValue.bytesValue.size = sizeof(contents);
+
+  ShovelerComponentFieldValue* target = shovelerComponentFieldCopyValue(&borrowedValue);
+  ASSERT_NE(target->bytesValue.bytes, nullptr);
+  ASSERT_NE(target->bytesValue.data, contents) << "borrowed data should be copied";
+  ASSERT_TRUE(shovelerComponentFieldCompareValue(target, &borrowedValue));
+
+  contents[0] = 42;
+  ASSERT_EQ(target->bytesValue.data[0], 5);
+
+  shovelerComponentFieldFreeValue(target);
+}
+
 static ShovelerComponent* getComponent(
     ShovelerComponent* component,
     long long int entityId,
@@ -26,6 +26,7 @@ ShovelerComponentSystem* shovelerSystemForComponentType(
     bool inserted =
         g_hash_table_insert(system->componentSystems, (gpointer) componentType->id, componentSystem);
     assert(inserted);
+    (void) inserted;
   }
 
   return componentSystem;
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/component.h"
+#include "shoveler/component_system.h"
+#include "shoveler/component_type.h"
+#include "shoveler/schema.h"
+#include "shoveler/system.h"
+#include "shoveler/world.h"
+#include "test_component_types.h"
+}
+
+static void updateAuthoritativeComponent(
+    ShovelerWorld* world,
+    ShovelerComponent* component,
+    const ShovelerComponentField* field,
+    const ShovelerComponentFieldValue* value,
+    void* userData) {}
+
+class ShovelerSystemTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    schema = shovelerSchemaCreate();
+    ShovelerComponentType* componentType1 = shovelerCreateTestComponentType1();
+    ShovelerComponentType* componentType2 = shovelerCreateTestComponentType2();
+    ShovelerComponentType* componentType3 = shovelerCreateTestComponentType3();
+    shovelerSchemaAddComponentType(schema, componentType1);
+    shovelerSchemaAddComponentType(schema, componentType2);
+    shovelerSchemaAddComponentType(schema, componentType3);
+
+    system = shovelerSystemCreate();
+    componentSystem1 = shovelerSystemForComponentType(system, componentType1);
+
+    world = shovelerWorldCreate(schema, system, updateAuthoritativeComponent, this);
+  }
+
+  virtual void TearDown() {
+    shovelerWorldFree(world);
+    shovelerSystemFree(system);
+    shovelerSchemaFree(schema);
+  }
+
+  ShovelerSchema* schema;
+  ShovelerSystem* system;
+  ShovelerComponentSystem* componentSystem1;
+  ShovelerWorld* world;
+};
+
+TEST_F(ShovelerSystemTest, tracksActiveComponents) {
+  ShovelerWorldEntity* entity1 = shovelerWorldAddEntity(world, 1);
+  ShovelerWorldEntity* entity2 = shovelerWorldAddEntity(world, 2);
+  ShovelerComponent* component1 = shovelerWorldEntityAddComponent(entity1, componentType1Id);
+  ShovelerComponent* component2 = shovelerWorldEntityAddComponent(entity2, componentType1Id);
+  shovelerComponentActivate(component1);
+  shovelerComponentActivate(component2);
+  ASSERT_EQ(shovelerComponentSystemGetNumActiveComponents(componentSystem1), 2);
+
+  shovelerComponentDeactivate(component1);
+  ASSERT_EQ(shovelerComponentSystemGetNumActiveComponents(componentSystem1), 1);
+  ASSERT_EQ(shovelerComponentSystemGetActiveComponent(componentSystem1, 0), component2);
+}
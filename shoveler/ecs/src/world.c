@@ -38,9 +38,11 @@ static void forEachReverseDependency(
     void* adapterUserData);
 static bool removeDependencyListEntry(
     GArray* dependencyList, const ShovelerEntityComponentId* entry);
+static int removeComponentDependencies(ShovelerWorld* world, ShovelerComponent* component);
 static void freeEntity(void* entityPointer);
 static void freeComponent(void* componentPointer);
 static void freeDependencyArray(void* dependencyArrayPointer);
+static GArray* getActiveComponents(ShovelerWorld* world, const char* componentTypeId);
 
 ShovelerWorld* shovelerWorldCreate(
     ShovelerSchema* schema,
@@ -68,6 +70,9 @@ ShovelerWorld* shovelerWorldCreate(
   world->componentWorldAdapter->userData = world;
   world->numComponentDependencies = 0;
   world->numComponents = 0;
+  world->removeEntitiesCallbacks = g_array_new(
+      /* zeroTerminated */ false, /* clear */ true, sizeof(ShovelerWorldRemoveEntitiesCallback));
+  world->isRemovingEntities = false;
 
   return world;
 }
@@ -116,6 +121,85 @@ bool shovelerWorldRemoveEntity(ShovelerWorld* world, long long int entityId) {
   return true;
 }
 
+int shovelerWorldRemoveEntities(
+    ShovelerWorld* world, int numEntityIds, const long long int* entityIds) {
+  assert(!world->isRemovingEntities);
+
+  int numRemovedEntities = 0;
+  int numRemovedDependencies = 0;
+  // the removed ids are a prefix of the given ones until an id is skipped, only then are they copied
+  GArray* removedEntityIds = NULL;
+  for (int i = 0; i < numEntityIds; i++) {
+    long long int entityId = entityIds[i];
+    ShovelerWorldEntity* entity = g_hash_table_lookup(world->entities, &entityId);
+    if (entity == NULL) {
+      if (removedEntityIds == NULL) {
+        removedEntityIds = g_array_sized_new(
+            /* zeroTerminated */ false,
+            /* clear */ false,
+            sizeof(long long int),
+            (guint) numEntityIds);
+        g_array_append_vals(removedEntityIds, entityIds, (guint) numRemovedEntities);
+      }
+      continue;
+    }
+
+    numRemovedEntities++;
+    if (removedEntityIds != NULL) {
+      g_array_append_val(removedEntityIds, entityId);
+    }
+
+    // Deactivate and drop the components with dependencies first, so that deactivating the rest
+    // doesn't need to visit them again as reverse dependencies.
+    GHashTableIter iter;
+    ShovelerComponent* component;
+    g_hash_table_iter_init(&iter, entity->components);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer*) &component)) {
+      if (component->dependencies->len > 0) {
+        shovelerComponentDeactivate(component);
+        numRemovedDependencies += removeComponentDependencies(world, component);
+      }
+    }
+
+    // Deactivation cascades through reverse dependencies, so anything depending on the remaining
+    // components is deactivated before them.
+    g_hash_table_iter_init(&iter, entity->components);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer*) &component)) {
+      shovelerComponentDeactivate(component);
+    }
+
+    world->isRemovingEntities = true;
+    world->numComponents -= g_hash_table_size(entity->components);
+    bool removed = g_hash_table_remove(world->entities, &entityId);
+    assert(removed);
+    (void) removed;
+    world->isRemovingEntities = false;
+  }
+
+  const long long int* removedEntityIdsData =
+      removedEntityIds != NULL ? (const long long int*) removedEntityIds->data : entityIds;
+  for (int i = 0; i < world->removeEntitiesCallbacks->len; i++) {
+    ShovelerWorldRemoveEntitiesCallback* callback =
+        &g_array_index(world->removeEntitiesCallbacks, ShovelerWorldRemoveEntitiesCallback, i);
+    if (callback->function != NULL) {
+      callback->function(
+          world,
+          numRemovedEntities,
+          removedEntityIdsData,
+          numRemovedDependencies,
+          callback->userData);
+    }
+  }
+
+  if (removedEntityIds != NULL) {
+    g_array_free(removedEntityIds, /* freeSegment */ true);
+  }
+
+  shovelerLogTrace(
+      "Removed %d entities with %d dependencies.", numRemovedEntities, numRemovedDependencies);
+  return numRemovedEntities;
+}
+
 ShovelerComponent* shovelerWorldEntityAddComponent(
     ShovelerWorldEntity* entity, const char* componentTypeId) {
   ShovelerWorld* world = entity->world;
@@ -227,10 +311,124 @@ bool shovelerWorldRemoveDependencyCallback(
   return true;
 }
 
+int shovelerWorldGetNumActiveComponents(ShovelerWorld* world, const char* componentTypeId) {
+  GArray* activeComponents = getActiveComponents(world, componentTypeId);
+  if (activeComponents == NULL) {
+    return 0;
+  }
+
+  return (int) activeComponents->len;
+}
+
+ShovelerWorldQuery shovelerWorldQueryComponents(ShovelerWorld* world, const char* componentTypeId) {
+  ShovelerWorldQuery query;
+  query.world = world;
+  query.components = getActiveComponents(world, componentTypeId);
+  query.index = 0;
+  query.numComponentTypeIds = 0;
+  query.componentTypeIds = NULL;
+  query.component = NULL;
+  query.entity = NULL;
+
+  return query;
+}
+
+ShovelerWorldQuery shovelerWorldQueryEntities(
+    ShovelerWorld* world, int numComponentTypeIds, const char* const* componentTypeIds) {
+  ShovelerWorldQuery query = shovelerWorldQueryComponents(world, NULL);
+  query.numComponentTypeIds = numComponentTypeIds;
+  query.componentTypeIds = componentTypeIds;
+
+  // drive the query with the smallest set of active components
+  for (int i = 0; i < numComponentTypeIds; i++) {
+    GArray* activeComponents = getActiveComponents(world, componentTypeIds[i]);
+    if (activeComponents == NULL || activeComponents->len == 0) {
+      query.components = NULL;
+      break;
+    }
+
+    if (query.components == NULL || activeComponents->len < query.components->len) {
+      query.components = activeComponents;
+    }
+  }
+
+  return query;
+}
+
+bool shovelerWorldQueryNext(ShovelerWorldQuery* query) {
+  if (query->components == NULL) {
+    return false;
+  }
+
+  while (query->index < (int) query->components->len) {
+    ShovelerComponent* component =
+        g_array_index(query->components, ShovelerComponent*, query->index);
+    query->index++;
+
+    if (query->numComponentTypeIds == 0) {
+      query->component = component;
+      return true;
+    }
+
+    ShovelerWorldEntity* entity = shovelerWorldGetEntity(query->world, component->entityId);
+    if (entity == NULL) {
+      continue;
+    }
+
+    bool matches = true;
+    for (int i = 0; i < query->numComponentTypeIds; i++) {
+      ShovelerComponent* otherComponent =
+          shovelerWorldEntityGetComponent(entity, query->componentTypeIds[i]);
+      if (otherComponent == NULL || !shovelerComponentIsActive(otherComponent)) {
+        matches = false;
+        break;
+      }
+    }
+
+    if (matches) {
+      query->component = component;
+      query->entity = entity;
+      return true;
+    }
+  }
+
+  query->component = NULL;
+  query->entity = NULL;
+  return false;
+}
+
+const ShovelerWorldRemoveEntitiesCallback* shovelerWorldAddRemoveEntitiesCallback(
+    ShovelerWorld* world, ShovelerWorldRemoveEntitiesCallbackFunction* function, void* userData) {
+  ShovelerWorldRemoveEntitiesCallback callback;
+  callback.function = function;
+  callback.userData = userData;
+
+  g_array_append_val(world->removeEntitiesCallbacks, callback);
+  return &g_array_index(
+      world->removeEntitiesCallbacks,
+      ShovelerWorldRemoveEntitiesCallback,
+      world->removeEntitiesCallbacks->len - 1);
+}
+
+bool shovelerWorldRemoveRemoveEntitiesCallback(
+    ShovelerWorld* world, const ShovelerWorldRemoveEntitiesCallback* callback) {
+  for (int i = 0; i < world->removeEntitiesCallbacks->len; i++) {
+    ShovelerWorldRemoveEntitiesCallback* currentCallback =
+        &g_array_index(world->removeEntitiesCallbacks, ShovelerWorldRemoveEntitiesCallback, i);
+    if (currentCallback == callback) {
+      g_array_remove_index_fast(world->removeEntitiesCallbacks, i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void shovelerWorldFree(ShovelerWorld* world) {
   g_hash_table_destroy(world->entities);
   g_hash_table_destroy(world->reverseDependencies);
   g_hash_table_destroy(world->dependencies);
+  g_array_free(world->removeEntitiesCallbacks, /* freeSegment */ true);
   g_array_free(world->dependencyCallbacks, /* freeSegment */ true);
   free(world->componentWorldAdapter);
   free(world);
@@ -319,6 +517,11 @@ static bool removeDependency(
     void* worldPointer) {
   ShovelerWorld* world = (ShovelerWorld*) worldPointer;
 
+  if (world->isRemovingEntities) {
+    // shovelerWorldRemoveEntities already removed the dependencies of the components it frees
+    return true;
+  }
+
   ShovelerEntityComponentId dependencySource =
       shovelerEntityComponentId(component->entityId, component->type->id);
   ShovelerEntityComponentId dependencyTarget =
@@ -349,6 +552,7 @@ static bool removeDependency(
   }
 
   world->numComponentDependencies--;
+
   shovelerLogTrace(
       "Removed dependency from component '%s' of entity %lld to component '%s' of entity %lld.",
       component->type->id,
@@ -400,6 +604,32 @@ static bool removeDependencyListEntry(
   return false;
 }
 
+static int removeComponentDependencies(ShovelerWorld* world, ShovelerComponent* component) {
+  ShovelerEntityComponentId dependencySource =
+      shovelerEntityComponentId(component->entityId, component->type->id);
+
+  for (guint i = 0; i < component->dependencies->len; i++) {
+    const ShovelerEntityComponentId* dependencyTarget =
+        &g_array_index(component->dependencies, ShovelerEntityComponentId, i);
+    GArray* reverseDependencies =
+        g_hash_table_lookup(world->reverseDependencies, dependencyTarget);
+    assert(reverseDependencies != NULL);
+
+    bool reverseDependencyRemoved =
+        removeDependencyListEntry(reverseDependencies, &dependencySource);
+    assert(reverseDependencyRemoved);
+    (void) reverseDependencyRemoved;
+  }
+
+  // keep the emptied array around like shovelerWorldEntityRemoveComponent does
+  GArray* dependencies = g_hash_table_lookup(world->dependencies, &dependencySource);
+  g_array_set_size(dependencies, 0);
+
+  int numRemovedDependencies = (int) component->dependencies->len;
+  world->numComponentDependencies -= numRemovedDependencies;
+  return numRemovedDependencies;
+}
+
 static void freeEntity(void* entityPointer) {
   ShovelerWorldEntity* entity = entityPointer;
 
@@ -419,3 +649,17 @@ static void freeDependencyArray(void* dependencyArrayPointer) {
 
   g_array_free(dependencyArray, /* freeSegment */ true);
 }
+
+static GArray* getActiveComponents(ShovelerWorld* world, const char* componentTypeId) {
+  if (componentTypeId == NULL) {
+    return NULL;
+  }
+
+  ShovelerComponentSystem* componentSystem =
+      g_hash_table_lookup(world->system->componentSystems, componentTypeId);
+  if (componentSystem == NULL) {
+    return NULL;
+  }
+
+  return componentSystem->activeComponents;
+}
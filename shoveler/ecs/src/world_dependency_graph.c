@@ -5,7 +5,7 @@
 #include "shoveler/file.h"
 #include "shoveler/world.h"
 
-GString* ShovelerWorldCreateDependencyGraph(ShovelerWorld* world) {
+GString* shovelerWorldDependencyGraphCreate(ShovelerWorld* world) {
   GString* graph = g_string_new("");
   g_string_append(graph, "digraph G {\n");
   g_string_append(graph, "	rankdir = \"LR\";\n");
@@ -72,7 +72,7 @@ GString* ShovelerWorldCreateDependencyGraph(ShovelerWorld* world) {
 }
 
 bool shovelerWorldDependencyGraphWrite(ShovelerWorld* world, const char* filename) {
-  GString* graph = ShovelerWorldCreateDependencyGraph(world);
+  GString* graph = shovelerWorldDependencyGraphCreate(world);
   bool success = shovelerFileWriteString(filename, graph->str);
   g_string_free(graph, true);
   return success;
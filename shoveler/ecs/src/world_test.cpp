@@ -41,6 +41,12 @@ static void dependencyCallback(
     const ShovelerEntityComponentId* dependencyTarget,
     bool added,
     void* userData);
+static void removeEntitiesCallback(
+    ShovelerWorld* world,
+    int numEntityIds,
+    const long long int* entityIds,
+    int numRemovedDependencies,
+    void* userData);
 
 static void* activateComponent(ShovelerComponent* component, void* userData);
 static void deactivateComponent(ShovelerComponent* component, void* userData);
@@ -103,6 +109,7 @@ public:
 
     world = shovelerWorldCreate(schema, system, updateAuthoritativeComponent, this);
     shovelerWorldAddDependencyCallback(world, dependencyCallback, this);
+    shovelerWorldAddRemoveEntitiesCallback(world, removeEntitiesCallback, this);
   }
 
   virtual void TearDown() {
@@ -125,6 +132,8 @@ public:
   std::vector<UpdateAuthoritativeComponentCall> updateAuthoritativeComponentCalls;
 
   std::vector<DependencyCallbackCall> dependencyCallbackCalls;
+  std::vector<long long int> removeEntitiesCallbackEntityIds;
+  std::vector<int> removeEntitiesCallbackNumRemovedDependencies;
   std::vector<ShovelerComponent*> activateCalls;
   std::vector<ShovelerComponent*> deactivateCalls;
 };
@@ -216,6 +225,87 @@ TEST_F(ShovelerWorldTest, addRemoveDependency) {
   ASSERT_THAT(deactivateCalls, ElementsAre(component1));
 }
 
+TEST_F(ShovelerWorldTest, removeEntities) {
+  const long long int entityId3 = 3;
+  ShovelerWorldEntity* entity1 = shovelerWorldAddEntity(world, entityId1);
+  ShovelerWorldEntity* entity2 = shovelerWorldAddEntity(world, entityId2);
+  ShovelerWorldEntity* entity3 = shovelerWorldAddEntity(world, entityId3);
+  ShovelerComponent* component1 = shovelerWorldEntityAddComponent(entity1, componentType2Id);
+  ShovelerComponent* component2 = shovelerWorldEntityAddComponent(entity2, componentType1Id);
+  ShovelerComponent* component3 = shovelerWorldEntityAddComponent(entity3, componentType1Id);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      component2, COMPONENT_TYPE_1_FIELD_DEPENDENCY_REACTIVATE, entityId1);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      component3, COMPONENT_TYPE_1_FIELD_DEPENDENCY_REACTIVATE, entityId1);
+  shovelerComponentActivate(component1);
+  ASSERT_TRUE(shovelerComponentIsActive(component2));
+  ASSERT_TRUE(shovelerComponentIsActive(component3));
+  dependencyCallbackCalls.clear();
+  deactivateCalls.clear();
+
+  const long long int entityIds[] = {entityId1, entityId2, 1337, entityId1};
+  int numRemoved = shovelerWorldRemoveEntities(world, 4, entityIds);
+
+  ASSERT_EQ(numRemoved, 2);
+  ASSERT_EQ(deactivateCalls.size(), 3);
+  ASSERT_EQ(deactivateCalls.back(), component1)
+      << "reverse dependencies must be deactivated first";
+  ASSERT_FALSE(shovelerComponentIsActive(component3));
+  ASSERT_THAT(dependencyCallbackCalls, IsEmpty());
+  ASSERT_THAT(removeEntitiesCallbackEntityIds, ElementsAre(entityId1, entityId2));
+  ASSERT_THAT(removeEntitiesCallbackNumRemovedDependencies, ElementsAre(1));
+  ASSERT_EQ(shovelerWorldGetEntity(world, entityId1), nullptr);
+  ASSERT_EQ(shovelerWorldGetEntity(world, entityId2), nullptr);
+  ASSERT_EQ(shovelerWorldGetEntity(world, entityId3), entity3);
+  ASSERT_EQ(world->numComponents, 1);
+  ASSERT_EQ(world->numComponentDependencies, 1)
+      << "dependencies of remaining entities on removed ones must be kept";
+
+  // re-adding the dependency must reactivate the remaining dependent
+  entity1 = shovelerWorldAddEntity(world, entityId1);
+  component1 = shovelerWorldEntityAddComponent(entity1, componentType2Id);
+  shovelerComponentActivate(component1);
+  ASSERT_TRUE(shovelerComponentIsActive(component3));
+}
+
+TEST_F(ShovelerWorldTest, queryComponents) {
+  ShovelerWorldEntity* entity1 = shovelerWorldAddEntity(world, entityId1);
+  ShovelerWorldEntity* entity2 = shovelerWorldAddEntity(world, entityId2);
+  ShovelerComponent* component1 = shovelerWorldEntityAddComponent(entity1, componentType2Id);
+  ShovelerComponent* component2 = shovelerWorldEntityAddComponent(entity2, componentType2Id);
+  shovelerComponentActivate(component1);
+  shovelerComponentActivate(component2);
+  shovelerComponentDeactivate(component1);
+
+  std::vector<ShovelerComponent*> components;
+  ShovelerWorldQuery query = shovelerWorldQueryComponents(world, componentType2Id);
+  while (shovelerWorldQueryNext(&query)) {
+    components.push_back(query.component);
+  }
+
+  ASSERT_THAT(components, ElementsAre(component2));
+  ASSERT_EQ(shovelerWorldGetNumActiveComponents(world, componentType2Id), 1);
+  ASSERT_EQ(shovelerWorldGetNumActiveComponents(world, componentType3Id), 0);
+}
+
+TEST_F(ShovelerWorldTest, queryEntities) {
+  ShovelerWorldEntity* entity1 = shovelerWorldAddEntity(world, entityId1);
+  ShovelerWorldEntity* entity2 = shovelerWorldAddEntity(world, entityId2);
+  shovelerComponentActivate(shovelerWorldEntityAddComponent(entity1, componentType2Id));
+  shovelerComponentActivate(shovelerWorldEntityAddComponent(entity1, componentType3Id));
+  shovelerComponentActivate(shovelerWorldEntityAddComponent(entity2, componentType2Id));
+  shovelerWorldEntityAddComponent(entity2, componentType3Id);
+
+  const char* componentTypeIds[] = {componentType2Id, componentType3Id};
+  std::vector<ShovelerWorldEntity*> entities;
+  ShovelerWorldQuery query = shovelerWorldQueryEntities(world, 2, componentTypeIds);
+  while (shovelerWorldQueryNext(&query)) {
+    entities.push_back(query.entity);
+  }
+
+  ASSERT_THAT(entities, ElementsAre(entity1));
+}
+
 static void updateAuthoritativeComponent(
     ShovelerWorld* world,
     ShovelerComponent* component,
@@ -238,6 +328,18 @@ static void dependencyCallback(
       DependencyCallbackCall{world, *dependencySource, *dependencyTarget, added});
 }
 
+static void removeEntitiesCallback(
+    ShovelerWorld* world,
+    int numEntityIds,
+    const long long int* entityIds,
+    int numRemovedDependencies,
+    void* testPointer) {
+  ShovelerWorldTest* test = (ShovelerWorldTest*) testPointer;
+  test->removeEntitiesCallbackEntityIds.insert(
+      test->removeEntitiesCallbackEntityIds.end(), entityIds, entityIds + numEntityIds);
+  test->removeEntitiesCallbackNumRemovedDependencies.emplace_back(numRemovedDependencies);
+}
+
 static void* activateComponent(ShovelerComponent* component, void* testPointer) {
   ShovelerWorldTest* test = (ShovelerWorldTest*) testPointer;
   test->activateCalls.emplace_back(component);
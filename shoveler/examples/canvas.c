@@ -44,6 +44,7 @@ int main(int argc, char *argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, 1);
@@ -96,8 +97,8 @@ int main(int argc, char *argv[])
 
 	ShovelerMaterial *tileSpriteMaterial = shovelerMaterialTileSpriteCreate(game->shaderCache, /* screenspace */ false);
 	ShovelerSprite *tileSprite = shovelerSpriteTileCreate(tileSpriteMaterial, tileset, /* tilesetRow */ 1, /* tilesetColumn */ 1);
-	tileSprite->position = shovelerVector2(-0.3f, -0.2f);
-	tileSprite->size = shovelerVector2(0.25f, 0.4f);
+	shovelerSpriteUpdatePosition(tileSprite, shovelerVector2(-0.3f, -0.2f));
+	shovelerSpriteUpdateSize(tileSprite, shovelerVector2(0.25f, 0.4f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 0, tileSprite);
 
 	ShovelerCollider2 tileBoxCollider = shovelerColliderBox2(shovelerBoundingBox2(
@@ -106,8 +107,8 @@ int main(int argc, char *argv[])
 	shovelerCollidersAddCollider2(game->colliders, &tileBoxCollider);
 
 	characterSprite = shovelerSpriteTileCreate(tileSpriteMaterial, animationTileset, /* tilesetRow */ 0, /* tilesetColumn */ 0);
-	characterSprite->position = shovelerVector2(0.0f, 0.0f);
-	characterSprite->size = shovelerVector2(0.2f, 0.2f);
+	shovelerSpriteUpdatePosition(characterSprite, shovelerVector2(0.0f, 0.0f));
+	shovelerSpriteUpdateSize(characterSprite, shovelerVector2(0.2f, 0.2f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 0, characterSprite);
 
 	animation = shovelerTileSpriteAnimationCreate(characterSprite, shovelerVector2(0.0f, 0.0f), 0.1f);
@@ -156,6 +157,5 @@ static void shovelerSampleUpdate(ShovelerGame *game, double dt)
 	float moveAmountY = controller->frame.position.values[1] - characterSprite->position.values[1];
 	shovelerTileSpriteAnimationUpdate(animation, shovelerVector2(moveAmountX, moveAmountY));
 
-	characterSprite->position.values[0] = controller->frame.position.values[0];
-	characterSprite->position.values[1] = controller->frame.position.values[1];
+	shovelerSpriteUpdatePosition(characterSprite, shovelerVector2(controller->frame.position.values[0], controller->frame.position.values[1]));
 }
@@ -45,6 +45,7 @@ int main(int argc, char *argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, 10);
@@ -91,12 +92,12 @@ int main(int argc, char *argv[])
 	shovelerImageGet(tilesImage, 1, 1, 0) = 0;
 	shovelerImageGet(tilesImage, 1, 1, 1) = 0;
 	shovelerImageGet(tilesImage, 1, 1, 2) = 2; // full tileset
-	ShovelerTexture *tilesTexture = shovelerTextureCreate2d(tilesImage, true);
+	ShovelerTexture *tilesTexture = shovelerTextureCreate2dWithoutMipmaps(tilesImage, true);
 	shovelerTextureUpdate(tilesTexture);
-	bool collidingTiles[4] = {false, false, false, true};
+	unsigned char collidingTiles[4] = {0, 0, 0, 1};
 	ShovelerTilemap *tilemap = shovelerTilemapCreate(tilesTexture, collidingTiles);
 	ShovelerSprite *tilemapSprite = shovelerSpriteTilemapCreate(tilemapMaterial, tilemap);
-	tilemapSprite->size = shovelerVector2(10.0f, 10.0f);
+	shovelerSpriteUpdateSize(tilemapSprite, shovelerVector2(10.0f, 10.0f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 0, tilemapSprite);
 	shovelerCollidersAddCollider2(game->colliders, &tilemapSprite->collider);
 
@@ -105,11 +106,11 @@ int main(int argc, char *argv[])
 	shovelerImageGet(borderTilesImage, 0, 0, 0) = 0;
 	shovelerImageGet(borderTilesImage, 0, 0, 1) = 0;
 	shovelerImageGet(borderTilesImage, 0, 0, 2) = 1; // full tileset
-	ShovelerTexture *borderTilesTexture = shovelerTextureCreate2d(borderTilesImage, true);
+	ShovelerTexture *borderTilesTexture = shovelerTextureCreate2dWithoutMipmaps(borderTilesImage, true);
 	shovelerTextureUpdate(borderTilesTexture);
 	ShovelerTilemap *borderTilemap = shovelerTilemapCreate(borderTilesTexture, NULL);
 	ShovelerSprite *borderTilemapSprite = shovelerSpriteTilemapCreate(tilemapMaterial, borderTilemap);
-	borderTilemapSprite->size = shovelerVector2(10.0f, 10.0f);
+	shovelerSpriteUpdateSize(borderTilemapSprite, shovelerVector2(10.0f, 10.0f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 2, borderTilemapSprite);
 	shovelerCollidersAddCollider2(game->colliders, &borderTilemapSprite->collider);
 
@@ -142,13 +143,13 @@ int main(int argc, char *argv[])
 
 	ShovelerMaterial *tileSpriteMaterial = shovelerMaterialTileSpriteCreate(game->shaderCache, /* screenspace */ false);
 	ShovelerSprite *tileSprite = shovelerSpriteTileCreate(tileSpriteMaterial, tileset, /* tilesetRow */ 0, /* tilesetColumn */ 1);
-	tileSprite->position = shovelerVector2(-1.5f, -1.5f);
-	tileSprite->size = shovelerVector2(5.0f, 5.0f);
+	shovelerSpriteUpdatePosition(tileSprite, shovelerVector2(-1.5f, -1.5f));
+	shovelerSpriteUpdateSize(tileSprite, shovelerVector2(5.0f, 5.0f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 1, tileSprite);
 
 	characterSprite = shovelerSpriteTileCreate(tileSpriteMaterial, animationTileset, /* tilesetRow */ 0, /* tilesetColumn */ 0);
-	characterSprite->position = shovelerVector2(0.0f, 0.0f);
-	characterSprite->size = shovelerVector2(1.0f, 1.0f);
+	shovelerSpriteUpdatePosition(characterSprite, shovelerVector2(0.0f, 0.0f));
+	shovelerSpriteUpdateSize(characterSprite, shovelerVector2(1.0f, 1.0f));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 1, characterSprite);
 
 	animation = shovelerTileSpriteAnimationCreate(characterSprite, shovelerVector2(0.0f, 0.0f), 0.1f);
@@ -209,6 +210,5 @@ static void updateGame(ShovelerGame *game, double dt)
 	float moveAmountY = controller->frame.position.values[1] - characterWorldY;
 	shovelerTileSpriteAnimationUpdate(animation, shovelerVector2(moveAmountX, moveAmountY));
 
-	characterSprite->position.values[0] = controller->frame.position.values[0];
-	characterSprite->position.values[1] = controller->frame.position.values[1];
+	shovelerSpriteUpdatePosition(characterSprite, shovelerVector2(controller->frame.position.values[0], controller->frame.position.values[1]));
 }
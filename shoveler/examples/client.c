@@ -17,6 +17,7 @@
 #include <shoveler/resources.h>
 #include <shoveler/resources/image_png.h>
 #include <shoveler/scene.h>
+#include <shoveler/shader_program.h>
 #include <shoveler/schema/base.h>
 #include <shoveler/schema/opengl.h>
 #include <shoveler/types.h>
@@ -35,6 +36,7 @@ static void updateAuthoritativeComponent(
     const ShovelerComponentFieldValue* value,
     void* userData);
 
+static ShovelerClientSystem* clientSystem = NULL;
 static ShovelerWorld* world = NULL;
 
 int main(int argc, char* argv[]) {
@@ -45,6 +47,7 @@ int main(int argc, char* argv[]) {
   windowSettings.samples = 4;
   windowSettings.windowedWidth = 640;
   windowSettings.windowedHeight = 480;
+  windowSettings.headless = false;
 
   ShovelerGameCameraSettings cameraSettings;
   cameraSettings.frame.position = shovelerVector3(0, 0, -5);
@@ -66,13 +69,18 @@ int main(int argc, char* argv[]) {
   shovelerLogInit("shoveler/", SHOVELER_LOG_LEVEL_INFO_UP, stdout);
   shovelerGlobalInit();
 
+  if (argc > 1) {
+    // optional existing directory to keep linked shader program binaries in across runs
+    shovelerShaderProgramEnableBinaryCache(argv[1]);
+  }
+
   ShovelerGame* game =
       shovelerGameCreate(updateGame, &windowSettings, &cameraSettings, &controllerSettings);
   if (game == NULL) {
     return EXIT_FAILURE;
   }
 
-  ShovelerClientSystem* clientSystem = shovelerClientSystemCreate(
+  clientSystem = shovelerClientSystemCreate(
       game,
       updateAuthoritativeComponent,
       /* updateAuthoritativeComponentUserData */ NULL);
@@ -882,6 +890,68 @@ int main(int argc, char* argv[]) {
   shovelerComponentDelegate(clientPositionComponent);
   shovelerComponentActivate(clientPositionComponent);
 
+  ShovelerWorldEntity* tilesEntity = shovelerWorldAddEntity(world, 24);
+  ShovelerComponent* tilesDrawableComponent =
+      shovelerWorldEntityAddComponent(tilesEntity, shovelerComponentTypeIdDrawable);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesDrawableComponent,
+      SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TYPE,
+      SHOVELER_COMPONENT_DRAWABLE_TYPE_TILES);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesDrawableComponent, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_WIDTH, 2);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesDrawableComponent, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_HEIGHT, 2);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      tilesDrawableComponent, SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES, 8);
+  shovelerComponentActivate(tilesDrawableComponent);
+  ShovelerComponent* tilesMaterialComponent =
+      shovelerWorldEntityAddComponent(tilesEntity, shovelerComponentTypeIdMaterial);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesMaterialComponent,
+      SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TYPE,
+      SHOVELER_COMPONENT_MATERIAL_TYPE_TILES);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      tilesMaterialComponent, SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TILESET, 10);
+  shovelerComponentActivate(tilesMaterialComponent);
+  ShovelerComponent* tilesModelComponent =
+      shovelerWorldEntityAddComponent(tilesEntity, shovelerComponentTypeIdModel);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_POSITION, 24);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_DRAWABLE, 24);
+  shovelerComponentUpdateCanonicalFieldEntityId(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_MATERIAL, 24);
+  shovelerComponentUpdateCanonicalFieldVector3(
+      tilesModelComponent,
+      SHOVELER_COMPONENT_MODEL_FIELD_ID_ROTATION,
+      shovelerVector3(SHOVELER_PI, 0.0f, SHOVELER_PI));
+  shovelerComponentUpdateCanonicalFieldVector3(
+      tilesModelComponent,
+      SHOVELER_COMPONENT_MODEL_FIELD_ID_SCALE,
+      shovelerVector3(0.5f, 0.5f, 1.0f));
+  shovelerComponentUpdateCanonicalFieldBool(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_VISIBLE, true);
+  shovelerComponentUpdateCanonicalFieldBool(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_EMITTER, false);
+  shovelerComponentUpdateCanonicalFieldBool(
+      tilesModelComponent, SHOVELER_COMPONENT_MODEL_FIELD_ID_CASTS_SHADOW, true);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesModelComponent,
+      SHOVELER_COMPONENT_MODEL_FIELD_ID_POLYGON_MODE,
+      SHOVELER_COMPONENT_MODEL_POLYGON_MODE_FILL);
+  shovelerComponentActivate(tilesModelComponent);
+  ShovelerComponent* tilesPositionComponent =
+      shovelerWorldEntityAddComponent(tilesEntity, shovelerComponentTypeIdPosition);
+  shovelerComponentUpdateCanonicalFieldInt(
+      tilesPositionComponent,
+      SHOVELER_COMPONENT_POSITION_FIELD_ID_TYPE,
+      SHOVELER_COMPONENT_POSITION_TYPE_ABSOLUTE);
+  shovelerComponentUpdateCanonicalFieldVector3(
+      tilesPositionComponent,
+      SHOVELER_COMPONENT_POSITION_FIELD_ID_COORDINATES,
+      shovelerVector3(0.0f, -5.0f, 7.5f));
+  shovelerComponentActivate(tilesPositionComponent);
+
   shovelerOpenGLCheckSuccess();
 
   while (shovelerGameIsRunning(game)) {
@@ -913,6 +983,7 @@ static GString* getImageData(ShovelerImage* image) {
 }
 
 static void updateGame(ShovelerGame* game, double dt) {
+  shovelerClientSystemUpdate(clientSystem, dt);
   shovelerCameraUpdateView(game->camera);
 
   time += dt;
@@ -37,6 +37,7 @@ static void updateAuthoritativeComponent(
 	const ShovelerComponentFieldValue* value,
 	void* userData);
 
+static ShovelerClientSystem* clientSystem = NULL;
 static ShovelerWorld* world = NULL;
 
 int main(int argc, char* argv[])
@@ -65,6 +66,7 @@ int main(int argc, char* argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, -5);
@@ -87,7 +89,7 @@ int main(int argc, char* argv[])
 		return EXIT_FAILURE;
 	}
 
-	ShovelerClientSystem* clientSystem = shovelerClientSystemCreate(
+	clientSystem = shovelerClientSystemCreate(
 		game,
 		updateAuthoritativeComponent,
 		/* updateAuthoritativeComponentUserData */ NULL);
@@ -171,6 +173,7 @@ int main(int argc, char* argv[])
 
 static void updateGame(ShovelerGame* game, double dt)
 {
+	shovelerClientSystemUpdate(clientSystem, dt);
 	shovelerCameraUpdateView(game->camera);
 }
 
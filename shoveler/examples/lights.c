@@ -52,6 +52,7 @@ int main(int argc, char *argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, -5);
@@ -1,4 +1,6 @@
+#include <stdbool.h> // bool
 #include <stdlib.h> // EXIT_FAILURE, EXIT_SUCCESS
+#include <string.h> // strcmp
 
 #include <glib.h>
 #include <glad/glad.h>
@@ -46,8 +48,9 @@ int main(int argc, char *argv[])
 	shovelerLogInit("shoveler/", SHOVELER_LOG_LEVEL_INFO_UP, stdout);
 	shovelerGlobalInit();
 
-	if(argc != 2) {
-		shovelerLogError("Usage: %s [font file]", argv[0]);
+	bool signedDistanceField = argc == 3 && strcmp(argv[2], "--signed-distance-field") == 0;
+	if(argc != 2 && !signedDistanceField) {
+		shovelerLogError("Usage: %s [font file] [--signed-distance-field]", argv[0]);
 		return EXIT_FAILURE;
 	}
 
@@ -67,6 +70,7 @@ int main(int argc, char *argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, 1);
@@ -96,16 +100,25 @@ int main(int argc, char *argv[])
 
 	ShovelerCanvas *canvas = shovelerCanvasCreate(/* numLayers */ 1);
 
-	ShovelerFontAtlas *fontAtlas = shovelerFontAtlasCreate(font, /* fontSize */ 48, /* padding */ 1);
+	// a signed distance field atlas stays crisp when the text is scaled, e.g. by moving the camera closer to it
+	ShovelerFontAtlas *fontAtlas;
+	if(signedDistanceField) {
+		fontAtlas = shovelerFontAtlasCreateSignedDistanceField(font, /* fontSize */ 48, /* padding */ 1, /* spread */ 8);
+	} else {
+		fontAtlas = shovelerFontAtlasCreate(font, /* fontSize */ 48, /* padding */ 1);
+	}
+	shovelerFontAtlasPrewarm(fontAtlas, SHOVELER_FONT_ATLAS_PRINTABLE_ASCII);
 	fontAtlasTexture = shovelerFontAtlasTextureCreate(fontAtlas);
+	shovelerGameSetProfilerOverlayFont(game, fontAtlasTexture);
 
 	ShovelerTextTextureRenderer *textTextureRenderer = shovelerTextTextureRendererCreate(fontAtlasTexture, game->shaderCache);
-	ShovelerTexture *shovelerTextTexture = shovelerTextTextureRendererRender(textTextureRenderer, "shoveler", &game->renderState);
+	ShovelerTextTexture *shovelerTextTexture = shovelerTextTextureRendererRender(textTextureRenderer, "shoveler", &game->renderState);
 	ShovelerSampler *textureSampler = shovelerSamplerCreate(/* interpolate */ true, /* useMipmaps */ true, /* clamp */ true);
 
 	ShovelerMaterial *textureSpriteMaterial = shovelerMaterialTextureSpriteCreate(game->shaderCache, /* screenspace */ false, SHOVELER_MATERIAL_TEXTURE_SPRITE_TYPE_ALPHA_MASK);
 	shovelerMaterialTextureSpriteSetColor(textureSpriteMaterial, shovelerVector4(0.0f, 1.0f, 0.0f, 1.0f));
-	ShovelerSprite *textSprite = shovelerSpriteTextureCreate(textureSpriteMaterial, shovelerTextTexture, textureSampler);
+	ShovelerSprite *textSprite = shovelerSpriteTextureCreate(textureSpriteMaterial, shovelerTextTexture->texture, textureSampler);
+	shovelerSpriteTextureSetTextureRegion(textSprite, shovelerTextTextureGetUvPosition(shovelerTextTexture), shovelerTextTextureGetUvSize(shovelerTextTexture));
 	shovelerSpriteUpdatePosition(textSprite, shovelerVector2(0.5f, 0.5f));
 	shovelerSpriteUpdateSize(textSprite, shovelerVector2(1.0f, (float) shovelerTextTexture->height / shovelerTextTexture->width));
 	shovelerCanvasAddSprite(canvas, /* layerId */ 0, textSprite);
@@ -142,7 +155,7 @@ int main(int argc, char *argv[])
 	shovelerSpriteFree(screenspaceTextSprite);
 	shovelerSpriteFree(textSprite);
 	shovelerSamplerFree(textureSampler);
-	shovelerTextureFree(shovelerTextTexture);
+	shovelerTextTextureRendererRelease(textTextureRenderer, shovelerTextTexture);
 	shovelerTextTextureRendererFree(textTextureRenderer);
 	shovelerFontAtlasTextureFree(fontAtlasTexture);
 	shovelerFontAtlasFree(fontAtlas);
@@ -169,7 +182,7 @@ static void shovelerSampleUpdate(ShovelerGame *game, double dt)
 		g_string_set_size(fpsString, 0);
 		g_string_append_printf(fpsString, "FPS: %.1f", exponentialAverageFps);
 		shovelerSpriteTextSetContent(screenspaceTextSprite, fpsString->str, /* copyContent */ false);
-		screenspaceTextSprite->position = shovelerVector2(10.0f, game->framebuffer->height - 48.0f - 10.0f);
+		shovelerSpriteUpdatePosition(screenspaceTextSprite, shovelerVector2(10.0f, game->framebuffer->height - 48.0f - 10.0f));
 
 		for(const char *c = fpsString->str; *c != '\0'; c++) {
 			unsigned char character = *((unsigned char *) c);
@@ -35,6 +35,7 @@ int main(int argc, char *argv[])
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	ShovelerGameCameraSettings cameraSettings;
 	cameraSettings.frame.position = shovelerVector3(0, 0, 1);
@@ -86,7 +87,7 @@ int main(int argc, char *argv[])
 	shovelerImageGet(tilesImage, 1, 1, 0) = 0;
 	shovelerImageGet(tilesImage, 1, 1, 1) = 0;
 	shovelerImageGet(tilesImage, 1, 1, 2) = 2; // full tileset
-	ShovelerTexture *tiles = shovelerTextureCreate2d(tilesImage, true);
+	ShovelerTexture *tiles = shovelerTextureCreate2dWithoutMipmaps(tilesImage, true);
 	shovelerTextureUpdate(tiles);
 
 	ShovelerTilemap *tilemap = shovelerTilemapCreate(tiles, NULL);
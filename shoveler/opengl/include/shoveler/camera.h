@@ -3,8 +3,24 @@
 
 #include <shoveler/frustum.h>
 #include <shoveler/types.h>
+#include <shoveler/uniform_buffer.h>
 #include <shoveler/uniform_map.h>
 
+/** GLSL declaration of the std140 uniform block matching ShovelerCameraUniformBlock. */
+#define SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE \
+	"layout(std140, row_major) uniform Camera {\n" \
+	"	mat4 view;\n" \
+	"	mat4 projection;\n" \
+	"	vec3 cameraPosition;\n" \
+	"};\n"
+
+typedef struct {
+	ShovelerMatrix view;
+	ShovelerMatrix projection;
+	ShovelerVector3 position;
+	float padding;
+} ShovelerCameraUniformBlock;
+
 struct ShovelerCameraStruct;
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
@@ -18,6 +34,8 @@ typedef struct ShovelerCameraStruct {
 	ShovelerMatrix view;
 	ShovelerMatrix projection;
 	ShovelerUniformMap *uniforms;
+	/** backs the "Camera" uniform block, shared by all programs using this camera */
+	ShovelerUniformBuffer *uniformBuffer;
 	void *data;
 	ShovelerCameraUpdateViewFunction *updateView;
 	ShovelerCameraFreeDataFunction *freeData;
@@ -16,12 +16,40 @@ typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.
 typedef struct ShovelerRenderStateStruct ShovelerRenderState; // forward declaration: render_state.h
 typedef struct ShovelerSceneStruct ShovelerScene; // forward declaration: scene.h
 typedef struct ShovelerSpriteStruct ShovelerSprite; // forward declaration: sprite.h
+typedef struct ShovelerSpriteBatchStruct ShovelerSpriteBatch; // forward declaration: sprite_batch.h
+
+/** side length of the square cells sprites are indexed by for visibility and collision queries */
+#define SHOVELER_CANVAS_CELL_SIZE 2.0f
+/** number of cells above which a sprite is tested by every query instead of being indexed in each of them */
+#define SHOVELER_CANVAS_MAX_SPRITE_CELLS 64
+
+/** Uniform grid index of the sprites in a canvas layer, kept up to date as sprites move. */
+typedef struct {
+	/** map from (ShovelerSprite *) to their (ShovelerCanvasSpriteEntry *) */
+	GHashTable *entries;
+	/** map from (gint64 *) cell coordinates to their (ShovelerCanvasCell *) */
+	GHashTable *cells;
+	/** queue of (ShovelerCanvasSpriteEntry *) spanning too many cells to be indexed in them */
+	GQueue *largeEntries;
+	unsigned int nextOrder;
+	unsigned int queryStamp;
+} ShovelerCanvasLayerIndex;
 
 typedef struct ShovelerCanvasStruct {
 	ShovelerCollider2 collider;
 	int numLayers;
 	/** array of size numLayers, wher each element is a list of (ShovelerSprite *) */
 	GQueue **layers;
+	/** whether consecutive sprites supporting it are drawn in batches, which requires the canvas to be rendered onto a quad */
+	bool batchSprites;
+	/** array of size numLayers with the spatial index of each layer */
+	/* private */ ShovelerCanvasLayerIndex *layerIndices;
+	/** array of (ShovelerCanvasSpriteEntry *) found by the last query, reused across queries */
+	/* private */ GArray *queryEntries;
+	/** array of (ShovelerSprite *) visible in the region being rendered, in the order they are drawn */
+	/* private */ GArray *renderSprites;
+	/** created on the first batched render, since it requires a GL context */
+	/* private */ ShovelerSpriteBatch *spriteBatch;
 } ShovelerCanvas;
 
 ShovelerCanvas *shovelerCanvasCreate(int numLayers);
@@ -29,6 +57,8 @@ ShovelerCanvas *shovelerCanvasCreate(int numLayers);
 void shovelerCanvasAddSprite(ShovelerCanvas *canvas, int layerId, ShovelerSprite *sprite);
 /** Removes a sprite from a given layer of the canvas. */
 bool shovelerCanvasRemoveSprite(ShovelerCanvas *canvas, int layerId, ShovelerSprite *sprite);
+/** Moves a sprite to the cells covered by its current bounding box, called whenever an added sprite's position or size changes. */
+void shovelerCanvasUpdateSprite(ShovelerCanvas *canvas, ShovelerSprite *sprite);
 bool shovelerCanvasRender(ShovelerCanvas *canvas, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 void shovelerCanvasFree(ShovelerCanvas *canvas);
 
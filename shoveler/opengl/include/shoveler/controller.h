@@ -67,7 +67,11 @@ typedef struct ShovelerControllerStruct {
 	ShovelerInputWindowSizeCallback *windowSizeCallback;
 } ShovelerController;
 
-/** Create a controller using a window and an input system from an initial reference frame that is copied. */
+/**
+ * Create a controller using a window and an input system from an initial reference frame that is copied.
+ *
+ * The window may be NULL for games without one, in which case the controller never moves on its own.
+ */
 ShovelerController *shovelerControllerCreate(GLFWwindow *window, ShovelerInput *input, struct ShovelerCollidersStruct *colliders, const ShovelerReferenceFrame *frame, float moveFactor, float tiltFactor, float boundingBoxSize2, float boundingBoxSize3);
 ShovelerControllerTiltCallback *shovelerControllerAddTiltCallback(ShovelerController *controller, ShovelerControllerTiltCallbackFunction *callbackFunction, void *userData);
 bool shovelerControllerRemoveTiltCallback(ShovelerController *controller, ShovelerControllerTiltCallback *tiltCallback);
@@ -4,21 +4,35 @@
 #include <stdbool.h> // bool
 
 struct ShovelerDrawableStruct;
+struct ShovelerInstanceBufferStruct; // forward declaration: instance_buffer.h
 
 typedef bool (ShovelerDrawableDrawFunction)(struct ShovelerDrawableStruct *drawable);
+typedef bool (ShovelerDrawableDrawInstancedFunction)(struct ShovelerDrawableStruct *drawable, struct ShovelerInstanceBufferStruct *instanceBuffer);
 typedef void (ShovelerDrawableFreeFunction)(struct ShovelerDrawableStruct *drawable);
 
 typedef struct ShovelerDrawableStruct {
+	/** sequential id assigned on initialization, e.g. to group draws by drawable */
+	unsigned int id;
 	ShovelerDrawableDrawFunction *draw;
+	/** draws all instances of an uploaded instance buffer at once, or NULL if not supported */
+	ShovelerDrawableDrawInstancedFunction *drawInstanced;
 	ShovelerDrawableFreeFunction *free;
 	void *data;
 } ShovelerDrawable;
 
+/** Initializes a drawable, assigning it the next sequential id. */
+void shovelerDrawableInit(ShovelerDrawable *drawable, ShovelerDrawableDrawFunction *draw, ShovelerDrawableDrawInstancedFunction *drawInstanced, ShovelerDrawableFreeFunction *free, void *data);
+
 static inline bool shovelerDrawableDraw(ShovelerDrawable *drawable)
 {
 	return drawable->draw(drawable);
 }
 
+static inline bool shovelerDrawableDrawInstanced(ShovelerDrawable *drawable, struct ShovelerInstanceBufferStruct *instanceBuffer)
+{
+	return drawable->drawInstanced(drawable, instanceBuffer);
+}
+
 static inline void shovelerDrawableFree(ShovelerDrawable *drawable)
 {
 	drawable->free(drawable);
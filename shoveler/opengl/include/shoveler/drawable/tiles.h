@@ -1,8 +1,41 @@
 #ifndef SHOVELER_DRAWABLE_TILES_H
 #define SHOVELER_DRAWABLE_TILES_H
 
+#include <stdbool.h> // bool
+
 #include <shoveler/drawable.h>
 
+typedef struct {
+	unsigned char tilesetColumn;
+	unsigned char tilesetRow;
+	/** one plus the layer of the tileset array to take the tile from, or zero for an empty tile */
+	unsigned char tilesetId;
+} ShovelerDrawableTilesTile;
+
+/**
+ * Creates a drawable of width times height unit tiles starting at the origin, all initially empty.
+ *
+ * Instead of building vertices for every tile, the tiles are kept in a persistent per-instance buffer and a single quad
+ * is instanced once per tile. Only materials expanding the quads in their vertex shader, like the tiles material, draw
+ * them at their positions.
+ */
 ShovelerDrawable *shovelerDrawableTilesCreate(unsigned char width, unsigned char height);
+/**
+ * Creates a drawable of numChunks chunks of chunkWidth times chunkHeight tiles each, which share a single tile buffer
+ * and are drawn together in one multi-draw call. All chunks initially start at the origin and are visible.
+ */
+ShovelerDrawable *shovelerDrawableTilesCreateChunked(unsigned char chunkWidth, unsigned char chunkHeight, int numChunks);
+/** Returns whether a drawable was created by this module, e.g. for depth materials to expand its tiles. */
+bool shovelerDrawableIsTiles(ShovelerDrawable *drawable);
+/** Moves a chunk to start at the passed tile coordinates, uploading only that chunk's part of the tile buffer. */
+bool shovelerDrawableTilesSetChunkPosition(ShovelerDrawable *tilesDrawable, int chunk, int column, int row);
+/** Sets whether a chunk is drawn, e.g. to skip chunks outside of the view without touching the tile buffer. */
+void shovelerDrawableTilesSetChunkVisible(ShovelerDrawable *tilesDrawable, int chunk, bool visible);
+/** Returns the current tile of a chunk, e.g. to only change the tiles that differ from an update. */
+ShovelerDrawableTilesTile shovelerDrawableTilesGetTile(ShovelerDrawable *tilesDrawable, int chunk, unsigned char column, unsigned char row);
+/** Changes a single tile of a chunk, uploading only its element of the tile buffer. */
+bool shovelerDrawableTilesSetTile(ShovelerDrawable *tilesDrawable, int chunk, unsigned char column, unsigned char row, ShovelerDrawableTilesTile tile);
+/** Changes all tiles of a chunk from an array with tile (column, row) at position [row * chunkWidth + column]. */
+bool shovelerDrawableTilesSetChunkTiles(ShovelerDrawable *tilesDrawable, int chunk, const ShovelerDrawableTilesTile *chunkTiles);
 
 #endif
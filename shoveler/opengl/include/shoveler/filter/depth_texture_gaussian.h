@@ -1,10 +1,75 @@
 #ifndef SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_H
 #define SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_H
 
+#include <glib.h>
+
+#include <shoveler/camera.h>
+#include <shoveler/drawable.h>
 #include <shoveler/filter.h>
+#include <shoveler/framebuffer.h>
+#include <shoveler/material.h>
+#include <shoveler/model.h>
+#include <shoveler/sampler.h>
+#include <shoveler/scene.h>
 
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
+/** maximum number of shadow maps of the same resolution a filter chain filters together in one batch */
+#define SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_BATCH_LAYERS 8
+/** number of consecutive renders leaving layers of a batch unused after which it shrinks to the layers it needed */
+#define SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_SHRINK_RENDERS 60
+
+/**
+ * Filter chain blurring the depth maps of any number of lights through shared filters instead of one per light.
+ *
+ * Depth maps are rendered into layers of batches shared by all inputs with the same resolution and exponential factor,
+ * which grow by a layer whenever they run out and shrink again once layers stay unused. Each batch is lifted and
+ * blurred in X direction for all its layers in one layered pass at a resolution reduced by the downsample factor, and
+ * then blurred in Y direction straight into every layer's own output region. Batches holding a single layer skip the
+ * layered targets and filter exactly like a light on its own.
+ */
+typedef struct ShovelerFilterDepthTextureGaussianChainStruct {
+	struct ShovelerShaderCacheStruct *shaderCache;
+	/** factor by which the blur passes reduce the resolution of their input */
+	int downsample;
+	/** array of pointers to the batches created so far, which are reused across renders */
+	/* private */ GArray *batches;
+	/* private */ ShovelerSampler *filterSampler;
+	/** sampler of the Y pass interpolating layers of reduced resolution up to their outputs */
+	/* private */ ShovelerSampler *upsampleSampler;
+	/* private */ ShovelerCamera *filterCamera;
+	/* private */ ShovelerDrawable *filterQuad;
+	/* private */ ShovelerSceneRenderPassOptions filterSceneRenderPassOptions;
+} ShovelerFilterDepthTextureGaussianChain;
+
 ShovelerFilter *shovelerFilterDepthTextureGaussianCreate(struct ShovelerShaderCacheStruct *shaderCache, int width, int height, GLsizei samples, float exponentialFactor);
+/**
+ * Creates a filter blurring the first layers of an array depth texture, such as a point light's six cube faces, in one
+ * layered pass per direction.
+ */
+ShovelerFilter *shovelerFilterDepthTextureGaussianCreateLayered(struct ShovelerShaderCacheStruct *shaderCache, int width, int height, int layers, float exponentialFactor);
+/** Restricts a layered filter to the passed number of leading layers, up to the number it was created with. */
+void shovelerFilterDepthTextureGaussianSetLayers(ShovelerFilter *filter, int numLayers);
+/** Redirects the filter output into the passed single channel framebuffer of any size, or back to its own if NULL. */
+void shovelerFilterDepthTextureGaussianSetOutputFramebuffer(ShovelerFilter *filter, ShovelerFramebuffer *outputFramebuffer);
+/** Redirects the filter output into a rectangle of the passed single channel framebuffer, leaving the rest untouched. */
+void shovelerFilterDepthTextureGaussianSetOutputRegion(ShovelerFilter *filter, ShovelerFramebuffer *outputFramebuffer, GLint x, GLint y, GLsizei width, GLsizei height);
+/**
+ * Makes the filter acquire its intermediate render target from the passed pool for the duration of each render instead
+ * of keeping its own, or go back to its own if NULL. Not supported for layered filters.
+ */
+void shovelerFilterDepthTextureGaussianSetFramebufferPool(ShovelerFilter *filter, ShovelerFramebufferPool *framebufferPool);
+
+ShovelerFilterDepthTextureGaussianChain *shovelerFilterDepthTextureGaussianChainCreate(struct ShovelerShaderCacheStruct *shaderCache);
+/** Changes the downsample factor of the blur passes, dropping all batches if it differs. Must not have pending inputs. */
+void shovelerFilterDepthTextureGaussianChainSetDownsample(ShovelerFilterDepthTextureGaussianChain *chain, int downsample);
+/**
+ * Adds a single sampled depth map to be filtered into a region of the passed output framebuffer on the next render, and
+ * returns a depth only framebuffer of the passed size to render it into, which is only valid until then.
+ */
+ShovelerFramebuffer *shovelerFilterDepthTextureGaussianChainAddInput(ShovelerFilterDepthTextureGaussianChain *chain, int width, int height, float exponentialFactor, ShovelerFramebuffer *outputFramebuffer, GLint outputX, GLint outputY, GLsizei outputWidth, GLsizei outputHeight);
+/** Filters all inputs added since the last render into their output regions, one batch at a time. */
+int shovelerFilterDepthTextureGaussianChainRender(ShovelerFilterDepthTextureGaussianChain *chain, ShovelerRenderState *renderState);
+void shovelerFilterDepthTextureGaussianChainFree(ShovelerFilterDepthTextureGaussianChain *chain);
 
 #endif
@@ -13,7 +13,7 @@ typedef struct ShovelerFontAtlasTextureStruct {
 } ShovelerFontAtlasTexture;
 
 ShovelerFontAtlasTexture *shovelerFontAtlasTextureCreate(ShovelerFontAtlas *fontAtlas);
-/* Updates the font atlas texture, returning true if a new texture was generated. */
+/* Updates the font atlas texture, uploading only the glyphs added since the last update, and returning true if a new texture was generated because the atlas grew. */
 bool shovelerFontAtlasTextureUpdate(ShovelerFontAtlasTexture *fontAtlasTexture);
 void shovelerFontAtlasTextureFree(ShovelerFontAtlasTexture *fontAtlasTexture);
 
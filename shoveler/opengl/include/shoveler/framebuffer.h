@@ -4,6 +4,7 @@
 #include <stdbool.h> // bool
 
 #include <glad/glad.h>
+#include <glib.h>
 
 #include <shoveler/texture.h>
 
@@ -15,11 +16,41 @@ typedef struct ShovelerFramebufferStruct {
 	ShovelerTexture *depthTarget;
 } ShovelerFramebuffer;
 
+/** Pool of framebuffers handed out for transient use, reusing released ones created with the same parameters. */
+typedef struct ShovelerFramebufferPoolStruct {
+	/** map from framebuffer parameters to queues of released framebuffers */
+	/* private */ GHashTable *releasedFramebuffers;
+	/** map from acquired framebuffers to their parameters */
+	/* private */ GHashTable *acquiredFramebuffers;
+	/** number of framebuffers created by the pool so far */
+	int numCreated;
+} ShovelerFramebufferPool;
+
 ShovelerFramebuffer *shovelerFramebufferCreate(GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel);
 ShovelerFramebuffer *shovelerFramebufferCreateColorOnly(GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel);
 ShovelerFramebuffer *shovelerFramebufferCreateDepthOnly(GLsizei width, GLsizei height, GLsizei samples);
+/** Creates a framebuffer with all layers of an array render target attached, selected per primitive by gl_Layer. */
+ShovelerFramebuffer *shovelerFramebufferCreateColorOnlyLayered(GLsizei width, GLsizei height, GLsizei layers, int channels, int bitsPerChannel);
+/** Creates a framebuffer with all layers of an array depth target attached, selected per primitive by gl_Layer. */
+ShovelerFramebuffer *shovelerFramebufferCreateDepthOnlyLayered(GLsizei width, GLsizei height, GLsizei layers);
+/**
+ * Creates a framebuffer rendering into a single layer of the passed array depth target, which it doesn't own and which
+ * must outlive it, so it has to be freed keeping its targets.
+ */
+ShovelerFramebuffer *shovelerFramebufferCreateDepthOnlyLayer(ShovelerTexture *depthTargetArray, GLint layer);
 bool shovelerFramebufferUse(ShovelerFramebuffer *framebuffer);
+/** Binds the framebuffer with viewport and scissor restricted to a region, so that clears leave the rest untouched. */
+bool shovelerFramebufferUseRegion(ShovelerFramebuffer *framebuffer, GLint x, GLint y, GLsizei width, GLsizei height);
 bool shovelerFramebufferBlitToDefault(ShovelerFramebuffer *framebuffer);
 void shovelerFramebufferFree(ShovelerFramebuffer *framebuffer, bool keepTargets);
 
+ShovelerFramebufferPool *shovelerFramebufferPoolCreate();
+ShovelerFramebuffer *shovelerFramebufferPoolAcquire(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel);
+ShovelerFramebuffer *shovelerFramebufferPoolAcquireColorOnly(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel);
+ShovelerFramebuffer *shovelerFramebufferPoolAcquireDepthOnly(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples);
+/** Returns an acquired framebuffer to the pool, after which its targets' contents may be overwritten at any time. */
+void shovelerFramebufferPoolRelease(ShovelerFramebufferPool *pool, ShovelerFramebuffer *framebuffer);
+/** Frees the pool along with all framebuffers it created, including ones still acquired. */
+void shovelerFramebufferPoolFree(ShovelerFramebufferPool *pool);
+
 #endif
@@ -18,9 +18,19 @@
 typedef struct ShovelerCanvasStruct ShovelerCanvas; // forward declaration: canvas.h
 typedef struct ShovelerCollidersStruct ShovelerColliders; // forward declaration: colliders.h
 typedef struct ShovelerDrawableStruct ShovelerDrawable; // forward declaration: drawable.h
+typedef struct ShovelerFontAtlasTextureStruct ShovelerFontAtlasTexture; // forward declaration: font_atlas_texture.h
 typedef struct ShovelerFontsStruct ShovelerFonts; // forward declaration: font.h
 typedef struct ShovelerGameStruct ShovelerGame; // forward declaration: below
+typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
+typedef struct ShovelerProfilerStruct ShovelerProfiler; // forward declaration: profiler.h
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
+typedef struct ShovelerTextureUploaderStruct ShovelerTextureUploader; // forward declaration: texture_uploader.h
+
+/** number of texture bytes streamed to the GPU per frame by the game's texture uploader */
+#define SHOVELER_GAME_TEXTURE_UPLOAD_FRAME_BUDGET (4 * 1024 * 1024)
+/** file the profiler trace captured between two presses of F8 is written to */
+#define SHOVELER_GAME_PROFILER_TRACE_FILENAME "shoveler_trace.json"
+#define SHOVELER_GAME_PROFILER_OVERLAY_FONT_SIZE 16.0f
 
 typedef void (ShovelerGameUpdateCallback)(ShovelerGame *game, double dt);
 
@@ -31,6 +41,12 @@ typedef struct {
 	int samples;
 	bool fullscreen;
 	bool vsync;
+	/**
+	 * Renders offscreen into the game's framebuffer without showing a window or swapping buffers, e.g. to benchmark on
+	 * build machines. Uses an invisible window if possible and otherwise falls back to a surfaceless EGL context, leaving
+	 * the game without a window.
+	 */
+	bool headless;
 } ShovelerGameWindowSettings;
 
 typedef struct {
@@ -51,12 +67,18 @@ typedef struct ShovelerGameStruct {
 	int windowedHeight;
 	int samples;
 	bool fullscreen;
+	bool headless;
 	ShovelerExecutor *updateExecutor;
+	/** window receiving input, or NULL if a headless game renders with a surfaceless context */
 	GLFWwindow *window;
+	/** EGL display and context of the surfaceless context of a headless game, or NULL if the window's is used */
+	/* private */ void *surfacelessDisplay;
+	/* private */ void *surfacelessContext;
 	ShovelerRenderState renderState;
 	ShovelerInput *input;
 	ShovelerFramebuffer *framebuffer;
 	ShovelerShaderCache *shaderCache;
+	ShovelerTextureUploader *textureUploader;
 	ShovelerScene *scene;
 	ShovelerCamera *camera;
 	ShovelerColliders *colliders;
@@ -66,6 +88,15 @@ typedef struct ShovelerGameStruct {
 	ShovelerDrawable *screenspaceCanvasQuad;
 	ShovelerMaterial *screenspaceCanvasMaterial;
 	ShovelerModel *screenspaceCanvasModel;
+	/** profiler of the game's frames, toggled with F9 */
+	ShovelerProfiler *profiler;
+	struct {
+		/** font atlas texture to render the overlay with, or NULL to log the profiler results instead */
+		ShovelerFontAtlasTexture *fontAtlasTexture;
+		ShovelerMaterial *material;
+		/** array of (ShovelerSprite *) text sprites on the screenspace canvas, one per profiler scope */
+		GArray *lineSprites;
+	} profilerOverlay;
 	ShovelerGameUpdateCallback *update;
 	double lastFrameTime;
 	double lastFpsPrintTime;
@@ -82,17 +113,16 @@ typedef struct ShovelerGameStruct {
 ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const ShovelerGameWindowSettings *windowSettings, const ShovelerGameCameraSettings *cameraSettings, const ShovelerGameControllerSettings *controllerSettings);
 ShovelerGame *shovelerGameGetForWindow(GLFWwindow *window);
 void shovelerGameToggleFullscreen(ShovelerGame *game);
+/** Shows the profiler results of the last frame on the screenspace canvas while the profiler is enabled. */
+void shovelerGameSetProfilerOverlayFont(ShovelerGame *game, ShovelerFontAtlasTexture *fontAtlasTexture);
+void shovelerGameUseContext(ShovelerGame *game);
 int shovelerGameRenderFrame(ShovelerGame *game);
 void shovelerGameFree(ShovelerGame *game);
 
 static inline bool shovelerGameIsRunning(ShovelerGame *game)
 {
-	return glfwWindowShouldClose(game->window) == 0;
-}
-
-static inline void shovelerGameUseContext(ShovelerGame *game)
-{
-	glfwMakeContextCurrent(game->window);
+	// a game without a window can't be closed, so it runs until its owner stops rendering frames
+	return game->window == NULL || glfwWindowShouldClose(game->window) == 0;
 }
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef SHOVELER_INSTANCE_BUFFER_H
+#define SHOVELER_INSTANCE_BUFFER_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <glad/glad.h>
+#include <glib.h>
+
+#include <shoveler/types.h>
+
+typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
+
+typedef struct {
+	/** model transformation, transposed to match the column major attribute layout */
+	ShovelerMatrix transformation;
+	/** model normal transformation, transposed to match the column major attribute layout */
+	ShovelerMatrix normalTransformation;
+	/** color of the instance, read by materials sharing their program across colors */
+	ShovelerVector4 color;
+} ShovelerInstanceBufferInstance;
+
+typedef struct ShovelerInstanceBufferStruct {
+	GLuint buffer;
+	/* private */ size_t bufferSize;
+	/** array of (ShovelerInstanceBufferInstance) */
+	GArray *instances;
+} ShovelerInstanceBuffer;
+
+ShovelerInstanceBuffer *shovelerInstanceBufferCreate();
+void shovelerInstanceBufferClear(ShovelerInstanceBuffer *instanceBuffer);
+void shovelerInstanceBufferAddModel(ShovelerInstanceBuffer *instanceBuffer, ShovelerModel *model, ShovelerVector4 color);
+/** Uploads the added instances to the GPU buffer, growing it if needed. */
+bool shovelerInstanceBufferUpload(ShovelerInstanceBuffer *instanceBuffer);
+/** Enables the per-instance vertex attributes on the currently bound vertex array object. */
+void shovelerInstanceBufferBindAttributes(ShovelerInstanceBuffer *instanceBuffer);
+/** Disables the per-instance vertex attributes on the currently bound vertex array object again. */
+void shovelerInstanceBufferUnbindAttributes(ShovelerInstanceBuffer *instanceBuffer);
+void shovelerInstanceBufferFree(ShovelerInstanceBuffer *instanceBuffer);
+
+static inline int shovelerInstanceBufferGetNumInstances(ShovelerInstanceBuffer *instanceBuffer)
+{
+	return (int) instanceBuffer->instances->len;
+}
+
+#endif
@@ -11,17 +11,63 @@
 
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
+/** GLSL declaration of the std140 uniform block matching ShovelerLightUniformBlock. */
+#define SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE \
+	"layout(std140, row_major) uniform Light {\n" \
+	"	mat4 lightView;\n" \
+	"	mat4 lightProjection;\n" \
+	"	vec3 lightColor;\n" \
+	"	float lightAmbientFactor;\n" \
+	"	vec3 lightPosition;\n" \
+	"	float lightExponentialShadowFactor;\n" \
+	"	bool isExponentialLiftedShadowMap;\n" \
+	"	bool isShadowMapped;\n" \
+	"	vec4 lightShadowMapRegion;\n" \
+	"};\n"
+
+typedef struct {
+	ShovelerMatrix view;
+	ShovelerMatrix projection;
+	ShovelerVector3 color;
+	float ambientFactor;
+	ShovelerVector3 position;
+	float exponentialShadowFactor;
+	/** std140 bools occupy four bytes */
+	GLuint isExponentialLiftedShadowMap;
+	/** whether the light is lit with its shadow map, or otherwise lights everything within its frustum */
+	GLuint isShadowMapped;
+	GLuint padding[2];
+	/** texture coordinate offset in xy and scale in zw of the light's shadow map within the bound shadow map texture */
+	ShovelerVector4 shadowMapRegion;
+} ShovelerLightUniformBlock;
+
 typedef void (ShovelerLightUpdatePositionFunction)(void *data, ShovelerVector3 position);
 typedef ShovelerVector3 (ShovelerLightGetPositionFunction)(void *data);
+/** Returns the radius around the light's position outside of which it doesn't affect anything. */
+typedef float (ShovelerLightGetRangeFunction)(void *data);
+/**
+ * Renders the light's shadow maps if they are out of date, possibly only queueing their filtering in the scene's shadow
+ * filter chain, which the scene renders after all lights' shadow maps and before any light's render function.
+ */
+typedef int (ShovelerLightRenderShadowMapFunction)(void *data, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState);
+/** Renders the light's additive pass, lit by its shadow maps rendered earlier in the frame. */
 typedef int (ShovelerLightRenderFunction)(void *data, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState);
 typedef void (ShovelerLightFreeDataFunction)(void *data);
 
 typedef struct ShovelerLightStruct {
 	struct ShovelerShaderCacheStruct *shaderCache;
 	ShovelerUniformMap *uniforms;
+	/** whether the light is expected to move every frame, which skips checking if its cached shadow maps are valid */
+	bool dynamic;
+	/** shadow map resolution level to render with this frame, where each level halves the resolution, set by the scene */
+	int shadowMapLevel;
+	/** whether the light renders and is lit with shadow maps this frame, or otherwise casts no shadows, set by the scene */
+	bool shadowed;
 	void *data;
 	ShovelerLightUpdatePositionFunction *updatePosition;
 	ShovelerLightGetPositionFunction *getPosition;
+	ShovelerLightGetRangeFunction *getRange;
+	ShovelerLightRenderShadowMapFunction *renderShadowMap;
 	ShovelerLightRenderFunction *render;
 	ShovelerLightFreeDataFunction *freeData;
 } ShovelerLight;
@@ -36,6 +82,16 @@ static inline ShovelerVector3 shovelerLightGetPosition(ShovelerLight *light)
 	return light->getPosition(light->data);
 }
 
+static inline float shovelerLightGetRange(ShovelerLight *light)
+{
+	return light->getRange(light->data);
+}
+
+static inline int shovelerLightRenderShadowMap(ShovelerLight *light, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState)
+{
+	return light->renderShadowMap(light->data, scene, camera, renderState);
+}
+
 static inline int shovelerLightRender(ShovelerLight *light, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState)
 {
 	return light->render(light->data, scene, camera, framebuffer, renderPassOptions, renderState);
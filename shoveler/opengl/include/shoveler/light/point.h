@@ -5,7 +5,28 @@
 
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
+#define SHOVELER_LIGHT_POINT_FACES 6
+
+/** GLSL declaration of the std140 uniform block matching ShovelerLightPointFacesUniformBlock. */
+#define SHOVELER_LIGHT_POINT_FACES_UNIFORM_BLOCK_SOURCE \
+	"layout(std140, row_major) uniform LightFaces {\n" \
+	"	mat4 lightFaceViewProjections[6];\n" \
+	"};\n"
+
+typedef struct {
+	ShovelerMatrix viewProjections[SHOVELER_LIGHT_POINT_FACES];
+} ShovelerLightPointFacesUniformBlock;
+
 ShovelerLight *shovelerLightPointCreate(struct ShovelerShaderCacheStruct *shaderCache, ShovelerVector3 position, int width, int height, GLsizei samples, float ambientFactor, float exponentialFactor, ShovelerVector3 color);
+/**
+ * Creates a point light that renders the shadow maps of all six faces in a single layered pass, which the geometry
+ * shader of its depth material fans out to the layers of an array depth target, and filters them in one layered pass.
+ *
+ * Layered shadow maps are always single sampled. They also don't take part in the scene's shadow atlas, since the
+ * layered filter writes all faces into an array texture rather than into atlas tiles, so a layered light keeps its
+ * own shadow maps even if shovelerSceneEnableShadowAtlas was called.
+ */
+ShovelerLight *shovelerLightPointCreateLayered(struct ShovelerShaderCacheStruct *shaderCache, ShovelerVector3 position, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color);
 ShovelerLightSpotShared *shovelerLightPointGetShared(ShovelerLight *light);
 
 #endif
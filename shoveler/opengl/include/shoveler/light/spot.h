@@ -12,20 +12,35 @@
 
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
+/** maximum number of shadow map resolution levels, each halving the resolution of the previous one */
+#define SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS 4
+
 typedef struct {
 	struct ShovelerShaderCacheStruct *shaderCache;
 	ShovelerSampler *shadowMapSampler;
+	int width;
+	int height;
+	/** depth framebuffer of layered resources, while others acquire theirs from the scene's pool during rendering */
 	ShovelerFramebuffer *depthFramebuffer;
+	GLsizei samples;
+	/** whether the depth resources render all faces of a point light at once into array layers */
+	bool layered;
 	ShovelerMaterial *depthMaterial;
 	ShovelerFilter *depthFilter;
 	ShovelerSceneRenderPassOptions depthRenderPassOptions;
+	/** filters for reduced resolution levels, created on first use, with level 0 being the above */
+	/* private */ ShovelerFilter *levelDepthFilters[SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS];
 	float ambientFactor;
 	float exponentialFactor;
 	ShovelerVector3 color;
 } ShovelerLightSpotShared;
 
 ShovelerLightSpotShared *shovelerLightSpotSharedCreate(struct ShovelerShaderCacheStruct *shaderCache, int width, int height, GLsizei samples, float ambientFactor, float exponentialFactor, ShovelerVector3 color);
+/** Creates shared resources whose depth framebuffer, material and filter render a point light's faces in one layered pass. */
+ShovelerLightSpotShared *shovelerLightSpotSharedCreateLayered(struct ShovelerShaderCacheStruct *shaderCache, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color);
 ShovelerLight *shovelerLightSpotCreateWithShared(ShovelerCamera *camera, ShovelerLightSpotShared *shared, bool managedShared);
+/** Creates a spot light that only renders its additive pass, lit with a shadow map kept up to date by its owner. */
+ShovelerLight *shovelerLightSpotCreateWithShadowMap(ShovelerCamera *camera, ShovelerLightSpotShared *shared, ShovelerTexture *shadowMap);
 void shovelerLightSpotSharedFree(ShovelerLightSpotShared *shared);
 
 static inline ShovelerLight *shovelerLightSpotCreate(struct ShovelerShaderCacheStruct *shaderCache, ShovelerCamera *camera, int width, int height, GLsizei samples, float ambientFactor, float exponentialFactor, ShovelerVector3 color)
@@ -5,7 +5,10 @@
 
 #include <glad/glad.h>
 
+#include <shoveler/types.h>
+
 typedef struct ShovelerCameraStruct ShovelerCamera; // forward declaration: camera.h
+typedef struct ShovelerInstanceBufferStruct ShovelerInstanceBuffer; // forward declaration: instance_buffer.h
 typedef struct ShovelerLightStruct ShovelerLight; // forward declaration: light.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: below
 typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
@@ -16,10 +19,13 @@ typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declara
 typedef struct ShovelerUniformMapStruct ShovelerUniformMap; // forward declaration: uniform_map.h
 
 typedef bool (ShovelerMaterialRenderFunction)(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+typedef bool (ShovelerMaterialRenderInstancedFunction)(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerInstanceBuffer *instanceBuffer, ShovelerRenderState *renderState);
 typedef int (ShovelerMaterialAttachUniformsFunction)(ShovelerMaterial *material, ShovelerShader *shader, void *userData);
 typedef void (ShovelerMaterialFreeDataFunction)(ShovelerMaterial *material);
 
 typedef struct ShovelerMaterialStruct {
+	/** sequential id assigned on creation, e.g. to group draws by material */
+	unsigned int id;
 	ShovelerShaderCache *shaderCache;
 	bool screenspace;
 	bool manageProgram;
@@ -28,6 +34,10 @@ typedef struct ShovelerMaterialStruct {
 	ShovelerUniformMap *uniforms;
 	/** callback executed whenever a model is rendered with this material */
 	ShovelerMaterialRenderFunction *render;
+	/** callback rendering all instances of a buffer sharing the passed model's drawable, or NULL if not supported */
+	ShovelerMaterialRenderInstancedFunction *renderInstanced;
+	/** color passed per instance when instancing, allowing instances of materials sharing a program to batch, or NULL */
+	const ShovelerVector4 *instanceColor;
 	/** callback executed whenever a render call causes a shader generation */
 	ShovelerMaterialAttachUniformsFunction *attachUniforms;
 	ShovelerMaterialFreeDataFunction *freeData;
@@ -38,6 +48,8 @@ typedef struct ShovelerMaterialStruct {
 ShovelerMaterial *shovelerMaterialCreate(ShovelerShaderCache *shaderCache, bool screenspace, GLuint program);
 /** Creates a material from a program without owning it. */
 ShovelerMaterial *shovelerMaterialCreateUnmanaged(ShovelerShaderCache *shaderCache, bool screenspace, GLuint program);
+/** Opts a material using the default render callback and the model vertex shader into instanced rendering. */
+void shovelerMaterialEnableInstancing(ShovelerMaterial *material);
 void shovelerMaterialFree(ShovelerMaterial *material);
 
 static inline bool shovelerMaterialRender(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
@@ -45,6 +57,11 @@ static inline bool shovelerMaterialRender(ShovelerMaterial *material, ShovelerSc
 	return material->render(material, scene, camera, light, model, renderState);
 }
 
+static inline bool shovelerMaterialRenderInstanced(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerInstanceBuffer *instanceBuffer, ShovelerRenderState *renderState)
+{
+	return material->renderInstanced(material, scene, camera, light, model, instanceBuffer, renderState);
+}
+
 static inline int shovelerMaterialAttachUniforms(ShovelerMaterial *material, ShovelerShader *shader, void *userData)
 {
 	return material->attachUniforms(material, shader, userData);
@@ -5,6 +5,9 @@
 
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
 
+/** Creates a depth material, which renders models drawing a tiles drawable with a vertex shader expanding their tiles. */
 ShovelerMaterial *shovelerMaterialDepthCreate(ShovelerShaderCache *shaderCache, bool screenspace);
+/** Creates a depth material rendering each primitive into all layers of a point light's layered depth target. */
+ShovelerMaterial *shovelerMaterialDepthCreateLayered(ShovelerShaderCache *shaderCache);
 
 #endif
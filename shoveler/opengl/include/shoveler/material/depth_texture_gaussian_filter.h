@@ -7,9 +7,20 @@
 
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
+/** maximum number of layers filtered by layered filter materials in a single draw */
+#define SHOVELER_MATERIAL_DEPTH_TEXTURE_GAUSSIAN_FILTER_MAX_LAYERS 8
+
 ShovelerMaterial *shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(struct ShovelerShaderCacheStruct *shaderCache, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height);
+/**
+ * Creates a filter material reading the first layers of an array texture and writing them into a layered framebuffer in
+ * a single draw, filtering all layers up to the maximum unless restricted further.
+ */
+ShovelerMaterial *shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreateLayered(struct ShovelerShaderCacheStruct *shaderCache, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height);
 void shovelerMaterialDepthTextureGaussianFilterEnableExponentialLifting(ShovelerMaterial *material, float liftExponentialFactor);
 void shovelerMaterialDepthTextureGaussianFilterDisableExponentialLifting(ShovelerMaterial *material);
+/** Sets the filter direction, where filtering in neither direction copies the texture with a single sample per texel. */
 void shovelerMaterialDepthTextureGaussianFilterSetDirection(ShovelerMaterial *material, bool filterX, bool filterY);
+/** Restricts a layered filter material to the passed number of leading layers. */
+void shovelerMaterialDepthTextureGaussianFilterSetLayers(ShovelerMaterial *material, int numLayers);
 
 #endif
@@ -6,11 +6,14 @@
 
 typedef struct ShovelerFontAtlasTextureStruct ShovelerFontAtlasTexture; // forward declaration: font_atlas_texture.h
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
+typedef struct ShovelerSpriteBatchStruct ShovelerSpriteBatch; // forward declaration: sprite_batch.h
 
 ShovelerMaterial *shovelerMaterialTextCreate(ShovelerShaderCache *shaderCache, bool screenspace);
 void shovelerMaterialTextSetActiveRegion(ShovelerMaterial *material, ShovelerVector2 regionPosition, ShovelerVector2 regionSize);
 void shovelerMaterialTextSetActiveFontAtlasTexture(ShovelerMaterial *material, ShovelerFontAtlasTexture *fontAtlasTexture);
 void shovelerMaterialTextSetActiveText(ShovelerMaterial *material, const char *text, ShovelerVector2 corner, float size);
 void shovelerMaterialTextSetActiveColor(ShovelerMaterial *material, ShovelerVector4 color);
+/** Draws the glyph quads of a sprite batch onto the model with the active font atlas texture and color, taking each glyph's font atlas uv from its vertices. */
+bool shovelerMaterialTextRenderBatch(ShovelerMaterial *material, ShovelerSpriteBatch *batch, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 
 #endif
@@ -17,5 +17,7 @@ typedef enum {
 
 ShovelerMaterial *shovelerMaterialTextureCreate(ShovelerShaderCache *shaderCache, bool screenspace, ShovelerMaterialTextureType type, ShovelerTexture *texture, bool manageTexture, ShovelerSampler *sampler, bool manageSampler);
 void shovelerMaterialTextureSetAlphaMaskColor(ShovelerMaterial *material, ShovelerVector4 color);
+/** Maps the model's UV coordinates onto a region of the texture, e.g. a text packed into a shared atlas. */
+void shovelerMaterialTextureSetTextureRegion(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size);
 
 #endif
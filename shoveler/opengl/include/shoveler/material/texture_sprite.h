@@ -19,6 +19,8 @@ typedef enum {
 ShovelerMaterial *shovelerMaterialTextureSpriteCreate(ShovelerShaderCache *shaderCache, bool screenspace, ShovelerMaterialTextureSpriteType type);
 void shovelerMaterialTextureSpriteSetActiveRegion(ShovelerMaterial *material, ShovelerVector2 regionPosition, ShovelerVector2 regionSize);
 void shovelerMaterialTextureSpriteSetActiveSprite(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size);
+/** Sets the region of the active texture that sprites are sampled from, in texture coordinates. */
+void shovelerMaterialTextureSpriteSetActiveTextureRegion(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size);
 void shovelerMaterialTextureSpriteSetColor(ShovelerMaterial *material, ShovelerVector4 color);
 void shovelerMaterialTextureSpriteSetActiveTexture(ShovelerMaterial *material, ShovelerTexture *texture, ShovelerSampler *sampler);
 
@@ -5,8 +5,14 @@
 
 #include <shoveler/types.h>
 
+typedef struct ShovelerCameraStruct ShovelerCamera; // forward declaration: camera.h
+typedef struct ShovelerLightStruct ShovelerLight; // forward declaration: light.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
+typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
+typedef struct ShovelerRenderStateStruct ShovelerRenderState; // forward declaration: render_state.h
+typedef struct ShovelerSceneStruct ShovelerScene; // forward declaration: scene.h
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
+typedef struct ShovelerSpriteBatchStruct ShovelerSpriteBatch; // forward declaration: sprite_batch.h
 typedef struct ShovelerSpriteTileStruct ShovelerSpriteTile; // forward declaration: sprite/tile.h
 typedef struct ShovelerTilesetStruct ShovelerTileset; // forward delcaration: tileset.h
 
@@ -16,5 +22,7 @@ void shovelerMaterialTileSpriteSetActiveTile(ShovelerMaterial *material, int til
 void shovelerMaterialTileSpriteSetActiveTileset(ShovelerMaterial *material, ShovelerTileset *tileset);
 void shovelerMaterialTileSpriteSetActiveSprite(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size);
 void shovelerMaterialTileSpriteSetActive(ShovelerMaterial *material, const ShovelerSpriteTile *spriteTile);
+/** Draws the quads of a sprite batch onto the model with the active region and tileset, taking each sprite's tile from its vertices. */
+bool shovelerMaterialTileSpriteRenderBatch(ShovelerMaterial *material, ShovelerSpriteBatch *batch, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 
 #endif
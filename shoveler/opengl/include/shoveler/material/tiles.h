@@ -0,0 +1,25 @@
+#ifndef SHOVELER_MATERIAL_TILES_H
+#define SHOVELER_MATERIAL_TILES_H
+
+#include <stdbool.h> // bool
+
+typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
+typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
+typedef struct ShovelerTilesetStruct ShovelerTileset; // forward declaration: tileset.h
+
+/**
+ * Creates a material for instanced tiles drawables, which expands each tile's quad in the vertex shader and samples it
+ * from the layer of the active tileset array picked by the tile's tileset id, so any number of tiles and chunks sharing
+ * that tileset are drawn by a single call.
+ *
+ * Depth materials recognize tiles drawables and expand their tiles the same way, so models using this material may cast
+ * shadows. Since depth is rendered per tile quad, empty tiles are skipped but transparent parts of tiles still occlude.
+ */
+ShovelerMaterial *shovelerMaterialTilesCreate(ShovelerShaderCache *shaderCache, bool screenspace);
+/**
+ * Sets the tileset to sample tiles from. Tilesets created with shovelerTilesetCreateArray pick their layer by tileset
+ * id, while tiles of any other tileset are sampled through a single layer view of its texture and must use id one.
+ */
+void shovelerMaterialTilesSetActiveTileset(ShovelerMaterial *material, ShovelerTileset *tileset);
+
+#endif
@@ -9,6 +9,7 @@
 #include <shoveler/types.h>
 #include <shoveler/uniform_map.h>
 
+struct ShovelerInstanceBufferStruct; // forward declaration: instance_buffer.h
 struct ShovelerMaterialStruct; // forward declaration: material.h
 struct ShovelerShaderCacheStruct; // forward declaration: shader_cache.h
 
@@ -24,13 +25,19 @@ typedef struct ShovelerModelStruct {
 	bool visible;
 	bool emitter;
 	bool castsShadow;
+	/** whether the model may change after being added to a scene, see shovelerSceneComputeShadowCasterHash */
+	bool dynamic;
 	GLuint polygonMode;
 	ShovelerUniformMap *uniforms;
+	/** incremented every time the transformation is updated */
+	/* private */ unsigned int version;
 } ShovelerModel;
 
 ShovelerModel *shovelerModelCreate(ShovelerDrawable *drawable, struct ShovelerMaterialStruct *material);
 void shovelerModelUpdateTransformation(ShovelerModel *model);
 bool shovelerModelRender(ShovelerModel *model);
+/** Renders the model's drawable once for every instance in the uploaded buffer. */
+bool shovelerModelRenderInstanced(ShovelerModel *model, struct ShovelerInstanceBufferStruct *instanceBuffer);
 void shovelerModelFree(ShovelerModel *model);
 
 #endif
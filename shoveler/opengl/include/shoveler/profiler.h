@@ -0,0 +1,75 @@
+#ifndef SHOVELER_PROFILER_H
+#define SHOVELER_PROFILER_H
+
+#include <stdbool.h> // bool
+
+#include <glad/glad.h>
+#include <glib.h>
+
+/** number of frames recorded before the GPU timings of the oldest one are read back, which avoids stalling on them */
+#define SHOVELER_PROFILER_FRAME_LATENCY 3
+#define SHOVELER_PROFILER_SCOPE_NAME_LENGTH 64
+
+typedef struct {
+	char name[SHOVELER_PROFILER_SCOPE_NAME_LENGTH];
+	/** number of scopes this one is nested in */
+	int depth;
+	/** index of the frame the scope was recorded in */
+	int frame;
+	/** start of the scope on the CPU in microseconds since the profiler was created */
+	gint64 cpuStartTime;
+	gint64 cpuDuration;
+	/** start of the scope's GPU commands in microseconds, mapped onto the same timeline as the CPU start */
+	gint64 gpuStartTime;
+	gint64 gpuDuration;
+} ShovelerProfilerScope;
+
+typedef struct {
+	/** array of (ShovelerProfilerScope) in the order they were begun */
+	GArray *scopes;
+	/** array of (GLuint) timestamp queries, two per scope marking its begin and end */
+	GArray *queries;
+	int frame;
+	bool pending;
+	gint64 cpuReferenceTime;
+	GLint64 gpuReferenceTime;
+} ShovelerProfilerFrame;
+
+typedef struct ShovelerProfilerStruct {
+	/** whether frames begun from now on are recorded */
+	bool enabled;
+	/** scopes of the most recent frame whose GPU timings are available, or empty if there is none yet */
+	GArray *lastScopes;
+	/** whether frames are being captured into a trace */
+	bool capturing;
+	/* private */ bool recording;
+	/* private */ int nextFrame;
+	/* private */ ShovelerProfilerFrame frames[SHOVELER_PROFILER_FRAME_LATENCY];
+	/** array of (int) indices of the currently open scopes in the current frame */
+	/* private */ GArray *openScopes;
+	/** array of (ShovelerProfilerScope) captured since capturing was started */
+	/* private */ GArray *traceScopes;
+	/* private */ gint64 creationTime;
+} ShovelerProfiler;
+
+ShovelerProfiler *shovelerProfilerCreate();
+/** Starts recording a frame if enabled, reading back the oldest recorded frame's timings and opening a frame scope. */
+void shovelerProfilerBeginFrame(ShovelerProfiler *profiler);
+/**
+ * Opens a scope measuring the CPU and GPU time until the matching call to shovelerProfilerEndScope, named by the passed
+ * printf format. Scopes must be strictly nested. Does nothing if the profiler is NULL or not recording a frame.
+ */
+void shovelerProfilerBeginScope(ShovelerProfiler *profiler, const char *nameFormat, ...);
+void shovelerProfilerEndScope(ShovelerProfiler *profiler);
+void shovelerProfilerEndFrame(ShovelerProfiler *profiler);
+/** Appends one line per scope of the last frame to the passed string, indented by their depth. */
+void shovelerProfilerFormatLastFrame(ShovelerProfiler *profiler, GString *output);
+void shovelerProfilerStartCapture(ShovelerProfiler *profiler);
+/**
+ * Stops capturing and writes the captured frames to a file in the Chrome trace event format, which can be opened in
+ * chrome://tracing or Perfetto. CPU and GPU timings are shown as separate threads.
+ */
+bool shovelerProfilerStopCapture(ShovelerProfiler *profiler, const char *filename);
+void shovelerProfilerFree(ShovelerProfiler *profiler);
+
+#endif
@@ -15,7 +15,8 @@ typedef struct ShovelerRenderStateStruct {
 } ShovelerRenderState;
 
 void shovelerRenderStateReset(const ShovelerRenderState *renderState);
-void shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRenderState *targetRenderState);
+/** Changes the render state to the target, only issuing GL calls for differing values, and returns the number of changes. */
+int shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRenderState *targetRenderState);
 /** Same as shovelerRenderStateSet, but adds a log line for every performed change. */
 void shovelerRenderStateSetVerbose(ShovelerRenderState *renderState, const ShovelerRenderState *targetRenderState);
 void shovelerRenderStateEnableBlend(ShovelerRenderState *renderState, GLenum sourceFactor, GLenum destinationFactor);
@@ -2,29 +2,104 @@
 #define SHOVELER_SCENE_H
 
 #include <stdbool.h> // bool
+#include <stdint.h> // uint64_t
 
 #include <glib.h>
 
+#include <shoveler/frustum.h>
 #include <shoveler/render_state.h>
 #include <shoveler/types.h>
 
 typedef struct ShovelerCameraStruct ShovelerCamera; // forward declaration: camera.h
+typedef struct ShovelerDrawableStruct ShovelerDrawable; // forward declaration: drawable.h
+typedef struct ShovelerFilterDepthTextureGaussianChainStruct ShovelerFilterDepthTextureGaussianChain; // forward declaration: filter/depth_texture_gaussian.h
 typedef struct ShovelerFramebufferStruct ShovelerFramebuffer; // forward declaration: framebuffer.h
+typedef struct ShovelerFramebufferPoolStruct ShovelerFramebufferPool; // forward declaration: framebuffer.h
+typedef struct ShovelerInstanceBufferStruct ShovelerInstanceBuffer; // forward declaration: instance_buffer.h
 typedef struct ShovelerLightStruct ShovelerLight; // forward declaration: light.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
 typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
+typedef struct ShovelerProfilerStruct ShovelerProfiler; // forward declaration: profiler.h
 typedef struct ShovelerShaderStruct ShovelerShader; // forward declaration: shader.h
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
+typedef struct ShovelerShadowAtlasStruct ShovelerShadowAtlas; // forward declaration: shadow_atlas.h
+typedef struct ShovelerUniformBufferStruct ShovelerUniformBuffer; // forward declaration: uniform_buffer.h
 typedef struct ShovelerUniformMapStruct ShovelerUniformMap; // forward declaration: uniform_map.h
 
+typedef struct {
+	/** number of models submitted to render queues */
+	int drawItems;
+	/** number of times consecutive draw items were rendered with a different shader program */
+	int programSwitches;
+	/** number of render state changes issued between draw items */
+	int stateChanges;
+	/** number of instanced draws that replaced runs of draw items sharing material and drawable */
+	int instanceBatches;
+	/** number of light shadow maps that were rendered and filtered */
+	int shadowMapsRendered;
+	/** number of light shadow maps that were reused from a previous frame */
+	int shadowMapsCached;
+	/** number of lights skipped because their range doesn't intersect the camera frustum */
+	int lightsCulled;
+	/** number of visible lights rendered without shadows because they exceeded the maximum number of shadowed lights or found no free shadow atlas tile */
+	int lightsUnshadowed;
+	/** number of shadow atlas tiles taken away from lights that weren't visible recently */
+	int shadowAtlasEvictions;
+	/** number of models skipped in the light passes because their occlusion query found them hidden */
+	int modelsOccluded;
+} ShovelerSceneRenderStatistics;
+
+typedef struct {
+	/**
+	 * maximum number of lights rendering shadow maps per frame, preferring the largest on screen, or zero for no limit,
+	 * where the remaining visible lights are still rendered but cast no shadows
+	 */
+	int maxShadowedLights;
+	/** number of shadow map resolution levels to pick from, where each level halves the resolution of the previous one */
+	int shadowMapLevels;
+	/** screen space size of a light's range, relative to the viewport height, below which the next level is picked */
+	float shadowMapLevelScreenSize;
+	/** factor by which shadow maps are downsampled before being blurred, where 1 blurs them at full resolution */
+	int shadowFilterDownsample;
+} ShovelerSceneLightOptions;
+
 typedef struct ShovelerSceneStruct {
 	ShovelerShaderCache *shaderCache;
 	ShovelerUniformMap *uniforms;
 	ShovelerMaterial *depthMaterial;
 	/* private */ bool debugMode;
 	/* private */ ShovelerVector2 activeFramebufferSize;
+	/* private */ bool instanced;
 	GHashTable *lights;
 	GHashTable *models;
+	/** render statistics since the beginning of the last call to shovelerSceneRenderFrame */
+	ShovelerSceneRenderStatistics statistics;
+	ShovelerSceneLightOptions lightOptions;
+	/** pool of transient render targets shared by the passes rendering this scene */
+	ShovelerFramebufferPool *framebufferPool;
+	/** atlas that lights render their shadow maps into, or NULL if each light keeps its own */
+	ShovelerShadowAtlas *shadowAtlas;
+	/** filter chain blurring the single sampled shadow maps of all lights in shared batches, created on first use */
+	/* private */ ShovelerFilterDepthTextureGaussianChain *shadowFilterChain;
+	/** profiler recording the CPU and GPU time of each render pass, or NULL */
+	ShovelerProfiler *profiler;
+	/** whether models hidden behind the depth pass in the previous frame are skipped in the light passes */
+	bool occlusionCulling;
+	/** array of draw items sorted per render pass, reused across passes */
+	/* private */ GArray *renderQueue;
+	/* private */ ShovelerInstanceBuffer *instanceBuffer;
+	/** zeroed uniform blocks backing shaders rendered without a camera or light */
+	/* private */ ShovelerUniformBuffer *fallbackCameraUniformBuffer;
+	/* private */ ShovelerUniformBuffer *fallbackLightUniformBuffer;
+	/** incremented whenever the set of models or any static model changes */
+	/* private */ unsigned int staticModelsGeneration;
+	/** array of lights visible in the current frame, reused across frames */
+	/* private */ GArray *visibleLights;
+	/** map from (ShovelerModel *) to their occlusion query state, only populated if occlusion culling is enabled */
+	/* private */ GHashTable *occlusionQueries;
+	/** unit cube drawn in place of a model's bounds for its occlusion query, created on first use */
+	/* private */ ShovelerDrawable *occlusionProxyDrawable;
+	/* private */ ShovelerModel *occlusionProxyModel;
 } ShovelerScene;
 
 typedef struct {
@@ -32,16 +107,51 @@ typedef struct {
 	bool emitters;
 	bool screenspace;
 	bool onlyShadowCasters;
+	/** whether to skip models whose last occlusion query found them hidden, see ShovelerScene.occlusionCulling */
+	bool skipOccluded;
 	ShovelerRenderState renderState;
 } ShovelerSceneRenderPassOptions;
 
 ShovelerScene *shovelerSceneCreate(ShovelerShaderCache *shaderCache);
 void shovelerSceneToggleDebugMode(ShovelerScene *scene);
+/**
+ * Makes lights render their shadow maps into tiles of a shared atlas owned by the scene, replacing any previous one.
+ *
+ * Layered point lights are excluded and keep filtering into their own array shadow maps. Has to be called before any
+ * lights are added, since lights hand back their tiles to the atlas they last used when they are freed.
+ */
+void shovelerSceneEnableShadowAtlas(ShovelerScene *scene, int tileWidth, int tileHeight, int columns, int rows);
 bool shovelerSceneAddLight(ShovelerScene *scene, ShovelerLight *light);
 bool shovelerSceneRemoveLight(ShovelerScene *scene, ShovelerLight *light);
 bool shovelerSceneAddModel(ShovelerScene *scene, ShovelerModel *model);
 bool shovelerSceneRemoveModel(ShovelerScene *scene, ShovelerModel *model);
+/** Invalidates cached shadow maps after a model not flagged as dynamic was changed in place. */
+void shovelerSceneMarkStaticModelsChanged(ShovelerScene *scene);
+/** Returns the scene's shadow filter chain, created on first use and downsampling as configured in the light options. */
+ShovelerFilterDepthTextureGaussianChain *shovelerSceneGetShadowFilterChain(ShovelerScene *scene);
+/**
+ * Computes a hash of everything that affects shadow maps rendered within the passed frustum.
+ *
+ * Static models only contribute through the scene's generation, while dynamic models are hashed individually if their
+ * bounding sphere, assumed to be centered at their translation with the length of their scale as radius, intersects
+ * the frustum.
+ */
+uint64_t shovelerSceneComputeShadowCasterHash(ShovelerScene *scene, const ShovelerFrustum *frustum);
+/**
+ * Renders all matching models, sorted by a key packing their program, material, drawable, and view depth to minimize
+ * state changes. Runs of models sharing material, drawable and polygon mode are drawn instanced where supported, where
+ * materials passing their color per instance only need to share their program.
+ */
 int shovelerSceneRenderPass(ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerSceneRenderPassOptions options, ShovelerRenderState *renderState);
+/**
+ * Renders a frame, skipping lights whose range doesn't intersect the camera frustum, and picking the remaining lights'
+ * shadow map resolution levels and whether they are rendered at all by their screen space size. All lights' shadow maps
+ * are rendered and filtered before any of their additive passes, so that filtering can be batched across lights.
+ *
+ * If occlusion culling is enabled, an occlusion query is issued against the depth pass for each opaque model's bounding
+ * box after the depth pass. Results are only read back once available in a later frame to avoid stalling, so a model
+ * that becomes visible may be missing its lighting for a frame or two.
+ */
 int shovelerSceneRenderFrame(ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerRenderState *renderState);
 /** Generates a shader, where shaders for calls to this with the same arguments might be cached. */
 ShovelerShader *shovelerSceneGenerateShader(ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerMaterial *material, void *userData);
@@ -29,6 +29,8 @@ typedef struct ShovelerShaderStruct {
 	ShovelerMaterial *material;
 	/** map from (char *) to (ShovelerUniformAttachment *) */
 	GHashTable *attachments;
+	/** array of (ShovelerUniformAttachment *) in attachment order, iterated on use */
+	GArray *attachmentList;
 } ShovelerShader;
 
 /** Computes a hash from a shader key that can be used to add shaders to a hash table. */
@@ -38,6 +40,7 @@ gboolean shovelerShaderKeyEqual(gconstpointer firstShaderKeyPointer, gconstpoint
 /** Creates a shader for a material with a previously created shader key. */
 ShovelerShader *shovelerShaderCreate(ShovelerShaderKey shaderKey, ShovelerMaterial *material);
 bool shovelerShaderAttachUniform(ShovelerShader *shader, const char *name, ShovelerUniform *uniform);
+/** Binds the shader's program if needed and uploads all uniforms whose value changed since the program last used them. */
 bool shovelerShaderUse(ShovelerShader *shader);
 void shovelerShaderFree(ShovelerShader *shader);
 
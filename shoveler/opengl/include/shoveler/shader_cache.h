@@ -3,8 +3,11 @@
 
 #include <stdbool.h>
 
+#include <glad/glad.h>
 #include <glib.h>
 
+#include <shoveler/uniform.h>
+
 typedef struct ShovelerCameraStruct ShovelerCamera; // forward declaration: camera.h
 typedef struct ShovelerLightStruct ShovelerLight; // forward declaration: light.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
@@ -28,6 +31,12 @@ typedef struct ShovelerShaderCacheStruct {
 	GHashTable *materialShaderKeys;
 	/** map from (void *) to set of (ShovelerShaderKey *) */
 	GHashTable *userDataShaderKeys;
+	/** map from (GLuint) program to map from (GLint) location to (ShovelerUniformCacheEntry *) */
+	GHashTable *programUniformCacheEntries;
+	/** program last bound through a shader of this cache, or 0 if unknown */
+	GLuint usedProgram;
+	/** map from (char *) name to (GLuint) program shared by all materials of a kind, owned by the cache */
+	GHashTable *sharedPrograms;
 } ShovelerShaderCache;
 
 typedef void (ShovelerShaderCacheFreeShaderFunction)(void *shaderPointer);
@@ -44,6 +53,16 @@ void shovelerShaderCacheInvalidateLight(ShovelerShaderCache *cache, ShovelerLigh
 void shovelerShaderCacheInvalidateModel(ShovelerShaderCache *cache, ShovelerModel *model);
 void shovelerShaderCacheInvalidateMaterial(ShovelerShaderCache *cache, ShovelerMaterial *material);
 void shovelerShaderCacheInvalidateUserData(ShovelerShaderCache *cache, void *userData);
+/** Returns the upload cache entry for a uniform location of a program, which stays valid until the cache is freed. */
+ShovelerUniformCacheEntry *shovelerShaderCacheGetUniformCacheEntry(ShovelerShaderCache *cache, GLuint program, GLint location);
+/** Binds the program unless it is already bound, returning whether a switch happened. */
+bool shovelerShaderCacheUseProgram(ShovelerShaderCache *cache, GLuint program);
+/** Forgets all cached uniform values and the binding of a program, e.g. because it is about to be deleted. */
+void shovelerShaderCacheInvalidateProgram(ShovelerShaderCache *cache, GLuint program);
+/** Returns the program shared under the passed name, or 0 if none was registered yet. */
+GLuint shovelerShaderCacheGetSharedProgram(ShovelerShaderCache *cache, const char *name);
+/** Registers a program to be shared by all materials of a kind under the passed name, transferring ownership of it. */
+void shovelerShaderCacheSetSharedProgram(ShovelerShaderCache *cache, const char *name, GLuint program);
 void shovelerShaderCacheFree(ShovelerShaderCache *cache);
 
 #endif
@@ -8,9 +8,31 @@
 typedef enum {
 	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION = 0,
 	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_NORMAL = 1,
-	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV = 2
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV = 2,
+	/** per-instance mat4, occupying locations 3 to 6 */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL = 3,
+	/** per-instance mat4, occupying locations 7 to 10 */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL_NORMAL = 7,
+	/** per-vertex uv within a batched sprite */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_UV = 11,
+	/** per-vertex tileset column and row of a batched sprite */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_TILE = 12,
+	/** per-instance column and row of an instanced tile */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE_POSITION = 13,
+	/** per-instance tileset column, row and id of an instanced tile */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE = 14,
+	/** per-instance color of an instanced model, used instead of a color material's uniform */
+	SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR = 15
 } ShovelerShaderProgramAttribute;
 
+/**
+ * Enables caching linked program binaries as files in the passed existing directory, keyed by a hash of the program's
+ * shader sources and the OpenGL driver. While enabled, compiling shaders is deferred to linking them into a program, so
+ * that both can be skipped when a valid binary is found in the cache. Invalid or rejected binaries are replaced by
+ * compiling and linking from source.
+ */
+void shovelerShaderProgramEnableBinaryCache(const char *directory);
+void shovelerShaderProgramDisableBinaryCache();
 GLuint shovelerShaderProgramCompileFromString(const char *source, GLenum type);
 GLuint shovelerShaderProgramCompileFromFile(const char *filename, GLenum type);
 GLuint shovelerShaderProgramLink(GLuint vertexShader, GLuint geometryShader, GLuint fragmentShader, bool deleteShaders);
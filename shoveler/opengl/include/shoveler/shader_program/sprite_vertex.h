@@ -0,0 +1,14 @@
+#ifndef SHOVELER_SHADER_PROGRAM_SPRITE_VERTEX_H
+#define SHOVELER_SHADER_PROGRAM_SPRITE_VERTEX_H
+
+#include <stdbool.h> // bool
+
+#include <glad/glad.h>
+
+/**
+ * Creates a vertex shader for sprite batches rendered onto a canvas quad, which reads the canvas uv as well as the
+ * sprite uv and tile of each vertex, passing the latter two on as fragmentSpriteUv and fragmentSpriteTile.
+ */
+GLuint shovelerShaderProgramSpriteVertexCreate(bool screenspace);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SHOVELER_SHADER_PROGRAM_TILE_VERTEX_H
+#define SHOVELER_SHADER_PROGRAM_TILE_VERTEX_H
+
+#include <stdbool.h> // bool
+
+#include <glad/glad.h>
+
+/**
+ * Creates a vertex shader for instanced tiles drawables, which moves the instanced unit quad to each tile's position and
+ * passes its tileset column, row and array layer on as fragmentTile. Empty tiles collapse into a degenerate quad.
+ */
+GLuint shovelerShaderProgramTileVertexCreate(bool screenspace);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SHOVELER_SHADOW_ATLAS_H
+#define SHOVELER_SHADOW_ATLAS_H
+
+#include <stdbool.h> // bool
+
+#include <glad/glad.h>
+
+#include <shoveler/framebuffer.h>
+#include <shoveler/types.h>
+
+typedef struct {
+	/* private */ const void *owner;
+	/* private */ unsigned int lastUsedFrame;
+} ShovelerShadowAtlasTile;
+
+/**
+ * Single color render target split into a grid of equally sized tiles that filtered shadow maps of lights are rendered
+ * into, with tiles handed out on demand and taken back from the least recently visible lights once all are in use.
+ * Tiles of owners that went away are released by them and therefore reclaimed first.
+ */
+typedef struct ShovelerShadowAtlasStruct {
+	ShovelerFramebuffer *framebuffer;
+	int tileWidth;
+	int tileHeight;
+	int columns;
+	int rows;
+	/** number of tiles taken away from their previous owner since the beginning of the current frame */
+	int evictions;
+	/* private */ unsigned int frame;
+	/* private */ ShovelerShadowAtlasTile *tiles;
+} ShovelerShadowAtlas;
+
+ShovelerShadowAtlas *shovelerShadowAtlasCreate(int tileWidth, int tileHeight, int columns, int rows);
+void shovelerShadowAtlasBeginFrame(ShovelerShadowAtlas *atlas);
+/**
+ * Marks the tile held by the passed owner as used in the current frame, or assigns it a new one.
+ *
+ * Returns true if the owner still held the tile passed in, in which case its contents are unchanged. Otherwise a free
+ * or least recently used tile is assigned to the owner and written to the passed index, and the caller has to render
+ * its contents again. Tiles already used by other owners this frame are never taken away, so if all tiles are, -1 is
+ * written to the passed index and the owner has to do without a tile for this frame.
+ */
+bool shovelerShadowAtlasUseTile(ShovelerShadowAtlas *atlas, const void *owner, int *tileIndex);
+/** Frees all tiles held by the passed owner, which must be called before the owner goes away. */
+void shovelerShadowAtlasReleaseOwner(ShovelerShadowAtlas *atlas, const void *owner);
+/** Retrieves the pixel rectangle a tile covers in the atlas framebuffer. */
+void shovelerShadowAtlasGetTileViewport(ShovelerShadowAtlas *atlas, int tileIndex, GLint *x, GLint *y, GLsizei *width, GLsizei *height);
+/** Returns the texture coordinate offset in xy and scale in zw mapping [0, 1] onto the texel centers of a tile. */
+ShovelerVector4 shovelerShadowAtlasGetTileRegion(ShovelerShadowAtlas *atlas, int tileIndex);
+void shovelerShadowAtlasFree(ShovelerShadowAtlas *atlas);
+
+#endif
@@ -5,14 +5,17 @@
 #include <shoveler/types.h>
 
 typedef struct ShovelerCameraStruct ShovelerCamera; // forward declaration: camera.h
+typedef struct ShovelerCanvasStruct ShovelerCanvas; // forward declaration: canvas.h
 typedef struct ShovelerLightStruct ShovelerLight; // forward declaration: light.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
 typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
 typedef struct ShovelerRenderStateStruct ShovelerRenderState; // forward declaration: render_state.h
 typedef struct ShovelerSceneStruct ShovelerScene; // forward declaration: scene.h
 typedef struct ShovelerSpriteStruct ShovelerSprite; // forward declaration: below
+typedef struct ShovelerSpriteBatchStruct ShovelerSpriteBatch; // forward declaration: sprite_batch.h
 
 typedef bool (ShovelerSpriteRenderFunction)(ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+typedef bool (ShovelerSpriteRenderBatchFunction)(ShovelerSprite **sprites, int numSprites, ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 typedef void (ShovelerSpriteFreeFunction)(ShovelerSprite *sprite);
 
 typedef struct ShovelerSpriteStruct {
@@ -22,10 +25,18 @@ typedef struct ShovelerSpriteStruct {
 	bool enableCollider;
 	ShovelerMaterial *material;
 	ShovelerSpriteRenderFunction *render;
+	/** callback rendering a run of sprites sharing this callback, material and batch key with a single draw, or NULL if not supported */
+	ShovelerSpriteRenderBatchFunction *renderBatch;
+	/** identifies the resources besides the material that a sprite can only be batched with if they are shared */
+	const void *batchKey;
 	ShovelerSpriteFreeFunction *free;
 	void *data;
+	/** canvas the sprite was added to, which is notified when the sprite moves, or NULL */
+	/* private */ ShovelerCanvas *canvas;
+	/* private */ int canvasLayerId;
 } ShovelerSprite;
 
+/** Initializes a sprite, whose position and size must only be changed via the update functions once added to a canvas. */
 void shovelerSpriteInit(ShovelerSprite *sprite, ShovelerMaterial *material, ShovelerCollider2IntersectFunction *interesect, ShovelerSpriteRenderFunction *render, ShovelerSpriteFreeFunction *free, void *data);
 void shovelerSpriteUpdatePosition(ShovelerSprite *sprite, ShovelerVector2 position);
 void shovelerSpriteUpdateSize(ShovelerSprite *sprite, ShovelerVector2 size);
@@ -11,6 +11,9 @@ typedef struct ShovelerSpriteTextureStruct {
 	ShovelerSprite sprite;
 	ShovelerTexture *texture;
 	ShovelerSampler *sampler;
+	/** region of the texture the sprite shows in texture coordinates, covering all of it by default */
+	ShovelerVector2 textureRegionPosition;
+	ShovelerVector2 textureRegionSize;
 } ShovelerSpriteTexture;
 
 /**
@@ -20,5 +23,7 @@ typedef struct ShovelerSpriteTextureStruct {
  * material and sampler.
  */
 ShovelerSprite *shovelerSpriteTextureCreate(ShovelerMaterial *material, ShovelerTexture *texture, ShovelerSampler *sampler);
+/** Restricts the sprite to a region of its texture, e.g. to show a text packed into a shared atlas. */
+void shovelerSpriteTextureSetTextureRegion(ShovelerSprite *sprite, ShovelerVector2 position, ShovelerVector2 size);
 
 #endif
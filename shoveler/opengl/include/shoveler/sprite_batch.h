@@ -0,0 +1,55 @@
+#ifndef SHOVELER_SPRITE_BATCH_H
+#define SHOVELER_SPRITE_BATCH_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <glad/glad.h>
+#include <glib.h>
+
+#include <shoveler/types.h>
+
+typedef struct ShovelerSpriteStruct ShovelerSprite; // forward declaration: sprite.h
+
+typedef struct {
+	/** uv of the vertex on the canvas quad, from which its position on the quad is derived */
+	float uv[2];
+	float spriteUv[2];
+	float spriteTile[2];
+} ShovelerSpriteBatchVertex;
+
+/**
+ * Streaming vertex buffer collecting the quads of sprites rendered onto the same canvas region, so that runs of sprites
+ * sharing a material can be drawn with a single call. Assumes the canvas is rendered onto a quad spanning [-1, 1]².
+ */
+typedef struct ShovelerSpriteBatchStruct {
+	GLuint vertexArrayObject;
+	GLuint vertexBuffer;
+	GLuint indexBuffer;
+	/* private */ size_t vertexBufferSize;
+	/* private */ int indexBufferQuads;
+	/** array of (ShovelerSpriteBatchVertex), four per quad */
+	GArray *vertices;
+} ShovelerSpriteBatch;
+
+ShovelerSpriteBatch *shovelerSpriteBatchCreate();
+void shovelerSpriteBatchClear(ShovelerSpriteBatch *batch);
+/** Adds the quad of a sprite as seen through the given canvas region, clipped to it and skipped if outside of it. */
+void shovelerSpriteBatchAddSprite(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, const ShovelerSprite *sprite, int tilesetColumn, int tilesetRow);
+/** Adds a quad with the given center and size like shovelerSpriteBatchAddSprite, returning false if it was skipped. */
+bool shovelerSpriteBatchAddQuad(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerVector2 position, ShovelerVector2 size, int tilesetColumn, int tilesetRow);
+/** Uploads the added quads to the orphaned vertex buffer and draws them with the currently used shader. */
+bool shovelerSpriteBatchDraw(ShovelerSpriteBatch *batch);
+void shovelerSpriteBatchFree(ShovelerSpriteBatch *batch);
+/**
+ * Maps a sprite's extent along one axis to canvas uvs, clipping it to the region and adjusting its sprite uvs
+ * accordingly. Returns false if nothing of the sprite is left.
+ */
+bool shovelerSpriteBatchClipAxis(float regionCorner, float regionSize, float spriteMin, float spriteMax, float *uvMin, float *uvMax, float *spriteUvMin, float *spriteUvMax);
+
+static inline int shovelerSpriteBatchGetNumQuads(ShovelerSpriteBatch *batch)
+{
+	return (int) batch->vertices->len / 4;
+}
+
+#endif
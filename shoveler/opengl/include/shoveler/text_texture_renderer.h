@@ -7,22 +7,50 @@
 #include <glib.h>
 
 #include <shoveler/canvas.h>
+#include <shoveler/scene.h>
+#include <shoveler/texture.h>
+#include <shoveler/types.h>
 
 typedef struct ShovelerDrawableStruct ShovelerDrawable; // forward declaration: drawable.h
 typedef struct ShovelerFontAtlasTextureStruct ShovelerFontAtlasTexture; // forward declaration: font_atlas_texture.h
 typedef struct ShovelerMaterialStruct ShovelerMaterial; // forward declaration: material.h
 typedef struct ShovelerModelStruct ShovelerModel; // forward declaration: model.h
-typedef struct ShovelerRenderStateStruct ShovelerRenderState; // forward declaration: render_state.h
-typedef struct ShovelerSceneStruct ShovelerScene; // forward declaration: scene.h
 typedef struct ShovelerShaderCacheStruct ShovelerShaderCache; // forward declaration: shader_cache.h
 typedef struct ShovelerSpriteStruct ShovelerSprite; // forward declaration: sprite.h
-typedef struct ShovelerTextureStruct ShovelerTexture; // forward declaration: texture.h
+
+/** number of text textures no longer referenced that a renderer keeps cached by default */
+#define SHOVELER_TEXT_TEXTURE_RENDERER_DEFAULT_CACHE_CAPACITY 64
+/** width and height of the shared atlas textures that texts are packed into, unless a single text is larger */
+#define SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_SIZE 1024
+/** number of empty texels kept around every text in an atlas, so that interpolated samples don't bleed into neighbors */
+#define SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING 1
+
+typedef struct ShovelerTextTextureAtlasStruct ShovelerTextTextureAtlas; // forward declaration: text_texture_renderer.c
 
 typedef struct ShovelerTextTextureStruct {
 	char *text;
+	/** shared atlas texture the text is rendered into together with other texts, owned by the renderer */
 	ShovelerTexture *texture;
+	/** region of the atlas texture covered by the text in texels, starting from its bottom left corner */
+	unsigned int x;
+	unsigned int y;
+	unsigned int width;
+	unsigned int height;
+	/* private */ ShovelerTextTextureAtlas *atlas;
+	/** distance of the text's baseline from the bottom of its region */
+	/* private */ float baseline;
+	/* private */ int references;
+	/* private */ bool pending;
+	/** link in the renderer's queue of unreferenced text textures, or NULL while referenced */
+	/* private */ GList *unusedLink;
 } ShovelerTextTexture;
 
+/**
+ * Renders texts of a font atlas into regions of shared atlas textures, caching them by text so that repeated labels are
+ * only rendered once. Texts are packed into shelves of an atlas, and the texts requested within a frame are rendered
+ * straight into their regions with a single scene pass per shelf they landed on. Shelves whose texts were all evicted
+ * are filled again by new texts of similar height, and atlases whose texts were all evicted are freed.
+ */
 typedef struct ShovelerTextTextureRendererStruct {
 	ShovelerFontAtlasTexture *fontAtlasTexture;
 	ShovelerScene *textScene;
@@ -31,12 +59,51 @@ typedef struct ShovelerTextTextureRendererStruct {
 	ShovelerDrawable *textQuad;
 	ShovelerModel *textModel;
 	ShovelerCanvas *textCanvas;
-	ShovelerSprite *textSprite;
+	/** number of unreferenced text textures kept cached before the least recently used ones are freed */
+	unsigned int cacheCapacity;
+	int cacheHits;
+	int cacheMisses;
+	int batchesRendered;
+	/* private */ ShovelerSceneRenderPassOptions textSceneRenderPassOptions;
+	/** array of (ShovelerSprite *) text sprites, one per text in the largest batch rendered so far */
+	/* private */ GArray *batchSprites;
+	/** queue of (ShovelerTextTextureAtlas *) that texts are packed into, with the one opened most recently last */
+	/* private */ GQueue *atlases;
+	/** map from (const char *) text to (ShovelerTextTexture *) */
+	/* private */ GHashTable *textTextures;
+	/** queue of unreferenced (ShovelerTextTexture *) from least to most recently used */
+	/* private */ GQueue *unusedTextTextures;
+	/** queue of (ShovelerTextTexture *) requested but not rendered yet */
+	/* private */ GQueue *pendingTextTextures;
 } ShovelerTextTextureRenderer;
 
 /** Create a renderer with the caller retaining ownership over the passed font atlas texture. */
 ShovelerTextTextureRenderer *shovelerTextTextureRendererCreate(ShovelerFontAtlasTexture *fontAtlasTexture, ShovelerShaderCache *shaderCache);
-ShovelerTexture *shovelerTextTextureRendererRender(ShovelerTextTextureRenderer *renderer, const char *text, ShovelerRenderState *renderState);
+/**
+ * Returns the region of an atlas texture holding the passed text, rendering it right away together with all other
+ * pending texts unless it is cached. The text texture is owned by the renderer and must be released using
+ * shovelerTextTextureRendererRelease.
+ */
+ShovelerTextTexture *shovelerTextTextureRendererRender(ShovelerTextTextureRenderer *renderer, const char *text, ShovelerRenderState *renderState);
+/**
+ * Returns the region of an atlas texture holding the passed text like shovelerTextTextureRendererRender, but defers
+ * rendering it to the next call to shovelerTextTextureRendererFlush if it isn't cached. The region is empty until then.
+ */
+ShovelerTextTexture *shovelerTextTextureRendererRequest(ShovelerTextTextureRenderer *renderer, const char *text);
+/** Renders all pending texts into their atlas regions, using one scene pass per atlas shelf with pending texts. */
+bool shovelerTextTextureRendererFlush(ShovelerTextTextureRenderer *renderer, ShovelerRenderState *renderState);
+/** Drops a reference to a text texture, which stays cached until evicted by less recently used texts. */
+void shovelerTextTextureRendererRelease(ShovelerTextTextureRenderer *renderer, ShovelerTextTexture *textTexture);
 void shovelerTextTextureRendererFree(ShovelerTextTextureRenderer *renderer);
 
+static inline ShovelerVector2 shovelerTextTextureGetUvPosition(const ShovelerTextTexture *textTexture)
+{
+	return shovelerVector2((float) textTexture->x / textTexture->texture->width, (float) textTexture->y / textTexture->texture->height);
+}
+
+static inline ShovelerVector2 shovelerTextTextureGetUvSize(const ShovelerTextTexture *textTexture)
+{
+	return shovelerVector2((float) textTexture->width / textTexture->texture->width, (float) textTexture->height / textTexture->texture->height);
+}
+
 #endif
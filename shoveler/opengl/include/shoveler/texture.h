@@ -6,23 +6,56 @@
 #include <glad/glad.h>
 
 typedef struct ShovelerImageStruct ShovelerImage; // forward declaration: image.h
+typedef struct ShovelerTextureUploaderStruct ShovelerTextureUploader; // forward declaration: texture_uploader.h
 
 typedef struct ShovelerTextureStruct {
 	unsigned int width;
 	unsigned int height;
 	unsigned int channels;
+	/** number of array layers, or 1 for textures that aren't arrays */
+	unsigned int layers;
 	ShovelerImage *image;
 	bool manageImage;
 	GLuint target;
 	GLuint texture;
 	GLuint internalFormat;
 	GLuint format;
+	/** whether the texture has a full mipmap chain that is regenerated whenever its image is uploaded */
+	bool mipmaps;
+	/** bounding rectangle of image regions marked as changed since the last upload, empty if its size is zero */
+	/* private */ unsigned int dirtyX;
+	/* private */ unsigned int dirtyY;
+	/* private */ unsigned int dirtyWidth;
+	/* private */ unsigned int dirtyHeight;
+	/** uploader with a queued upload of this texture's image, if any */
+	/* private */ ShovelerTextureUploader *uploader;
 } ShovelerTexture;
 
 ShovelerTexture *shovelerTextureCreate2d(ShovelerImage *image, bool manageImage);
+/** Creates a 2D texture with only a base level, for images that are only ever sampled without mipmapping. */
+ShovelerTexture *shovelerTextureCreate2dWithoutMipmaps(ShovelerImage *image, bool manageImage);
+/** Creates a 2D array texture without mipmaps from an image stacking its equally high layers vertically. */
+ShovelerTexture *shovelerTextureCreate2dArray(ShovelerImage *image, unsigned int layers, bool manageImage);
 ShovelerTexture *shovelerTextureCreateRenderTarget(unsigned int width, unsigned int height, unsigned int channels, GLsizei samples, int bitsPerChannel);
 ShovelerTexture *shovelerTextureCreateDepthTarget(unsigned int width, unsigned int height, GLsizei samples);
+/** Creates a single sampled 2D array render target to be rendered into with layered framebuffers. */
+ShovelerTexture *shovelerTextureCreateRenderTargetArray(unsigned int width, unsigned int height, unsigned int layers, unsigned int channels, int bitsPerChannel);
+ShovelerTexture *shovelerTextureCreateDepthTargetArray(unsigned int width, unsigned int height, unsigned int layers);
+/** Creates a 2D texture view sharing the storage of a single layer of the passed array texture, which must outlive it. */
+ShovelerTexture *shovelerTextureCreateLayerView(ShovelerTexture *arrayTexture, unsigned int layer);
+/** Creates a single layer 2D array texture view sharing the storage of the passed 2D texture, which must outlive it. */
+ShovelerTexture *shovelerTextureCreateArrayView(ShovelerTexture *texture2d);
+/** Uploads the whole image of the texture. */
 bool shovelerTextureUpdate(ShovelerTexture *texture);
+/** Uploads a rectangle of the texture's image, in every layer for arrays, regenerating mipmaps only if the texture has them. */
+bool shovelerTextureUpdateRegion(ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+/** Grows the rectangle of the image to be uploaded by the next call to shovelerTextureUpdateDirty. */
+void shovelerTextureMarkDirty(ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+/** Uploads the bounding rectangle of all regions marked dirty since the last upload, doing nothing if there are none. */
+bool shovelerTextureUpdateDirty(ShovelerTexture *texture);
+/** Binds the texture to the active unit to modify it, which shovelerTextureUse takes into account. */
+void shovelerTextureBind(ShovelerTexture *texture);
+/** Binds the texture to a unit, skipping the bind if it is still bound there from the last use. */
 bool shovelerTextureUse(ShovelerTexture *texture, GLuint unitIndex);
 void shovelerTextureFree(ShovelerTexture *texture);
 
@@ -0,0 +1,57 @@
+#ifndef SHOVELER_TEXTURE_UPLOADER_H
+#define SHOVELER_TEXTURE_UPLOADER_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <glad/glad.h>
+#include <glib.h>
+
+typedef struct ShovelerTextureStruct ShovelerTexture; // forward declaration: texture.h
+
+/** number of pixel buffers cycled through, so that filling one never waits for the GPU to finish reading another */
+#define SHOVELER_TEXTURE_UPLOADER_BUFFERS 3
+
+typedef struct {
+	GLuint buffer;
+	/** fence signaled once the GPU finished reading the uploads last issued from this buffer, or NULL */
+	GLsync fence;
+} ShovelerTextureUploaderBuffer;
+
+/**
+ * Streams texture images to the GPU through pixel buffers, spreading large uploads across frames by copying at most a
+ * budget of bytes per frame in whole image rows.
+ */
+typedef struct ShovelerTextureUploaderStruct {
+	/** maximum number of bytes uploaded per frame, where an image row larger than it is still uploaded whole */
+	size_t frameBudget;
+	/** number of bytes uploaded by the last update */
+	size_t bytesUploaded;
+	/** number of bytes still queued for upload */
+	size_t bytesPending;
+	/* private */ ShovelerTextureUploaderBuffer buffers[SHOVELER_TEXTURE_UPLOADER_BUFFERS];
+	/* private */ int nextBuffer;
+	/** queue of (ShovelerTextureUploaderUpload *) in the order they were enqueued */
+	/* private */ GQueue *uploads;
+	/** map from textures to their queued upload */
+	/* private */ GHashTable *textureUploads;
+	/** array of (ShovelerTextureUploaderBand) issued in the current update, reused across updates */
+	/* private */ GArray *bands;
+} ShovelerTextureUploader;
+
+ShovelerTextureUploader *shovelerTextureUploaderCreate(size_t frameBudget);
+/** Queues uploading the whole image of a texture, which must stay alive until uploaded or the texture is freed. */
+void shovelerTextureUploaderEnqueue(ShovelerTextureUploader *uploader, ShovelerTexture *texture);
+/** Queues uploading a rectangle of a texture's image, merging it with an upload of the same texture still queued. */
+void shovelerTextureUploaderEnqueueRegion(ShovelerTextureUploader *uploader, ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+/** Drops any queued upload of the passed texture, which is done automatically when the texture is freed. */
+void shovelerTextureUploaderCancel(ShovelerTextureUploader *uploader, ShovelerTexture *texture);
+/**
+ * Copies the next queued rows up to the frame budget into a pixel buffer and issues their uploads, to be called once
+ * per frame. Skips the frame without blocking if the GPU is still reading from the next buffer in line.
+ */
+bool shovelerTextureUploaderUpdate(ShovelerTextureUploader *uploader);
+/** Frees the uploader, dropping all queued uploads. */
+void shovelerTextureUploaderFree(ShovelerTextureUploader *uploader);
+
+#endif
@@ -19,13 +19,14 @@ typedef struct ShovelerTilemapStruct {
 	/** list of (ShovelerTileset *) */
 	GQueue *tilesets;
 	/**
-	 * Array of booleans indicating colliding tiles, where tile (column, row) is at position [row * numColumns + column].
+	 * Array of bytes that are nonzero for colliding tiles, where tile (column, row) is at position
+	 * [row * numColumns + column].
 	 */
-	const bool *collidingTiles;
+	const unsigned char *collidingTiles;
 } ShovelerTilemap;
 
 /** Creates a tilemap from a texture and an array of colliding tiles, with the caller retaining ownership over both. */
-ShovelerTilemap *shovelerTilemapCreate(ShovelerTexture *tiles, const bool *collidingTiles);
+ShovelerTilemap *shovelerTilemapCreate(ShovelerTexture *tiles, const unsigned char *collidingTiles);
 /** Adds a tileset to the tilemap, returning its index. */
 int shovelerTilemapAddTileset(ShovelerTilemap *tilemap, ShovelerTileset *tileset);
 bool shovelerTilemapIntersect(ShovelerTilemap *tilemap, const ShovelerBoundingBox2 *boundingBox, const ShovelerBoundingBox2 *object);
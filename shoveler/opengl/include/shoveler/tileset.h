@@ -6,6 +6,7 @@
 typedef struct ShovelerImageStruct ShovelerImage; // forward declaration: image.h
 typedef struct ShovelerSamplerStruct ShovelerSampler; // forward declaration: sampler.h
 typedef struct ShovelerTextureStruct ShovelerTexture; // forward declaration: texture.h
+typedef struct ShovelerTextureUploaderStruct ShovelerTextureUploader; // forward declaration: texture_uploader.h
 
 typedef struct ShovelerTilesetStruct {
 	unsigned char columns;
@@ -18,6 +19,16 @@ typedef struct ShovelerTilesetStruct {
 
 /** Creates a tileset from an existing image, with the caller retaining ownership over the passed image. */
 ShovelerTileset *shovelerTilesetCreate(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding);
+/**
+ * Creates a tileset like shovelerTilesetCreate, but queues its texture on the passed uploader to be streamed in over the
+ * next frames instead of uploading it right away.
+ */
+ShovelerTileset *shovelerTilesetCreateStreamed(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding, ShovelerTextureUploader *uploader);
+/**
+ * Creates a tileset whose texture is an array with one layer per passed image, with the caller retaining ownership over
+ * the passed images. All images must have the same size and are split into the same grid of tiles.
+ */
+ShovelerTileset *shovelerTilesetCreateArray(const ShovelerImage *const *images, unsigned int numImages, unsigned char columns, unsigned char rows, unsigned char padding);
 /** Creates a tileset from an existing texture, with the caller retaining ownership over the passed texture. */
 ShovelerTileset *shovelerTilesetCreateFromTexture(ShovelerTexture *texture, unsigned char columns, unsigned char rows, unsigned char padding);
 void shovelerTilesetFree(ShovelerTileset *tileset);
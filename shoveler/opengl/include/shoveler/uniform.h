@@ -9,6 +9,8 @@
 #include <shoveler/texture.h>
 #include <shoveler/types.h>
 
+typedef struct ShovelerUniformBufferStruct ShovelerUniformBuffer; // forward declaration: uniform_buffer.h
+
 typedef enum {
 	SHOVELER_UNIFORM_TYPE_BOOL,
 	SHOVELER_UNIFORM_TYPE_BOOL_POINTER,
@@ -27,7 +29,9 @@ typedef enum {
 	SHOVELER_UNIFORM_TYPE_MATRIX,
 	SHOVELER_UNIFORM_TYPE_MATRIX_POINTER,
 	SHOVELER_UNIFORM_TYPE_TEXTURE,
-	SHOVELER_UNIFORM_TYPE_TEXTURE_POINTER
+	SHOVELER_UNIFORM_TYPE_TEXTURE_POINTER,
+	/** uniform block backed by a buffer, attached by block name instead of uniform location */
+	SHOVELER_UNIFORM_TYPE_BUFFER
 } ShovelerUniformType;
 
 typedef struct {
@@ -59,6 +63,7 @@ typedef union {
 	ShovelerMatrix *matrixPointerValue;
 	ShovelerUniformTexture textureValue;
 	ShovelerUniformTexturePointer texturePointerValue;
+	ShovelerUniformBuffer *bufferValue;
 } ShovelerUniformValue;
 
 typedef struct {
@@ -66,6 +71,12 @@ typedef struct {
 	ShovelerUniformValue value;
 } ShovelerUniform;
 
+/** Value last uploaded to a uniform location of a shader program, used to skip redundant uploads. */
+typedef struct {
+	bool valid;
+	ShovelerUniformValue value;
+} ShovelerUniformCacheEntry;
+
 ShovelerUniform *shovelerUniformCreateBool(bool value);
 ShovelerUniform *shovelerUniformCreateBoolPointer(bool *value);
 ShovelerUniform *shovelerUniformCreateInt(int value);
@@ -84,8 +95,11 @@ ShovelerUniform *shovelerUniformCreateMatrix(ShovelerMatrix value);
 ShovelerUniform *shovelerUniformCreateMatrixPointer(ShovelerMatrix *value);
 ShovelerUniform *shovelerUniformCreateTexture(ShovelerTexture *texture, ShovelerSampler *sampler);
 ShovelerUniform *shovelerUniformCreateTexturePointer(ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer);
+ShovelerUniform *shovelerUniformCreateBuffer(ShovelerUniformBuffer *buffer);
 ShovelerUniform *shovelerUniformCopy(const ShovelerUniform *uniform);
 bool shovelerUniformUse(ShovelerUniform *uniform, GLint location, GLuint *textureUnitIndexCounter);
+/** Same as shovelerUniformUse, but only uploads the value if it differs from the one stored in the cache entry. */
+bool shovelerUniformUseCached(ShovelerUniform *uniform, GLint location, GLuint *textureUnitIndexCounter, ShovelerUniformCacheEntry *cacheEntry);
 void shovelerUniformFree(ShovelerUniform *uniform);
 
 #endif
@@ -6,9 +6,11 @@
 typedef struct {
 	ShovelerUniform *uniform;
 	GLint location;
+	/** per-program upload cache for this location, or NULL to always upload */
+	ShovelerUniformCacheEntry *cacheEntry;
 } ShovelerUniformAttachment;
 
-ShovelerUniformAttachment *shovelerUniformAttachmentCreate(ShovelerUniform *uniform, GLint location);
+ShovelerUniformAttachment *shovelerUniformAttachmentCreate(ShovelerUniform *uniform, GLint location, ShovelerUniformCacheEntry *cacheEntry);
 bool shovelerUniformAttachmentUse(ShovelerUniformAttachment *uniformAttachment, GLuint *textureUnitIndexCounter);
 void shovelerUniformAttachmentFree(ShovelerUniformAttachment *uniformAttachment);
 
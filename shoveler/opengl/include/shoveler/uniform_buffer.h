@@ -0,0 +1,36 @@
+#ifndef SHOVELER_UNIFORM_BUFFER_H
+#define SHOVELER_UNIFORM_BUFFER_H
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+#include <glad/glad.h>
+
+/** Uniform block binding points shared by all shader programs. */
+typedef enum {
+	SHOVELER_UNIFORM_BUFFER_BINDING_CAMERA = 0,
+	SHOVELER_UNIFORM_BUFFER_BINDING_LIGHT = 1,
+	SHOVELER_UNIFORM_BUFFER_BINDING_LIGHT_FACES = 2,
+} ShovelerUniformBufferBinding;
+
+/** Writes the current std140 contents of a uniform buffer into the passed data of the buffer's size. */
+typedef void (ShovelerUniformBufferFillFunction)(void *data, void *userData);
+
+typedef struct ShovelerUniformBufferStruct {
+	GLuint buffer;
+	ShovelerUniformBufferBinding binding;
+	size_t size;
+	/** callback to refresh the contents on use, or NULL to keep them zeroed */
+	ShovelerUniformBufferFillFunction *fill;
+	void *userData;
+	/* private */ void *stagingData;
+	/* private */ void *uploadedData;
+	/* private */ bool uploaded;
+} ShovelerUniformBuffer;
+
+ShovelerUniformBuffer *shovelerUniformBufferCreate(ShovelerUniformBufferBinding binding, size_t size, ShovelerUniformBufferFillFunction *fill, void *userData);
+/** Refreshes the contents through the fill callback, uploads them only if they changed, and binds the buffer. */
+bool shovelerUniformBufferUse(ShovelerUniformBuffer *uniformBuffer);
+void shovelerUniformBufferFree(ShovelerUniformBuffer *uniformBuffer);
+
+#endif
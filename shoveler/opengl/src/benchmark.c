@@ -0,0 +1,574 @@
+#include <math.h> // cos, sin
+#include <stdio.h> // fprintf, printf, fflush
+#include <stdlib.h> // atoi, malloc, free, qsort, EXIT_FAILURE, EXIT_SUCCESS
+#include <string.h> // strcmp
+
+#include <glib.h>
+
+#include "shoveler/camera/perspective.h"
+#include "shoveler/drawable/cube.h"
+#include "shoveler/drawable/quad.h"
+#include "shoveler/drawable/tiles.h"
+#include "shoveler/light/point.h"
+#include "shoveler/material/canvas.h"
+#include "shoveler/material/color.h"
+#include "shoveler/material/texture.h"
+#include "shoveler/material/tile_sprite.h"
+#include "shoveler/material/tilemap.h"
+#include "shoveler/material/tiles.h"
+#include "shoveler/sprite/tile.h"
+#include "shoveler/image/png.h"
+#include "shoveler/canvas.h"
+#include "shoveler/constants.h"
+#include "shoveler/framebuffer.h"
+#include "shoveler/game.h"
+#include "shoveler/global.h"
+#include "shoveler/image.h"
+#include "shoveler/log.h"
+#include "shoveler/model.h"
+#include "shoveler/opengl.h"
+#include "shoveler/sampler.h"
+#include "shoveler/scene.h"
+#include "shoveler/texture.h"
+#include "shoveler/tile_sprite_animation.h"
+#include "shoveler/tilemap.h"
+#include "shoveler/tileset.h"
+
+#define BENCHMARK_WIDTH 640
+#define BENCHMARK_HEIGHT 480
+#define BENCHMARK_DEFAULT_FRAMES 120
+/** frames rendered before measuring, so shader compilation and texture uploads don't skew the statistics */
+#define BENCHMARK_WARMUP_FRAMES 10
+/** simulated time step per frame, which keeps the scene identical between runs regardless of the measured frame times */
+#define BENCHMARK_TIME_STEP (1.0 / 60.0)
+#define BENCHMARK_CANVAS_SPRITES_PER_SIDE 16
+#define BENCHMARK_NUM_CUBES 4
+#define BENCHMARK_NUM_POINT_LIGHTS 2
+#define BENCHMARK_SHADOW_MAP_SIZE 512
+
+typedef struct {
+	int numFrames;
+	/** whether point lights render all their faces in a single layered pass instead of one pass per face */
+	bool layeredPointLights;
+	/** maximum number of lights casting shadows per frame, or zero for no limit */
+	int maxShadowedLights;
+	/** whether lights render their shadow maps into a shared atlas instead of their own framebuffers */
+	bool shadowAtlas;
+	/** whether light passes skip models that the previous frame's occlusion queries found hidden */
+	bool occlusionCulling;
+	/** factor by which shared shadow map filters reduce the resolution they blur at */
+	int shadowFilterDownsample;
+	/** whether the tilemap is drawn as a shadow casting tiles drawable instead of a tilemap textured emitter quad */
+	bool tilesDrawable;
+	/** file to write the last frame to as PNG, e.g. to compare the output of different options, or NULL */
+	const char *outputFilename;
+} BenchmarkOptions;
+
+typedef struct {
+	BenchmarkOptions options;
+	ShovelerSampler *sampler;
+	ShovelerTexture *cubeTexture;
+	ShovelerMaterial *colorMaterial;
+	ShovelerMaterial *textureMaterial;
+	ShovelerMaterial *tilemapMaterial;
+	ShovelerMaterial *tilesMaterial;
+	ShovelerMaterial *tileSpriteMaterial;
+	ShovelerMaterial *canvasMaterial;
+	ShovelerDrawable *quad;
+	ShovelerDrawable *cube;
+	ShovelerDrawable *tilesDrawable;
+	ShovelerModel *cubeModels[BENCHMARK_NUM_CUBES];
+	ShovelerTexture *tiles;
+	ShovelerTileset *tileset;
+	ShovelerTileset *tilesTileset;
+	ShovelerTileset *animationTileset;
+	ShovelerTilemap *tilemap;
+	ShovelerCanvas *canvas;
+	/** array of (ShovelerSprite *) static tile sprites on the canvas */
+	GArray *tileSprites;
+	ShovelerSprite *characterSprite;
+	ShovelerTileSpriteAnimation *animation;
+	int frame;
+} Benchmark;
+
+static bool parseOptions(int argc, char *argv[], BenchmarkOptions *options);
+static void setUp(Benchmark *benchmark, ShovelerGame *game);
+static void addRoom(Benchmark *benchmark, ShovelerGame *game);
+static void addTilemap(Benchmark *benchmark, ShovelerGame *game);
+static void addTilesDrawable(Benchmark *benchmark, ShovelerGame *game, ShovelerImage *tilesetImage);
+static void addCanvas(Benchmark *benchmark, ShovelerGame *game, ShovelerImage *tilesetImage);
+static void tearDown(Benchmark *benchmark);
+static void update(ShovelerGame *game, double dt);
+static bool writeFrame(ShovelerGame *game, const char *filename);
+static void report(int numFrames, gint64 *frameTimes, ShovelerScene *scene);
+static double getPercentileMs(int numFrames, gint64 *sortedFrameTimes, double percentile);
+static int compareFrameTimes(const void *firstPointer, const void *secondPointer);
+
+static Benchmark benchmark;
+
+/**
+ * Renders a deterministic scene combining the lights, tiles and canvas examples headlessly for the number of frames
+ * given on the command line, and prints frame time statistics to stdout as a JSON object. Options following the number
+ * of frames switch on optional rendering paths, whose output can be compared by writing the last frame to a file.
+ */
+int main(int argc, char *argv[])
+{
+	if(!parseOptions(argc, argv, &benchmark.options)) {
+		fprintf(stderr, "usage: %s [frames] [--layered-point-lights] [--max-shadowed-lights <lights>] [--shadow-atlas] [--occlusion-culling] [--shadow-filter-downsample <factor>] [--tiles-drawable] [--output <file.png>]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	int numFrames = benchmark.options.numFrames;
+
+	ShovelerGameWindowSettings windowSettings;
+	windowSettings.windowTitle = "shoveler benchmark";
+	windowSettings.fullscreen = false;
+	windowSettings.vsync = false;
+	windowSettings.samples = 4;
+	windowSettings.windowedWidth = BENCHMARK_WIDTH;
+	windowSettings.windowedHeight = BENCHMARK_HEIGHT;
+	windowSettings.headless = true;
+
+	ShovelerGameCameraSettings cameraSettings;
+	cameraSettings.frame.position = shovelerVector3(0, 0, -5);
+	cameraSettings.frame.direction = shovelerVector3(0, 0, 1);
+	cameraSettings.frame.up = shovelerVector3(0, 1, 0);
+	cameraSettings.projection.fieldOfViewY = 2.0f * SHOVELER_PI * 50.0f / 360.0f;
+	cameraSettings.projection.aspectRatio = (float) windowSettings.windowedWidth / windowSettings.windowedHeight;
+	cameraSettings.projection.nearClippingPlane = 0.01;
+	cameraSettings.projection.farClippingPlane = 1000;
+
+	ShovelerGameControllerSettings controllerSettings;
+	controllerSettings.frame = cameraSettings.frame;
+	controllerSettings.moveFactor = 0.0f;
+	controllerSettings.tiltFactor = 0.0f;
+	controllerSettings.boundingBoxSize2 = 0.0f;
+	controllerSettings.boundingBoxSize3 = 0.0f;
+
+	shovelerLogInit("shoveler/", SHOVELER_LOG_LEVEL_WARNING_UP, stderr);
+	if(!shovelerGlobalInit()) {
+		shovelerLogTerminate();
+		return EXIT_FAILURE;
+	}
+
+	ShovelerGame *game = shovelerGameCreate(update, &windowSettings, &cameraSettings, &controllerSettings);
+	if(game == NULL) {
+		shovelerGlobalUninit();
+		shovelerLogTerminate();
+		return EXIT_FAILURE;
+	}
+
+	game->controller->lockMoveX = true;
+	game->controller->lockMoveY = true;
+	game->controller->lockMoveZ = true;
+	game->controller->lockTiltX = true;
+	game->controller->lockTiltY = true;
+
+	game->scene->lightOptions.maxShadowedLights = benchmark.options.maxShadowedLights;
+	if(benchmark.options.shadowAtlas) {
+		// one row of tiles for the faces of each of the point lights
+		shovelerSceneEnableShadowAtlas(game->scene, BENCHMARK_SHADOW_MAP_SIZE, BENCHMARK_SHADOW_MAP_SIZE, SHOVELER_LIGHT_POINT_FACES, BENCHMARK_NUM_POINT_LIGHTS);
+	}
+	game->scene->occlusionCulling = benchmark.options.occlusionCulling;
+	game->scene->lightOptions.shadowFilterDownsample = benchmark.options.shadowFilterDownsample;
+
+	setUp(&benchmark, game);
+
+	for(int i = 0; i < BENCHMARK_WARMUP_FRAMES; i++) {
+		shovelerGameRenderFrame(game);
+	}
+
+	gint64 *frameTimes = malloc(numFrames * sizeof(gint64));
+	for(int i = 0; i < numFrames; i++) {
+		gint64 start = g_get_monotonic_time();
+		shovelerGameRenderFrame(game);
+		frameTimes[i] = g_get_monotonic_time() - start;
+	}
+
+	bool success = shovelerOpenGLCheckSuccess();
+	if(success && benchmark.options.outputFilename != NULL) {
+		success = writeFrame(game, benchmark.options.outputFilename);
+	}
+
+	if(success) {
+		report(numFrames, frameTimes, game->scene);
+	}
+
+	free(frameTimes);
+	tearDown(&benchmark);
+	shovelerGameFree(game);
+	shovelerGlobalUninit();
+	shovelerLogTerminate();
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static bool parseOptions(int argc, char *argv[], BenchmarkOptions *options)
+{
+	options->numFrames = BENCHMARK_DEFAULT_FRAMES;
+	options->layeredPointLights = false;
+	options->maxShadowedLights = 0;
+	options->shadowAtlas = false;
+	options->occlusionCulling = false;
+	options->shadowFilterDownsample = 1;
+	options->tilesDrawable = false;
+	options->outputFilename = NULL;
+
+	int i = 1;
+	if(i < argc && argv[i][0] != '-') {
+		options->numFrames = atoi(argv[i++]);
+		if(options->numFrames <= 0) {
+			return false;
+		}
+	}
+
+	for(; i < argc; i++) {
+		if(strcmp(argv[i], "--layered-point-lights") == 0) {
+			options->layeredPointLights = true;
+		} else if(strcmp(argv[i], "--max-shadowed-lights") == 0 && i + 1 < argc) {
+			options->maxShadowedLights = atoi(argv[++i]);
+		} else if(strcmp(argv[i], "--shadow-atlas") == 0) {
+			options->shadowAtlas = true;
+		} else if(strcmp(argv[i], "--occlusion-culling") == 0) {
+			options->occlusionCulling = true;
+		} else if(strcmp(argv[i], "--shadow-filter-downsample") == 0 && i + 1 < argc) {
+			options->shadowFilterDownsample = atoi(argv[++i]);
+			if(options->shadowFilterDownsample <= 0) {
+				return false;
+			}
+		} else if(strcmp(argv[i], "--tiles-drawable") == 0) {
+			options->tilesDrawable = true;
+		} else if(strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			options->outputFilename = argv[++i];
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void setUp(Benchmark *benchmark, ShovelerGame *game)
+{
+	benchmark->frame = 0;
+
+	ShovelerImage *tilesetImage = shovelerImageCreate(2, 2, 4);
+	shovelerImageClear(tilesetImage);
+	shovelerImageGet(tilesetImage, 0, 0, 0) = 255; // red
+	shovelerImageGet(tilesetImage, 0, 0, 3) = 255;
+	shovelerImageGet(tilesetImage, 0, 1, 1) = 255; // green
+	shovelerImageGet(tilesetImage, 0, 1, 3) = 255;
+	shovelerImageGet(tilesetImage, 1, 0, 2) = 255; // blue
+	shovelerImageGet(tilesetImage, 1, 0, 3) = 255;
+	shovelerImageGet(tilesetImage, 1, 1, 0) = 255; // white
+	shovelerImageGet(tilesetImage, 1, 1, 1) = 255;
+	shovelerImageGet(tilesetImage, 1, 1, 2) = 255;
+	shovelerImageGet(tilesetImage, 1, 1, 3) = 255;
+
+	// shared by the tilemap and the canvas' tile sprites
+	benchmark->tileset = shovelerTilesetCreate(tilesetImage, 2, 2, 1);
+
+	addRoom(benchmark, game);
+	if(benchmark->options.tilesDrawable) {
+		addTilesDrawable(benchmark, game, tilesetImage);
+	} else {
+		addTilemap(benchmark, game);
+	}
+	addCanvas(benchmark, game, tilesetImage);
+
+	shovelerImageFree(tilesetImage);
+}
+
+/** Adds the walled room with textured cubes lit by the two shadow casting point lights of the lights example. */
+static void addRoom(Benchmark *benchmark, ShovelerGame *game)
+{
+	benchmark->sampler = shovelerSamplerCreate(false, true, true);
+	benchmark->colorMaterial = shovelerMaterialColorCreate(game->shaderCache, /* screenspace */ false, shovelerVector4(0.7, 0.7, 0.7, 1.0));
+
+	ShovelerImage *image = shovelerImageCreate(2, 2, 3);
+	shovelerImageClear(image);
+	shovelerImageGet(image, 0, 0, 0) = 255;
+	shovelerImageGet(image, 0, 1, 1) = 255;
+	shovelerImageGet(image, 1, 0, 2) = 255;
+	shovelerImageGet(image, 1, 1, 0) = 255;
+	shovelerImageGet(image, 1, 1, 1) = 255;
+	shovelerImageGet(image, 1, 1, 2) = 255;
+	benchmark->cubeTexture = shovelerTextureCreate2d(image, true);
+	shovelerTextureUpdate(benchmark->cubeTexture);
+	benchmark->textureMaterial = shovelerMaterialTextureCreate(game->shaderCache, /* screenspace */ false, SHOVELER_MATERIAL_TEXTURE_TYPE_PHONG, benchmark->cubeTexture, /* manageTexture */ false, benchmark->sampler, /* manageSampler */ false);
+
+	benchmark->quad = shovelerDrawableQuadCreate();
+
+	ShovelerVector3 wallTranslations[] = {
+		shovelerVector3(0.0f, -10.0f, 0.0f),
+		shovelerVector3(0.0f, 10.0f, 0.0f),
+		shovelerVector3(0.0f, 0.0f, 10.0f),
+		shovelerVector3(0.0f, 0.0f, -10.0f),
+		shovelerVector3(10.0f, 0.0f, 0.0f),
+		shovelerVector3(-10.0f, 0.0f, 0.0f),
+	};
+	ShovelerVector3 wallRotations[] = {
+		shovelerVector3(SHOVELER_PI / 2.0f, 0.0f, 0.0f),
+		shovelerVector3(-SHOVELER_PI / 2.0f, 0.0f, 0.0f),
+		shovelerVector3(SHOVELER_PI, 0.0f, 0.0f),
+		shovelerVector3(0.0f, 0.0f, 0.0f),
+		shovelerVector3(0.0f, SHOVELER_PI / 2.0f, 0.0f),
+		shovelerVector3(0.0f, -SHOVELER_PI / 2.0f, 0.0f),
+	};
+	for(int i = 0; i < 6; i++) {
+		ShovelerModel *wallModel = shovelerModelCreate(benchmark->quad, benchmark->colorMaterial);
+		wallModel->translation = wallTranslations[i];
+		wallModel->rotation = wallRotations[i];
+		wallModel->scale = shovelerVector3(10.0f, 10.0f, 1.0f);
+		shovelerModelUpdateTransformation(wallModel);
+		shovelerSceneAddModel(game->scene, wallModel);
+	}
+
+	ShovelerVector3 cubeTranslations[BENCHMARK_NUM_CUBES] = {
+		shovelerVector3(0.0f, -5.0f, 0.0f),
+		shovelerVector3(0.0f, 0.0f, 5.0f),
+		shovelerVector3(5.0f, 0.0f, 0.0f),
+		shovelerVector3(-5.0f, 0.0f, 0.0f),
+	};
+	benchmark->cube = shovelerDrawableCubeCreate();
+	for(int i = 0; i < BENCHMARK_NUM_CUBES; i++) {
+		benchmark->cubeModels[i] = shovelerModelCreate(benchmark->cube, benchmark->textureMaterial);
+		benchmark->cubeModels[i]->translation = cubeTranslations[i];
+		shovelerModelUpdateTransformation(benchmark->cubeModels[i]);
+		shovelerSceneAddModel(game->scene, benchmark->cubeModels[i]);
+	}
+
+	ShovelerVector3 lightPositions[BENCHMARK_NUM_POINT_LIGHTS] = {shovelerVector3(0, 0, 0), shovelerVector3(-8, -8, -8)};
+	ShovelerVector3 lightColors[BENCHMARK_NUM_POINT_LIGHTS] = {shovelerVector3(1.0f, 1.0f, 1.0f), shovelerVector3(0.1f, 0.1f, 0.1f)};
+	for(int i = 0; i < BENCHMARK_NUM_POINT_LIGHTS; i++) {
+		ShovelerLight *pointlight;
+		if(benchmark->options.layeredPointLights) {
+			pointlight = shovelerLightPointCreateLayered(game->shaderCache, lightPositions[i], BENCHMARK_SHADOW_MAP_SIZE, BENCHMARK_SHADOW_MAP_SIZE, 0.0f, 80.0f, lightColors[i]);
+		} else {
+			pointlight = shovelerLightPointCreate(game->shaderCache, lightPositions[i], BENCHMARK_SHADOW_MAP_SIZE, BENCHMARK_SHADOW_MAP_SIZE, 1, 0.0f, 80.0f, lightColors[i]);
+		}
+		shovelerSceneAddLight(game->scene, pointlight);
+	}
+}
+
+/** Adds the tilemap of the tiles example, hovering to the left in front of the camera. */
+static void addTilemap(Benchmark *benchmark, ShovelerGame *game)
+{
+	ShovelerImage *tilesImage = shovelerImageCreate(2, 2, 3);
+	shovelerImageClear(tilesImage);
+	shovelerImageGet(tilesImage, 0, 0, 2) = 1; // red
+	shovelerImageGet(tilesImage, 0, 1, 2) = 1; // red
+	shovelerImageGet(tilesImage, 1, 0, 1) = 1;
+	shovelerImageGet(tilesImage, 1, 0, 2) = 1; // green
+	shovelerImageGet(tilesImage, 1, 1, 2) = 2; // full tileset
+	benchmark->tiles = shovelerTextureCreate2dWithoutMipmaps(tilesImage, true);
+	shovelerTextureUpdate(benchmark->tiles);
+
+	benchmark->tilemap = shovelerTilemapCreate(benchmark->tiles, NULL);
+	shovelerTilemapAddTileset(benchmark->tilemap, benchmark->tileset);
+
+	benchmark->tilemapMaterial = shovelerMaterialTilemapCreate(game->shaderCache, /* screenspace */ false);
+	shovelerMaterialTilemapSetActiveRegion(benchmark->tilemapMaterial, /* regionPosition */ shovelerVector2(0.0f, 0.0f), /* regionSize */ shovelerVector2(1.0f, 1.0f));
+	shovelerMaterialTilemapSetActive(benchmark->tilemapMaterial, benchmark->tilemap);
+
+	ShovelerModel *tilesModel = shovelerModelCreate(benchmark->quad, benchmark->tilemapMaterial);
+	tilesModel->translation = shovelerVector3(1.5f, 0.0f, 0.0f);
+	tilesModel->rotation = shovelerVector3(0.0f, SHOVELER_PI, 0.0f);
+	tilesModel->castsShadow = false;
+	tilesModel->emitter = true;
+	shovelerModelUpdateTransformation(tilesModel);
+	shovelerSceneAddModel(game->scene, tilesModel);
+}
+
+/** Adds the tiles of the tilemap as a tiles drawable behind the central light, casting their shadow onto the back wall. */
+static void addTilesDrawable(Benchmark *benchmark, ShovelerGame *game, ShovelerImage *tilesetImage)
+{
+	const ShovelerImage *tilesetImages[] = {tilesetImage};
+	benchmark->tilesTileset = shovelerTilesetCreateArray(tilesetImages, 1, 2, 2, 1);
+
+	benchmark->tilesDrawable = shovelerDrawableTilesCreate(2, 2);
+	ShovelerDrawableTilesTile tiles[] = {
+		{0, 0, 1}, // red
+		{0, 1, 1}, // green
+		{0, 0, 1}, // red
+		{1, 1, 1}, // white
+	};
+	shovelerDrawableTilesSetChunkTiles(benchmark->tilesDrawable, /* chunk */ 0, tiles);
+
+	benchmark->tilesMaterial = shovelerMaterialTilesCreate(game->shaderCache, /* screenspace */ false);
+	shovelerMaterialTilesSetActiveTileset(benchmark->tilesMaterial, benchmark->tilesTileset);
+
+	// the drawable's tiles start at its origin, so shift it by half its size to line up with the centered tilemap quad
+	ShovelerModel *tilesModel = shovelerModelCreate(benchmark->tilesDrawable, benchmark->tilesMaterial);
+	tilesModel->translation = shovelerVector3(2.5f, -1.0f, 2.0f);
+	tilesModel->rotation = shovelerVector3(0.0f, SHOVELER_PI, 0.0f);
+	shovelerModelUpdateTransformation(tilesModel);
+	shovelerSceneAddModel(game->scene, tilesModel);
+}
+
+/** Adds a canvas of the canvas example with a grid of tile sprites and an animated character, hovering to the right. */
+static void addCanvas(Benchmark *benchmark, ShovelerGame *game, ShovelerImage *tilesetImage)
+{
+	ShovelerImage *animationTilesetImage = shovelerImageCreateAnimationTileset(tilesetImage, 1);
+	benchmark->animationTileset = shovelerTilesetCreate(animationTilesetImage, 4, 3, 1);
+	shovelerImageFree(animationTilesetImage);
+
+	benchmark->canvas = shovelerCanvasCreate(/* numLayers */ 2);
+	benchmark->tileSpriteMaterial = shovelerMaterialTileSpriteCreate(game->shaderCache, /* screenspace */ false);
+
+	float spriteSize = 1.0f / BENCHMARK_CANVAS_SPRITES_PER_SIDE;
+	benchmark->tileSprites = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerSprite *));
+	for(int row = 0; row < BENCHMARK_CANVAS_SPRITES_PER_SIDE; row++) {
+		for(int column = 0; column < BENCHMARK_CANVAS_SPRITES_PER_SIDE; column++) {
+			ShovelerSprite *tileSprite = shovelerSpriteTileCreate(benchmark->tileSpriteMaterial, benchmark->tileset, /* tilesetRow */ row % 2, /* tilesetColumn */ (row / 2 + column) % 2);
+			shovelerSpriteUpdatePosition(tileSprite, shovelerVector2(-0.5f + (column + 0.5f) * spriteSize, -0.5f + (row + 0.5f) * spriteSize));
+			shovelerSpriteUpdateSize(tileSprite, shovelerVector2(spriteSize, spriteSize));
+			shovelerCanvasAddSprite(benchmark->canvas, /* layerId */ 0, tileSprite);
+			g_array_append_val(benchmark->tileSprites, tileSprite);
+		}
+	}
+
+	benchmark->characterSprite = shovelerSpriteTileCreate(benchmark->tileSpriteMaterial, benchmark->animationTileset, /* tilesetRow */ 0, /* tilesetColumn */ 0);
+	shovelerSpriteUpdateSize(benchmark->characterSprite, shovelerVector2(0.2f, 0.2f));
+	shovelerCanvasAddSprite(benchmark->canvas, /* layerId */ 1, benchmark->characterSprite);
+
+	benchmark->animation = shovelerTileSpriteAnimationCreate(benchmark->characterSprite, benchmark->characterSprite->position, 0.1f);
+	benchmark->animation->moveAmountThreshold = 0.05f;
+
+	benchmark->canvasMaterial = shovelerMaterialCanvasCreate(game->shaderCache, /* screenspace */ false);
+	shovelerMaterialCanvasSetActive(benchmark->canvasMaterial, benchmark->canvas);
+	shovelerMaterialCanvasSetActiveRegion(benchmark->canvasMaterial, shovelerVector2(0.0f, 0.0f), shovelerVector2(1.0f, 1.0f));
+
+	ShovelerModel *canvasModel = shovelerModelCreate(benchmark->quad, benchmark->canvasMaterial);
+	canvasModel->translation = shovelerVector3(-1.5f, 0.0f, 0.0f);
+	canvasModel->rotation = shovelerVector3(0.0f, SHOVELER_PI, 0.0f);
+	canvasModel->castsShadow = false;
+	canvasModel->emitter = true;
+	shovelerModelUpdateTransformation(canvasModel);
+	shovelerSceneAddModel(game->scene, canvasModel);
+}
+
+static void tearDown(Benchmark *benchmark)
+{
+	shovelerTileSpriteAnimationFree(benchmark->animation);
+	shovelerCanvasFree(benchmark->canvas);
+	for(guint i = 0; i < benchmark->tileSprites->len; i++) {
+		shovelerSpriteFree(g_array_index(benchmark->tileSprites, ShovelerSprite *, i));
+	}
+	g_array_free(benchmark->tileSprites, /* freeSegment */ true);
+	shovelerSpriteFree(benchmark->characterSprite);
+	shovelerTilemapFree(benchmark->tilemap);
+	shovelerTilesetFree(benchmark->tileset);
+	shovelerTilesetFree(benchmark->tilesTileset);
+	shovelerTilesetFree(benchmark->animationTileset);
+	shovelerTextureFree(benchmark->tiles);
+	shovelerDrawableFree(benchmark->cube);
+	if(benchmark->tilesDrawable != NULL) {
+		shovelerDrawableFree(benchmark->tilesDrawable);
+	}
+	shovelerDrawableFree(benchmark->quad);
+	shovelerMaterialFree(benchmark->canvasMaterial);
+	shovelerMaterialFree(benchmark->tileSpriteMaterial);
+	shovelerMaterialFree(benchmark->tilemapMaterial);
+	shovelerMaterialFree(benchmark->tilesMaterial);
+	shovelerMaterialFree(benchmark->textureMaterial);
+	shovelerMaterialFree(benchmark->colorMaterial);
+	shovelerTextureFree(benchmark->cubeTexture);
+	shovelerSamplerFree(benchmark->sampler);
+}
+
+/** Advances the scene by a fixed time step, ignoring the measured frame time so every run renders the same frames. */
+static void update(ShovelerGame *game, double dt)
+{
+	double time = benchmark.frame++ * BENCHMARK_TIME_STEP;
+
+	shovelerCameraUpdateView(game->camera);
+
+	for(int i = 0; i < BENCHMARK_NUM_CUBES; i++) {
+		ShovelerModel *cubeModel = benchmark.cubeModels[i];
+		cubeModel->rotation = shovelerVector3((0.1f + 0.1f * i) * time, 0.2f * time, (0.5f - 0.1f * i) * time);
+		shovelerModelUpdateTransformation(cubeModel);
+	}
+
+	ShovelerVector2 characterPosition = shovelerVector2(0.3f * cos(time), 0.3f * sin(time));
+	shovelerTileSpriteAnimationUpdate(benchmark.animation, characterPosition);
+	shovelerSpriteUpdatePosition(benchmark.characterSprite, characterPosition);
+}
+
+/** Resolves the game's possibly multisampled framebuffer and writes its contents to a PNG file. */
+static bool writeFrame(ShovelerGame *game, const char *filename)
+{
+	GLsizei width = game->framebuffer->width;
+	GLsizei height = game->framebuffer->height;
+	ShovelerFramebuffer *resolveFramebuffer = shovelerFramebufferCreateColorOnly(width, height, /* samples */ 1, /* channels */ 3, /* bitsPerChannel */ 8);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, game->framebuffer->framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFramebuffer->framebuffer);
+	glDisable(GL_SCISSOR_TEST);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	ShovelerImage *image = shovelerImageCreate(width, height, 3);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, resolveFramebuffer->framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, image->data);
+	shovelerFramebufferFree(resolveFramebuffer, /* keepTargets */ false);
+
+	if(!shovelerOpenGLCheckSuccess()) {
+		shovelerImageFree(image);
+		return false;
+	}
+
+	// OpenGL returns the bottom row first
+	ShovelerImage *flippedImage = shovelerImageCreateFlippedY(image);
+	bool success = shovelerImagePngWriteFile(flippedImage, filename);
+	shovelerImageFree(flippedImage);
+	shovelerImageFree(image);
+
+	return success;
+}
+
+static void report(int numFrames, gint64 *frameTimes, ShovelerScene *scene)
+{
+	gint64 totalFrameTime = 0;
+	for(int i = 0; i < numFrames; i++) {
+		totalFrameTime += frameTimes[i];
+	}
+
+	qsort(frameTimes, numFrames, sizeof(gint64), compareFrameTimes);
+
+	double meanMs = totalFrameTime / 1000.0 / numFrames;
+	printf(
+		"{\"benchmark\": \"headless_scene\", \"width\": %d, \"height\": %d, \"frames\": %d, \"fps\": %.1f, "
+		"\"frame_ms_min\": %.3f, \"frame_ms_mean\": %.3f, \"frame_ms_median\": %.3f, \"frame_ms_p95\": %.3f, "
+		"\"frame_ms_p99\": %.3f, \"frame_ms_max\": %.3f, \"draw_items\": %d, \"models_occluded\": %d}\n",
+		BENCHMARK_WIDTH,
+		BENCHMARK_HEIGHT,
+		numFrames,
+		1000.0 / meanMs,
+		frameTimes[0] / 1000.0,
+		meanMs,
+		getPercentileMs(numFrames, frameTimes, 50.0),
+		getPercentileMs(numFrames, frameTimes, 95.0),
+		getPercentileMs(numFrames, frameTimes, 99.0),
+		frameTimes[numFrames - 1] / 1000.0,
+		scene->statistics.drawItems,
+		scene->statistics.modelsOccluded);
+	fflush(stdout);
+}
+
+/** Returns the nearest-rank percentile of the passed ascending frame times in milliseconds. */
+static double getPercentileMs(int numFrames, gint64 *sortedFrameTimes, double percentile)
+{
+	int rank = (int) ceil(percentile / 100.0 * numFrames);
+	if(rank < 1) {
+		rank = 1;
+	}
+
+	return sortedFrameTimes[rank - 1] / 1000.0;
+}
+
+static int compareFrameTimes(const void *firstPointer, const void *secondPointer)
+{
+	gint64 first = *(const gint64 *) firstPointer;
+	gint64 second = *(const gint64 *) secondPointer;
+	return (first > second) - (first < second);
+}
@@ -3,6 +3,8 @@
 #include "shoveler/camera.h"
 #include "shoveler/shader_cache.h"
 
+static void fillUniformBlock(void *data, void *cameraPointer);
+
 void shovelerCameraInit(ShovelerCamera *camera, ShovelerShaderCache *shaderCache, ShovelerVector3 position, void *data, ShovelerCameraUpdateViewFunction *updateView, ShovelerCameraFreeDataFunction *freeData)
 {
 	camera->shaderCache = shaderCache;
@@ -24,16 +26,13 @@ void shovelerCameraInit(ShovelerCamera *camera, ShovelerShaderCache *shaderCache
 	camera->view = shovelerMatrixIdentity;
 	camera->projection = shovelerMatrixIdentity;
 	camera->uniforms = shovelerUniformMapCreate();
+	camera->uniformBuffer = shovelerUniformBufferCreate(SHOVELER_UNIFORM_BUFFER_BINDING_CAMERA, sizeof(ShovelerCameraUniformBlock), fillUniformBlock, camera);
 	camera->data = data;
 	camera->updateView = updateView;
 	camera->freeData = freeData;
 
-	ShovelerUniform *viewUniform = shovelerUniformCreateMatrixPointer(&camera->view);
-	shovelerUniformMapInsert(camera->uniforms, "view", viewUniform);
-	ShovelerUniform *projectionUniform = shovelerUniformCreateMatrixPointer(&camera->projection);
-	shovelerUniformMapInsert(camera->uniforms, "projection", projectionUniform);
-	ShovelerUniform *cameraPositionUniform = shovelerUniformCreateVector3Pointer(&camera->position);
-	shovelerUniformMapInsert(camera->uniforms, "cameraPosition", cameraPositionUniform);
+	ShovelerUniform *cameraBlockUniform = shovelerUniformCreateBuffer(camera->uniformBuffer);
+	shovelerUniformMapInsert(camera->uniforms, "Camera", cameraBlockUniform);
 }
 
 void shovelerCameraFree(ShovelerCamera *camera)
@@ -45,5 +44,15 @@ void shovelerCameraFree(ShovelerCamera *camera)
 	shovelerShaderCacheInvalidateCamera(camera->shaderCache, camera);
 
 	shovelerUniformMapFree(camera->uniforms);
+	shovelerUniformBufferFree(camera->uniformBuffer);
 	camera->freeData(camera->data);
 }
+
+static void fillUniformBlock(void *data, void *cameraPointer)
+{
+	ShovelerCamera *camera = cameraPointer;
+	ShovelerCameraUniformBlock *block = data;
+	block->view = camera->view;
+	block->projection = camera->projection;
+	block->position = camera->position;
+}
@@ -1,5 +1,7 @@
 #include <assert.h> // assert
-#include <math.h> // INFINITY
+#include <limits.h> // INT_MIN, INT_MAX
+#include <math.h> // INFINITY, floorf
+#include <stdint.h> // uint32_t, uint64_t
 #include <stdlib.h> // malloc, free
 #include <string.h> // memcpy
 
@@ -10,8 +12,44 @@
 #include "shoveler/log.h"
 #include "shoveler/shader.h"
 #include "shoveler/sprite.h"
+#include "shoveler/sprite_batch.h"
 
+typedef struct {
+	int minX;
+	int minY;
+	int maxX;
+	int maxY;
+} CellRange;
+
+typedef struct {
+	ShovelerSprite *sprite;
+	/** whether the sprite spans too many cells and is kept in the layer's large entries instead */
+	bool large;
+	CellRange cells;
+	/** position of the sprite in its layer, by which query results are ordered */
+	unsigned int order;
+	/** stamp of the last query that visited this entry, so that sprites spanning several cells are only tested once */
+	unsigned int queryStamp;
+} ShovelerCanvasSpriteEntry;
+
+typedef struct {
+	gint64 key;
+	/** queue of (ShovelerCanvasSpriteEntry *) overlapping this cell */
+	GQueue *entries;
+} ShovelerCanvasCell;
+
+static bool queryLayer(ShovelerCanvas *canvas, int layerId, const ShovelerBoundingBox2 *boundingBox);
+static bool renderSprites(ShovelerCanvas *canvas, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static bool renderSprite(ShovelerCanvas *canvas, ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 static const ShovelerCollider2 *intersectCanvas(const ShovelerCollider2 *collider, const ShovelerBoundingBox2 *object, ShovelerCollider2FilterCandidateFunction *filterCandidate, void *filterCandidateUserData);
+static bool canBatchSprites(ShovelerSprite *sprite, ShovelerSprite *nextSprite);
+static bool getCellRange(const ShovelerBoundingBox2 *boundingBox, CellRange *cellRange);
+static double getNumCells(const CellRange *cellRange);
+static void indexEntry(ShovelerCanvasLayerIndex *layerIndex, ShovelerCanvasSpriteEntry *entry);
+static void unindexEntry(ShovelerCanvasLayerIndex *layerIndex, ShovelerCanvasSpriteEntry *entry);
+static gint64 getCellKey(int x, int y);
+static int compareEntries(const void *firstEntryPointer, const void *secondEntryPointer);
+static void freeCell(void *cellPointer);
 
 ShovelerCanvas *shovelerCanvasCreate(int numLayers)
 {
@@ -25,9 +63,21 @@ ShovelerCanvas *shovelerCanvasCreate(int numLayers)
 	canvas->collider.data = canvas;
 	canvas->numLayers = numLayers;
 	canvas->layers = malloc((size_t) numLayers * sizeof(GQueue *));
+	canvas->layerIndices = malloc((size_t) numLayers * sizeof(ShovelerCanvasLayerIndex));
+	canvas->queryEntries = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerCanvasSpriteEntry *));
+	canvas->batchSprites = true;
+	canvas->renderSprites = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerSprite *));
+	canvas->spriteBatch = NULL;
 
 	for(int layerId = 0; layerId < canvas->numLayers; layerId++) {
 		canvas->layers[layerId] = g_queue_new();
+
+		ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[layerId];
+		layerIndex->entries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+		layerIndex->cells = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, freeCell);
+		layerIndex->largeEntries = g_queue_new();
+		layerIndex->nextOrder = 0;
+		layerIndex->queryStamp = 0;
 	}
 
 	return canvas;
@@ -38,9 +88,22 @@ void shovelerCanvasAddSprite(ShovelerCanvas *canvas, int layerId, ShovelerSprite
 	assert(layerId >= 0);
 	assert(layerId < canvas->numLayers);
 
+	assert(sprite->canvas == NULL);
+
 	GQueue *layer = canvas->layers[layerId];
+	ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[layerId];
 
 	g_queue_push_tail(layer, (gpointer) sprite);
+
+	ShovelerCanvasSpriteEntry *entry = malloc(sizeof(ShovelerCanvasSpriteEntry));
+	entry->sprite = sprite;
+	entry->order = layerIndex->nextOrder++;
+	entry->queryStamp = layerIndex->queryStamp;
+	indexEntry(layerIndex, entry);
+	g_hash_table_insert(layerIndex->entries, sprite, entry);
+
+	sprite->canvas = canvas;
+	sprite->canvasLayerId = layerId;
 }
 
 bool shovelerCanvasRemoveSprite(ShovelerCanvas *canvas, int layerId, ShovelerSprite *sprite)
@@ -49,8 +112,43 @@ bool shovelerCanvasRemoveSprite(ShovelerCanvas *canvas, int layerId, ShovelerSpr
 	assert(layerId < canvas->numLayers);
 
 	GQueue *layer = canvas->layers[layerId];
+	ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[layerId];
+
+	if(!g_queue_remove(layer, sprite)) {
+		return false;
+	}
 
-	return g_queue_remove(layer, sprite);
+	ShovelerCanvasSpriteEntry *entry = g_hash_table_lookup(layerIndex->entries, sprite);
+	assert(entry != NULL);
+	unindexEntry(layerIndex, entry);
+	g_hash_table_remove(layerIndex->entries, sprite);
+
+	sprite->canvas = NULL;
+	return true;
+}
+
+void shovelerCanvasUpdateSprite(ShovelerCanvas *canvas, ShovelerSprite *sprite)
+{
+	assert(sprite->canvas == canvas);
+
+	ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[sprite->canvasLayerId];
+	ShovelerCanvasSpriteEntry *entry = g_hash_table_lookup(layerIndex->entries, sprite);
+	assert(entry != NULL);
+
+	CellRange cellRange;
+	bool large = !getCellRange(&sprite->collider.boundingBox, &cellRange) || getNumCells(&cellRange) > SHOVELER_CANVAS_MAX_SPRITE_CELLS;
+	if(large && entry->large) {
+		return;
+	}
+
+	if(!large && !entry->large
+		&& cellRange.minX == entry->cells.minX && cellRange.minY == entry->cells.minY
+		&& cellRange.maxX == entry->cells.maxX && cellRange.maxY == entry->cells.maxY) {
+		return;
+	}
+
+	unindexEntry(layerIndex, entry);
+	indexEntry(layerIndex, entry);
 }
 
 bool shovelerCanvasRender(ShovelerCanvas *canvas, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
@@ -63,31 +161,32 @@ bool shovelerCanvasRender(ShovelerCanvas *canvas, ShovelerVector2 regionPosition
 
 	shovelerRenderStateEnableBlend(renderState, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	g_array_set_size(canvas->renderSprites, 0);
 	for(int layerId = 0; layerId < canvas->numLayers; layerId++) {
-		GQueue *layer = canvas->layers[layerId];
+		// We're deliberately checking only against the sprites' bounding boxes instead of doing a
+		// full collider check, because we don't care about an actual collision. All we need to
+		// know is if a sprite is close enough to the canvas to be rendered.
+		if(queryLayer(canvas, layerId, &regionBoundingBox)) {
+			for(guint i = 0; i < canvas->queryEntries->len; i++) {
+				ShovelerCanvasSpriteEntry *entry = g_array_index(canvas->queryEntries, ShovelerCanvasSpriteEntry *, i);
+				g_array_append_val(canvas->renderSprites, entry->sprite);
+			}
+			continue;
+		}
 
+		GQueue *layer = canvas->layers[layerId];
 		for(GList *iter = layer->head; iter != NULL; iter = iter->next) {
 			ShovelerSprite *sprite = iter->data;
 
-			// We're deliberately checking only against the sprite's bounding box instead of doing a
-			// full collider check, because we don't care about an actual collision. All we need to
-			// know is if a sprite is close enough to the canvas to be rendered.
 			if(!shovelerBoundingBox2Intersect(&regionBoundingBox, &sprite->collider.boundingBox)) {
 				continue;
 			}
 
-			if(!shovelerSpriteRender(sprite, regionPosition, regionSize, scene, camera, light, model, renderState)) {
-				shovelerLogWarning("Failed to render sprite %p of canvas %p to scene %p, camera %p, light %p and model %p.", sprite, canvas, scene, camera, light, model);
-				return false;
-			}
-
-			if(!sprite->material->screenspace) {
-				shovelerRenderStateEnableDepthTest(renderState, GL_EQUAL);
-			}
+			g_array_append_val(canvas->renderSprites, sprite);
 		}
 	}
 
-	return true;
+	return renderSprites(canvas, regionPosition, regionSize, scene, camera, light, model, renderState);
 }
 
 void shovelerCanvasFree(ShovelerCanvas *canvas)
@@ -97,9 +196,23 @@ void shovelerCanvasFree(ShovelerCanvas *canvas)
 	}
 
 	for(int layerId = 0; layerId < canvas->numLayers; layerId++) {
+		for(GList *iter = canvas->layers[layerId]->head; iter != NULL; iter = iter->next) {
+			ShovelerSprite *sprite = iter->data;
+			sprite->canvas = NULL;
+		}
+
 		g_queue_free(canvas->layers[layerId]);
+
+		ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[layerId];
+		g_queue_free(layerIndex->largeEntries);
+		g_hash_table_destroy(layerIndex->cells);
+		g_hash_table_destroy(layerIndex->entries);
 	}
 
+	shovelerSpriteBatchFree(canvas->spriteBatch);
+	g_array_free(canvas->renderSprites, /* freeSegment */ true);
+	g_array_free(canvas->queryEntries, /* freeSegment */ true);
+	free(canvas->layerIndices);
 	free(canvas->layers);
 	free(canvas);
 }
@@ -109,8 +222,23 @@ static const ShovelerCollider2 *intersectCanvas(const ShovelerCollider2 *collide
 	ShovelerCanvas *canvas = (ShovelerCanvas *) collider->data;
 
 	for(int layerId = 0; layerId < canvas->numLayers; layerId++) {
-		GQueue *layer = canvas->layers[layerId];
+		if(queryLayer(canvas, layerId, object)) {
+			for(guint i = 0; i < canvas->queryEntries->len; i++) {
+				ShovelerSprite *sprite = g_array_index(canvas->queryEntries, ShovelerCanvasSpriteEntry *, i)->sprite;
+
+				if(!sprite->enableCollider) {
+					continue;
+				}
+
+				const ShovelerCollider2 *collidingSprite = shovelerCollider2IntersectFiltered(&sprite->collider, object, filterCandidate, filterCandidateUserData);
+				if(collidingSprite != NULL) {
+					return collidingSprite;
+				}
+			}
+			continue;
+		}
 
+		GQueue *layer = canvas->layers[layerId];
 		for(GList *iter = layer->head; iter != NULL; iter = iter->next) {
 			ShovelerSprite *sprite = iter->data;
 
@@ -127,3 +255,230 @@ static const ShovelerCollider2 *intersectCanvas(const ShovelerCollider2 *collide
 
 	return NULL;
 }
+
+/**
+ * Collects the sprites of a layer whose bounding boxes intersect the passed one into the canvas' query entries, in the
+ * order they were added. Returns false without collecting anything if the box covers more cells than the layer has
+ * sprites, in which case scanning the layer directly is cheaper.
+ */
+static bool queryLayer(ShovelerCanvas *canvas, int layerId, const ShovelerBoundingBox2 *boundingBox)
+{
+	GQueue *layer = canvas->layers[layerId];
+	ShovelerCanvasLayerIndex *layerIndex = &canvas->layerIndices[layerId];
+
+	CellRange cellRange;
+	if(!getCellRange(boundingBox, &cellRange) || getNumCells(&cellRange) > layer->length) {
+		return false;
+	}
+
+	g_array_set_size(canvas->queryEntries, 0);
+	layerIndex->queryStamp++;
+
+	for(int x = cellRange.minX; x <= cellRange.maxX; x++) {
+		for(int y = cellRange.minY; y <= cellRange.maxY; y++) {
+			gint64 key = getCellKey(x, y);
+			ShovelerCanvasCell *cell = g_hash_table_lookup(layerIndex->cells, &key);
+			if(cell == NULL) {
+				continue;
+			}
+
+			for(GList *iter = cell->entries->head; iter != NULL; iter = iter->next) {
+				ShovelerCanvasSpriteEntry *entry = iter->data;
+				if(entry->queryStamp == layerIndex->queryStamp) {
+					continue;
+				}
+				entry->queryStamp = layerIndex->queryStamp;
+
+				if(shovelerBoundingBox2Intersect(boundingBox, &entry->sprite->collider.boundingBox)) {
+					g_array_append_val(canvas->queryEntries, entry);
+				}
+			}
+		}
+	}
+
+	for(GList *iter = layerIndex->largeEntries->head; iter != NULL; iter = iter->next) {
+		ShovelerCanvasSpriteEntry *entry = iter->data;
+		if(shovelerBoundingBox2Intersect(boundingBox, &entry->sprite->collider.boundingBox)) {
+			g_array_append_val(canvas->queryEntries, entry);
+		}
+	}
+
+	qsort(canvas->queryEntries->data, canvas->queryEntries->len, sizeof(ShovelerCanvasSpriteEntry *), compareEntries);
+
+	return true;
+}
+
+/**
+ * Renders the collected visible sprites in order, drawing runs of consecutive sprites that can be batched together
+ * with a single call each. Since draw order is kept, layering and blending are the same as when drawing one by one.
+ */
+static bool renderSprites(ShovelerCanvas *canvas, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	ShovelerSprite **sprites = (ShovelerSprite **) canvas->renderSprites->data;
+	int numSprites = (int) canvas->renderSprites->len;
+	GLboolean depthMask = renderState->depthMask;
+	bool depthWritten = false;
+
+	for(int i = 0; i < numSprites;) {
+		ShovelerSprite *sprite = sprites[i];
+
+		// Non-screenspace sprites after the first are tested for equal depth against the canvas surface written by the
+		// first one, which a batch can't do exactly since its quads interpolate depth differently. We thus always draw
+		// the first sprite on its own, and let batches test against its depth without writing their own.
+		int runLength = 1;
+		if(canvas->batchSprites && sprite->renderBatch != NULL && (sprite->material->screenspace || depthWritten)) {
+			while(i + runLength < numSprites && canBatchSprites(sprite, sprites[i + runLength])) {
+				runLength++;
+			}
+		}
+
+		if(runLength == 1) {
+			if(!renderSprite(canvas, sprite, regionPosition, regionSize, scene, camera, light, model, renderState)) {
+				return false;
+			}
+
+			depthWritten = depthWritten || !sprite->material->screenspace;
+			i++;
+			continue;
+		}
+
+		if(canvas->spriteBatch == NULL) {
+			canvas->spriteBatch = shovelerSpriteBatchCreate();
+		}
+
+		if(!sprite->material->screenspace) {
+			shovelerRenderStateEnableDepthTest(renderState, GL_LEQUAL);
+			shovelerRenderStateSetDepthMask(renderState, GL_FALSE);
+		}
+
+		if(!sprite->renderBatch(&sprites[i], runLength, canvas->spriteBatch, regionPosition, regionSize, scene, camera, light, model, renderState)) {
+			shovelerLogWarning("Failed to render batch of %d sprites starting with %p of canvas %p to scene %p, camera %p, light %p and model %p.", runLength, sprite, canvas, scene, camera, light, model);
+			return false;
+		}
+
+		if(!sprite->material->screenspace) {
+			shovelerRenderStateEnableDepthTest(renderState, GL_EQUAL);
+			shovelerRenderStateSetDepthMask(renderState, depthMask);
+		}
+
+		i += runLength;
+	}
+
+	return true;
+}
+
+static bool renderSprite(ShovelerCanvas *canvas, ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	if(!shovelerSpriteRender(sprite, regionPosition, regionSize, scene, camera, light, model, renderState)) {
+		shovelerLogWarning("Failed to render sprite %p of canvas %p to scene %p, camera %p, light %p and model %p.", sprite, canvas, scene, camera, light, model);
+		return false;
+	}
+
+	if(!sprite->material->screenspace) {
+		shovelerRenderStateEnableDepthTest(renderState, GL_EQUAL);
+	}
+
+	return true;
+}
+
+static bool canBatchSprites(ShovelerSprite *sprite, ShovelerSprite *nextSprite)
+{
+	return nextSprite->renderBatch == sprite->renderBatch
+		&& nextSprite->material == sprite->material
+		&& nextSprite->batchKey == sprite->batchKey;
+}
+
+static bool getCellRange(const ShovelerBoundingBox2 *boundingBox, CellRange *cellRange)
+{
+	float minX = floorf(boundingBox->min.values[0] / SHOVELER_CANVAS_CELL_SIZE);
+	float minY = floorf(boundingBox->min.values[1] / SHOVELER_CANVAS_CELL_SIZE);
+	float maxX = floorf(boundingBox->max.values[0] / SHOVELER_CANVAS_CELL_SIZE);
+	float maxY = floorf(boundingBox->max.values[1] / SHOVELER_CANVAS_CELL_SIZE);
+
+	// also rejects infinite and NaN coordinates
+	if(!(minX >= INT_MIN && maxX <= INT_MAX && minY >= INT_MIN && maxY <= INT_MAX)) {
+		return false;
+	}
+
+	cellRange->minX = (int) minX;
+	cellRange->minY = (int) minY;
+	cellRange->maxX = (int) maxX;
+	cellRange->maxY = (int) maxY;
+	return true;
+}
+
+static double getNumCells(const CellRange *cellRange)
+{
+	return ((double) cellRange->maxX - cellRange->minX + 1) * ((double) cellRange->maxY - cellRange->minY + 1);
+}
+
+static void indexEntry(ShovelerCanvasLayerIndex *layerIndex, ShovelerCanvasSpriteEntry *entry)
+{
+	entry->large = !getCellRange(&entry->sprite->collider.boundingBox, &entry->cells) || getNumCells(&entry->cells) > SHOVELER_CANVAS_MAX_SPRITE_CELLS;
+	if(entry->large) {
+		g_queue_push_tail(layerIndex->largeEntries, entry);
+		return;
+	}
+
+	for(int x = entry->cells.minX; x <= entry->cells.maxX; x++) {
+		for(int y = entry->cells.minY; y <= entry->cells.maxY; y++) {
+			gint64 key = getCellKey(x, y);
+			ShovelerCanvasCell *cell = g_hash_table_lookup(layerIndex->cells, &key);
+			if(cell == NULL) {
+				cell = malloc(sizeof(ShovelerCanvasCell));
+				cell->key = key;
+				cell->entries = g_queue_new();
+				g_hash_table_insert(layerIndex->cells, &cell->key, cell);
+			}
+
+			g_queue_push_tail(cell->entries, entry);
+		}
+	}
+}
+
+static void unindexEntry(ShovelerCanvasLayerIndex *layerIndex, ShovelerCanvasSpriteEntry *entry)
+{
+	if(entry->large) {
+		g_queue_remove(layerIndex->largeEntries, entry);
+		return;
+	}
+
+	for(int x = entry->cells.minX; x <= entry->cells.maxX; x++) {
+		for(int y = entry->cells.minY; y <= entry->cells.maxY; y++) {
+			gint64 key = getCellKey(x, y);
+			ShovelerCanvasCell *cell = g_hash_table_lookup(layerIndex->cells, &key);
+			assert(cell != NULL);
+
+			g_queue_remove(cell->entries, entry);
+			if(g_queue_is_empty(cell->entries)) {
+				g_hash_table_remove(layerIndex->cells, &key);
+			}
+		}
+	}
+}
+
+static gint64 getCellKey(int x, int y)
+{
+	return (gint64) (((uint64_t) (uint32_t) x << 32) | (uint32_t) y);
+}
+
+static int compareEntries(const void *firstEntryPointer, const void *secondEntryPointer)
+{
+	const ShovelerCanvasSpriteEntry *firstEntry = *((ShovelerCanvasSpriteEntry **) firstEntryPointer);
+	const ShovelerCanvasSpriteEntry *secondEntry = *((ShovelerCanvasSpriteEntry **) secondEntryPointer);
+
+	if(firstEntry->order < secondEntry->order) {
+		return -1;
+	}
+	if(firstEntry->order > secondEntry->order) {
+		return 1;
+	}
+	return 0;
+}
+
+static void freeCell(void *cellPointer)
+{
+	ShovelerCanvasCell *cell = cellPointer;
+	g_queue_free(cell->entries);
+	free(cell);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/canvas.h"
+#include "shoveler/sprite.h"
+}
+
+static const ShovelerCollider2 *intersectSpriteBoundingBox(const ShovelerCollider2 *collider, const ShovelerBoundingBox2 *object, ShovelerCollider2FilterCandidateFunction *filterCandidate, void *filterCandidateUserData);
+
+class ShovelerCanvasTest : public ::testing::Test {
+public:
+	virtual void SetUp()
+	{
+		canvas = shovelerCanvasCreate(/* numLayers */ 2);
+
+		for(int i = 0; i < numSprites; i++) {
+			shovelerSpriteInit(&sprites[i], /* material */ NULL, intersectSpriteBoundingBox, /* render */ NULL, /* free */ NULL, /* data */ NULL);
+			shovelerSpriteUpdatePosition(&sprites[i], shovelerVector2(10.0f * (i % 10), 10.0f * (i / 10)));
+			shovelerCanvasAddSprite(canvas, /* layerId */ 0, &sprites[i]);
+		}
+	}
+
+	virtual void TearDown()
+	{
+		shovelerCanvasFree(canvas);
+	}
+
+	const ShovelerCollider2 *intersect(float x, float y)
+	{
+		ShovelerBoundingBox2 object = shovelerBoundingBox2(shovelerVector2(x - 0.1f, y - 0.1f), shovelerVector2(x + 0.1f, y + 0.1f));
+		return shovelerCollider2Intersect(&canvas->collider, &object);
+	}
+
+	static const int numSprites = 100;
+	ShovelerCanvas *canvas;
+	ShovelerSprite sprites[numSprites];
+};
+
+TEST_F(ShovelerCanvasTest, intersect)
+{
+	ASSERT_EQ(intersect(0.0f, 0.0f), &sprites[0].collider);
+	ASSERT_EQ(intersect(30.0f, 70.0f), &sprites[73].collider);
+	ASSERT_EQ(intersect(90.4f, 89.6f), &sprites[99].collider);
+	ASSERT_TRUE(intersect(5.0f, 5.0f) == NULL);
+	ASSERT_TRUE(intersect(-100.0f, 0.0f) == NULL);
+}
+
+TEST_F(ShovelerCanvasTest, intersectMovedSprite)
+{
+	shovelerSpriteUpdatePosition(&sprites[42], shovelerVector2(-55.0f, 5.0f));
+
+	ASSERT_TRUE(intersect(20.0f, 40.0f) == NULL);
+	ASSERT_EQ(intersect(-55.0f, 5.0f), &sprites[42].collider);
+
+	shovelerSpriteUpdateSize(&sprites[42], shovelerVector2(1000.0f, 1.0f));
+
+	ASSERT_EQ(intersect(400.0f, 5.0f), &sprites[42].collider);
+	ASSERT_EQ(intersect(-500.0f, 5.0f), &sprites[42].collider);
+
+	shovelerSpriteUpdateSize(&sprites[42], shovelerVector2(1.0f, 1.0f));
+
+	ASSERT_TRUE(intersect(400.0f, 5.0f) == NULL);
+	ASSERT_EQ(intersect(-55.0f, 5.0f), &sprites[42].collider);
+}
+
+TEST_F(ShovelerCanvasTest, intersectInOrder)
+{
+	ShovelerSprite overlappingSprite;
+	shovelerSpriteInit(&overlappingSprite, /* material */ NULL, intersectSpriteBoundingBox, /* render */ NULL, /* free */ NULL, /* data */ NULL);
+	shovelerSpriteUpdatePosition(&overlappingSprite, shovelerVector2(50.0f, 50.0f));
+	shovelerCanvasAddSprite(canvas, /* layerId */ 0, &overlappingSprite);
+
+	ASSERT_EQ(intersect(50.0f, 50.0f), &sprites[55].collider);
+
+	bool removed = shovelerCanvasRemoveSprite(canvas, /* layerId */ 0, &sprites[55]);
+	ASSERT_TRUE(removed);
+	ASSERT_EQ(intersect(50.0f, 50.0f), &overlappingSprite.collider);
+
+	shovelerCanvasAddSprite(canvas, /* layerId */ 1, &sprites[55]);
+	ASSERT_EQ(intersect(50.0f, 50.0f), &overlappingSprite.collider);
+
+	shovelerSpriteSetEnableCollider(&overlappingSprite, false);
+	ASSERT_EQ(intersect(50.0f, 50.0f), &sprites[55].collider);
+}
+
+static const ShovelerCollider2 *intersectSpriteBoundingBox(const ShovelerCollider2 *collider, const ShovelerBoundingBox2 *object, ShovelerCollider2FilterCandidateFunction *filterCandidate, void *filterCandidateUserData)
+{
+	if(!shovelerBoundingBox2Intersect(&collider->boundingBox, object)) {
+		return NULL;
+	}
+
+	return collider;
+}
@@ -51,7 +51,11 @@ ShovelerController *shovelerControllerCreate(GLFWwindow *window, ShovelerInput *
 	controller->lockTiltX = false;
 	controller->lockTiltY = false;
 
-	glfwGetCursorPos(controller->window, &controller->previousCursorX, &controller->previousCursorY);
+	controller->previousCursorX = 0.0;
+	controller->previousCursorY = 0.0;
+	if(controller->window != NULL) {
+		glfwGetCursorPos(controller->window, &controller->previousCursorX, &controller->previousCursorY);
+	}
 
 	controller->movingForward = false;
 	controller->movingBackward = false;
@@ -134,7 +138,7 @@ void shovelerControllerSetFrame(ShovelerController *controller, const ShovelerRe
 
 void shovelerControllerUpdate(ShovelerController *controller, float dt)
 {
-	if(glfwGetInputMode(controller->window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED) {
+	if(controller->window == NULL || glfwGetInputMode(controller->window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED) {
 		return;
 	}
 
@@ -0,0 +1,12 @@
+#include "shoveler/drawable.h"
+
+static unsigned int nextDrawableId = 0;
+
+void shovelerDrawableInit(ShovelerDrawable *drawable, ShovelerDrawableDrawFunction *draw, ShovelerDrawableDrawInstancedFunction *drawInstanced, ShovelerDrawableFreeFunction *free, void *data)
+{
+	drawable->id = nextDrawableId++;
+	drawable->draw = draw;
+	drawable->drawInstanced = drawInstanced;
+	drawable->free = free;
+	drawable->data = data;
+}
@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 
 #include "shoveler/drawable/cube.h"
+#include "shoveler/instance_buffer.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/opengl.h"
 
@@ -24,6 +25,7 @@ typedef struct {
 } CubeData;
 
 static bool drawCube(ShovelerDrawable *cube);
+static bool drawCubeInstanced(ShovelerDrawable *cube, ShovelerInstanceBuffer *instanceBuffer);
 static void freeCube(ShovelerDrawable *cube);
 
 static CubeVertex cubeVertices[] = {
@@ -80,9 +82,7 @@ ShovelerDrawable *shovelerDrawableCubeCreate()
 {
 	CubeData *cubeData = malloc(sizeof(CubeData));
 	ShovelerDrawable *cube = malloc(sizeof(ShovelerDrawable));
-	cube->draw = drawCube;
-	cube->free = freeCube;
-	cube->data = cubeData;
+	shovelerDrawableInit(cube, drawCube, drawCubeInstanced, freeCube, cubeData);
 
 	glGenVertexArrays(1, &cubeData->vertexArrayObject);
 	glBindVertexArray(cubeData->vertexArrayObject);
@@ -124,6 +124,20 @@ static bool drawCube(ShovelerDrawable *cube)
 	return shovelerOpenGLCheckSuccess();
 }
 
+static bool drawCubeInstanced(ShovelerDrawable *cube, ShovelerInstanceBuffer *instanceBuffer)
+{
+	CubeData *cubeData = cube->data;
+
+	glBindVertexArray(cubeData->vertexArrayObject);
+	glBindVertexBuffer(0, cubeData->vertexBuffer, 0, sizeof(CubeVertex));
+	shovelerInstanceBufferBindAttributes(instanceBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeData->indexBuffer);
+	glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, NULL, shovelerInstanceBufferGetNumInstances(instanceBuffer));
+	shovelerInstanceBufferUnbindAttributes(instanceBuffer);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
 static void freeCube(ShovelerDrawable *cube)
 {
 	CubeData *cubeData = cube->data;
@@ -25,9 +25,7 @@ ShovelerDrawable *shovelerDrawablePointCreate()
 {
 	PointData *pointData = malloc(sizeof(PointData));
 	ShovelerDrawable *point = malloc(sizeof(ShovelerDrawable));
-	point->draw = drawPoint;
-	point->free = freePoint;
-	point->data = pointData;
+	shovelerDrawableInit(point, drawPoint, /* drawInstanced */ NULL, freePoint, pointData);
 
 	glGenVertexArrays(1, &pointData->vertexArrayObject);
 	glBindVertexArray(pointData->vertexArrayObject);
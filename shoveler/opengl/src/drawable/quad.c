@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 
 #include "shoveler/drawable/quad.h"
+#include "shoveler/instance_buffer.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/opengl.h"
 
@@ -24,6 +25,7 @@ typedef struct {
 } QuadData;
 
 static bool drawQuad(ShovelerDrawable *quad);
+static bool drawQuadInstanced(ShovelerDrawable *quad, ShovelerInstanceBuffer *instanceBuffer);
 static void freeQuad(ShovelerDrawable *quad);
 
 static QuadVertex quadVertices[] = {
@@ -40,9 +42,7 @@ ShovelerDrawable *shovelerDrawableQuadCreate()
 {
 	QuadData *quadData = malloc(sizeof(QuadData));
 	ShovelerDrawable *quad = malloc(sizeof(ShovelerDrawable));
-	quad->draw = drawQuad;
-	quad->free = freeQuad;
-	quad->data = quadData;
+	shovelerDrawableInit(quad, drawQuad, drawQuadInstanced, freeQuad, quadData);
 
 	glGenVertexArrays(1, &quadData->vertexArrayObject);
 	glBindVertexArray(quadData->vertexArrayObject);
@@ -84,6 +84,20 @@ static bool drawQuad(ShovelerDrawable *quad)
 	return shovelerOpenGLCheckSuccess();
 }
 
+static bool drawQuadInstanced(ShovelerDrawable *quad, ShovelerInstanceBuffer *instanceBuffer)
+{
+	QuadData *quadData = quad->data;
+
+	glBindVertexArray(quadData->vertexArrayObject);
+	glBindVertexBuffer(0, quadData->vertexBuffer, 0, sizeof(QuadVertex));
+	shovelerInstanceBufferBindAttributes(instanceBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadData->indexBuffer);
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, NULL, shovelerInstanceBufferGetNumInstances(instanceBuffer));
+	shovelerInstanceBufferUnbindAttributes(instanceBuffer);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
 static void freeQuad(ShovelerDrawable *quad)
 {
 	QuadData *quadData = quad->data;
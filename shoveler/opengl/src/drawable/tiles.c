@@ -1,77 +1,97 @@
+#include <assert.h> // assert
+#include <limits.h> // SHRT_MIN, SHRT_MAX
 #include <stdbool.h> // bool
+#include <stddef.h> // offsetof
 #include <stdlib.h> // malloc, free
 
 #include <glad/glad.h>
+#include <glib.h>
 
 #include "shoveler/drawable/tiles.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/opengl.h"
 
+#define TILES_VERTEX_BINDING 0
+#define TILES_INSTANCE_BINDING 1
+
 typedef struct {
-	unsigned char position[2];
-	unsigned char uv[2];
+	unsigned char corner[2];
 } TilesVertex;
 
 typedef struct {
-	unsigned int indices[3];
-} TilesTriangle;
+	GLshort position[2];
+	ShovelerDrawableTilesTile tile;
+	unsigned char unused;
+} TilesInstance;
+
+typedef struct {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint first;
+	GLuint baseInstance;
+} TilesDrawCommand;
 
 typedef struct {
 	ShovelerDrawable drawable;
-	unsigned char width;
-	unsigned char height;
-	TilesVertex *vertices;
-	TilesTriangle *triangles;
+	unsigned char chunkWidth;
+	unsigned char chunkHeight;
+	int numChunks;
+	/** CPU copy of the tile buffer, with chunk c's tile (column, row) at [c * chunkWidth * chunkHeight + row * chunkWidth + column] */
+	TilesInstance *instances;
+	bool *chunksVisible;
+	/** array of (TilesDrawCommand) covering the visible chunks, rebuilt on the next draw after their visibility changed */
+	GArray *commands;
+	bool commandsDirty;
 	GLuint vertexArrayObject;
 	GLuint vertexBuffer;
-	GLuint indexBuffer;
+	GLuint instanceBuffer;
+	GLuint commandBuffer;
 } Tiles;
 
 static bool drawTiles(ShovelerDrawable *tilesDrawable);
 static void freeTiles(ShovelerDrawable *tilesDrawable);
+static bool uploadInstances(Tiles *tiles, int firstInstance, int numInstances);
+static void updateCommands(Tiles *tiles);
+static int getChunkSize(Tiles *tiles);
+
+static TilesVertex tilesVertices[] = {
+	{{0, 0}},
+	{{1, 0}},
+	{{0, 1}},
+	{{1, 1}}};
 
 ShovelerDrawable *shovelerDrawableTilesCreate(unsigned char width, unsigned char height)
 {
+	return shovelerDrawableTilesCreateChunked(width, height, 1);
+}
+
+ShovelerDrawable *shovelerDrawableTilesCreateChunked(unsigned char chunkWidth, unsigned char chunkHeight, int numChunks)
+{
+	assert(numChunks >= 1);
+
 	Tiles *tiles = malloc(sizeof(Tiles));
-	tiles->width = width;
-	tiles->height = height;
-	tiles->vertices = malloc(4 * width * height * sizeof(TilesVertex));
-	tiles->triangles = malloc(2 * width * height * sizeof(TilesTriangle));
-	tiles->drawable.data = tiles;
-	tiles->drawable.draw = drawTiles;
-	tiles->drawable.free = freeTiles;
-
-	for(unsigned char x = 0; x < width; x++) {
-		for(unsigned char y = 0; y < height; y++) {
-			unsigned int index = x * height + y;
-
-			tiles->vertices[4 * index + 0].position[0] = x;
-			tiles->vertices[4 * index + 0].position[1] = y;
-			tiles->vertices[4 * index + 0].uv[0] = 0;
-			tiles->vertices[4 * index + 0].uv[1] = 0;
-
-			tiles->vertices[4 * index + 1].position[0] = x + 1;
-			tiles->vertices[4 * index + 1].position[1] = y;
-			tiles->vertices[4 * index + 1].uv[0] = 1;
-			tiles->vertices[4 * index + 1].uv[1] = 0;
-
-			tiles->vertices[4 * index + 2].position[0] = x;
-			tiles->vertices[4 * index + 2].position[1] = y + 1;
-			tiles->vertices[4 * index + 2].uv[0] = 0;
-			tiles->vertices[4 * index + 2].uv[1] = 1;
-
-			tiles->vertices[4 * index + 3].position[0] = x + 1;
-			tiles->vertices[4 * index + 3].position[1] = y + 1;
-			tiles->vertices[4 * index + 3].uv[0] = 1;
-			tiles->vertices[4 * index + 3].uv[1] = 1;
-
-			tiles->triangles[2 * index + 0].indices[0] = 4 * index + 1;
-			tiles->triangles[2 * index + 0].indices[1] = 4 * index + 3;
-			tiles->triangles[2 * index + 0].indices[2] = 4 * index + 0;
-
-			tiles->triangles[2 * index + 1].indices[0] = 4 * index + 3;
-			tiles->triangles[2 * index + 1].indices[1] = 4 * index + 2;
-			tiles->triangles[2 * index + 1].indices[2] = 4 * index + 0;
+	tiles->chunkWidth = chunkWidth;
+	tiles->chunkHeight = chunkHeight;
+	tiles->numChunks = numChunks;
+	tiles->instances = malloc(numChunks * getChunkSize(tiles) * sizeof(TilesInstance));
+	tiles->chunksVisible = malloc(numChunks * sizeof(bool));
+	tiles->commands = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(TilesDrawCommand));
+	tiles->commandsDirty = true;
+	shovelerDrawableInit(&tiles->drawable, drawTiles, /* drawInstanced */ NULL, freeTiles, tiles);
+
+	for(int chunk = 0; chunk < numChunks; chunk++) {
+		tiles->chunksVisible[chunk] = true;
+
+		for(unsigned char row = 0; row < chunkHeight; row++) {
+			for(unsigned char column = 0; column < chunkWidth; column++) {
+				TilesInstance *instance = &tiles->instances[chunk * getChunkSize(tiles) + row * chunkWidth + column];
+				instance->position[0] = column;
+				instance->position[1] = row;
+				instance->tile.tilesetColumn = 0;
+				instance->tile.tilesetRow = 0;
+				instance->tile.tilesetId = 0;
+				instance->unused = 0;
+			}
 		}
 	}
 
@@ -79,18 +99,26 @@ ShovelerDrawable *shovelerDrawableTilesCreate(unsigned char width, unsigned char
 	glBindVertexArray(tiles->vertexArrayObject);
 	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION);
 	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV);
-	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, 2, GL_UNSIGNED_BYTE, GL_FALSE, offsetof(TilesVertex, position));
-	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, 2, GL_UNSIGNED_BYTE, GL_FALSE, offsetof(TilesVertex, uv));
-	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, 0);
-	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, 0);
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE_POSITION);
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE);
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, 2, GL_UNSIGNED_BYTE, GL_FALSE, offsetof(TilesVertex, corner));
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, 2, GL_UNSIGNED_BYTE, GL_FALSE, offsetof(TilesVertex, corner));
+	glVertexAttribIFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE_POSITION, 2, GL_SHORT, offsetof(TilesInstance, position));
+	glVertexAttribIFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE, 3, GL_UNSIGNED_BYTE, offsetof(TilesInstance, tile));
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, TILES_VERTEX_BINDING);
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, TILES_VERTEX_BINDING);
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE_POSITION, TILES_INSTANCE_BINDING);
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE, TILES_INSTANCE_BINDING);
+	glVertexBindingDivisor(TILES_INSTANCE_BINDING, 1);
 
 	glGenBuffers(1, &tiles->vertexBuffer);
-	glGenBuffers(1, &tiles->indexBuffer);
+	glGenBuffers(1, &tiles->instanceBuffer);
+	glGenBuffers(1, &tiles->commandBuffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, tiles->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, 4 * width * height * sizeof(TilesVertex), tiles->vertices, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tiles->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, 2 * width * height * sizeof(TilesTriangle), tiles->triangles, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, 4 * sizeof(TilesVertex), tilesVertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, tiles->instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, numChunks * getChunkSize(tiles) * sizeof(TilesInstance), tiles->instances, GL_DYNAMIC_DRAW);
 
 	if(!shovelerOpenGLCheckSuccess()) {
 		freeTiles(&tiles->drawable);
@@ -100,14 +128,95 @@ ShovelerDrawable *shovelerDrawableTilesCreate(unsigned char width, unsigned char
 	return &tiles->drawable;
 }
 
+bool shovelerDrawableIsTiles(ShovelerDrawable *drawable)
+{
+	return drawable->draw == drawTiles;
+}
+
+bool shovelerDrawableTilesSetChunkPosition(ShovelerDrawable *tilesDrawable, int chunk, int column, int row)
+{
+	Tiles *tiles = tilesDrawable->data;
+	assert(chunk >= 0 && chunk < tiles->numChunks);
+	assert(column >= SHRT_MIN && column + tiles->chunkWidth <= SHRT_MAX);
+	assert(row >= SHRT_MIN && row + tiles->chunkHeight <= SHRT_MAX);
+
+	int firstInstance = chunk * getChunkSize(tiles);
+	for(unsigned char tileRow = 0; tileRow < tiles->chunkHeight; tileRow++) {
+		for(unsigned char tileColumn = 0; tileColumn < tiles->chunkWidth; tileColumn++) {
+			TilesInstance *instance = &tiles->instances[firstInstance + tileRow * tiles->chunkWidth + tileColumn];
+			instance->position[0] = (GLshort) (column + tileColumn);
+			instance->position[1] = (GLshort) (row + tileRow);
+		}
+	}
+
+	return uploadInstances(tiles, firstInstance, getChunkSize(tiles));
+}
+
+void shovelerDrawableTilesSetChunkVisible(ShovelerDrawable *tilesDrawable, int chunk, bool visible)
+{
+	Tiles *tiles = tilesDrawable->data;
+	assert(chunk >= 0 && chunk < tiles->numChunks);
+
+	if(tiles->chunksVisible[chunk] != visible) {
+		tiles->chunksVisible[chunk] = visible;
+		tiles->commandsDirty = true;
+	}
+}
+
+ShovelerDrawableTilesTile shovelerDrawableTilesGetTile(ShovelerDrawable *tilesDrawable, int chunk, unsigned char column, unsigned char row)
+{
+	Tiles *tiles = tilesDrawable->data;
+	assert(chunk >= 0 && chunk < tiles->numChunks);
+	assert(column < tiles->chunkWidth);
+	assert(row < tiles->chunkHeight);
+
+	return tiles->instances[chunk * getChunkSize(tiles) + row * tiles->chunkWidth + column].tile;
+}
+
+bool shovelerDrawableTilesSetTile(ShovelerDrawable *tilesDrawable, int chunk, unsigned char column, unsigned char row, ShovelerDrawableTilesTile tile)
+{
+	Tiles *tiles = tilesDrawable->data;
+	assert(chunk >= 0 && chunk < tiles->numChunks);
+	assert(column < tiles->chunkWidth);
+	assert(row < tiles->chunkHeight);
+
+	int instanceIndex = chunk * getChunkSize(tiles) + row * tiles->chunkWidth + column;
+	tiles->instances[instanceIndex].tile = tile;
+
+	return uploadInstances(tiles, instanceIndex, 1);
+}
+
+bool shovelerDrawableTilesSetChunkTiles(ShovelerDrawable *tilesDrawable, int chunk, const ShovelerDrawableTilesTile *chunkTiles)
+{
+	Tiles *tiles = tilesDrawable->data;
+	assert(chunk >= 0 && chunk < tiles->numChunks);
+
+	int firstInstance = chunk * getChunkSize(tiles);
+	for(int i = 0; i < getChunkSize(tiles); i++) {
+		tiles->instances[firstInstance + i].tile = chunkTiles[i];
+	}
+
+	return uploadInstances(tiles, firstInstance, getChunkSize(tiles));
+}
+
 static bool drawTiles(ShovelerDrawable *tilesDrawable)
 {
 	Tiles *tiles = tilesDrawable->data;
 
+	if(tiles->commandsDirty) {
+		updateCommands(tiles);
+	}
+
+	if(tiles->commands->len == 0) {
+		return true;
+	}
+
 	glBindVertexArray(tiles->vertexArrayObject);
-	glBindVertexBuffer(0, tiles->vertexBuffer, 0, sizeof(TilesVertex));
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tiles->indexBuffer);
-	glDrawElements(GL_TRIANGLES, 2 * 3 * tiles->width * tiles->height, GL_UNSIGNED_INT, NULL);
+	glBindVertexBuffer(TILES_VERTEX_BINDING, tiles->vertexBuffer, 0, sizeof(TilesVertex));
+	glBindVertexBuffer(TILES_INSTANCE_BINDING, tiles->instanceBuffer, 0, sizeof(TilesInstance));
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, tiles->commandBuffer);
+	glMultiDrawArraysIndirect(GL_TRIANGLE_STRIP, NULL, (GLsizei) tiles->commands->len, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
 	return shovelerOpenGLCheckSuccess();
 }
@@ -117,9 +226,55 @@ static void freeTiles(ShovelerDrawable *tilesDrawable)
 	Tiles *tiles = tilesDrawable->data;
 	glDeleteVertexArrays(1, &tiles->vertexArrayObject);
 	glDeleteBuffers(1, &tiles->vertexBuffer);
-	glDeleteBuffers(1, &tiles->indexBuffer);
+	glDeleteBuffers(1, &tiles->instanceBuffer);
+	glDeleteBuffers(1, &tiles->commandBuffer);
 
-	free(tiles->triangles);
-	free(tiles->vertices);
+	g_array_free(tiles->commands, /* freeSegment */ true);
+	free(tiles->chunksVisible);
+	free(tiles->instances);
 	free(tiles);
 }
+
+static bool uploadInstances(Tiles *tiles, int firstInstance, int numInstances)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, tiles->instanceBuffer);
+	glBufferSubData(GL_ARRAY_BUFFER, firstInstance * sizeof(TilesInstance), numInstances * sizeof(TilesInstance), &tiles->instances[firstInstance]);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+static void updateCommands(Tiles *tiles)
+{
+	g_array_set_size(tiles->commands, 0);
+
+	// chunks are laid out back to back in the tile buffer, so runs of consecutive visible chunks share one command
+	for(int chunk = 0; chunk < tiles->numChunks; chunk++) {
+		if(!tiles->chunksVisible[chunk]) {
+			continue;
+		}
+
+		if(chunk > 0 && tiles->chunksVisible[chunk - 1]) {
+			TilesDrawCommand *lastCommand = &g_array_index(tiles->commands, TilesDrawCommand, tiles->commands->len - 1);
+			lastCommand->instanceCount += getChunkSize(tiles);
+			continue;
+		}
+
+		TilesDrawCommand command;
+		command.count = 4;
+		command.instanceCount = getChunkSize(tiles);
+		command.first = 0;
+		command.baseInstance = chunk * getChunkSize(tiles);
+		g_array_append_val(tiles->commands, command);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, tiles->commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, tiles->commands->len * sizeof(TilesDrawCommand), tiles->commands->data, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	tiles->commandsDirty = false;
+}
+
+static int getChunkSize(Tiles *tiles)
+{
+	return tiles->chunkWidth * tiles->chunkHeight;
+}
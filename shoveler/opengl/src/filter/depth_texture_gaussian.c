@@ -1,3 +1,4 @@
+#include <assert.h> // assert
 #include <stdlib.h> // malloc, free
 
 #include "shoveler/camera/identity.h"
@@ -8,17 +9,36 @@
 #include "shoveler/material.h"
 #include "shoveler/drawable.h"
 #include "shoveler/model.h"
+#include "shoveler/render_state.h"
 #include "shoveler/sampler.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader_cache.h"
+#include "shoveler/texture.h"
 
 typedef struct {
 	ShovelerFilter filter;
 	ShovelerShaderCache *shaderCache;
 	ShovelerSampler *filterSampler;
 	ShovelerCamera *filterCamera;
+	int width;
+	int height;
+	GLsizei samples;
+	bool layered;
+	/** number of array layers of layered filters */
+	int layers;
+	/** pool to acquire the intermediate render target from during each render, or NULL to keep an own one */
+	ShovelerFramebufferPool *framebufferPool;
+	/** intermediate render target, only set during renders if acquired from a pool */
 	ShovelerFramebuffer *filterXFramebuffer;
+	/** render target sampled by the second pass, pointed to by its material */
+	ShovelerTexture *filterXTexture;
+	/** default output render target, created on first use */
 	ShovelerFramebuffer *filterYFramebuffer;
+	ShovelerFramebuffer *outputFramebuffer;
+	GLint outputX;
+	GLint outputY;
+	GLsizei outputWidth;
+	GLsizei outputHeight;
 	ShovelerMaterial *filterXMaterial;
 	ShovelerMaterial *filterYMaterial;
 	ShovelerDrawable *filterQuad;
@@ -28,10 +48,296 @@ typedef struct {
 	float exponentialFactor;
 } DepthTextureGaussianFilter;
 
+typedef struct {
+	ShovelerFramebuffer *framebuffer;
+	GLint x;
+	GLint y;
+	GLsizei width;
+	GLsizei height;
+} ChainOutput;
+
+typedef struct {
+	int width;
+	int height;
+	float exponentialFactor;
+	int filterWidth;
+	int filterHeight;
+	/** number of layers the targets below were created with, grown and shrunk to the number of inputs received */
+	int layers;
+	/** target the inputs' depth maps are rendered into, layered unless the batch holds a single layer */
+	ShovelerFramebuffer *depthFramebuffer;
+	/** framebuffers rendering into the individual layers of the above */
+	ShovelerFramebuffer *depthLayerFramebuffers[SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_BATCH_LAYERS];
+	/** depth target read by the X pass, pointed to by its material */
+	ShovelerTexture *filterXInput;
+	/** target of the X pass at the reduced resolution, layered unless the batch holds a single layer */
+	ShovelerFramebuffer *filterXFramebuffer;
+	/** views of the individual layers of the above, or its own target for a single layer */
+	ShovelerTexture *filterXLayers[SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_BATCH_LAYERS];
+	/** layer of the X pass read by the Y pass, pointed to by its material */
+	ShovelerTexture *filterYInput;
+	/** sampler of the Y pass, which only needs to interpolate if the X pass has a reduced resolution */
+	ShovelerSampler *filterYSampler;
+	/** lifts and blurs all used layers at once, layered unless the batch holds a single layer */
+	ShovelerMaterial *filterXMaterial;
+	/** blurs a single layer straight into its output region, upsampling it if it has a higher resolution */
+	ShovelerMaterial *filterYMaterial;
+	ShovelerModel *filterModel;
+	ShovelerScene *filterScene;
+	ChainOutput outputs[SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_BATCH_LAYERS];
+	/** number of layers used by inputs added since the last render */
+	int numLayers;
+	/** highest number of layers used by the renders since the batch was last fully used */
+	int peakLayers;
+	/** number of consecutive renders that left some of the layers unused */
+	int underusedRenders;
+} ChainBatch;
+
+static ShovelerFilter *createFilter(ShovelerShaderCache *shaderCache, int width, int height, GLsizei samples, int layers, float exponentialFactor, bool layered);
+static void createOwnFilterYFramebuffer(DepthTextureGaussianFilter *depthTextureGaussianFilter);
 static int filterDepthTextureGaussian(ShovelerFilter *filter, ShovelerRenderState *renderState);
 static void freeDepthTextureGaussian(void *data);
+static ChainBatch *createChainBatch(ShovelerFilterDepthTextureGaussianChain *chain, int width, int height, float exponentialFactor);
+static void resizeChainBatch(ShovelerFilterDepthTextureGaussianChain *chain, ChainBatch *batch, int layers);
+static void createChainBatchTargets(ChainBatch *batch, int layers);
+static void freeChainBatchTargets(ChainBatch *batch);
+static void freeChainBatch(ChainBatch *batch);
+static void freeChainBatches(ShovelerFilterDepthTextureGaussianChain *chain);
 
 ShovelerFilter *shovelerFilterDepthTextureGaussianCreate(ShovelerShaderCache *shaderCache, int width, int height, GLsizei samples, float exponentialFactor)
+{
+	return createFilter(shaderCache, width, height, samples, /* layers */ 1, exponentialFactor, /* layered */ false);
+}
+
+ShovelerFilter *shovelerFilterDepthTextureGaussianCreateLayered(ShovelerShaderCache *shaderCache, int width, int height, int layers, float exponentialFactor)
+{
+	assert(layers <= SHOVELER_MATERIAL_DEPTH_TEXTURE_GAUSSIAN_FILTER_MAX_LAYERS);
+
+	ShovelerFilter *filter = createFilter(shaderCache, width, height, /* samples */ 1, layers, exponentialFactor, /* layered */ true);
+	shovelerFilterDepthTextureGaussianSetLayers(filter, layers);
+	return filter;
+}
+
+void shovelerFilterDepthTextureGaussianSetLayers(ShovelerFilter *filter, int numLayers)
+{
+	DepthTextureGaussianFilter *depthTextureGaussianFilter = (DepthTextureGaussianFilter *) filter->data;
+	assert(depthTextureGaussianFilter->layered);
+	assert(numLayers <= depthTextureGaussianFilter->layers);
+
+	shovelerMaterialDepthTextureGaussianFilterSetLayers(depthTextureGaussianFilter->filterXMaterial, numLayers);
+	shovelerMaterialDepthTextureGaussianFilterSetLayers(depthTextureGaussianFilter->filterYMaterial, numLayers);
+}
+
+void shovelerFilterDepthTextureGaussianSetOutputFramebuffer(ShovelerFilter *filter, ShovelerFramebuffer *outputFramebuffer)
+{
+	DepthTextureGaussianFilter *depthTextureGaussianFilter = (DepthTextureGaussianFilter *) filter->data;
+
+	if(outputFramebuffer == NULL) {
+		if(depthTextureGaussianFilter->filterYFramebuffer == NULL) {
+			createOwnFilterYFramebuffer(depthTextureGaussianFilter);
+		}
+
+		outputFramebuffer = depthTextureGaussianFilter->filterYFramebuffer;
+	}
+
+	shovelerFilterDepthTextureGaussianSetOutputRegion(filter, outputFramebuffer, 0, 0, outputFramebuffer->width, outputFramebuffer->height);
+}
+
+void shovelerFilterDepthTextureGaussianSetOutputRegion(ShovelerFilter *filter, ShovelerFramebuffer *outputFramebuffer, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	DepthTextureGaussianFilter *depthTextureGaussianFilter = (DepthTextureGaussianFilter *) filter->data;
+
+	depthTextureGaussianFilter->outputFramebuffer = outputFramebuffer;
+	depthTextureGaussianFilter->outputX = x;
+	depthTextureGaussianFilter->outputY = y;
+	depthTextureGaussianFilter->outputWidth = width;
+	depthTextureGaussianFilter->outputHeight = height;
+	filter->outputTexture = outputFramebuffer->renderTarget;
+}
+
+void shovelerFilterDepthTextureGaussianSetFramebufferPool(ShovelerFilter *filter, ShovelerFramebufferPool *framebufferPool)
+{
+	DepthTextureGaussianFilter *depthTextureGaussianFilter = (DepthTextureGaussianFilter *) filter->data;
+	assert(!depthTextureGaussianFilter->layered);
+
+	if(framebufferPool == depthTextureGaussianFilter->framebufferPool) {
+		return;
+	}
+
+	if(depthTextureGaussianFilter->framebufferPool == NULL) {
+		shovelerFramebufferFree(depthTextureGaussianFilter->filterXFramebuffer, /* keepTargets */ false);
+		depthTextureGaussianFilter->filterXFramebuffer = NULL;
+		depthTextureGaussianFilter->filterXTexture = NULL;
+	} else if(framebufferPool == NULL) {
+		depthTextureGaussianFilter->filterXFramebuffer = shovelerFramebufferCreateColorOnly(depthTextureGaussianFilter->width, depthTextureGaussianFilter->height, depthTextureGaussianFilter->samples, 1, 32);
+		depthTextureGaussianFilter->filterXTexture = depthTextureGaussianFilter->filterXFramebuffer->renderTarget;
+	}
+
+	depthTextureGaussianFilter->framebufferPool = framebufferPool;
+}
+
+ShovelerFilterDepthTextureGaussianChain *shovelerFilterDepthTextureGaussianChainCreate(ShovelerShaderCache *shaderCache)
+{
+	ShovelerFilterDepthTextureGaussianChain *chain = malloc(sizeof(ShovelerFilterDepthTextureGaussianChain));
+	chain->shaderCache = shaderCache;
+	chain->downsample = 1;
+	chain->batches = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ChainBatch *));
+	chain->filterSampler = shovelerSamplerCreate(/* interpolate */ false, /* useMipmaps */ false, /* clamp */ true);
+	chain->upsampleSampler = shovelerSamplerCreate(/* interpolate */ true, /* useMipmaps */ false, /* clamp */ true);
+	chain->filterCamera = shovelerCameraIdentityCreate(shaderCache);
+	chain->filterQuad = shovelerDrawableQuadCreate();
+
+	chain->filterSceneRenderPassOptions.overrideMaterial = NULL;
+	chain->filterSceneRenderPassOptions.emitters = false;
+	chain->filterSceneRenderPassOptions.screenspace = true;
+	chain->filterSceneRenderPassOptions.onlyShadowCasters = true;
+	chain->filterSceneRenderPassOptions.skipOccluded = false;
+	chain->filterSceneRenderPassOptions.renderState.blend = false;
+	chain->filterSceneRenderPassOptions.renderState.blendSourceFactor = GL_ONE;
+	chain->filterSceneRenderPassOptions.renderState.blendDestinationFactor = GL_ONE;
+	chain->filterSceneRenderPassOptions.renderState.depthTest = false;
+	chain->filterSceneRenderPassOptions.renderState.depthFunction = GL_EQUAL;
+	chain->filterSceneRenderPassOptions.renderState.depthMask = GL_FALSE;
+
+	return chain;
+}
+
+void shovelerFilterDepthTextureGaussianChainSetDownsample(ShovelerFilterDepthTextureGaussianChain *chain, int downsample)
+{
+	if(downsample < 1) {
+		downsample = 1;
+	}
+
+	if(downsample == chain->downsample) {
+		return;
+	}
+
+	freeChainBatches(chain);
+	chain->downsample = downsample;
+}
+
+ShovelerFramebuffer *shovelerFilterDepthTextureGaussianChainAddInput(ShovelerFilterDepthTextureGaussianChain *chain, int width, int height, float exponentialFactor, ShovelerFramebuffer *outputFramebuffer, GLint outputX, GLint outputY, GLsizei outputWidth, GLsizei outputHeight)
+{
+	// prefer a free layer, then growing a batch by another layer, and only then start a new single layer batch
+	ChainBatch *batch = NULL;
+	ChainBatch *growableBatch = NULL;
+	for(guint i = 0; i < chain->batches->len; i++) {
+		ChainBatch *candidateBatch = g_array_index(chain->batches, ChainBatch *, i);
+		if(candidateBatch->width != width
+			|| candidateBatch->height != height
+			|| candidateBatch->exponentialFactor != exponentialFactor) {
+			continue;
+		}
+
+		if(candidateBatch->numLayers < candidateBatch->layers) {
+			batch = candidateBatch;
+			break;
+		}
+
+		if(growableBatch == NULL && candidateBatch->layers < SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_BATCH_LAYERS) {
+			growableBatch = candidateBatch;
+		}
+	}
+
+	if(batch == NULL && growableBatch != NULL) {
+		batch = growableBatch;
+		resizeChainBatch(chain, batch, batch->layers + 1);
+	}
+
+	if(batch == NULL) {
+		batch = createChainBatch(chain, width, height, exponentialFactor);
+		g_array_append_val(chain->batches, batch);
+	}
+
+	int layer = batch->numLayers++;
+	ChainOutput *output = &batch->outputs[layer];
+	output->framebuffer = outputFramebuffer;
+	output->x = outputX;
+	output->y = outputY;
+	output->width = outputWidth;
+	output->height = outputHeight;
+
+	return batch->depthLayerFramebuffers[layer];
+}
+
+int shovelerFilterDepthTextureGaussianChainRender(ShovelerFilterDepthTextureGaussianChain *chain, ShovelerRenderState *renderState)
+{
+	int rendered = 0;
+
+	shovelerRenderStateDisableBlend(renderState);
+	shovelerRenderStateDisableDepthTest(renderState);
+
+	for(guint i = 0; i < chain->batches->len; i++) {
+		ChainBatch *batch = g_array_index(chain->batches, ChainBatch *, i);
+
+		// both passes cover their whole viewport, so neither needs to clear it first
+		if(batch->numLayers > 0) {
+			// lift and blur all used layers at once in X direction at the reduced resolution
+			if(batch->layers > 1) {
+				shovelerMaterialDepthTextureGaussianFilterSetLayers(batch->filterXMaterial, batch->numLayers);
+			}
+
+			shovelerFramebufferUse(batch->filterXFramebuffer);
+			chain->filterSceneRenderPassOptions.overrideMaterial = batch->filterXMaterial;
+			rendered += shovelerSceneRenderPass(batch->filterScene, chain->filterCamera, NULL, chain->filterSceneRenderPassOptions, renderState);
+
+			// blur each layer in Y direction straight into its output, interpolating if it has a higher resolution
+			chain->filterSceneRenderPassOptions.overrideMaterial = batch->filterYMaterial;
+			for(int layer = 0; layer < batch->numLayers; layer++) {
+				ChainOutput *output = &batch->outputs[layer];
+				shovelerFramebufferUseRegion(output->framebuffer, output->x, output->y, output->width, output->height);
+
+				batch->filterYInput = batch->filterXLayers[layer];
+				rendered += shovelerSceneRenderPass(batch->filterScene, chain->filterCamera, NULL, chain->filterSceneRenderPassOptions, renderState);
+			}
+		}
+
+		// shrink batches to the most layers they needed once they have stayed underused for a while
+		if(batch->numLayers < batch->layers) {
+			batch->peakLayers = batch->numLayers > batch->peakLayers ? batch->numLayers : batch->peakLayers;
+			batch->underusedRenders++;
+		} else {
+			batch->peakLayers = 0;
+			batch->underusedRenders = 0;
+		}
+
+		batch->numLayers = 0;
+
+		if(batch->underusedRenders >= SHOVELER_FILTER_DEPTH_TEXTURE_GAUSSIAN_CHAIN_SHRINK_RENDERS) {
+			if(batch->peakLayers == 0) {
+				freeChainBatch(batch);
+				g_array_remove_index(chain->batches, i);
+				i--;
+				continue;
+			}
+
+			resizeChainBatch(chain, batch, batch->peakLayers);
+		}
+	}
+
+	chain->filterSceneRenderPassOptions.overrideMaterial = NULL;
+
+	return rendered;
+}
+
+void shovelerFilterDepthTextureGaussianChainFree(ShovelerFilterDepthTextureGaussianChain *chain)
+{
+	if(chain == NULL) {
+		return;
+	}
+
+	shovelerShaderCacheInvalidateCamera(chain->shaderCache, chain->filterCamera);
+
+	freeChainBatches(chain);
+	g_array_free(chain->batches, /* freeSegment */ true);
+	shovelerDrawableFree(chain->filterQuad);
+	shovelerCameraFree(chain->filterCamera);
+	shovelerSamplerFree(chain->upsampleSampler);
+	shovelerSamplerFree(chain->filterSampler);
+	free(chain);
+}
+
+static ShovelerFilter *createFilter(ShovelerShaderCache *shaderCache, int width, int height, GLsizei samples, int layers, float exponentialFactor, bool layered)
 {
 	DepthTextureGaussianFilter *depthTextureGaussianFilter = malloc(sizeof(DepthTextureGaussianFilter));
 	depthTextureGaussianFilter->filter.inputTexture = NULL;
@@ -42,15 +348,35 @@ ShovelerFilter *shovelerFilterDepthTextureGaussianCreate(ShovelerShaderCache *sh
 	depthTextureGaussianFilter->shaderCache = shaderCache;
 	depthTextureGaussianFilter->filterSampler = shovelerSamplerCreate(false, false, true);
 	depthTextureGaussianFilter->filterCamera = shovelerCameraIdentityCreate(shaderCache);
+	depthTextureGaussianFilter->width = width;
+	depthTextureGaussianFilter->height = height;
+	depthTextureGaussianFilter->samples = samples;
+	depthTextureGaussianFilter->layered = layered;
+	depthTextureGaussianFilter->layers = layers;
+	depthTextureGaussianFilter->framebufferPool = NULL;
+	depthTextureGaussianFilter->filterYFramebuffer = NULL;
+	depthTextureGaussianFilter->outputFramebuffer = NULL;
 
-	depthTextureGaussianFilter->filterXFramebuffer = shovelerFramebufferCreateColorOnly(width, height, samples, 1, 32);
-	depthTextureGaussianFilter->filterYFramebuffer = shovelerFramebufferCreateColorOnly(width, height, samples, 1, 32);
+	if(layered) {
+		depthTextureGaussianFilter->filterXFramebuffer = shovelerFramebufferCreateColorOnlyLayered(width, height, layers, 1, 32);
+		depthTextureGaussianFilter->filterXTexture = depthTextureGaussianFilter->filterXFramebuffer->renderTarget;
+		depthTextureGaussianFilter->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreateLayered(shaderCache, &depthTextureGaussianFilter->filter.inputTexture, &depthTextureGaussianFilter->filterSampler, width, height);
+		depthTextureGaussianFilter->filterYMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreateLayered(shaderCache, &depthTextureGaussianFilter->filterXTexture, &depthTextureGaussianFilter->filterSampler, width, height);
+	} else {
+		depthTextureGaussianFilter->filterXFramebuffer = shovelerFramebufferCreateColorOnly(width, height, samples, 1, 32);
+		depthTextureGaussianFilter->filterXTexture = depthTextureGaussianFilter->filterXFramebuffer->renderTarget;
+		depthTextureGaussianFilter->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(shaderCache, &depthTextureGaussianFilter->filter.inputTexture, &depthTextureGaussianFilter->filterSampler, width, height);
+		depthTextureGaussianFilter->filterYMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(shaderCache, &depthTextureGaussianFilter->filterXTexture, &depthTextureGaussianFilter->filterSampler, width, height);
+	}
 
-	depthTextureGaussianFilter->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(shaderCache, &depthTextureGaussianFilter->filter.inputTexture, &depthTextureGaussianFilter->filterSampler, width, height);
 	shovelerMaterialDepthTextureGaussianFilterEnableExponentialLifting(depthTextureGaussianFilter->filterXMaterial, exponentialFactor);
-	depthTextureGaussianFilter->filterYMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(shaderCache, &depthTextureGaussianFilter->filterXFramebuffer->renderTarget, &depthTextureGaussianFilter->filterSampler, width, height);
 	shovelerMaterialDepthTextureGaussianFilterSetDirection(depthTextureGaussianFilter->filterYMaterial, false, true);
-	depthTextureGaussianFilter->filter.outputTexture = depthTextureGaussianFilter->filterYFramebuffer->renderTarget;
+	depthTextureGaussianFilter->filter.outputTexture = NULL;
+
+	// layered filters expose their output texture right away for layer views to be created from it
+	if(layered) {
+		shovelerFilterDepthTextureGaussianSetOutputFramebuffer(&depthTextureGaussianFilter->filter, NULL);
+	}
 
 	depthTextureGaussianFilter->filterQuad = shovelerDrawableQuadCreate();
 	depthTextureGaussianFilter->filterScene = shovelerSceneCreate(shaderCache);
@@ -65,6 +391,7 @@ ShovelerFilter *shovelerFilterDepthTextureGaussianCreate(ShovelerShaderCache *sh
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.emitters = false;
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.screenspace = true;
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.onlyShadowCasters = true;
+	depthTextureGaussianFilter->filterSceneRenderPassOptions.skipOccluded = false;
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.renderState.blend = false;
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.renderState.blendSourceFactor = GL_ONE;
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.renderState.blendDestinationFactor = GL_ONE;
@@ -76,10 +403,28 @@ ShovelerFilter *shovelerFilterDepthTextureGaussianCreate(ShovelerShaderCache *sh
 	return &depthTextureGaussianFilter->filter;
 }
 
+static void createOwnFilterYFramebuffer(DepthTextureGaussianFilter *depthTextureGaussianFilter)
+{
+	if(depthTextureGaussianFilter->layered) {
+		depthTextureGaussianFilter->filterYFramebuffer = shovelerFramebufferCreateColorOnlyLayered(depthTextureGaussianFilter->width, depthTextureGaussianFilter->height, depthTextureGaussianFilter->layers, 1, 32);
+	} else {
+		depthTextureGaussianFilter->filterYFramebuffer = shovelerFramebufferCreateColorOnly(depthTextureGaussianFilter->width, depthTextureGaussianFilter->height, depthTextureGaussianFilter->samples, 1, 32);
+	}
+}
+
 static int filterDepthTextureGaussian(ShovelerFilter *filter, ShovelerRenderState *renderState)
 {
 	DepthTextureGaussianFilter *depthTextureGaussianFilter = (DepthTextureGaussianFilter *) filter->data;
 
+	if(depthTextureGaussianFilter->outputFramebuffer == NULL) {
+		shovelerFilterDepthTextureGaussianSetOutputFramebuffer(filter, NULL);
+	}
+
+	if(depthTextureGaussianFilter->framebufferPool != NULL) {
+		depthTextureGaussianFilter->filterXFramebuffer = shovelerFramebufferPoolAcquireColorOnly(depthTextureGaussianFilter->framebufferPool, depthTextureGaussianFilter->width, depthTextureGaussianFilter->height, depthTextureGaussianFilter->samples, 1, 32);
+		depthTextureGaussianFilter->filterXTexture = depthTextureGaussianFilter->filterXFramebuffer->renderTarget;
+	}
+
 	int rendered = 0;
 
 	shovelerRenderStateDisableBlend(renderState);
@@ -94,12 +439,17 @@ static int filterDepthTextureGaussian(ShovelerFilter *filter, ShovelerRenderStat
 	rendered += shovelerSceneRenderPass(depthTextureGaussianFilter->filterScene, depthTextureGaussianFilter->filterCamera, NULL, depthTextureGaussianFilter->filterSceneRenderPassOptions, renderState);
 
 	// filter depth map in Y direction
-	shovelerFramebufferUse(depthTextureGaussianFilter->filterYFramebuffer);
+	shovelerFramebufferUseRegion(depthTextureGaussianFilter->outputFramebuffer, depthTextureGaussianFilter->outputX, depthTextureGaussianFilter->outputY, depthTextureGaussianFilter->outputWidth, depthTextureGaussianFilter->outputHeight);
 	glClear(GL_COLOR_BUFFER_BIT);
 
 	depthTextureGaussianFilter->filterSceneRenderPassOptions.overrideMaterial = depthTextureGaussianFilter->filterYMaterial;
 	rendered += shovelerSceneRenderPass(depthTextureGaussianFilter->filterScene, depthTextureGaussianFilter->filterCamera, NULL, depthTextureGaussianFilter->filterSceneRenderPassOptions, renderState);
 
+	if(depthTextureGaussianFilter->framebufferPool != NULL) {
+		shovelerFramebufferPoolRelease(depthTextureGaussianFilter->framebufferPool, depthTextureGaussianFilter->filterXFramebuffer);
+		depthTextureGaussianFilter->filterXFramebuffer = NULL;
+	}
+
 	return rendered;
 }
 
@@ -119,3 +469,123 @@ static void freeDepthTextureGaussian(void *data)
 	shovelerSamplerFree(depthTextureGaussianFilter->filterSampler);
 	free(depthTextureGaussianFilter);
 }
+
+static ChainBatch *createChainBatch(ShovelerFilterDepthTextureGaussianChain *chain, int width, int height, float exponentialFactor)
+{
+	int filterWidth = width / chain->downsample;
+	int filterHeight = height / chain->downsample;
+
+	ChainBatch *batch = malloc(sizeof(ChainBatch));
+	batch->width = width;
+	batch->height = height;
+	batch->exponentialFactor = exponentialFactor;
+	batch->filterWidth = filterWidth > 0 ? filterWidth : 1;
+	batch->filterHeight = filterHeight > 0 ? filterHeight : 1;
+	batch->filterYInput = NULL;
+	batch->filterYSampler = chain->downsample > 1 ? chain->upsampleSampler : chain->filterSampler;
+	batch->numLayers = 0;
+	batch->peakLayers = 0;
+	batch->underusedRenders = 0;
+
+	// batches start out with a single layer, which takes the same path as filtering a light on its own
+	createChainBatchTargets(batch, /* layers */ 1);
+	batch->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(chain->shaderCache, &batch->filterXInput, &chain->filterSampler, batch->filterWidth, batch->filterHeight);
+	shovelerMaterialDepthTextureGaussianFilterEnableExponentialLifting(batch->filterXMaterial, exponentialFactor);
+	batch->filterYMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(chain->shaderCache, &batch->filterYInput, &batch->filterYSampler, batch->filterWidth, batch->filterHeight);
+	shovelerMaterialDepthTextureGaussianFilterSetDirection(batch->filterYMaterial, false, true);
+
+	batch->filterScene = shovelerSceneCreate(chain->shaderCache);
+	batch->filterModel = shovelerModelCreate(chain->filterQuad, batch->filterYMaterial);
+	batch->filterModel->translation.values[0] = -1.0f;
+	batch->filterModel->translation.values[1] = -1.0f;
+	batch->filterModel->scale.values[0] = 2.0f;
+	batch->filterModel->scale.values[1] = 2.0f;
+	shovelerModelUpdateTransformation(batch->filterModel);
+	shovelerSceneAddModel(batch->filterScene, batch->filterModel);
+
+	return batch;
+}
+
+/** Recreates the targets of a batch with the passed number of layers, keeping the depth maps already rendered. */
+static void resizeChainBatch(ShovelerFilterDepthTextureGaussianChain *chain, ChainBatch *batch, int layers)
+{
+	ChainBatch previousBatch = *batch;
+	createChainBatchTargets(batch, layers);
+
+	int keptLayers = batch->numLayers < layers ? batch->numLayers : layers;
+	ShovelerTexture *previousDepthTarget = previousBatch.depthFramebuffer->depthTarget;
+	ShovelerTexture *depthTarget = batch->depthFramebuffer->depthTarget;
+	for(int layer = 0; layer < keptLayers; layer++) {
+		glCopyImageSubData(
+			previousDepthTarget->texture, previousDepthTarget->target, 0, 0, 0, previousDepthTarget->target == GL_TEXTURE_2D_ARRAY ? layer : 0,
+			depthTarget->texture, depthTarget->target, 0, 0, 0, depthTarget->target == GL_TEXTURE_2D_ARRAY ? layer : 0,
+			batch->width, batch->height, 1);
+	}
+
+	freeChainBatchTargets(&previousBatch);
+
+	if((previousBatch.layers > 1) != (layers > 1)) {
+		shovelerMaterialFree(batch->filterXMaterial);
+		if(layers > 1) {
+			batch->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreateLayered(chain->shaderCache, &batch->filterXInput, &chain->filterSampler, batch->filterWidth, batch->filterHeight);
+		} else {
+			batch->filterXMaterial = shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(chain->shaderCache, &batch->filterXInput, &chain->filterSampler, batch->filterWidth, batch->filterHeight);
+		}
+		shovelerMaterialDepthTextureGaussianFilterEnableExponentialLifting(batch->filterXMaterial, batch->exponentialFactor);
+	}
+
+	batch->peakLayers = 0;
+	batch->underusedRenders = 0;
+}
+
+static void createChainBatchTargets(ChainBatch *batch, int layers)
+{
+	batch->layers = layers;
+
+	if(layers == 1) {
+		batch->depthFramebuffer = shovelerFramebufferCreateDepthOnly(batch->width, batch->height, /* samples */ 1);
+		batch->depthLayerFramebuffers[0] = batch->depthFramebuffer;
+		batch->filterXFramebuffer = shovelerFramebufferCreateColorOnly(batch->filterWidth, batch->filterHeight, /* samples */ 1, 1, 32);
+		batch->filterXLayers[0] = batch->filterXFramebuffer->renderTarget;
+	} else {
+		batch->depthFramebuffer = shovelerFramebufferCreateDepthOnlyLayered(batch->width, batch->height, layers);
+		batch->filterXFramebuffer = shovelerFramebufferCreateColorOnlyLayered(batch->filterWidth, batch->filterHeight, layers, 1, 32);
+		for(int layer = 0; layer < layers; layer++) {
+			batch->depthLayerFramebuffers[layer] = shovelerFramebufferCreateDepthOnlyLayer(batch->depthFramebuffer->depthTarget, layer);
+			batch->filterXLayers[layer] = shovelerTextureCreateLayerView(batch->filterXFramebuffer->renderTarget, layer);
+		}
+	}
+
+	batch->filterXInput = batch->depthFramebuffer->depthTarget;
+}
+
+static void freeChainBatchTargets(ChainBatch *batch)
+{
+	if(batch->layers > 1) {
+		for(int layer = 0; layer < batch->layers; layer++) {
+			shovelerTextureFree(batch->filterXLayers[layer]);
+			shovelerFramebufferFree(batch->depthLayerFramebuffers[layer], /* keepTargets */ true);
+		}
+	}
+
+	shovelerFramebufferFree(batch->filterXFramebuffer, /* keepTargets */ false);
+	shovelerFramebufferFree(batch->depthFramebuffer, /* keepTargets */ false);
+}
+
+static void freeChainBatch(ChainBatch *batch)
+{
+	shovelerSceneFree(batch->filterScene);
+	shovelerMaterialFree(batch->filterYMaterial);
+	shovelerMaterialFree(batch->filterXMaterial);
+	freeChainBatchTargets(batch);
+	free(batch);
+}
+
+static void freeChainBatches(ShovelerFilterDepthTextureGaussianChain *chain)
+{
+	for(guint i = 0; i < chain->batches->len; i++) {
+		freeChainBatch(g_array_index(chain->batches, ChainBatch *, i));
+	}
+
+	g_array_set_size(chain->batches, 0);
+}
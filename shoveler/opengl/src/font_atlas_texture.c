@@ -17,19 +17,24 @@ ShovelerFontAtlasTexture *shovelerFontAtlasTextureCreate(ShovelerFontAtlas *font
 
 bool shovelerFontAtlasTextureUpdate(ShovelerFontAtlasTexture *fontAtlasTexture)
 {
-	bool newTextureGenerated = false;
+	ShovelerFontAtlas *fontAtlas = fontAtlasTexture->fontAtlas;
 
-	if(fontAtlasTexture->texture == NULL || fontAtlasTexture->atlasImageSize != fontAtlasTexture->fontAtlas->image->width) {
+	// upload synchronously rather than through a texture uploader, since text is rendered from new glyphs right away
+	if(fontAtlasTexture->texture == NULL || fontAtlasTexture->atlasImageSize != fontAtlas->image->width) {
 		shovelerTextureFree(fontAtlasTexture->texture);
-		fontAtlasTexture->atlasImageSize = fontAtlasTexture->fontAtlas->image->width;
-		fontAtlasTexture->texture = shovelerTextureCreate2d(fontAtlasTexture->fontAtlas->image, false);
-		newTextureGenerated = true;
+		fontAtlasTexture->atlasImageSize = fontAtlas->image->width;
+		fontAtlasTexture->texture = shovelerTextureCreate2d(fontAtlas->image, false);
+		shovelerTextureUpdate(fontAtlasTexture->texture);
+		shovelerFontAtlasClearDirty(fontAtlas);
+		return true;
 	}
 
-	// TODO: only update the texture if the font atlas is "dirty"
-	shovelerTextureUpdate(fontAtlasTexture->texture);
+	// only upload the glyphs added since the last update
+	shovelerTextureMarkDirty(fontAtlasTexture->texture, (unsigned int) fontAtlas->dirtyX, (unsigned int) fontAtlas->dirtyY, (unsigned int) fontAtlas->dirtyWidth, (unsigned int) fontAtlas->dirtyHeight);
+	shovelerTextureUpdateDirty(fontAtlasTexture->texture);
+	shovelerFontAtlasClearDirty(fontAtlas);
 
-	return newTextureGenerated;
+	return false;
 }
 
 void shovelerFontAtlasTextureFree(ShovelerFontAtlasTexture *fontAtlasTexture)
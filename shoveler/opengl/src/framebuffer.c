@@ -1,9 +1,30 @@
+#include <assert.h> // assert
 #include <stdlib.h> // malloc, free
 
 #include "shoveler/framebuffer.h"
 #include "shoveler/log.h"
 #include "shoveler/opengl.h"
 
+typedef enum {
+	POOL_TARGETS_COLOR_AND_DEPTH,
+	POOL_TARGETS_COLOR_ONLY,
+	POOL_TARGETS_DEPTH_ONLY,
+} PoolTargets;
+
+typedef struct {
+	PoolTargets targets;
+	GLsizei width;
+	GLsizei height;
+	GLsizei samples;
+	int channels;
+	int bitsPerChannel;
+} PoolKey;
+
+static ShovelerFramebuffer *acquireFromPool(ShovelerFramebufferPool *pool, PoolKey key);
+static guint hashPoolKey(gconstpointer poolKeyPointer);
+static gboolean comparePoolKeys(gconstpointer firstPoolKeyPointer, gconstpointer secondPoolKeyPointer);
+static void freeReleasedFramebuffers(void *queuePointer);
+static void freeFramebuffer(void *framebufferPointer);
 static void handleFramebufferIncomplete(GLenum error);
 
 ShovelerFramebuffer *shovelerFramebufferCreate(GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel)
@@ -67,6 +88,69 @@ ShovelerFramebuffer *shovelerFramebufferCreateDepthOnly(GLsizei width, GLsizei h
 	return framebuffer;
 }
 
+ShovelerFramebuffer *shovelerFramebufferCreateColorOnlyLayered(GLsizei width, GLsizei height, GLsizei layers, int channels, int bitsPerChannel)
+{
+	ShovelerFramebuffer *framebuffer = malloc(sizeof(ShovelerFramebuffer));
+	glGenFramebuffers(1, &framebuffer->framebuffer);
+	framebuffer->width = width;
+	framebuffer->height = height;
+	framebuffer->renderTarget = shovelerTextureCreateRenderTargetArray(width, height, layers, channels, bitsPerChannel);
+	framebuffer->depthTarget = NULL;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer);
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, framebuffer->renderTarget->texture, 0);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if(status != GL_FRAMEBUFFER_COMPLETE) {
+		handleFramebufferIncomplete(status);
+	}
+
+	return framebuffer;
+}
+
+ShovelerFramebuffer *shovelerFramebufferCreateDepthOnlyLayered(GLsizei width, GLsizei height, GLsizei layers)
+{
+	ShovelerFramebuffer *framebuffer = malloc(sizeof(ShovelerFramebuffer));
+	glGenFramebuffers(1, &framebuffer->framebuffer);
+	framebuffer->width = width;
+	framebuffer->height = height;
+	framebuffer->renderTarget = NULL;
+	framebuffer->depthTarget = shovelerTextureCreateDepthTargetArray(width, height, layers);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer);
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, framebuffer->depthTarget->texture, 0);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if(status != GL_FRAMEBUFFER_COMPLETE) {
+		handleFramebufferIncomplete(status);
+	}
+
+	return framebuffer;
+}
+
+ShovelerFramebuffer *shovelerFramebufferCreateDepthOnlyLayer(ShovelerTexture *depthTargetArray, GLint layer)
+{
+	assert(depthTargetArray->target == GL_TEXTURE_2D_ARRAY);
+	assert((unsigned int) layer < depthTargetArray->layers);
+
+	ShovelerFramebuffer *framebuffer = malloc(sizeof(ShovelerFramebuffer));
+	glGenFramebuffers(1, &framebuffer->framebuffer);
+	framebuffer->width = depthTargetArray->width;
+	framebuffer->height = depthTargetArray->height;
+	framebuffer->renderTarget = NULL;
+	framebuffer->depthTarget = depthTargetArray;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTargetArray->texture, 0, layer);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if(status != GL_FRAMEBUFFER_COMPLETE) {
+		handleFramebufferIncomplete(status);
+	}
+
+	return framebuffer;
+}
+
 bool shovelerFramebufferUse(ShovelerFramebuffer *framebuffer)
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->framebuffer);
@@ -77,15 +161,29 @@ bool shovelerFramebufferUse(ShovelerFramebuffer *framebuffer)
 		glDrawBuffer(GL_NONE);
 	}
 
+	glDisable(GL_SCISSOR_TEST);
 	glViewport(0, 0, framebuffer->width, framebuffer->height);
 	return shovelerOpenGLCheckSuccess();
 }
 
+bool shovelerFramebufferUseRegion(ShovelerFramebuffer *framebuffer, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if(!shovelerFramebufferUse(framebuffer)) {
+		return false;
+	}
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(x, y, width, height);
+	glViewport(x, y, width, height);
+	return shovelerOpenGLCheckSuccess();
+}
+
 bool shovelerFramebufferBlitToDefault(ShovelerFramebuffer *framebuffer)
 {
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer->framebuffer);
 	glDrawBuffer(GL_BACK);
+	glDisable(GL_SCISSOR_TEST);
 	glBlitFramebuffer(0, 0, framebuffer->width, framebuffer->height, 0, 0, framebuffer->width, framebuffer->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 	return shovelerOpenGLCheckSuccess();
 }
@@ -105,6 +203,133 @@ void shovelerFramebufferFree(ShovelerFramebuffer *framebuffer, bool keepTargets)
 	free(framebuffer);
 }
 
+ShovelerFramebufferPool *shovelerFramebufferPoolCreate()
+{
+	ShovelerFramebufferPool *pool = malloc(sizeof(ShovelerFramebufferPool));
+	pool->releasedFramebuffers = g_hash_table_new_full(hashPoolKey, comparePoolKeys, free, freeReleasedFramebuffers);
+	pool->acquiredFramebuffers = g_hash_table_new_full(g_direct_hash, g_direct_equal, freeFramebuffer, free);
+	pool->numCreated = 0;
+
+	return pool;
+}
+
+ShovelerFramebuffer *shovelerFramebufferPoolAcquire(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel)
+{
+	PoolKey key = {POOL_TARGETS_COLOR_AND_DEPTH, width, height, samples, channels, bitsPerChannel};
+	return acquireFromPool(pool, key);
+}
+
+ShovelerFramebuffer *shovelerFramebufferPoolAcquireColorOnly(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples, int channels, int bitsPerChannel)
+{
+	PoolKey key = {POOL_TARGETS_COLOR_ONLY, width, height, samples, channels, bitsPerChannel};
+	return acquireFromPool(pool, key);
+}
+
+ShovelerFramebuffer *shovelerFramebufferPoolAcquireDepthOnly(ShovelerFramebufferPool *pool, GLsizei width, GLsizei height, GLsizei samples)
+{
+	PoolKey key = {POOL_TARGETS_DEPTH_ONLY, width, height, samples, 0, 0};
+	return acquireFromPool(pool, key);
+}
+
+void shovelerFramebufferPoolRelease(ShovelerFramebufferPool *pool, ShovelerFramebuffer *framebuffer)
+{
+	PoolKey *key;
+	if(!g_hash_table_lookup_extended(pool->acquiredFramebuffers, framebuffer, NULL, (gpointer *) &key)) {
+		shovelerLogWarning("Tried to release framebuffer %p to pool %p that didn't acquire it, ignoring.", framebuffer, pool);
+		return;
+	}
+
+	g_hash_table_steal(pool->acquiredFramebuffers, framebuffer);
+
+	GQueue *releasedFramebuffers = g_hash_table_lookup(pool->releasedFramebuffers, key);
+	if(releasedFramebuffers == NULL) {
+		releasedFramebuffers = g_queue_new();
+		g_hash_table_insert(pool->releasedFramebuffers, key, releasedFramebuffers);
+	} else {
+		free(key);
+	}
+
+	g_queue_push_tail(releasedFramebuffers, framebuffer);
+}
+
+void shovelerFramebufferPoolFree(ShovelerFramebufferPool *pool)
+{
+	if(pool == NULL) {
+		return;
+	}
+
+	g_hash_table_destroy(pool->acquiredFramebuffers);
+	g_hash_table_destroy(pool->releasedFramebuffers);
+	free(pool);
+}
+
+static ShovelerFramebuffer *acquireFromPool(ShovelerFramebufferPool *pool, PoolKey key)
+{
+	ShovelerFramebuffer *framebuffer = NULL;
+
+	GQueue *releasedFramebuffers = g_hash_table_lookup(pool->releasedFramebuffers, &key);
+	if(releasedFramebuffers != NULL) {
+		framebuffer = g_queue_pop_tail(releasedFramebuffers);
+	}
+
+	if(framebuffer == NULL) {
+		switch(key.targets) {
+			case POOL_TARGETS_COLOR_AND_DEPTH:
+				framebuffer = shovelerFramebufferCreate(key.width, key.height, key.samples, key.channels, key.bitsPerChannel);
+			break;
+			case POOL_TARGETS_COLOR_ONLY:
+				framebuffer = shovelerFramebufferCreateColorOnly(key.width, key.height, key.samples, key.channels, key.bitsPerChannel);
+			break;
+			case POOL_TARGETS_DEPTH_ONLY:
+				framebuffer = shovelerFramebufferCreateDepthOnly(key.width, key.height, key.samples);
+			break;
+		}
+		pool->numCreated++;
+	}
+
+	PoolKey *acquiredKey = malloc(sizeof(PoolKey));
+	*acquiredKey = key;
+	g_hash_table_insert(pool->acquiredFramebuffers, framebuffer, acquiredKey);
+
+	return framebuffer;
+}
+
+static guint hashPoolKey(gconstpointer poolKeyPointer)
+{
+	const PoolKey *key = poolKeyPointer;
+
+	guint hash = (guint) key->targets;
+	hash = 31 * hash + (guint) key->width;
+	hash = 31 * hash + (guint) key->height;
+	hash = 31 * hash + (guint) key->samples;
+	hash = 31 * hash + (guint) key->channels;
+	hash = 31 * hash + (guint) key->bitsPerChannel;
+	return hash;
+}
+
+static gboolean comparePoolKeys(gconstpointer firstPoolKeyPointer, gconstpointer secondPoolKeyPointer)
+{
+	const PoolKey *firstKey = firstPoolKeyPointer;
+	const PoolKey *secondKey = secondPoolKeyPointer;
+
+	return firstKey->targets == secondKey->targets
+		&& firstKey->width == secondKey->width
+		&& firstKey->height == secondKey->height
+		&& firstKey->samples == secondKey->samples
+		&& firstKey->channels == secondKey->channels
+		&& firstKey->bitsPerChannel == secondKey->bitsPerChannel;
+}
+
+static void freeReleasedFramebuffers(void *queuePointer)
+{
+	g_queue_free_full(queuePointer, freeFramebuffer);
+}
+
+static void freeFramebuffer(void *framebufferPointer)
+{
+	shovelerFramebufferFree(framebufferPointer, /* keepTargets */ false);
+}
+
 static void handleFramebufferIncomplete(GLenum error)
 {
 	switch(error) {
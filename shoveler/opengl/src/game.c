@@ -1,10 +1,19 @@
 #include <stdlib.h> // malloc, free
+#include <string.h> // strchr
 
 #include <glad/glad.h>
 
+#ifdef SHOVELER_HAVE_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #include "shoveler/camera/perspective.h"
 #include "shoveler/drawable/quad.h"
 #include "shoveler/material/canvas.h"
+#include "shoveler/material/text.h"
+#include "shoveler/sprite/text.h"
 #include "shoveler/canvas.h"
 #include "shoveler/colliders.h"
 #include "shoveler/font.h"
@@ -14,11 +23,16 @@
 #include "shoveler/material.h"
 #include "shoveler/model.h"
 #include "shoveler/opengl.h"
+#include "shoveler/profiler.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader_cache.h"
+#include "shoveler/texture_uploader.h"
 
+static bool createSurfacelessContext(ShovelerGame *game);
+static void freeSurfacelessContext(ShovelerGame *game);
 static void updateScreenspaceCanvasRegion(ShovelerGame *game);
 static void keyHandler(ShovelerInput *input, int key, int scancode, int action, int mods, void *unused);
+static void updateProfilerOverlay(ShovelerGame *game);
 static gint64 elapsedNs(double dt);
 static void printFps(void *gamePointer);
 
@@ -28,18 +42,24 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 	game->windowedWidth = windowSettings->windowedWidth;
 	game->windowedHeight = windowSettings->windowedHeight;
 	game->samples = windowSettings->samples;
-	game->fullscreen = windowSettings->fullscreen;
+	game->fullscreen = windowSettings->fullscreen && !windowSettings->headless;
+	game->headless = windowSettings->headless;
 	game->updateExecutor = shovelerExecutorCreateDirect();
+	game->surfacelessDisplay = NULL;
+	game->surfacelessContext = NULL;
 
 	// request OpenGL4
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+	glfwWindowHint(GLFW_VISIBLE, windowSettings->headless ? GLFW_FALSE : GLFW_TRUE);
 
 	int width = windowSettings->windowedWidth;
 	int height = windowSettings->windowedHeight;
 	GLFWmonitor *monitor = NULL;
-	if(windowSettings->fullscreen) {
+	if(windowSettings->headless) {
+		shovelerLogInfo("Using headless mode rendering offscreen at %dx%d.", width, height);
+	} else if(windowSettings->fullscreen) {
 		monitor = glfwGetPrimaryMonitor();
 		shovelerLogInfo("Using borderless fullscreen mode on primary monitor '%s'.", glfwGetMonitorName(monitor));
 
@@ -56,23 +76,35 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 
 	game->window = glfwCreateWindow(width, height, windowSettings->windowTitle, monitor, NULL);
 	if(game->window == NULL) {
-		shovelerLogError("Failed to create glfw window.");
-		free(game);
-		return NULL;
+		// machines without a window system or GPU can still render through a surfaceless context, e.g. using llvmpipe
+		if(!windowSettings->headless || !createSurfacelessContext(game)) {
+			shovelerLogError("Failed to create glfw window.");
+			free(game);
+			return NULL;
+		}
 	}
 
-	glfwMakeContextCurrent(game->window);
+	shovelerGameUseContext(game);
+
+	GLADloadproc loadProc = (GLADloadproc) glfwGetProcAddress;
+#ifdef SHOVELER_HAVE_EGL
+	if(game->surfacelessContext != NULL) {
+		loadProc = (GLADloadproc) eglGetProcAddress;
+	}
+#endif
 
-	if(!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress)) {
+	if(!gladLoadGLLoader(loadProc)) {
 		shovelerLogError("Failed to initialize glad.");
+		freeSurfacelessContext(game);
 		glfwDestroyWindow(game->window);
 		free(game);
 		return NULL;
 	}
 
-	shovelerLogInfo("Opened glfw window with name '%s', using OpenGL driver version '%s' by '%s' and GLSL version '%s'.", windowSettings->windowTitle, glGetString(GL_VERSION), glGetString(GL_VENDOR), glGetString(GL_SHADING_LANGUAGE_VERSION));
+	shovelerLogInfo("Opened %s with name '%s', using OpenGL driver version '%s' by '%s' and GLSL version '%s'.", game->window != NULL ? "glfw window" : "headless game", windowSettings->windowTitle, glGetString(GL_VERSION), glGetString(GL_VENDOR), glGetString(GL_SHADING_LANGUAGE_VERSION));
 
 	if(!shovelerOpenGLCheckSuccess()) {
+		freeSurfacelessContext(game);
 		glfwDestroyWindow(game->window);
 		free(game);
 		return NULL;
@@ -88,10 +120,13 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 
 	glEnable(GL_CULL_FACE);
 
-	glfwSwapInterval(windowSettings->vsync ? 1 : 0);
+	if(!game->headless) {
+		glfwSwapInterval(windowSettings->vsync ? 1 : 0);
+	}
 
 	if(!shovelerOpenGLCheckSuccess()) {
 		glfwTerminate();
+		freeSurfacelessContext(game);
 		glfwDestroyWindow(game->window);
 		free(game);
 		return NULL;
@@ -102,6 +137,7 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 
 	game->framebuffer = shovelerFramebufferCreate(width, height, windowSettings->samples, 4, 8);
 	game->shaderCache = shovelerShaderCacheCreate();
+	game->textureUploader = shovelerTextureUploaderCreate(SHOVELER_GAME_TEXTURE_UPLOAD_FRAME_BUDGET);
 	game->scene = shovelerSceneCreate(game->shaderCache);
 	game->camera = shovelerCameraPerspectiveCreate(game->shaderCache, &cameraSettings->frame, &cameraSettings->projection);
 	game->colliders = shovelerCollidersCreate();
@@ -116,6 +152,12 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 	game->screenspaceCanvasModel = shovelerModelCreate(game->screenspaceCanvasQuad, game->screenspaceCanvasMaterial);
 	shovelerSceneAddModel(game->scene, game->screenspaceCanvasModel);
 
+	game->profiler = shovelerProfilerCreate();
+	game->scene->profiler = game->profiler;
+	game->profilerOverlay.fontAtlasTexture = NULL;
+	game->profilerOverlay.material = NULL;
+	game->profilerOverlay.lineSprites = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerSprite *));
+
 	game->update = update;
 	game->lastFrameTime = glfwGetTime();
 	game->lastFpsPrintTime = game->lastFrameTime;
@@ -130,8 +172,10 @@ ShovelerGame *shovelerGameCreate(ShovelerGameUpdateCallback *update, const Shove
 
 	shovelerCameraPerspectiveAttachController(game->camera, game->controller);
 
-	ShovelerGlobalContext *global = shovelerGlobalGetContext();
-	g_hash_table_insert(global->games, game->window, game);
+	if(game->window != NULL) {
+		ShovelerGlobalContext *global = shovelerGlobalGetContext();
+		g_hash_table_insert(global->games, game->window, game);
+	}
 
 	return game;
 }
@@ -165,23 +209,78 @@ void shovelerGameToggleFullscreen(ShovelerGame *game)
 	updateScreenspaceCanvasRegion(game);
 }
 
-int shovelerGameRenderFrame(ShovelerGame *game)
+void shovelerGameSetProfilerOverlayFont(ShovelerGame *game, ShovelerFontAtlasTexture *fontAtlasTexture)
 {
+	if(game->profilerOverlay.material == NULL) {
+		game->profilerOverlay.material = shovelerMaterialTextCreate(game->shaderCache, /* screenspace */ true);
+	}
+
+	game->profilerOverlay.fontAtlasTexture = fontAtlasTexture;
+
+	for(guint i = 0; i < game->profilerOverlay.lineSprites->len; i++) {
+		ShovelerSprite *lineSprite = g_array_index(game->profilerOverlay.lineSprites, ShovelerSprite *, i);
+		ShovelerSpriteText *lineSpriteText = lineSprite->data;
+		lineSpriteText->fontAtlasTexture = fontAtlasTexture;
+	}
+}
+
+void shovelerGameUseContext(ShovelerGame *game)
+{
+#ifdef SHOVELER_HAVE_EGL
+	if(game->surfacelessContext != NULL) {
+		eglMakeCurrent(game->surfacelessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, game->surfacelessContext);
+		return;
+	}
+#endif
+
 	glfwMakeContextCurrent(game->window);
+}
+
+int shovelerGameRenderFrame(ShovelerGame *game)
+{
+	shovelerGameUseContext(game);
 
 	double now = glfwGetTime();
 	double dt = now - game->lastFrameTime;
 	game->lastFrameTime = now;
 	game->framesSinceLastFpsPrint++;
 
+	shovelerProfilerBeginFrame(game->profiler);
+
+	shovelerProfilerBeginScope(game->profiler, "executor");
 	shovelerExecutorUpdate(game->updateExecutor, elapsedNs(dt));
+	shovelerProfilerEndScope(game->profiler);
+
 	shovelerControllerUpdate(game->controller, dt);
+
+	shovelerProfilerBeginScope(game->profiler, "update");
 	game->update(game, dt);
+	shovelerProfilerEndScope(game->profiler);
+
+	shovelerProfilerBeginScope(game->profiler, "texture uploads");
+	shovelerTextureUploaderUpdate(game->textureUploader);
+	shovelerProfilerEndScope(game->profiler);
 
+	shovelerProfilerBeginScope(game->profiler, "scene");
 	int rendered = shovelerSceneRenderFrame(game->scene, game->camera, game->framebuffer, &game->renderState);
-	shovelerFramebufferBlitToDefault(game->framebuffer);
+	shovelerProfilerEndScope(game->profiler);
 
-	glfwSwapBuffers(game->window);
+	if(game->headless) {
+		// there is nothing to present, but wait for the frame to finish so that frame times include its GPU work
+		shovelerProfilerBeginScope(game->profiler, "finish");
+		glFinish();
+		shovelerProfilerEndScope(game->profiler);
+	} else {
+		shovelerProfilerBeginScope(game->profiler, "blit");
+		shovelerFramebufferBlitToDefault(game->framebuffer);
+		shovelerProfilerEndScope(game->profiler);
+	}
+
+	shovelerProfilerEndFrame(game->profiler);
+
+	if(!game->headless) {
+		glfwSwapBuffers(game->window);
+	}
 	glfwPollEvents();
 
 	return rendered;
@@ -189,13 +288,23 @@ int shovelerGameRenderFrame(ShovelerGame *game)
 
 void shovelerGameFree(ShovelerGame *game)
 {
-	ShovelerGlobalContext *global = shovelerGlobalGetContext();
-	g_hash_table_remove(global->games, game->window);
+	if(game->window != NULL) {
+		ShovelerGlobalContext *global = shovelerGlobalGetContext();
+		g_hash_table_remove(global->games, game->window);
+	}
 
 	shovelerCameraPerspectiveDetachController(game->camera);
 
 	shovelerFramebufferFree(game->framebuffer, /* keepTargets */ false);
 
+	for(guint i = 0; i < game->profilerOverlay.lineSprites->len; i++) {
+		ShovelerSprite *lineSprite = g_array_index(game->profilerOverlay.lineSprites, ShovelerSprite *, i);
+		shovelerCanvasRemoveSprite(game->screenspaceCanvas, /* layerId */ 0, lineSprite);
+		shovelerSpriteFree(lineSprite);
+	}
+	g_array_free(game->profilerOverlay.lineSprites, /* freeSegment */ true);
+	shovelerMaterialFree(game->profilerOverlay.material);
+
 	shovelerSceneRemoveModel(game->scene, game->screenspaceCanvasModel);
 	shovelerMaterialFree(game->screenspaceCanvasMaterial);
 	shovelerDrawableFree(game->screenspaceCanvasQuad);
@@ -208,13 +317,84 @@ void shovelerGameFree(ShovelerGame *game)
 	shovelerSceneFree(game->scene);
 	shovelerCameraFree(game->camera);
 	shovelerShaderCacheFree(game->shaderCache);
+	shovelerTextureUploaderFree(game->textureUploader);
+	shovelerProfilerFree(game->profiler);
 
+	freeSurfacelessContext(game);
 	glfwDestroyWindow(game->window);
 
 	shovelerExecutorFree(game->updateExecutor);
 	free(game);
 }
 
+/**
+ * Creates a surfaceless EGL context to render with, which unlike a glfw window doesn't need a window system. The game is
+ * left without a window, so it doesn't receive any input.
+ */
+static bool createSurfacelessContext(ShovelerGame *game)
+{
+#ifdef SHOVELER_HAVE_EGL
+	shovelerLogInfo("Failed to create glfw window with an OpenGL context, falling back to a surfaceless EGL context.");
+
+	PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if(eglGetPlatformDisplayEXT == NULL) {
+		shovelerLogError("Failed to create surfaceless context: EGL_EXT_platform_base is not supported.");
+		return false;
+	}
+
+	EGLDisplay display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	EGLint major;
+	EGLint minor;
+	if(display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+		shovelerLogError("Failed to create surfaceless context: failed to initialize surfaceless EGL display.");
+		return false;
+	}
+
+	if(!eglBindAPI(EGL_OPENGL_API)) {
+		shovelerLogError("Failed to create surfaceless context: EGL %d.%d does not support OpenGL.", major, minor);
+		eglTerminate(display);
+		return false;
+	}
+
+	EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 5,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE};
+	EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+	if(context == EGL_NO_CONTEXT) {
+		shovelerLogError("Failed to create surfaceless context: failed to create OpenGL 4.5 EGL context (error 0x%04x).", eglGetError());
+		eglTerminate(display);
+		return false;
+	}
+
+	game->window = NULL;
+	game->surfacelessDisplay = display;
+	game->surfacelessContext = context;
+
+	shovelerLogInfo("Created surfaceless EGL %d.%d context.", major, minor);
+	return true;
+#else
+	shovelerLogError("Failed to create surfaceless context: shoveler was built without EGL.");
+	return false;
+#endif
+}
+
+static void freeSurfacelessContext(ShovelerGame *game)
+{
+#ifdef SHOVELER_HAVE_EGL
+	if(game->surfacelessContext == NULL) {
+		return;
+	}
+
+	eglMakeCurrent(game->surfacelessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(game->surfacelessDisplay, game->surfacelessContext);
+	eglTerminate(game->surfacelessDisplay);
+	game->surfacelessDisplay = NULL;
+	game->surfacelessContext = NULL;
+#endif
+}
+
 static void updateScreenspaceCanvasRegion(ShovelerGame *game)
 {
 	ShovelerVector2 regionPosition = shovelerVector2(0.5f * game->framebuffer->width, 0.5f * game->framebuffer->height);
@@ -234,6 +414,66 @@ static void keyHandler(ShovelerInput *input, int key, int scancode, int action,
 		shovelerLogInfo("F10 key pressed, toggling scene debug mode.");
 		shovelerSceneToggleDebugMode(input->game->scene);
 	}
+
+	if(key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+		ShovelerGame *game = input->game;
+		game->profiler->enabled = !game->profiler->enabled;
+		shovelerLogInfo("F9 key pressed, %s profiler.", game->profiler->enabled ? "enabling" : "disabling");
+		updateProfilerOverlay(game);
+	}
+
+	if(key == GLFW_KEY_F8 && action == GLFW_PRESS) {
+		ShovelerGame *game = input->game;
+		if(game->profiler->capturing) {
+			shovelerLogInfo("F8 key pressed, writing captured profiler trace.");
+			shovelerProfilerStopCapture(game->profiler, SHOVELER_GAME_PROFILER_TRACE_FILENAME);
+		} else {
+			shovelerLogInfo("F8 key pressed, capturing profiler trace until pressed again.");
+			game->profiler->enabled = true;
+			shovelerProfilerStartCapture(game->profiler);
+		}
+	}
+}
+
+/** Shows one line per scope of the profiler's last frame, or clears the overlay if the profiler is disabled. */
+static void updateProfilerOverlay(ShovelerGame *game)
+{
+	if(game->profilerOverlay.fontAtlasTexture == NULL) {
+		return;
+	}
+
+	GString *text = g_string_new("");
+	if(game->profiler->enabled) {
+		shovelerProfilerFormatLastFrame(game->profiler, text);
+	}
+
+	float lineHeight = 1.25f * SHOVELER_GAME_PROFILER_OVERLAY_FONT_SIZE;
+	guint numLines = 0;
+	for(char *line = text->str; *line != '\0'; numLines++) {
+		char *lineEnd = strchr(line, '\n');
+		*lineEnd = '\0';
+
+		if(numLines >= game->profilerOverlay.lineSprites->len) {
+			ShovelerSprite *lineSprite = shovelerSpriteTextCreate(game->profilerOverlay.material, game->profilerOverlay.fontAtlasTexture, SHOVELER_GAME_PROFILER_OVERLAY_FONT_SIZE, shovelerVector4(1.0f, 1.0f, 1.0f, 1.0f));
+			shovelerSpriteSetEnableCollider(lineSprite, false);
+			shovelerCanvasAddSprite(game->screenspaceCanvas, /* layerId */ 0, lineSprite);
+			g_array_append_val(game->profilerOverlay.lineSprites, lineSprite);
+		}
+
+		ShovelerSprite *lineSprite = g_array_index(game->profilerOverlay.lineSprites, ShovelerSprite *, numLines);
+		shovelerSpriteTextSetContent(lineSprite, line, /* copyContent */ true);
+		shovelerSpriteUpdatePosition(lineSprite, shovelerVector2(10.0f, game->framebuffer->height - 10.0f - (numLines + 1) * lineHeight));
+
+		line = lineEnd + 1;
+	}
+
+	// keep the sprites of lines no longer needed around for later frames with more scopes
+	for(guint i = numLines; i < game->profilerOverlay.lineSprites->len; i++) {
+		ShovelerSprite *lineSprite = g_array_index(game->profilerOverlay.lineSprites, ShovelerSprite *, i);
+		shovelerSpriteTextSetContent(lineSprite, "", /* copyContent */ false);
+	}
+
+	g_string_free(text, true);
 }
 
 static gint64 elapsedNs(double dt)
@@ -253,7 +493,18 @@ static void printFps(void *gamePointer)
 	double secondsSinceLastFpsPrint = now - game->lastFpsPrintTime;
 
 	double fps = game->framesSinceLastFpsPrint / secondsSinceLastFpsPrint;
-	shovelerLogInfo("Current FPS: %.1f", fps);
+	shovelerLogInfo("Current FPS: %.1f (last frame: %d draw items, %d instance batches, %d program switches, %d render state changes, %d rendered and %d cached shadow maps, %d culled and %d unshadowed lights, %d shadow atlas evictions, %zu bytes of textures uploaded and %zu pending)", fps, game->scene->statistics.drawItems, game->scene->statistics.instanceBatches, game->scene->statistics.programSwitches, game->scene->statistics.stateChanges, game->scene->statistics.shadowMapsRendered, game->scene->statistics.shadowMapsCached, game->scene->statistics.lightsCulled, game->scene->statistics.lightsUnshadowed, game->scene->statistics.shadowAtlasEvictions, game->textureUploader->bytesUploaded, game->textureUploader->bytesPending);
+
+	if(game->profiler->enabled) {
+		if(game->profilerOverlay.fontAtlasTexture != NULL) {
+			updateProfilerOverlay(game);
+		} else {
+			GString *text = g_string_new("");
+			shovelerProfilerFormatLastFrame(game->profiler, text);
+			shovelerLogInfo("Profiled last frame:\n%s", text->str);
+			g_string_free(text, true);
+		}
+	}
 
 	game->lastFpsPrintTime = now;
 	game->framesSinceLastFpsPrint = 0;
@@ -18,6 +18,7 @@ bool shovelerGlobalInit()
 
 		if(!glfwInit()) {
 			shovelerLogError("Failed to initialize glfw.");
+			g_hash_table_destroy(globalContext.games);
 			return false;
 		}
 	}
@@ -28,12 +28,15 @@ ShovelerInput *shovelerInputCreate(ShovelerGame *game)
 	input->scrollCallbacks = g_hash_table_new_full(g_direct_hash, g_direct_equal, freeScrollCallback, NULL);
 	input->windowSizeCallbacks = g_hash_table_new_full(g_direct_hash, g_direct_equal, freeWindowSizeCallback, NULL);
 
-	glfwSetKeyCallback(game->window, keyHandler);
-	glfwSetMouseButtonCallback(game->window, mouseButtonHandler);
-	glfwSetCursorPosCallback(game->window, cursorPosHandler);
-	glfwSetScrollCallback(game->window, scrollHandler);
-	glfwSetWindowSizeCallback(game->window, windowSizeHandler);
-	glfwSetWindowFocusCallback(game->window, windowFocusHandler);
+	// a headless game without a window never receives any input
+	if(game->window != NULL) {
+		glfwSetKeyCallback(game->window, keyHandler);
+		glfwSetMouseButtonCallback(game->window, mouseButtonHandler);
+		glfwSetCursorPosCallback(game->window, cursorPosHandler);
+		glfwSetScrollCallback(game->window, scrollHandler);
+		glfwSetWindowSizeCallback(game->window, windowSizeHandler);
+		glfwSetWindowFocusCallback(game->window, windowFocusHandler);
+	}
 
 	return input;
 }
@@ -115,14 +118,16 @@ bool shovelerInputRemoveWindowSizeCallback(ShovelerInput *input, ShovelerInputWi
 
 void shovelerInputFree(ShovelerInput *input)
 {
-	glfwSetInputMode(input->game->window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-
-	glfwSetKeyCallback(input->game->window, NULL);
-	glfwSetMouseButtonCallback(input->game->window, NULL);
-	glfwSetCursorPosCallback(input->game->window, NULL);
-	glfwSetScrollCallback(input->game->window, NULL);
-	glfwSetWindowSizeCallback(input->game->window, NULL);
-	glfwSetWindowFocusCallback(input->game->window, NULL);
+	if(input->game->window != NULL) {
+		glfwSetInputMode(input->game->window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+		glfwSetKeyCallback(input->game->window, NULL);
+		glfwSetMouseButtonCallback(input->game->window, NULL);
+		glfwSetCursorPosCallback(input->game->window, NULL);
+		glfwSetScrollCallback(input->game->window, NULL);
+		glfwSetWindowSizeCallback(input->game->window, NULL);
+		glfwSetWindowFocusCallback(input->game->window, NULL);
+	}
 
 	g_hash_table_destroy(input->keyCallbacks);
 	g_hash_table_destroy(input->mouseButtonCallbacks);
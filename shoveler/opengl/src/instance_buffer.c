@@ -0,0 +1,93 @@
+#include <stddef.h> // offsetof
+#include <stdlib.h> // malloc, free
+
+#include "shoveler/instance_buffer.h"
+#include "shoveler/model.h"
+#include "shoveler/opengl.h"
+#include "shoveler/shader_program.h"
+
+#define INSTANCE_BUFFER_BINDING 1
+
+ShovelerInstanceBuffer *shovelerInstanceBufferCreate()
+{
+	ShovelerInstanceBuffer *instanceBuffer = malloc(sizeof(ShovelerInstanceBuffer));
+	instanceBuffer->bufferSize = 0;
+	instanceBuffer->instances = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerInstanceBufferInstance));
+
+	glGenBuffers(1, &instanceBuffer->buffer);
+
+	return instanceBuffer;
+}
+
+void shovelerInstanceBufferClear(ShovelerInstanceBuffer *instanceBuffer)
+{
+	g_array_set_size(instanceBuffer->instances, 0);
+}
+
+void shovelerInstanceBufferAddModel(ShovelerInstanceBuffer *instanceBuffer, ShovelerModel *model, ShovelerVector4 color)
+{
+	ShovelerInstanceBufferInstance instance;
+	instance.transformation = shovelerMatrixTranspose(model->transformation);
+	instance.normalTransformation = shovelerMatrixTranspose(model->normalTransformation);
+	instance.color = color;
+	g_array_append_val(instanceBuffer->instances, instance);
+}
+
+bool shovelerInstanceBufferUpload(ShovelerInstanceBuffer *instanceBuffer)
+{
+	size_t size = instanceBuffer->instances->len * sizeof(ShovelerInstanceBufferInstance);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer->buffer);
+	if(size > instanceBuffer->bufferSize) {
+		instanceBuffer->bufferSize = 2 * size;
+	}
+
+	// respecify the storage every time to orphan contents that previous draws might still be reading from
+	glBufferData(GL_ARRAY_BUFFER, instanceBuffer->bufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instanceBuffer->instances->data);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+void shovelerInstanceBufferBindAttributes(ShovelerInstanceBuffer *instanceBuffer)
+{
+	// a mat4 attribute occupies four consecutive locations, one per column
+	for(GLuint column = 0; column < 4; column++) {
+		GLuint modelLocation = SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL + column;
+		glEnableVertexAttribArray(modelLocation);
+		glVertexAttribFormat(modelLocation, 4, GL_FLOAT, GL_FALSE, offsetof(ShovelerInstanceBufferInstance, transformation) + column * 4 * sizeof(float));
+		glVertexAttribBinding(modelLocation, INSTANCE_BUFFER_BINDING);
+
+		GLuint modelNormalLocation = SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL_NORMAL + column;
+		glEnableVertexAttribArray(modelNormalLocation);
+		glVertexAttribFormat(modelNormalLocation, 4, GL_FLOAT, GL_FALSE, offsetof(ShovelerInstanceBufferInstance, normalTransformation) + column * 4 * sizeof(float));
+		glVertexAttribBinding(modelNormalLocation, INSTANCE_BUFFER_BINDING);
+	}
+
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR);
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE, offsetof(ShovelerInstanceBufferInstance, color));
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR, INSTANCE_BUFFER_BINDING);
+
+	glVertexBindingDivisor(INSTANCE_BUFFER_BINDING, 1);
+	glBindVertexBuffer(INSTANCE_BUFFER_BINDING, instanceBuffer->buffer, 0, sizeof(ShovelerInstanceBufferInstance));
+}
+
+void shovelerInstanceBufferUnbindAttributes(ShovelerInstanceBuffer *instanceBuffer)
+{
+	for(GLuint column = 0; column < 4; column++) {
+		glDisableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL + column);
+		glDisableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL_NORMAL + column);
+	}
+	glDisableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR);
+}
+
+void shovelerInstanceBufferFree(ShovelerInstanceBuffer *instanceBuffer)
+{
+	if(instanceBuffer == NULL) {
+		return;
+	}
+
+	glDeleteBuffers(1, &instanceBuffer->buffer);
+	g_array_free(instanceBuffer->instances, /* freeSegment */ true);
+	free(instanceBuffer);
+}
@@ -1,36 +1,100 @@
+#include <stdint.h> // uint64_t
 #include <stdlib.h> // malloc, free
 
 #include "shoveler/camera/perspective.h"
+#include "shoveler/filter/depth_texture_gaussian.h"
 #include "shoveler/light/point.h"
 #include "shoveler/light/spot.h"
 #include "shoveler/constants.h"
 #include "shoveler/light.h"
+#include "shoveler/profiler.h"
 #include "shoveler/projection.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/types.h"
+#include "shoveler/uniform_buffer.h"
 
 typedef struct {
 	ShovelerLight light;
 	ShovelerLightSpotShared *shared;
-	ShovelerLight *spotlights[6];
+	ShovelerCamera *cameras[SHOVELER_LIGHT_POINT_FACES];
+	ShovelerLight *spotlights[SHOVELER_LIGHT_POINT_FACES];
+	/** views of the layers of the shared filter's output in layered mode, lighting the faces' additive passes */
+	ShovelerTexture *shadowMapLayers[SHOVELER_LIGHT_POINT_FACES];
+	ShovelerUniformBuffer *facesUniformBuffer;
+	bool shadowMapCached;
+	ShovelerScene *cachedScene;
+	ShovelerVector3 cachedPosition;
+	uint64_t cachedShadowCasterHash;
 } ShovelerLightPoint;
 
+static ShovelerLightPoint *createPointLight(ShovelerShaderCache *shaderCache, ShovelerVector3 position, ShovelerLightSpotShared *shared);
+static int renderLayeredShadowMap(ShovelerLightPoint *pointlight, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState);
+static bool updateShadowMapCache(ShovelerLightPoint *pointlight, ShovelerScene *scene);
+static void fillFacesUniformBlock(void *data, void *pointlightPointer);
 static void updatePosition(void *pointlightPointer, ShovelerVector3 position);
 static ShovelerVector3 getPosition(void *pointlightPointer);
+static float getRange(void *pointlightPointer);
+static int renderPointLightShadowMap(void *pointlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState);
 static int renderPointLight(void *pointlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState);
 static void freePointLight(void *pointlightPointer);
 
 ShovelerLight *shovelerLightPointCreate(ShovelerShaderCache *shaderCache, ShovelerVector3 position, int width, int height, GLsizei samples, float ambientFactor, float exponentialFactor, ShovelerVector3 color)
+{
+	ShovelerLightSpotShared *shared = shovelerLightSpotSharedCreate(shaderCache, width, height, samples, ambientFactor, exponentialFactor, color);
+	ShovelerLightPoint *pointlight = createPointLight(shaderCache, position, shared);
+
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		pointlight->shadowMapLayers[i] = NULL;
+		pointlight->spotlights[i] = shovelerLightSpotCreateWithShared(pointlight->cameras[i], pointlight->shared, false);
+	}
+
+	return &pointlight->light;
+}
+
+ShovelerLight *shovelerLightPointCreateLayered(ShovelerShaderCache *shaderCache, ShovelerVector3 position, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color)
+{
+	ShovelerLightSpotShared *shared = shovelerLightSpotSharedCreateLayered(shaderCache, width, height, ambientFactor, exponentialFactor, color);
+	ShovelerLightPoint *pointlight = createPointLight(shaderCache, position, shared);
+
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		pointlight->shadowMapLayers[i] = shovelerTextureCreateLayerView(shared->depthFilter->outputTexture, i);
+		pointlight->spotlights[i] = shovelerLightSpotCreateWithShadowMap(pointlight->cameras[i], pointlight->shared, pointlight->shadowMapLayers[i]);
+	}
+
+	pointlight->facesUniformBuffer = shovelerUniformBufferCreate(SHOVELER_UNIFORM_BUFFER_BINDING_LIGHT_FACES, sizeof(ShovelerLightPointFacesUniformBlock), fillFacesUniformBlock, pointlight);
+	shovelerUniformMapInsert(pointlight->light.uniforms, "LightFaces", shovelerUniformCreateBuffer(pointlight->facesUniformBuffer));
+
+	return &pointlight->light;
+}
+
+ShovelerLightSpotShared *shovelerLightPointGetShared(ShovelerLight *light)
+{
+	ShovelerLightPoint *pointlight = light->data;
+	return pointlight->shared;
+}
+
+static ShovelerLightPoint *createPointLight(ShovelerShaderCache *shaderCache, ShovelerVector3 position, ShovelerLightSpotShared *shared)
 {
 	ShovelerLightPoint *pointlight = malloc(sizeof(ShovelerLightPoint));
+	pointlight->light.shaderCache = shaderCache;
 	pointlight->light.data = pointlight;
 	pointlight->light.updatePosition = updatePosition;
 	pointlight->light.getPosition = getPosition;
+	pointlight->light.getRange = getRange;
+	pointlight->light.renderShadowMap = renderPointLightShadowMap;
 	pointlight->light.render = renderPointLight;
 	pointlight->light.freeData = freePointLight;
 	pointlight->light.uniforms = shovelerUniformMapCreate();
-	pointlight->shared = shovelerLightSpotSharedCreate(shaderCache, width, height, samples, ambientFactor, exponentialFactor, color);
+	pointlight->light.dynamic = false;
+	pointlight->light.shadowMapLevel = 0;
+	pointlight->light.shadowed = true;
+	pointlight->shared = shared;
+	pointlight->facesUniformBuffer = NULL;
+	pointlight->shadowMapCached = false;
+	pointlight->cachedScene = NULL;
+	pointlight->cachedPosition = position;
+	pointlight->cachedShadowCasterHash = 0;
 
 	ShovelerProjectionPerspective projection;
 	projection.fieldOfViewY = SHOVELER_PI / 2.0f;
@@ -45,27 +109,15 @@ ShovelerLight *shovelerLightPointCreate(ShovelerShaderCache *shaderCache, Shovel
 	ShovelerReferenceFrame upFrame = shovelerReferenceFrame(position, shovelerVector3(0.0f, 1.0f, 0.0f), shovelerVector3(0.0f, 0.0f, -1.0f));
 	ShovelerReferenceFrame downFrame = shovelerReferenceFrame(position, shovelerVector3(0.0f, -1.0f, 0.0f), shovelerVector3(0.0f, 0.0f, 1.0f));
 	
-	ShovelerCamera *forwardCamera = shovelerCameraPerspectiveCreate(shaderCache, &forwardFrame, &projection);
-	ShovelerCamera *backwardCamera = shovelerCameraPerspectiveCreate(shaderCache, &backwardFrame, &projection);
-	ShovelerCamera *leftCamera = shovelerCameraPerspectiveCreate(shaderCache, &leftFrame, &projection);
-	ShovelerCamera *rightCamera = shovelerCameraPerspectiveCreate(shaderCache, &rightFrame, &projection);
-	ShovelerCamera *upCamera = shovelerCameraPerspectiveCreate(shaderCache, &upFrame, &projection);
-	ShovelerCamera *downCamera = shovelerCameraPerspectiveCreate(shaderCache, &downFrame, &projection);
-
-	pointlight->spotlights[0] = shovelerLightSpotCreateWithShared(forwardCamera, pointlight->shared, false);
-	pointlight->spotlights[1] = shovelerLightSpotCreateWithShared(backwardCamera, pointlight->shared, false);
-	pointlight->spotlights[2] = shovelerLightSpotCreateWithShared(leftCamera, pointlight->shared, false);
-	pointlight->spotlights[3] = shovelerLightSpotCreateWithShared(rightCamera, pointlight->shared, false);
-	pointlight->spotlights[4] = shovelerLightSpotCreateWithShared(upCamera, pointlight->shared, false);
-	pointlight->spotlights[5] = shovelerLightSpotCreateWithShared(downCamera, pointlight->shared, false);
+	// the spot lights created for the faces take ownership of these cameras
+	pointlight->cameras[0] = shovelerCameraPerspectiveCreate(shaderCache, &forwardFrame, &projection);
+	pointlight->cameras[1] = shovelerCameraPerspectiveCreate(shaderCache, &backwardFrame, &projection);
+	pointlight->cameras[2] = shovelerCameraPerspectiveCreate(shaderCache, &leftFrame, &projection);
+	pointlight->cameras[3] = shovelerCameraPerspectiveCreate(shaderCache, &rightFrame, &projection);
+	pointlight->cameras[4] = shovelerCameraPerspectiveCreate(shaderCache, &upFrame, &projection);
+	pointlight->cameras[5] = shovelerCameraPerspectiveCreate(shaderCache, &downFrame, &projection);
 
-	return &pointlight->light;
-}
-
-ShovelerLightSpotShared *shovelerLightPointGetShared(ShovelerLight *light)
-{
-	ShovelerLightPoint *pointlight = light->data;
-	return pointlight->shared;
+	return pointlight;
 }
 
 static void updatePosition(void *pointlightPointer, ShovelerVector3 position)
@@ -83,19 +135,133 @@ static ShovelerVector3 getPosition(void *pointlightPointer)
 	return shovelerLightGetPosition(pointlight->spotlights[0]);
 }
 
-static int renderPointLight(void *pointlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState)
+static float getRange(void *pointlightPointer)
+{
+	ShovelerLightPoint *pointlight = pointlightPointer;
+	return shovelerLightGetRange(pointlight->spotlights[0]);
+}
+
+static int renderPointLightShadowMap(void *pointlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState)
 {
 	ShovelerLightPoint *pointlight = (ShovelerLightPoint *) pointlightPointer;
 
+	// faces start out shadowed, but may lose their shadows if they find no free shadow atlas tile
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		pointlight->spotlights[i]->shadowed = pointlight->light.shadowed;
+	}
+
+	if(pointlight->shared->layered) {
+		return renderLayeredShadowMap(pointlight, scene, camera, renderState);
+	}
+
 	int rendered = 0;
+	for(int i = 0; i < 6; i++) {
+		pointlight->spotlights[i]->dynamic = pointlight->light.dynamic;
+		pointlight->spotlights[i]->shadowMapLevel = pointlight->light.shadowMapLevel;
+		shovelerProfilerBeginScope(scene->profiler, "face %d", i);
+		rendered += shovelerLightRenderShadowMap(pointlight->spotlights[i], scene, camera, renderState);
+		shovelerProfilerEndScope(scene->profiler);
+	}
+
+	return rendered;
+}
+
+static int renderPointLight(void *pointlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState)
+{
+	ShovelerLightPoint *pointlight = (ShovelerLightPoint *) pointlightPointer;
 
+	int rendered = 0;
 	for(int i = 0; i < 6; i++) {
+		pointlight->spotlights[i]->shadowed = pointlight->light.shadowed && pointlight->spotlights[i]->shadowed;
+		shovelerProfilerBeginScope(scene->profiler, "face %d", i);
 		rendered += shovelerLightRender(pointlight->spotlights[i], scene, camera, framebuffer, renderPassOptions, renderState);
+		shovelerProfilerEndScope(scene->profiler);
+	}
+
+	return rendered;
+}
+
+static int renderLayeredShadowMap(ShovelerLightPoint *pointlight, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState)
+{
+	bool anyFaceVisible = false;
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		if(shovelerFrustumIntersectFrustum(&camera->frustum, &pointlight->cameras[i]->frustum)) {
+			anyFaceVisible = true;
+			break;
+		}
+	}
+
+	if(!anyFaceVisible) {
+		return 0;
 	}
 
+	if(updateShadowMapCache(pointlight, scene)) {
+		scene->statistics.shadowMapsCached++;
+		return 0;
+	}
+
+	int rendered = 0;
+
+	// render all faces' depth maps at once, the depth material fans primitives out to the layers
+	shovelerProfilerBeginScope(scene->profiler, "layered shadow map");
+	shovelerFramebufferUse(pointlight->shared->depthFramebuffer);
+	shovelerRenderStateSetDepthMask(renderState, GL_TRUE);
+	glClear(GL_DEPTH_BUFFER_BIT);
+
+	rendered += shovelerSceneRenderPass(scene, pointlight->cameras[0], &pointlight->light, pointlight->shared->depthRenderPassOptions, renderState);
+	shovelerProfilerEndScope(scene->profiler);
+
+	// filter all layers at once into the array the faces' shadow map views point to
+	shovelerProfilerBeginScope(scene->profiler, "layered shadow filter");
+	rendered += shovelerFilterRender(pointlight->shared->depthFilter, pointlight->shared->depthFramebuffer->depthTarget, renderState);
+	shovelerProfilerEndScope(scene->profiler);
+
+	scene->statistics.shadowMapsRendered++;
+
 	return rendered;
 }
 
+/** Returns true if the layered shadow map rendered previously can be reused, and otherwise records the state it is rendered in. */
+static bool updateShadowMapCache(ShovelerLightPoint *pointlight, ShovelerScene *scene)
+{
+	if(pointlight->light.dynamic) {
+		pointlight->shadowMapCached = false;
+		return false;
+	}
+
+	uint64_t shadowCasterHash = 0;
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		shadowCasterHash = 31 * shadowCasterHash + shovelerSceneComputeShadowCasterHash(scene, &pointlight->cameras[i]->frustum);
+	}
+
+	ShovelerVector3 position = pointlight->cameras[0]->position;
+
+	if(pointlight->shadowMapCached
+		&& pointlight->cachedScene == scene
+		&& pointlight->cachedShadowCasterHash == shadowCasterHash
+		&& pointlight->cachedPosition.values[0] == position.values[0]
+		&& pointlight->cachedPosition.values[1] == position.values[1]
+		&& pointlight->cachedPosition.values[2] == position.values[2]) {
+		return true;
+	}
+
+	pointlight->shadowMapCached = true;
+	pointlight->cachedScene = scene;
+	pointlight->cachedPosition = position;
+	pointlight->cachedShadowCasterHash = shadowCasterHash;
+	return false;
+}
+
+static void fillFacesUniformBlock(void *data, void *pointlightPointer)
+{
+	ShovelerLightPoint *pointlight = (ShovelerLightPoint *) pointlightPointer;
+	ShovelerLightPointFacesUniformBlock *block = data;
+
+	for(int i = 0; i < SHOVELER_LIGHT_POINT_FACES; i++) {
+		block->viewProjections[i] = shovelerMatrixMultiply(pointlight->cameras[i]->projection, pointlight->cameras[i]->view);
+	}
+}
+
 static void freePointLight(void *pointlightPointer)
 {
 	ShovelerLightPoint *pointlight = (ShovelerLightPoint *) pointlightPointer;
@@ -104,12 +270,16 @@ static void freePointLight(void *pointlightPointer)
 		return;
 	}
 
+	shovelerShaderCacheInvalidateLight(pointlight->light.shaderCache, &pointlight->light);
+
 	for(int i = 0; i < 6; i++) {
 		shovelerLightFree(pointlight->spotlights[i]);
+		shovelerTextureFree(pointlight->shadowMapLayers[i]);
 	}
 
 	shovelerLightSpotSharedFree(pointlight->shared);
 	shovelerUniformMapFree(pointlight->light.uniforms);
+	shovelerUniformBufferFree(pointlight->facesUniformBuffer);
 
 	free(pointlight);
 }
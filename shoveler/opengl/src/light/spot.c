@@ -1,36 +1,137 @@
+#include <assert.h> // assert
+#include <math.h> // fmaxf, sqrtf
 #include <stdlib.h> // malloc, free
+#include <string.h> // memcmp
 #include <shoveler/light/spot.h>
 
 #include "shoveler/camera/identity.h"
 #include "shoveler/filter/depth_texture_gaussian.h"
+#include "shoveler/light/point.h"
 #include "shoveler/light/spot.h"
 #include "shoveler/material/depth.h"
+#include "shoveler/profiler.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader_cache.h"
+#include "shoveler/shadow_atlas.h"
 
 typedef struct {
 	ShovelerLight light;
 	ShovelerCamera *camera;
 	ShovelerLightSpotShared *shared;
 	bool manageShared;
+	ShovelerUniformBuffer *uniformBuffer;
+	/** whether this light renders its own shadow map rather than being passed one on creation */
+	bool ownsShadowMap;
+	/** filtered shadow map of this light if the scene has no shadow atlas, created on first use */
+	ShovelerFramebuffer *shadowMapFramebuffer;
+	/** shadow atlas this light last held a tile of, which has to outlive the light */
+	ShovelerShadowAtlas *shadowAtlas;
+	int shadowAtlasTile;
+	/** texture the light is lit with, which is either its own shadow map or the shadow atlas */
+	ShovelerTexture *shadowMap;
+	/** region of the shadow map texture the light's shadow map is in */
+	ShovelerVector4 shadowMapRegion;
+	bool shadowMapCached;
+	ShovelerScene *cachedScene;
+	ShovelerMatrix cachedView;
+	ShovelerMatrix cachedProjection;
+	uint64_t cachedShadowCasterHash;
+	int cachedShadowMapLevel;
 } ShovelerLightSpot;
 
 static void updatePosition(void *spotlightPointer, ShovelerVector3 position);
 static ShovelerVector3 getPosition(void *spotlightPointer);
+static float getRange(void *spotlightPointer);
+static int renderSpotLightShadowMap(void *spotlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState);
 static int renderSpotLight(void *spotlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState);
 static void freeSpotLight(void *spotlightPointer);
+static ShovelerLightSpotShared *createShared(ShovelerShaderCache *shaderCache, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color);
+static ShovelerLightSpot *createSpotLight(ShovelerCamera *camera, ShovelerLightSpotShared *shared, bool managedShared);
+static ShovelerFilter *getShadowMapLevelFilter(ShovelerLightSpotShared *shared, int level);
+static bool updateShadowMapTarget(ShovelerLightSpot *spotlight, ShovelerScene *scene);
+static bool updateShadowMapCache(ShovelerLightSpot *spotlight, ShovelerScene *scene);
+static void fillUniformBlock(void *data, void *spotlightPointer);
 
 ShovelerLightSpotShared *shovelerLightSpotSharedCreate(ShovelerShaderCache *shaderCache, int width, int height, GLsizei samples, float ambientFactor, float exponentialFactor, ShovelerVector3 color) {
+	ShovelerLightSpotShared *shared = createShared(shaderCache, width, height, ambientFactor, exponentialFactor, color);
+	shared->depthFramebuffer = NULL;
+	shared->samples = samples;
+	shared->layered = false;
+	shared->depthMaterial = shovelerMaterialDepthCreate(shaderCache, /* screenspace */ false);
+	shared->depthFilter = NULL;
+	shared->depthRenderPassOptions.overrideMaterial = shared->depthMaterial;
+	return shared;
+}
+
+ShovelerLightSpotShared *shovelerLightSpotSharedCreateLayered(ShovelerShaderCache *shaderCache, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color)
+{
+	ShovelerLightSpotShared *shared = createShared(shaderCache, width, height, ambientFactor, exponentialFactor, color);
+	shared->depthFramebuffer = shovelerFramebufferCreateDepthOnlyLayered(width, height, SHOVELER_LIGHT_POINT_FACES);
+	shared->samples = 1;
+	shared->layered = true;
+	shared->depthMaterial = shovelerMaterialDepthCreateLayered(shaderCache);
+	shared->depthFilter = shovelerFilterDepthTextureGaussianCreateLayered(shaderCache, width, height, SHOVELER_LIGHT_POINT_FACES, exponentialFactor);
+	shared->depthRenderPassOptions.overrideMaterial = shared->depthMaterial;
+	return shared;
+}
+
+ShovelerLight *shovelerLightSpotCreateWithShared(ShovelerCamera *camera, ShovelerLightSpotShared *shared, bool managedShared)
+{
+	assert(!shared->layered);
+
+	ShovelerLightSpot *spotlight = createSpotLight(camera, shared, managedShared);
+	spotlight->ownsShadowMap = true;
+	spotlight->shadowMap = NULL;
+
+	return &spotlight->light;
+}
+
+ShovelerLight *shovelerLightSpotCreateWithShadowMap(ShovelerCamera *camera, ShovelerLightSpotShared *shared, ShovelerTexture *shadowMap)
+{
+	ShovelerLightSpot *spotlight = createSpotLight(camera, shared, /* managedShared */ false);
+	spotlight->ownsShadowMap = false;
+	spotlight->shadowMap = shadowMap;
+
+	return &spotlight->light;
+}
+
+void shovelerLightSpotSharedFree(ShovelerLightSpotShared *shared)
+{
+	if(shared == NULL) {
+		return;
+	}
+
+	for(int level = 1; level < SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS; level++) {
+		if(shared->levelDepthFilters[level] != NULL) {
+			shovelerFilterFree(shared->levelDepthFilters[level]);
+		}
+	}
+
+	if(shared->depthFilter != NULL) {
+		shovelerFilterFree(shared->depthFilter);
+	}
+
+	shovelerMaterialFree(shared->depthMaterial);
+	shovelerFramebufferFree(shared->depthFramebuffer, /* keepTargets */ false);
+	shovelerSamplerFree(shared->shadowMapSampler);
+
+	free(shared);
+}
+
+static ShovelerLightSpotShared *createShared(ShovelerShaderCache *shaderCache, int width, int height, float ambientFactor, float exponentialFactor, ShovelerVector3 color)
+{
 	ShovelerLightSpotShared *shared = malloc(sizeof(ShovelerLightSpotShared));
 	shared->shaderCache = shaderCache;
 	shared->shadowMapSampler = shovelerSamplerCreate(true, true, true);
-	shared->depthFramebuffer = shovelerFramebufferCreateDepthOnly(width, height, samples);
-	shared->depthMaterial = shovelerMaterialDepthCreate(shaderCache, /* screenspace */ false);
-	shared->depthFilter = shovelerFilterDepthTextureGaussianCreate(shaderCache, width, height, samples, exponentialFactor);
-	shared->depthRenderPassOptions.overrideMaterial = shared->depthMaterial;
+	shared->width = width;
+	shared->height = height;
+	for(int level = 0; level < SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS; level++) {
+		shared->levelDepthFilters[level] = NULL;
+	}
 	shared->depthRenderPassOptions.emitters = false;
 	shared->depthRenderPassOptions.screenspace = false;
 	shared->depthRenderPassOptions.onlyShadowCasters = true;
+	shared->depthRenderPassOptions.skipOccluded = false;
 	shared->depthRenderPassOptions.renderState.blend = false;
 	shared->depthRenderPassOptions.renderState.blendSourceFactor = GL_ONE;
 	shared->depthRenderPassOptions.renderState.blendDestinationFactor = GL_ONE;
@@ -43,44 +144,41 @@ ShovelerLightSpotShared *shovelerLightSpotSharedCreate(ShovelerShaderCache *shad
 	return shared;
 }
 
-ShovelerLight *shovelerLightSpotCreateWithShared(ShovelerCamera *camera, ShovelerLightSpotShared *shared, bool managedShared)
+static ShovelerLightSpot *createSpotLight(ShovelerCamera *camera, ShovelerLightSpotShared *shared, bool managedShared)
 {
 	ShovelerLightSpot *spotlight = malloc(sizeof(ShovelerLightSpot));
 	spotlight->light.shaderCache = shared->shaderCache;
 	spotlight->light.data = spotlight;
 	spotlight->light.updatePosition = updatePosition;
 	spotlight->light.getPosition = getPosition;
+	spotlight->light.getRange = getRange;
+	spotlight->light.renderShadowMap = renderSpotLightShadowMap;
 	spotlight->light.render = renderSpotLight;
 	spotlight->light.freeData = freeSpotLight;
 	spotlight->light.uniforms = shovelerUniformMapCreate();
+	spotlight->light.dynamic = false;
+	spotlight->light.shadowMapLevel = 0;
+	spotlight->light.shadowed = true;
 	spotlight->camera = camera;
 	spotlight->shared = shared;
 	spotlight->manageShared = managedShared;
+	spotlight->uniformBuffer = shovelerUniformBufferCreate(SHOVELER_UNIFORM_BUFFER_BINDING_LIGHT, sizeof(ShovelerLightUniformBlock), fillUniformBlock, spotlight);
+	spotlight->shadowMapFramebuffer = NULL;
+	spotlight->shadowAtlas = NULL;
+	spotlight->shadowAtlasTile = -1;
+	spotlight->shadowMap = NULL;
+	spotlight->shadowMapRegion = shovelerVector4(0.0f, 0.0f, 1.0f, 1.0f);
+	spotlight->shadowMapCached = false;
+	spotlight->cachedScene = NULL;
+	spotlight->cachedView = shovelerMatrixIdentity;
+	spotlight->cachedProjection = shovelerMatrixIdentity;
+	spotlight->cachedShadowCasterHash = 0;
+	spotlight->cachedShadowMapLevel = 0;
 
-	shovelerUniformMapInsert(spotlight->light.uniforms, "isExponentialLiftedShadowMap", shovelerUniformCreateInt(1));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightAmbientFactor", shovelerUniformCreateFloat(spotlight->shared->ambientFactor));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightExponentialShadowFactor", shovelerUniformCreateFloat(spotlight->shared->exponentialFactor));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightColor", shovelerUniformCreateVector3Pointer(&spotlight->shared->color));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightPosition", shovelerUniformCreateVector3Pointer(&spotlight->camera->position));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightView", shovelerUniformCreateMatrixPointer(&spotlight->camera->view));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "lightProjection", shovelerUniformCreateMatrixPointer(&spotlight->camera->projection));
-	shovelerUniformMapInsert(spotlight->light.uniforms, "shadowMap", shovelerUniformCreateTexture(spotlight->shared->depthFilter->outputTexture, spotlight->shared->shadowMapSampler));
+	shovelerUniformMapInsert(spotlight->light.uniforms, "Light", shovelerUniformCreateBuffer(spotlight->uniformBuffer));
+	shovelerUniformMapInsert(spotlight->light.uniforms, "shadowMap", shovelerUniformCreateTexturePointer(&spotlight->shadowMap, &spotlight->shared->shadowMapSampler));
 
-	return &spotlight->light;
-}
-
-void shovelerLightSpotSharedFree(ShovelerLightSpotShared *shared)
-{
-	if(shared == NULL) {
-		return;
-	}
-
-	shovelerFilterFree(shared->depthFilter);
-	shovelerMaterialFree(shared->depthMaterial);
-	shovelerFramebufferFree(shared->depthFramebuffer, /* keepTargets */ false);
-	shovelerSamplerFree(shared->shadowMapSampler);
-
-	free(shared);
+	return spotlight;
 }
 
 static void updatePosition(void *spotlightPointer, ShovelerVector3 position)
@@ -96,28 +194,140 @@ static ShovelerVector3 getPosition(void *spotlightPointer)
 	return spotlight->camera->position;
 }
 
-static int renderSpotLight(void *spotlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState)
+static float getRange(void *spotlightPointer)
+{
+	ShovelerLightSpot *spotlight = (ShovelerLightSpot *) spotlightPointer;
+	const ShovelerFrustum *frustum = &spotlight->camera->frustum;
+	ShovelerVector3 farVertices[] = {
+		frustum->farBottomLeftVertex,
+		frustum->farBottomRightVertex,
+		frustum->farTopRightVertex,
+		frustum->farTopLeftVertex,
+	};
+
+	float range = 0.0f;
+	for(int i = 0; i < 4; i++) {
+		ShovelerVector3 positionToVertex = shovelerVector3LinearCombination(1.0f, farVertices[i], -1.0f, spotlight->camera->position);
+		range = fmaxf(range, sqrtf(shovelerVector3Dot(positionToVertex, positionToVertex)));
+	}
+
+	return range;
+}
+
+static int renderSpotLightShadowMap(void *spotlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState)
 {
 	ShovelerLightSpot *spotlight = (ShovelerLightSpot *) spotlightPointer;
 
+	// shadow maps passed in on creation are kept up to date by their owner
+	if(!spotlight->ownsShadowMap) {
+		return 0;
+	}
+
 	if(!shovelerFrustumIntersectFrustum(&camera->frustum, &spotlight->camera->frustum)) {
 		return 0;
 	}
 
+	if(!updateShadowMapTarget(spotlight, scene)) {
+		spotlight->shadowMapCached = false;
+	}
+
+	// all atlas tiles are taken by lights rendered earlier this frame, so this one is lit without shadows instead
+	if(spotlight->shadowAtlas != NULL && spotlight->shadowAtlasTile < 0) {
+		spotlight->light.shadowed = false;
+		scene->statistics.lightsUnshadowed++;
+		return 0;
+	}
+
+	if(updateShadowMapCache(spotlight, scene)) {
+		scene->statistics.shadowMapsCached++;
+		return 0;
+	}
+
+	int level = spotlight->light.shadowMapLevel;
+	if(level >= SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS) {
+		level = SHOVELER_LIGHT_SPOT_SHADOW_MAP_LEVELS - 1;
+	}
+
+	int width = spotlight->shared->width >> level;
+	int height = spotlight->shared->height >> level;
+	width = width > 0 ? width : 1;
+	height = height > 0 ? height : 1;
+
+	// filter depth map into this light's own shadow map or atlas tile so it survives other lights sharing the
+	// filter, which also upsamples reduced resolution levels
+	ShovelerFramebuffer *outputFramebuffer;
+	GLint outputX = 0;
+	GLint outputY = 0;
+	GLsizei outputWidth;
+	GLsizei outputHeight;
+	if(spotlight->shadowMapFramebuffer != NULL) {
+		outputFramebuffer = spotlight->shadowMapFramebuffer;
+		outputWidth = outputFramebuffer->width;
+		outputHeight = outputFramebuffer->height;
+	} else {
+		outputFramebuffer = spotlight->shadowAtlas->framebuffer;
+		shovelerShadowAtlasGetTileViewport(spotlight->shadowAtlas, spotlight->shadowAtlasTile, &outputX, &outputY, &outputWidth, &outputHeight);
+	}
+
 	int rendered = 0;
 
+	// single sampled depth maps are filtered later together with other lights' of the same resolution
+	bool batched = spotlight->shared->samples <= 1;
+
+	ShovelerFramebuffer *depthFramebuffer;
+	if(batched) {
+		depthFramebuffer = shovelerFilterDepthTextureGaussianChainAddInput(shovelerSceneGetShadowFilterChain(scene), width, height, spotlight->shared->exponentialFactor, outputFramebuffer, outputX, outputY, outputWidth, outputHeight);
+	} else {
+		depthFramebuffer = shovelerFramebufferPoolAcquireDepthOnly(scene->framebufferPool, width, height, spotlight->shared->samples);
+	}
+
 	// render depth map
-	shovelerFramebufferUse(spotlight->shared->depthFramebuffer);
+	shovelerProfilerBeginScope(scene->profiler, "shadow map");
+	shovelerFramebufferUse(depthFramebuffer);
+	shovelerRenderStateSetDepthMask(renderState, GL_TRUE);
 	glClear(GL_DEPTH_BUFFER_BIT);
 
 	rendered += shovelerSceneRenderPass(scene, spotlight->camera, NULL, spotlight->shared->depthRenderPassOptions, renderState);
+	shovelerProfilerEndScope(scene->profiler);
+
+	if(!batched) {
+		shovelerProfilerBeginScope(scene->profiler, "shadow filter");
+		ShovelerFilter *depthFilter = getShadowMapLevelFilter(spotlight->shared, level);
+		shovelerFilterDepthTextureGaussianSetOutputRegion(depthFilter, outputFramebuffer, outputX, outputY, outputWidth, outputHeight);
+		shovelerFilterDepthTextureGaussianSetFramebufferPool(depthFilter, scene->framebufferPool);
+		rendered += shovelerFilterRender(depthFilter, depthFramebuffer->depthTarget, renderState);
+		shovelerProfilerEndScope(scene->profiler);
+
+		shovelerFramebufferPoolRelease(scene->framebufferPool, depthFramebuffer);
+	}
+
+	scene->statistics.shadowMapsRendered++;
+
+	return rendered;
+}
+
+static int renderSpotLight(void *spotlightPointer, ShovelerScene *scene, ShovelerCamera *camera, ShovelerFramebuffer *framebuffer, ShovelerSceneRenderPassOptions renderPassOptions, ShovelerRenderState *renderState)
+{
+	ShovelerLightSpot *spotlight = (ShovelerLightSpot *) spotlightPointer;
 
-	// filter depth map
-	rendered += shovelerFilterRender(spotlight->shared->depthFilter, spotlight->shared->depthFramebuffer->depthTarget, renderState);
+	if(!shovelerFrustumIntersectFrustum(&camera->frustum, &spotlight->camera->frustum)) {
+		return 0;
+	}
+
+	// lights without shadows don't sample their shadow map, but still need a texture to bind in its place
+	if(spotlight->shadowMap == NULL) {
+		if(scene->shadowAtlas != NULL) {
+			spotlight->shadowMap = scene->shadowAtlas->framebuffer->renderTarget;
+		} else {
+			updateShadowMapTarget(spotlight, scene);
+		}
+	}
 
 	// render additive light to scene
+	shovelerProfilerBeginScope(scene->profiler, "additive pass");
 	shovelerFramebufferUse(framebuffer);
-	rendered += shovelerSceneRenderPass(scene, camera, &spotlight->light, renderPassOptions, renderState);
+	int rendered = shovelerSceneRenderPass(scene, camera, &spotlight->light, renderPassOptions, renderState);
+	shovelerProfilerEndScope(scene->profiler);
 
 	return rendered;
 }
@@ -131,9 +341,12 @@ static void freeSpotLight(void *spotlightPointer)
 	}
 
 	shovelerShaderCacheInvalidateLight(spotlight->light.shaderCache, &spotlight->light);
+	shovelerShadowAtlasReleaseOwner(spotlight->shadowAtlas, &spotlight->light);
 
 	shovelerCameraFree(spotlight->camera);
 	shovelerUniformMapFree(spotlight->light.uniforms);
+	shovelerUniformBufferFree(spotlight->uniformBuffer);
+	shovelerFramebufferFree(spotlight->shadowMapFramebuffer, /* keepTargets */ false);
 
 	if(spotlight->manageShared) {
 		shovelerLightSpotSharedFree(spotlight->shared);
@@ -141,3 +354,102 @@ static void freeSpotLight(void *spotlightPointer)
 
 	free(spotlight);
 }
+
+/** Retrieves the filter for multisampled shadow maps of the given resolution level, creating it on first use. */
+static ShovelerFilter *getShadowMapLevelFilter(ShovelerLightSpotShared *shared, int level)
+{
+	if(level <= 0) {
+		if(shared->depthFilter == NULL) {
+			shared->depthFilter = shovelerFilterDepthTextureGaussianCreate(shared->shaderCache, shared->width, shared->height, shared->samples, shared->exponentialFactor);
+		}
+
+		return shared->depthFilter;
+	}
+
+	if(shared->levelDepthFilters[level] == NULL) {
+		int width = shared->width >> level;
+		int height = shared->height >> level;
+		shared->levelDepthFilters[level] = shovelerFilterDepthTextureGaussianCreate(shared->shaderCache, width > 0 ? width : 1, height > 0 ? height : 1, shared->samples, shared->exponentialFactor);
+	}
+
+	return shared->levelDepthFilters[level];
+}
+
+/**
+ * Picks where the light's shadow map is rendered to, which is a tile of the scene's shadow atlas if it has one, and
+ * otherwise the light's own framebuffer. Returns true if the previous contents of that target are still there.
+ */
+static bool updateShadowMapTarget(ShovelerLightSpot *spotlight, ShovelerScene *scene)
+{
+	if(scene->shadowAtlas != NULL) {
+		if(spotlight->shadowAtlas != scene->shadowAtlas) {
+			spotlight->shadowAtlas = scene->shadowAtlas;
+			spotlight->shadowAtlasTile = -1;
+		}
+
+		shovelerFramebufferFree(spotlight->shadowMapFramebuffer, /* keepTargets */ false);
+		spotlight->shadowMapFramebuffer = NULL;
+
+		bool tileKept = shovelerShadowAtlasUseTile(spotlight->shadowAtlas, &spotlight->light, &spotlight->shadowAtlasTile);
+		spotlight->shadowMap = spotlight->shadowAtlas->framebuffer->renderTarget;
+		if(spotlight->shadowAtlasTile >= 0) {
+			spotlight->shadowMapRegion = shovelerShadowAtlasGetTileRegion(spotlight->shadowAtlas, spotlight->shadowAtlasTile);
+		}
+		return tileKept;
+	}
+
+	spotlight->shadowAtlas = NULL;
+	spotlight->shadowAtlasTile = -1;
+	spotlight->shadowMapRegion = shovelerVector4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	if(spotlight->shadowMapFramebuffer != NULL) {
+		return true;
+	}
+
+	spotlight->shadowMapFramebuffer = shovelerFramebufferCreateColorOnly(spotlight->shared->width, spotlight->shared->height, spotlight->shared->samples, 1, 32);
+	spotlight->shadowMap = spotlight->shadowMapFramebuffer->renderTarget;
+	return false;
+}
+
+/** Returns true if the shadow map rendered previously can be reused, and otherwise records the state it is rendered in. */
+static bool updateShadowMapCache(ShovelerLightSpot *spotlight, ShovelerScene *scene)
+{
+	if(spotlight->light.dynamic) {
+		spotlight->shadowMapCached = false;
+		return false;
+	}
+
+	uint64_t shadowCasterHash = shovelerSceneComputeShadowCasterHash(scene, &spotlight->camera->frustum);
+
+	if(spotlight->shadowMapCached
+		&& spotlight->cachedScene == scene
+		&& spotlight->cachedShadowCasterHash == shadowCasterHash
+		&& spotlight->cachedShadowMapLevel == spotlight->light.shadowMapLevel
+		&& memcmp(&spotlight->cachedView, &spotlight->camera->view, sizeof(ShovelerMatrix)) == 0
+		&& memcmp(&spotlight->cachedProjection, &spotlight->camera->projection, sizeof(ShovelerMatrix)) == 0) {
+		return true;
+	}
+
+	spotlight->shadowMapCached = true;
+	spotlight->cachedScene = scene;
+	spotlight->cachedView = spotlight->camera->view;
+	spotlight->cachedProjection = spotlight->camera->projection;
+	spotlight->cachedShadowCasterHash = shadowCasterHash;
+	spotlight->cachedShadowMapLevel = spotlight->light.shadowMapLevel;
+	return false;
+}
+
+static void fillUniformBlock(void *data, void *spotlightPointer)
+{
+	ShovelerLightSpot *spotlight = (ShovelerLightSpot *) spotlightPointer;
+	ShovelerLightUniformBlock *block = data;
+	block->view = spotlight->camera->view;
+	block->projection = spotlight->camera->projection;
+	block->color = spotlight->shared->color;
+	block->ambientFactor = spotlight->shared->ambientFactor;
+	block->position = spotlight->camera->position;
+	block->exponentialShadowFactor = spotlight->shared->exponentialFactor;
+	block->isExponentialLiftedShadowMap = 1;
+	block->isShadowMapped = spotlight->light.shadowed ? 1 : 0;
+	block->shadowMapRegion = spotlight->shadowMapRegion;
+}
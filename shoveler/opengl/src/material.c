@@ -3,6 +3,7 @@
 #include <glib.h>
 
 #include "shoveler/camera.h"
+#include "shoveler/instance_buffer.h"
 #include "shoveler/light.h"
 #include "shoveler/log.h"
 #include "shoveler/material.h"
@@ -13,9 +14,12 @@
 #include "shoveler/shader_cache.h"
 
 static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static bool renderInstanced(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerInstanceBuffer *instanceBuffer, ShovelerRenderState *renderState);
 static int attachUniforms(ShovelerMaterial *material, ShovelerShader *shader, void *userData);
 static void freeMaterialData(ShovelerMaterial *material);
 
+static unsigned int nextMaterialId = 0;
+
 ShovelerMaterial *shovelerMaterialCreate(ShovelerShaderCache *shaderCache, bool screenspace, GLuint program)
 {
 	ShovelerMaterial *material = shovelerMaterialCreateUnmanaged(shaderCache, screenspace, program);
@@ -26,18 +30,26 @@ ShovelerMaterial *shovelerMaterialCreate(ShovelerShaderCache *shaderCache, bool
 ShovelerMaterial *shovelerMaterialCreateUnmanaged(ShovelerShaderCache *shaderCache, bool screenspace, GLuint program)
 {
 	ShovelerMaterial *material = malloc(sizeof(ShovelerMaterial));
+	material->id = nextMaterialId++;
 	material->screenspace = screenspace;
 	material->shaderCache = shaderCache;
 	material->manageProgram = false;
 	material->program = program;
 	material->uniforms = shovelerUniformMapCreate();
 	material->render = render;
+	material->renderInstanced = NULL;
+	material->instanceColor = NULL;
 	material->attachUniforms = attachUniforms;
 	material->freeData = freeMaterialData;
 	material->data = NULL;
 	return material;
 }
 
+void shovelerMaterialEnableInstancing(ShovelerMaterial *material)
+{
+	material->renderInstanced = renderInstanced;
+}
+
 void shovelerMaterialFree(ShovelerMaterial *material)
 {
 	if(material == NULL) {
@@ -50,6 +62,7 @@ void shovelerMaterialFree(ShovelerMaterial *material)
 	shovelerUniformMapFree(material->uniforms);
 
 	if(material->manageProgram) {
+		shovelerShaderCacheInvalidateProgram(material->shaderCache, material->program);
 		glDeleteProgram(material->program);
 	}
 
@@ -74,6 +87,24 @@ static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCam
 	return true;
 }
 
+static bool renderInstanced(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerInstanceBuffer *instanceBuffer, ShovelerRenderState *renderState)
+{
+	// the passed model only stands in for the shared drawable, transformations come from the instance buffer
+	ShovelerShader *shader = shovelerSceneGenerateShader(scene, camera, light, model, material, NULL);
+
+	if(!shovelerShaderUse(shader)) {
+		shovelerLogWarning("Failed to use shader for instanced material %p, scene %p, camera %p, light %p and model %p.", material, scene, camera, light, model);
+		return false;
+	}
+
+	if(!shovelerModelRenderInstanced(model, instanceBuffer)) {
+		shovelerLogWarning("Failed to render %d instances of model %p with material %p in scene %p for camera %p and light %p.", shovelerInstanceBufferGetNumInstances(instanceBuffer), model, material, scene, camera, light);
+		return false;
+	}
+
+	return true;
+}
+
 static int attachUniforms(ShovelerMaterial *material, ShovelerShader *shader, void *userData)
 {
 	// simply attach uniform map by default
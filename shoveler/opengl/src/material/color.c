@@ -1,5 +1,7 @@
 #include "shoveler/material/depth.h"
 #include "shoveler/shader_program/model_vertex.h"
+#include "shoveler/camera.h"
+#include "shoveler/light.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/types.h"
@@ -9,21 +11,19 @@
 static const char *fragmentShaderSource =
 	"#version 400\n"
 	""
-	"uniform vec3 cameraPosition;\n"
+	SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
 	""
-	"uniform vec3 lightColor;\n"
-	"uniform float lightAmbientFactor;\n"
-	"uniform float lightExponentialShadowFactor;\n"
-	"uniform vec3 lightPosition;\n"
-	"uniform bool isExponentialLiftedShadowMap;\n"
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
 	"uniform sampler2D shadowMap;\n"
 	""
+	"uniform bool sceneInstanced;\n"
 	"uniform vec4 color;\n"
 	""
 	"in vec3 worldPosition;\n"
 	"in vec3 worldNormal;\n"
 	"in vec2 worldUv;\n"
 	"in vec4 lightFrustumPosition4;\n"
+	"in vec4 modelColor;\n"
 	""
 	"out vec4 fragmentColor;\n"
 	""
@@ -43,11 +43,15 @@ static const char *fragmentShaderSource =
 	""
 	"void main()\n"
 	"{\n"
+	"	vec4 materialColor = sceneInstanced ? modelColor : color;\n"
 	"	vec3 lightFrustumPosition = lightFrustumPosition4.xyz / lightFrustumPosition4.w;\n"
 	"	vec3 lightScreenPosition = 0.5 * (lightFrustumPosition + vec3(1.0, 1.0, 1.0));\n"
 	"	float exponentialShadowFactor = 0.0;\n"
-	"	if(isInLightCamera(lightScreenPosition)) {\n"
-	"		float shadowMapDepth = texture2D(shadowMap, lightScreenPosition.xy).r;\n"
+	"	if(!isShadowMapped) {\n"
+	"		bool isInLightFrustum = isInLightCamera(lightScreenPosition) && lightScreenPosition.z >= 0.0 && lightScreenPosition.z <= 1.0;\n"
+	"		exponentialShadowFactor = isInLightFrustum ? 1.0 : 0.0;\n"
+	"	} else if(isInLightCamera(lightScreenPosition)) {\n"
+	"		float shadowMapDepth = texture2D(shadowMap, lightShadowMapRegion.xy + lightScreenPosition.xy * lightShadowMapRegion.zw).r;\n"
 	"		float fragmentDepth = lightScreenPosition.z;\n"
 	"		exponentialShadowFactor = getExponentialShadowFactor(shadowMapDepth, fragmentDepth);\n"
 	"	}\n"
@@ -61,18 +65,29 @@ static const char *fragmentShaderSource =
 	"	vec3 reflectedLight = -reflect(-lightDirection, normal);\n"
 	"	float specularFactor = pow(clamp(dot(reflectedLight, cameraDirection), 0.0, 1.0), 250.0);\n"
 	""
-	"	fragmentColor = vec4(clamp(lightAmbientFactor * color.rgb + exponentialShadowFactor * diffuseFactor * color.rgb * lightColor + exponentialShadowFactor * specularFactor * lightColor, 0.0, 1.0), color.a);\n"
+	"	fragmentColor = vec4(clamp(lightAmbientFactor * materialColor.rgb + exponentialShadowFactor * diffuseFactor * materialColor.rgb * lightColor + exponentialShadowFactor * specularFactor * lightColor, 0.0, 1.0), materialColor.a);\n"
 	"}\n";
 
 ShovelerMaterial *shovelerMaterialColorCreate(ShovelerShaderCache *shaderCache, bool screenspace, ShovelerVector4 color)
 {
-	GLuint vertexShaderObject = shovelerShaderProgramModelVertexCreate(screenspace);
-	GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(fragmentShaderSource, GL_FRAGMENT_SHADER);
-	GLuint program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
+	// all color materials share their program so that instances of different colors can be drawn in the same batch
+	const char *programName = screenspace ? "color screenspace" : "color";
+	GLuint program = shovelerShaderCacheGetSharedProgram(shaderCache, programName);
+	if(program == 0) {
+		GLuint vertexShaderObject = shovelerShaderProgramModelVertexCreate(screenspace);
+		GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(fragmentShaderSource, GL_FRAGMENT_SHADER);
+		program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
+		if(program != 0) {
+			shovelerShaderCacheSetSharedProgram(shaderCache, programName, program);
+		}
+	}
 
-	ShovelerMaterial *material = shovelerMaterialCreate(shaderCache, screenspace, program);
+	ShovelerMaterial *material = shovelerMaterialCreateUnmanaged(shaderCache, screenspace, program);
+	shovelerMaterialEnableInstancing(material);
 
-	shovelerUniformMapInsert(material->uniforms, "color", shovelerUniformCreateVector4(color));
+	ShovelerUniform *colorUniform = shovelerUniformCreateVector4(color);
+	shovelerUniformMapInsert(material->uniforms, "color", colorUniform);
+	material->instanceColor = &colorUniform->value.vector4Value;
 
 	return material;
 }
@@ -1,5 +1,11 @@
+#include <stdlib.h> // malloc, free
+
+#include "shoveler/drawable/tiles.h"
 #include "shoveler/material/depth.h"
+#include "shoveler/light/point.h"
 #include "shoveler/shader_program/model_vertex.h"
+#include "shoveler/shader_program/tile_vertex.h"
+#include "shoveler/model.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/shader_program.h"
 
@@ -13,10 +19,94 @@ static const char *fragmentShaderSource =
 		"	fragmentDepth = vec4(gl_FragCoord.z);\n"
 		"}\n";
 
+static const char *layeredGeometryShaderSource =
+		"#version 400\n"
+		"\n"
+		"layout(triangles, invocations = 6) in;\n"
+		"layout(triangle_strip, max_vertices = 3) out;\n"
+		"\n"
+		SHOVELER_LIGHT_POINT_FACES_UNIFORM_BLOCK_SOURCE
+		"\n"
+		"in vec3 worldPosition[];\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"	for(int i = 0; i < 3; i++) {\n"
+		"		gl_Layer = gl_InvocationID;\n"
+		"		gl_Position = lightFaceViewProjections[gl_InvocationID] * vec4(worldPosition[i], 1.0);\n"
+		"		EmitVertex();\n"
+		"	}\n"
+		"	EndPrimitive();\n"
+		"}\n";
+
+typedef struct {
+	bool layered;
+	/** default render callback used for all models not drawing a tiles drawable */
+	ShovelerMaterialRenderFunction *renderModel;
+	/** depth material expanding tiles drawables in its vertex shader, created on the first tiles model rendered */
+	ShovelerMaterial *tilesMaterial;
+} MaterialData;
+
+static ShovelerMaterial *createDepthMaterial(ShovelerShaderCache *shaderCache, bool screenspace, bool layered);
+static GLuint linkProgram(GLuint vertexShaderObject, bool layered);
+static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static void freeMaterialData(ShovelerMaterial *material);
+
 ShovelerMaterial *shovelerMaterialDepthCreate(ShovelerShaderCache *shaderCache, bool screenspace)
 {
-	GLuint vertexShaderObject = shovelerShaderProgramModelVertexCreate(screenspace);
+	return createDepthMaterial(shaderCache, screenspace, /* layered */ false);
+}
+
+ShovelerMaterial *shovelerMaterialDepthCreateLayered(ShovelerShaderCache *shaderCache)
+{
+	return createDepthMaterial(shaderCache, /* screenspace */ false, /* layered */ true);
+}
+
+static ShovelerMaterial *createDepthMaterial(ShovelerShaderCache *shaderCache, bool screenspace, bool layered)
+{
+	GLuint program = linkProgram(shovelerShaderProgramModelVertexCreate(screenspace), layered);
+	ShovelerMaterial *material = shovelerMaterialCreate(shaderCache, screenspace, program);
+	shovelerMaterialEnableInstancing(material);
+
+	MaterialData *materialData = malloc(sizeof(MaterialData));
+	materialData->layered = layered;
+	materialData->renderModel = material->render;
+	materialData->tilesMaterial = NULL;
+
+	material->data = materialData;
+	material->render = render;
+	material->freeData = freeMaterialData;
+
+	return material;
+}
+
+static GLuint linkProgram(GLuint vertexShaderObject, bool layered)
+{
+	GLuint geometryShaderObject = layered ? shovelerShaderProgramCompileFromString(layeredGeometryShaderSource, GL_GEOMETRY_SHADER) : 0;
 	GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(fragmentShaderSource, GL_FRAGMENT_SHADER);
-	GLuint program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
-	return shovelerMaterialCreate(shaderCache, screenspace, program);
+	return shovelerShaderProgramLink(vertexShaderObject, geometryShaderObject, fragmentShaderObject, true);
+}
+
+static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	MaterialData *materialData = material->data;
+
+	if(!shovelerDrawableIsTiles(model->drawable)) {
+		return materialData->renderModel(material, scene, camera, light, model, renderState);
+	}
+
+	// the model vertex shader only reads vertex positions, which would collapse all tiles onto the drawable's single quad
+	if(materialData->tilesMaterial == NULL) {
+		GLuint program = linkProgram(shovelerShaderProgramTileVertexCreate(material->screenspace), materialData->layered);
+		materialData->tilesMaterial = shovelerMaterialCreate(material->shaderCache, material->screenspace, program);
+	}
+
+	return shovelerMaterialRender(materialData->tilesMaterial, scene, camera, light, model, renderState);
+}
+
+static void freeMaterialData(ShovelerMaterial *material)
+{
+	MaterialData *materialData = material->data;
+	shovelerMaterialFree(materialData->tilesMaterial);
+	free(materialData);
 }
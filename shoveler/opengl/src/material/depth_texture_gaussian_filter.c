@@ -1,3 +1,4 @@
+#include <assert.h> // assert
 #include <stdlib.h> // malloc, free
 
 #include "shoveler/material/depth_texture_gaussian_filter.h"
@@ -10,8 +11,13 @@ typedef struct {
 	int liftExponential;
 	float liftExponentialFactor;
 	ShovelerVector2 filterDirection;
+	int numLayers;
 } ShovelerMaterialDepthTextureGaussianFilterData;
 
+#define STRINGIFY(value) #value
+#define STRINGIFY_EXPANDED(value) STRINGIFY(value)
+
+static ShovelerMaterial *createMaterial(ShovelerShaderCache *shaderCache, GLuint program, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height);
 static void freeMaterialDepthTextureGaussianFilterData(ShovelerMaterial *material);
 
 static const char *vertexShaderSource =
@@ -62,6 +68,11 @@ static const char *fragmentShaderSource =
 		""
 		"void main()\n"
 		"{\n"
+		"	if(filterDirection == vec2(0.0)) {\n"
+		"		filteredDepth = getTextureSample(worldUv);\n"
+		"		return;\n"
+		"	}\n"
+		""
 		"	filteredDepth = 0.0;\n"
 		""
 		"	for(int i = 0; i < 9; i++) {\n"
@@ -72,27 +83,91 @@ static const char *fragmentShaderSource =
 		"	}\n"
 		"}\n";
 
+static const char *layeredGeometryShaderSource =
+		"#version 400\n"
+		""
+		"layout(triangles, invocations = " STRINGIFY_EXPANDED(SHOVELER_MATERIAL_DEPTH_TEXTURE_GAUSSIAN_FILTER_MAX_LAYERS) ") in;\n"
+		"layout(triangle_strip, max_vertices = 3) out;\n"
+		""
+		"uniform int numLayers;\n"
+		""
+		"in vec2 worldUv[];\n"
+		""
+		"out vec2 layerUv;\n"
+		"flat out int layer;\n"
+		""
+		"void main()\n"
+		"{\n"
+		"	if(gl_InvocationID >= numLayers) {\n"
+		"		return;\n"
+		"	}\n"
+		""
+		"	for(int i = 0; i < 3; i++) {\n"
+		"		gl_Layer = gl_InvocationID;\n"
+		"		gl_Position = gl_in[i].gl_Position;\n"
+		"		layerUv = worldUv[i];\n"
+		"		layer = gl_InvocationID;\n"
+		"		EmitVertex();\n"
+		"	}\n"
+		"	EndPrimitive();\n"
+		"}\n";
+
+static const char *layeredFragmentShaderSource =
+		"#version 400\n"
+		""
+		"uniform bool liftExponential;\n"
+		"uniform float liftExponentialFactor;\n"
+		"uniform vec2 filterDirection;\n"
+		"uniform vec2 inverseTextureSize;\n"
+		"uniform sampler2DArray textureImage;\n"
+		""
+		"in vec2 layerUv;\n"
+		"flat in int layer;\n"
+		""
+		"out float filteredDepth;\n"
+		""
+		"float gaussianKernel[9] = float[](0.048297, 0.08393, 0.124548, 0.157829, 0.170793, 0.157829, 0.124548, 0.08393, 0.048297);\n"
+		""
+		"float getTextureSample(vec2 samplePosition)\n"
+		"{\n"
+		"	float textureSample = texture(textureImage, vec3(samplePosition, layer)).r;\n"
+		""
+		"	if(liftExponential) {\n"
+		"		return exp(textureSample * liftExponentialFactor);\n"
+		"	} else {\n"
+		"		return textureSample;\n"
+		"	}\n"
+		"}\n"
+		""
+		"void main()\n"
+		"{\n"
+		"	filteredDepth = 0.0;\n"
+		""
+		"	for(int i = 0; i < 9; i++) {\n"
+		"		int offset = i - 4;\n"
+		"		vec2 samplePosition = layerUv + offset * filterDirection * inverseTextureSize;\n"
+		"		float textureSample = getTextureSample(samplePosition);\n"
+		"		filteredDepth += gaussianKernel[i] * textureSample;\n"
+		"	}\n"
+		"}\n";
+
 ShovelerMaterial *shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreate(ShovelerShaderCache *shaderCache, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height)
 {
 	GLuint vertexShaderObject = shovelerShaderProgramCompileFromString(vertexShaderSource, GL_VERTEX_SHADER);
 	GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(fragmentShaderSource, GL_FRAGMENT_SHADER);
 	GLuint program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
 
-	ShovelerMaterial *material = shovelerMaterialCreate(shaderCache, /* screenspace */ true, program);
-
-	ShovelerMaterialDepthTextureGaussianFilterData *materialDepthTextureGaussianFilterData = malloc(sizeof(ShovelerMaterialDepthTextureGaussianFilterData));
-	material->freeData = freeMaterialDepthTextureGaussianFilterData;
-	material->data = materialDepthTextureGaussianFilterData;
-	shovelerMaterialDepthTextureGaussianFilterDisableExponentialLifting(material);
-	shovelerMaterialDepthTextureGaussianFilterSetDirection(material, true, false);
+	return createMaterial(shaderCache, program, texturePointer, samplerPointer, width, height);
+}
 
-	shovelerUniformMapInsert(material->uniforms, "liftExponential", shovelerUniformCreateIntPointer(&materialDepthTextureGaussianFilterData->liftExponential));
-	shovelerUniformMapInsert(material->uniforms, "liftExponentialFactor", shovelerUniformCreateFloatPointer(&materialDepthTextureGaussianFilterData->liftExponentialFactor));
-	shovelerUniformMapInsert(material->uniforms, "filterDirection", shovelerUniformCreateVector2Pointer(&materialDepthTextureGaussianFilterData->filterDirection));
-	shovelerUniformMapInsert(material->uniforms, "inverseTextureSize", shovelerUniformCreateVector2(shovelerVector2(1.0f / width, 1.0f / height)));
-	shovelerUniformMapInsert(material->uniforms, "textureImage", shovelerUniformCreateTexturePointer(texturePointer, samplerPointer));
+ShovelerMaterial *shovelerMaterialDepthTextureGaussianFilterGaussianFilterCreateLayered(ShovelerShaderCache *shaderCache, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height)
+{
+	GLuint vertexShaderObject = shovelerShaderProgramCompileFromString(vertexShaderSource, GL_VERTEX_SHADER);
+	GLuint geometryShaderObject = shovelerShaderProgramCompileFromString(layeredGeometryShaderSource, GL_GEOMETRY_SHADER);
+	GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(layeredFragmentShaderSource, GL_FRAGMENT_SHADER);
+	GLuint program = shovelerShaderProgramLink(vertexShaderObject, geometryShaderObject, fragmentShaderObject, true);
 
-	return material;
+	return createMaterial(shaderCache, program, texturePointer, samplerPointer, width, height);
 }
 
 void shovelerMaterialDepthTextureGaussianFilterEnableExponentialLifting(ShovelerMaterial *material, float liftExponentialFactor)
@@ -116,6 +191,35 @@ void shovelerMaterialDepthTextureGaussianFilterSetDirection(ShovelerMaterial *ma
 	materialDepthTextureGaussianFilterData->filterDirection.values[1] = filterY ? 1 : 0;
 }
 
+void shovelerMaterialDepthTextureGaussianFilterSetLayers(ShovelerMaterial *material, int numLayers)
+{
+	assert(numLayers <= SHOVELER_MATERIAL_DEPTH_TEXTURE_GAUSSIAN_FILTER_MAX_LAYERS);
+
+	ShovelerMaterialDepthTextureGaussianFilterData *materialDepthTextureGaussianFilterData = material->data;
+	materialDepthTextureGaussianFilterData->numLayers = numLayers;
+}
+
+static ShovelerMaterial *createMaterial(ShovelerShaderCache *shaderCache, GLuint program, ShovelerTexture **texturePointer, ShovelerSampler **samplerPointer, int width, int height)
+{
+	ShovelerMaterial *material = shovelerMaterialCreate(shaderCache, /* screenspace */ true, program);
+
+	ShovelerMaterialDepthTextureGaussianFilterData *materialDepthTextureGaussianFilterData = malloc(sizeof(ShovelerMaterialDepthTextureGaussianFilterData));
+	material->freeData = freeMaterialDepthTextureGaussianFilterData;
+	material->data = materialDepthTextureGaussianFilterData;
+	shovelerMaterialDepthTextureGaussianFilterDisableExponentialLifting(material);
+	shovelerMaterialDepthTextureGaussianFilterSetDirection(material, true, false);
+	shovelerMaterialDepthTextureGaussianFilterSetLayers(material, SHOVELER_MATERIAL_DEPTH_TEXTURE_GAUSSIAN_FILTER_MAX_LAYERS);
+
+	shovelerUniformMapInsert(material->uniforms, "liftExponential", shovelerUniformCreateIntPointer(&materialDepthTextureGaussianFilterData->liftExponential));
+	shovelerUniformMapInsert(material->uniforms, "liftExponentialFactor", shovelerUniformCreateFloatPointer(&materialDepthTextureGaussianFilterData->liftExponentialFactor));
+	shovelerUniformMapInsert(material->uniforms, "filterDirection", shovelerUniformCreateVector2Pointer(&materialDepthTextureGaussianFilterData->filterDirection));
+	shovelerUniformMapInsert(material->uniforms, "numLayers", shovelerUniformCreateIntPointer(&materialDepthTextureGaussianFilterData->numLayers));
+	shovelerUniformMapInsert(material->uniforms, "inverseTextureSize", shovelerUniformCreateVector2(shovelerVector2(1.0f / width, 1.0f / height)));
+	shovelerUniformMapInsert(material->uniforms, "textureImage", shovelerUniformCreateTexturePointer(texturePointer, samplerPointer));
+
+	return material;
+}
+
 static void freeMaterialDepthTextureGaussianFilterData(ShovelerMaterial *material)
 {
 	ShovelerMaterialDepthTextureGaussianFilterData *materialDepthTextureGaussianFilterData = material->data;
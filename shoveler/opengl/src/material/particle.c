@@ -1,4 +1,5 @@
 #include "shoveler/material/particle.h"
+#include "shoveler/camera.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/uniform.h"
@@ -9,7 +10,7 @@ static const char *vertexShaderSource =
 		"\n"
 		"uniform mat4 model;\n"
 		"uniform mat4 modelNormal;\n"
-		"uniform mat4 view;\n"
+		SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
 		"\n"
 		"in vec3 position;\n"
 		"\n"
@@ -35,8 +36,7 @@ static const char *geometryShaderSource =
 		"layout(points) in;\n"
 		"layout(triangle_strip, max_vertices = 4) out;\n"
 		"\n"
-		"uniform mat4 view;\n"\
-		"uniform mat4 projection;\n"
+		SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
 		"\n"
 		"in vec2 particleSize[];\n"
 		"\n"
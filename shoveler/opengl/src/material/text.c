@@ -2,6 +2,7 @@
 
 #include "shoveler/material/text.h"
 #include "shoveler/shader_program/model_vertex.h"
+#include "shoveler/shader_program/sprite_vertex.h"
 #include "shoveler/camera.h"
 #include "shoveler/font_atlas.h"
 #include "shoveler/font_atlas_texture.h"
@@ -14,6 +15,7 @@
 #include "shoveler/shader.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/shader_program.h"
+#include "shoveler/sprite_batch.h"
 
 static const char *fragmentShaderSource =
 	"#version 400\n"
@@ -22,6 +24,7 @@ static const char *fragmentShaderSource =
 	"uniform vec2 regionPosition;\n"
 	"uniform vec2 regionSize;\n"
 	"uniform sampler2D fontAtlas;\n"
+	"uniform bool fontAtlasSignedDistanceField;\n"
 	"uniform uint fontSize;\n"
 	"uniform vec2 textCorner;\n"
 	"uniform float textSize;\n"
@@ -31,8 +34,8 @@ static const char *fragmentShaderSource =
 	"uniform uint glyphMinY;\n"
 	"uniform uint glyphWidth;\n"
 	"uniform uint glyphHeight;\n"
-	"uniform uint glyphBearingX;\n"
-	"uniform uint glyphBearingY;\n"
+	"uniform int glyphBearingX;\n"
+	"uniform int glyphBearingY;\n"
 	"uniform bool glyphIsRotated;\n"
 	"\n"
 	"flat in vec2 fragmentPosition;\n"
@@ -93,31 +96,74 @@ static const char *fragmentShaderSource =
 	""
 	"	vec2 glyphUv = getSpriteUv(characterGlyphCorner, characterGlyphSize);\n"
 	""
+	"	// Sample outside of the glyph bounds check so that derivatives stay defined across the whole quad.\n"
+	"	vec2 fontAtlasUv = getFontAtlasUv(clamp(glyphUv, 0.0, 1.0));\n"
+	"	float fontAtlasValue = texture2D(fontAtlas, fontAtlasUv).r;\n"
+	"	float fontAtlasValueWidth = fwidth(fontAtlasValue);\n"
+	""
+	"	float alpha = fontAtlasValue;\n"
+	"	if (fontAtlasSignedDistanceField) {\n"
+	"		// The outline lies at half intensity, so antialias over the distance covered by a single screen pixel.\n"
+	"		alpha = clamp((fontAtlasValue - 0.5) / max(fontAtlasValueWidth, 0.0001) + 0.5, 0.0, 1.0);\n"
+	"	}\n"
+	""
 	"	if (glyphUv.x >= 0.0 &&\n"
 	"		glyphUv.x <= 1.0 &&\n"
 	"		glyphUv.y >= 0.0 &&\n"
 	"		glyphUv.y <= 1.0) {\n"
-	"		vec2 fontAtlasUv = getFontAtlasUv(glyphUv);\n"
-	"		float fontAtlasValue = texture2D(fontAtlas, fontAtlasUv).r;\n"
-	""
 	"		if (sceneDebugMode) {\n"
 	"			fragmentColor = vec4(fontAtlasUv.xy, fontAtlasUv.y, 1.0);\n"
 	"		} else {\n"
-	"			fragmentColor = vec4(textColor.rgb, fontAtlasValue * textColor.a);\n"
+	"			fragmentColor = vec4(textColor.rgb, alpha * textColor.a);\n"
 	"		}\n"
 	"	} else {\n"
 	"		fragmentColor = vec4(0.0);\n"
 	"	}\n"
 	"}\n";
 
+static const char *batchFragmentShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform bool sceneDebugMode;\n"
+	"uniform sampler2D fontAtlas;\n"
+	"uniform bool fontAtlasSignedDistanceField;\n"
+	"uniform vec4 textColor;\n"
+	"\n"
+	"in vec2 fragmentSpriteUv;\n"
+	"flat in vec2 fragmentSpriteTile;\n"
+	"\n"
+	"out vec4 fragmentColor;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	// Each quad covers exactly one glyph, with its font atlas uv already interpolated across it.\n"
+	"	vec2 fontAtlasUv = fragmentSpriteUv;\n"
+	"	float fontAtlasValue = texture2D(fontAtlas, fontAtlasUv).r;\n"
+	"	float fontAtlasValueWidth = fwidth(fontAtlasValue);\n"
+	""
+	"	float alpha = fontAtlasValue;\n"
+	"	if (fontAtlasSignedDistanceField) {\n"
+	"		alpha = clamp((fontAtlasValue - 0.5) / max(fontAtlasValueWidth, 0.0001) + 0.5, 0.0, 1.0);\n"
+	"	}\n"
+	""
+	"	if (sceneDebugMode) {\n"
+	"		fragmentColor = vec4(fontAtlasUv.xy, fontAtlasUv.y, 1.0);\n"
+	"	} else {\n"
+	"		fragmentColor = vec4(textColor.rgb, alpha * textColor.a);\n"
+	"	}\n"
+	"}\n";
+
 typedef struct {
 	ShovelerMaterial *material;
+	/** renders the glyph quads of a sprite batch, reading their font atlas uvs from the vertices instead of uniforms */
+	ShovelerMaterial *batchMaterial;
 	ShovelerSampler *sampler;
 	ShovelerVector2 activeRegionPosition;
 	ShovelerVector2 activeRegionSize;
 	ShovelerFontAtlasTexture *activeFontAtlasTexture;
 	ShovelerTexture *activeTexture;
 	unsigned int activeFontSize;
+	bool activeFontAtlasSignedDistanceField;
 	const char *activeText;
 	ShovelerVector2 activeTextCorner;
 	float activeTextSize;
@@ -127,8 +173,8 @@ typedef struct {
 	unsigned int activeGlyphMinY;
 	unsigned int activeGlyphWidth;
 	unsigned int activeGlyphHeight;
-	unsigned int activeGlyphBearingX;
-	unsigned int activeGlyphBearingY;
+	int activeGlyphBearingX;
+	int activeGlyphBearingY;
 	bool activeGlyphIsRotated;
 } MaterialData;
 
@@ -150,6 +196,7 @@ ShovelerMaterial *shovelerMaterialTextCreate(ShovelerShaderCache *shaderCache, b
 	materialData->activeFontAtlasTexture = NULL;
 	materialData->activeTexture = NULL;
 	materialData->activeFontSize = 0;
+	materialData->activeFontAtlasSignedDistanceField = false;
 	materialData->activeTextCorner = shovelerVector2(0.0f, 0.0f);
 	materialData->activeTextSize = 0.0f;
 	materialData->activeTextColor = shovelerVector4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -162,10 +209,16 @@ ShovelerMaterial *shovelerMaterialTextCreate(ShovelerShaderCache *shaderCache, b
 	materialData->activeGlyphBearingY = 0;
 	materialData->activeGlyphIsRotated = false;
 
+	GLuint batchVertexShaderObject = shovelerShaderProgramSpriteVertexCreate(screenspace);
+	GLuint batchFragmentShaderObject = shovelerShaderProgramCompileFromString(batchFragmentShaderSource, GL_FRAGMENT_SHADER);
+	GLuint batchProgram = shovelerShaderProgramLink(batchVertexShaderObject, 0, batchFragmentShaderObject, true);
+	materialData->batchMaterial = shovelerMaterialCreate(shaderCache, screenspace, batchProgram);
+
 	shovelerUniformMapInsert(materialData->material->uniforms, "regionPosition", shovelerUniformCreateVector2Pointer(&materialData->activeRegionPosition));
 	shovelerUniformMapInsert(materialData->material->uniforms, "regionSize", shovelerUniformCreateVector2Pointer(&materialData->activeRegionSize));
 
 	shovelerUniformMapInsert(materialData->material->uniforms, "fontAtlas", shovelerUniformCreateTexturePointer(&materialData->activeTexture, &materialData->sampler));
+	shovelerUniformMapInsert(materialData->material->uniforms, "fontAtlasSignedDistanceField", shovelerUniformCreateBoolPointer(&materialData->activeFontAtlasSignedDistanceField));
 	shovelerUniformMapInsert(materialData->material->uniforms, "fontSize", shovelerUniformCreateUnsignedIntPointer(&materialData->activeFontSize));
 
 	shovelerUniformMapInsert(materialData->material->uniforms, "textCorner", shovelerUniformCreateVector2Pointer(&materialData->activeTextCorner));
@@ -179,10 +232,14 @@ ShovelerMaterial *shovelerMaterialTextCreate(ShovelerShaderCache *shaderCache, b
 	shovelerUniformMapInsert(materialData->material->uniforms, "glyphMinY", shovelerUniformCreateUnsignedIntPointer(&materialData->activeGlyphMinY));
 	shovelerUniformMapInsert(materialData->material->uniforms, "glyphWidth", shovelerUniformCreateUnsignedIntPointer(&materialData->activeGlyphWidth));
 	shovelerUniformMapInsert(materialData->material->uniforms, "glyphHeight", shovelerUniformCreateUnsignedIntPointer(&materialData->activeGlyphHeight));
-	shovelerUniformMapInsert(materialData->material->uniforms, "glyphBearingX", shovelerUniformCreateUnsignedIntPointer(&materialData->activeGlyphBearingX));
-	shovelerUniformMapInsert(materialData->material->uniforms, "glyphBearingY", shovelerUniformCreateUnsignedIntPointer(&materialData->activeGlyphBearingY));
+	shovelerUniformMapInsert(materialData->material->uniforms, "glyphBearingX", shovelerUniformCreateIntPointer(&materialData->activeGlyphBearingX));
+	shovelerUniformMapInsert(materialData->material->uniforms, "glyphBearingY", shovelerUniformCreateIntPointer(&materialData->activeGlyphBearingY));
 	shovelerUniformMapInsert(materialData->material->uniforms, "glyphIsRotated", shovelerUniformCreateBoolPointer(&materialData->activeGlyphIsRotated));
 
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "fontAtlas", shovelerUniformCreateTexturePointer(&materialData->activeTexture, &materialData->sampler));
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "fontAtlasSignedDistanceField", shovelerUniformCreateBoolPointer(&materialData->activeFontAtlasSignedDistanceField));
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "textColor", shovelerUniformCreateVector4Pointer(&materialData->activeTextColor));
+
 	return materialData->material;
 }
 
@@ -198,6 +255,7 @@ void shovelerMaterialTextSetActiveFontAtlasTexture(ShovelerMaterial *material, S
 	MaterialData *materialData = material->data;
 	materialData->activeFontAtlasTexture = fontAtlasTexture;
 	materialData->activeFontSize = fontAtlasTexture->fontAtlas->fontSize;
+	materialData->activeFontAtlasSignedDistanceField = fontAtlasTexture->fontAtlas->mode == SHOVELER_FONT_ATLAS_MODE_SIGNED_DISTANCE_FIELD;
 }
 
 void shovelerMaterialTextSetActiveText(ShovelerMaterial *material, const char *text, ShovelerVector2 corner, float size)
@@ -214,6 +272,28 @@ void shovelerMaterialTextSetActiveColor(ShovelerMaterial *material, ShovelerVect
 	materialData->activeTextColor = color;
 }
 
+bool shovelerMaterialTextRenderBatch(ShovelerMaterial *material, ShovelerSpriteBatch *batch, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	MaterialData *materialData = material->data;
+
+	shovelerRenderStateEnableBlend(renderState, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	materialData->activeTexture = materialData->activeFontAtlasTexture->texture;
+
+	ShovelerShader *shader = shovelerSceneGenerateShader(scene, camera, light, model, materialData->batchMaterial, NULL);
+	if(!shovelerShaderUse(shader)) {
+		shovelerLogWarning("Failed to use batch shader for text material %p, scene %p, camera %p, light %p and model %p.", material, scene, camera, light, model);
+		return false;
+	}
+
+	if(!shovelerSpriteBatchDraw(batch)) {
+		shovelerLogWarning("Failed to draw batch of %d glyphs with text material %p in scene %p for camera %p, light %p and model %p.", shovelerSpriteBatchGetNumQuads(batch), material, scene, camera, light, model);
+		return false;
+	}
+
+	return true;
+}
+
 static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
 {
 	MaterialData *materialData = material->data;
@@ -262,6 +342,7 @@ static void freeMaterialData(ShovelerMaterial *material)
 {
 	MaterialData *materialData = material->data;
 
+	shovelerMaterialFree(materialData->batchMaterial);
 	shovelerSamplerFree(materialData->sampler);
 	free(materialData);
 }
@@ -2,6 +2,8 @@
 
 #include "shoveler/material/texture.h"
 #include "shoveler/shader_program/model_vertex.h"
+#include "shoveler/camera.h"
+#include "shoveler/light.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/uniform.h"
@@ -10,6 +12,9 @@
 typedef struct {
 	/** color in alpha mask mode */
 	ShovelerVector4 color;
+	/** region of the texture mapped onto the model's UV coordinates, in texture coordinates */
+	ShovelerVector2 textureRegionPosition;
+	ShovelerVector2 textureRegionSize;
 	ShovelerTexture *texture;
 	bool manageTexture;
 	ShovelerSampler *sampler;
@@ -26,6 +31,8 @@ static const char *fragmentShaderSourceColor =
 		"uniform bool alphaMask;\n"
 		"uniform vec4 color;\n"
 		"uniform sampler2D textureImage;\n"
+		"uniform vec2 textureRegionPosition;\n"
+		"uniform vec2 textureRegionSize;\n"
 		"\n"
 		"in vec3 worldPosition;\n"
 		"in vec2 worldUv;\n"
@@ -34,31 +41,31 @@ static const char *fragmentShaderSourceColor =
 		"\n"
 		"void main()\n"
 		"{\n"
+		"	vec2 textureUv = textureRegionPosition + worldUv * textureRegionSize;\n"
+		"\n"
 		"	if(sceneDebugMode) {\n"
 		"		fragmentColor = vec4(worldUv.xy, worldUv.y, 1.0);\n"
 		"	} else if(depthOnly) {\n"
-		"		fragmentColor = vec4(texture2D(textureImage, worldUv).r);\n"
+		"		fragmentColor = vec4(texture2D(textureImage, textureUv).r);\n"
 		"	} else if(alphaMask) {\n"
-		"		fragmentColor = vec4(color.rgb, color.a * texture2D(textureImage, worldUv).r);\n"
+		"		fragmentColor = vec4(color.rgb, color.a * texture2D(textureImage, textureUv).r);\n"
 		"	} else {\n"
-		"		fragmentColor = vec4(texture2D(textureImage, worldUv).rgb, 1.0);\n"
+		"		fragmentColor = vec4(texture2D(textureImage, textureUv).rgb, 1.0);\n"
 		"	}\n"
 		"}\n";
 
 static const char *fragmentShaderSourcePhong =
 		"#version 400\n"
 		""
-		"uniform vec3 cameraPosition;\n"
+		SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
 		""
 		"uniform bool sceneDebugMode;\n"
-		"uniform vec3 lightColor;\n"
-		"uniform float lightAmbientFactor;\n"
-		"uniform float lightExponentialShadowFactor;\n"
-		"uniform vec3 lightPosition;\n"
-		"uniform bool isExponentialLiftedShadowMap;\n"
+		SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
 		"uniform sampler2D shadowMap;\n"
 		""
 		"uniform sampler2D textureImage;\n"
+		"uniform vec2 textureRegionPosition;\n"
+		"uniform vec2 textureRegionSize;\n"
 		""
 		"in vec3 worldPosition;\n"
 		"in vec3 worldNormal;\n"
@@ -86,13 +93,17 @@ static const char *fragmentShaderSourcePhong =
 		"	vec3 lightFrustumPosition = lightFrustumPosition4.xyz / lightFrustumPosition4.w;\n"
 		"	vec3 lightScreenPosition = 0.5 * (lightFrustumPosition + vec3(1.0, 1.0, 1.0));\n"
 		"	float exponentialShadowFactor = 0.0;\n"
-		"	if(isInLightCamera(lightScreenPosition)) {\n"
-		"		float shadowMapDepth = texture2D(shadowMap, lightScreenPosition.xy).r;\n"
+		"	if(!isShadowMapped) {\n"
+		"		bool isInLightFrustum = isInLightCamera(lightScreenPosition) && lightScreenPosition.z >= 0.0 && lightScreenPosition.z <= 1.0;\n"
+		"		exponentialShadowFactor = isInLightFrustum ? 1.0 : 0.0;\n"
+		"	} else if(isInLightCamera(lightScreenPosition)) {\n"
+		"		float shadowMapDepth = texture2D(shadowMap, lightShadowMapRegion.xy + lightScreenPosition.xy * lightShadowMapRegion.zw).r;\n"
 		"		float fragmentDepth = lightScreenPosition.z;\n"
 		"		exponentialShadowFactor = getExponentialShadowFactor(shadowMapDepth, fragmentDepth);\n"
 		"	}\n"
 		""
-		"	vec3 color = texture2D(textureImage, worldUv).rgb;\n"
+		"	vec2 textureUv = textureRegionPosition + worldUv * textureRegionSize;\n"
+		"	vec3 color = texture2D(textureImage, textureUv).rgb;\n"
 		"	vec3 lightDirection = normalize(worldPosition - lightPosition);\n"
 		"	vec3 normal = normalize(worldNormal);\n"
 		"	"
@@ -118,9 +129,12 @@ ShovelerMaterial *shovelerMaterialTextureCreate(ShovelerShaderCache *shaderCache
 	GLuint program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
 
 	ShovelerMaterial *material = shovelerMaterialCreate(shaderCache, screenspace, program);
+	shovelerMaterialEnableInstancing(material);
 
 	ShovelerMaterialTextureData *materialTextureData = malloc(sizeof(ShovelerMaterialTextureData));
 	materialTextureData->color = shovelerVector4(0.0f, 0.0f, 0.0f, 0.0f);
+	materialTextureData->textureRegionPosition = shovelerVector2(0.0f, 0.0f);
+	materialTextureData->textureRegionSize = shovelerVector2(1.0f, 1.0f);
 	materialTextureData->texture = texture;
 	materialTextureData->manageTexture = manageTexture;
 	materialTextureData->sampler = sampler;
@@ -133,6 +147,8 @@ ShovelerMaterial *shovelerMaterialTextureCreate(ShovelerShaderCache *shaderCache
 	shovelerUniformMapInsert(material->uniforms, "depthOnly", shovelerUniformCreateInt(type == SHOVELER_MATERIAL_TEXTURE_TYPE_DEPTH));
 	shovelerUniformMapInsert(material->uniforms, "alphaMask", shovelerUniformCreateInt(type == SHOVELER_MATERIAL_TEXTURE_TYPE_ALPHA_MASK));
 	shovelerUniformMapInsert(material->uniforms, "textureImage", shovelerUniformCreateTexture(texture, sampler));
+	shovelerUniformMapInsert(material->uniforms, "textureRegionPosition", shovelerUniformCreateVector2Pointer(&materialTextureData->textureRegionPosition));
+	shovelerUniformMapInsert(material->uniforms, "textureRegionSize", shovelerUniformCreateVector2Pointer(&materialTextureData->textureRegionSize));
 
 	return material;
 }
@@ -143,6 +159,13 @@ void shovelerMaterialTextureSetAlphaMaskColor(ShovelerMaterial *material, Shovel
 	materialTextureData->color = color;
 }
 
+void shovelerMaterialTextureSetTextureRegion(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size)
+{
+	ShovelerMaterialTextureData *materialTextureData = material->data;
+	materialTextureData->textureRegionPosition = position;
+	materialTextureData->textureRegionSize = size;
+}
+
 static void freeMaterialTextureData(ShovelerMaterial *material)
 {
 	ShovelerMaterialTextureData *materialTextureData = material->data;
@@ -19,6 +19,8 @@ static const char *fragmentShaderSource =
 	"uniform vec2 regionSize;\n"
 	"uniform vec2 spritePosition;\n"
 	"uniform vec2 spriteSize;\n"
+	"uniform vec2 textureRegionPosition;\n"
+	"uniform vec2 textureRegionSize;\n"
 	"uniform bool depthOnly;\n"
 	"uniform bool alphaMask;\n"
 	"uniform vec4 color;\n"
@@ -57,14 +59,16 @@ static const char *fragmentShaderSource =
 	"		return;\n"
 	"	}\n"
 	"\n"
+	"	vec2 textureUv = textureRegionPosition + spriteUv * textureRegionSize;\n"
+	"\n"
 	"	if(sceneDebugMode) {\n"
 	"		fragmentColor = vec4(spriteUv.xy, spriteUv.y, 1.0);\n"
 	"	} else if(depthOnly) {\n"
-	"		fragmentColor = vec4(texture2D(texture, spriteUv).r);\n"
+	"		fragmentColor = vec4(texture2D(texture, textureUv).r);\n"
 	"	} else if(alphaMask) {\n"
-	"		fragmentColor = vec4(color.rgb, color.a * texture2D(texture, spriteUv).r);\n"
+	"		fragmentColor = vec4(color.rgb, color.a * texture2D(texture, textureUv).r);\n"
 	"	} else {\n"
-	"		fragmentColor = vec4(texture2D(texture, spriteUv).rgb, 1.0);\n"
+	"		fragmentColor = vec4(texture2D(texture, textureUv).rgb, 1.0);\n"
 	"	}\n"
 	"}\n";
 
@@ -74,6 +78,8 @@ typedef struct {
 	ShovelerVector2 activeRegionSize;
 	ShovelerVector2 activeSpritePosition;
 	ShovelerVector2 activeSpriteSize;
+	ShovelerVector2 activeTextureRegionPosition;
+	ShovelerVector2 activeTextureRegionSize;
 	ShovelerVector4 activeColor;
 	ShovelerTexture *activeTexture;
 	ShovelerSampler *activeSampler;
@@ -95,6 +101,8 @@ ShovelerMaterial *shovelerMaterialTextureSpriteCreate(ShovelerShaderCache *shade
 	materialData->activeRegionSize = shovelerVector2(1.0f, 1.0f);
 	materialData->activeSpritePosition = shovelerVector2(0.0f, 0.0f);
 	materialData->activeSpriteSize = shovelerVector2(0.0f, 0.0f);
+	materialData->activeTextureRegionPosition = shovelerVector2(0.0f, 0.0f);
+	materialData->activeTextureRegionSize = shovelerVector2(1.0f, 1.0f);
 	materialData->activeColor = shovelerVector4(0.0f, 0.0f, 0.0f, 0.0f);
 	materialData->activeTexture = NULL;
 	materialData->activeSampler = NULL;
@@ -104,6 +112,8 @@ ShovelerMaterial *shovelerMaterialTextureSpriteCreate(ShovelerShaderCache *shade
 
 	shovelerUniformMapInsert(materialData->material->uniforms, "spritePosition", shovelerUniformCreateVector2Pointer(&materialData->activeSpritePosition));
 	shovelerUniformMapInsert(materialData->material->uniforms, "spriteSize", shovelerUniformCreateVector2Pointer(&materialData->activeSpriteSize));
+	shovelerUniformMapInsert(materialData->material->uniforms, "textureRegionPosition", shovelerUniformCreateVector2Pointer(&materialData->activeTextureRegionPosition));
+	shovelerUniformMapInsert(materialData->material->uniforms, "textureRegionSize", shovelerUniformCreateVector2Pointer(&materialData->activeTextureRegionSize));
 
 	shovelerUniformMapInsert(materialData->material->uniforms, "depthOnly", shovelerUniformCreateInt(type == SHOVELER_MATERIAL_TEXTURE_SPRITE_TYPE_DEPTH));
 	shovelerUniformMapInsert(materialData->material->uniforms, "alphaMask", shovelerUniformCreateInt(type == SHOVELER_MATERIAL_TEXTURE_SPRITE_TYPE_ALPHA_MASK));
@@ -127,6 +137,13 @@ void shovelerMaterialTextureSpriteSetActiveSprite(ShovelerMaterial *material, Sh
 	materialData->activeSpriteSize = size;
 }
 
+void shovelerMaterialTextureSpriteSetActiveTextureRegion(ShovelerMaterial *material, ShovelerVector2 position, ShovelerVector2 size)
+{
+	MaterialData *materialData = material->data;
+	materialData->activeTextureRegionPosition = position;
+	materialData->activeTextureRegionSize = size;
+}
+
 void shovelerMaterialTextureSpriteSetColor(ShovelerMaterial *material, ShovelerVector4 color)
 {
 	MaterialData *materialData = material->data;
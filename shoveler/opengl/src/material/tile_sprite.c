@@ -1,11 +1,16 @@
 #include <stdlib.h> // malloc, free
 
 #include "shoveler/material/tile_sprite.h"
+#include "shoveler/log.h"
 #include "shoveler/material.h"
+#include "shoveler/scene.h"
 #include "shoveler/shader_program/model_vertex.h"
+#include "shoveler/shader_program/sprite_vertex.h"
 #include "shoveler/shader_cache.h"
+#include "shoveler/shader.h"
 #include "shoveler/shader_program.h"
 #include "shoveler/sprite/tile.h"
+#include "shoveler/sprite_batch.h"
 #include "shoveler/tileset.h"
 #include "shoveler/types.h"
 #include "shoveler/uniform.h"
@@ -80,8 +85,46 @@ static const char *fragmentShaderSource =
 	"	}\n"
 	"}\n";
 
+static const char *batchFragmentShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform bool sceneDebugMode;\n"
+	"uniform int tilesetColumns;\n"
+	"uniform int tilesetRows;\n"
+	"uniform int tilesetPadding;\n"
+	"uniform sampler2D tileset;\n"
+	"\n"
+	"in vec2 fragmentSpriteUv;\n"
+	"flat in vec2 fragmentSpriteTile;\n"
+	"\n"
+	"out vec4 fragmentColor;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 tile = fragmentSpriteTile;\n"
+	"	vec2 tileUv = clamp(fragmentSpriteUv, 0.0, 1.0);\n"
+	"\n"
+	"	vec2 tilesetSize = textureSize(tileset, 0);\n"
+	"	vec2 tilesetInverseDimensions = 1.0 / vec2(tilesetColumns, tilesetRows);\n"
+	"	vec2 paddedTileSize = tilesetSize * tilesetInverseDimensions;\n"
+	"	vec2 paddedTilePaddingFraction = vec2(tilesetPadding) / paddedTileSize;\n"
+	"	vec2 tilePaddingScaleFactor = vec2(1.0) - 2.0 * paddedTilePaddingFraction;\n"
+	"\n"
+	"	vec2 tilePaddedUv = paddedTilePaddingFraction + tilePaddingScaleFactor * tileUv;\n"
+	"	vec2 tilesetUv = (tile.xy + tilePaddedUv) * tilesetInverseDimensions;\n"
+	"\n"
+	"	vec4 color = texture2D(tileset, tilesetUv).rgba;\n"
+	"	if (sceneDebugMode) {\n"
+	"		fragmentColor = vec4(tilesetUv.xy, tilesetUv.y, 1.0);\n"
+	"	} else {\n"
+	"		fragmentColor = color;\n"
+	"	}\n"
+	"}\n";
+
 typedef struct {
 	ShovelerMaterial *material;
+	/** renders the quads of a sprite batch, reading the per-sprite values from its vertices instead of uniforms */
+	ShovelerMaterial *batchMaterial;
 	ShovelerVector2 activeRegionPosition;
 	ShovelerVector2 activeRegionSize;
 	int activeSpriteTilesetColumn;
@@ -119,6 +162,11 @@ ShovelerMaterial *shovelerMaterialTileSpriteCreate(ShovelerShaderCache *shaderCa
 	materialData->activeTilesetTexture = NULL;
 	materialData->activeTilesetSampler = NULL;
 
+	GLuint batchVertexShaderObject = shovelerShaderProgramSpriteVertexCreate(screenspace);
+	GLuint batchFragmentShaderObject = shovelerShaderProgramCompileFromString(batchFragmentShaderSource, GL_FRAGMENT_SHADER);
+	GLuint batchProgram = shovelerShaderProgramLink(batchVertexShaderObject, 0, batchFragmentShaderObject, true);
+	materialData->batchMaterial = shovelerMaterialCreate(shaderCache, screenspace, batchProgram);
+
 	shovelerUniformMapInsert(materialData->material->uniforms, "regionPosition", shovelerUniformCreateVector2Pointer(&materialData->activeRegionPosition));
 	shovelerUniformMapInsert(materialData->material->uniforms, "regionSize", shovelerUniformCreateVector2Pointer(&materialData->activeRegionSize));
 
@@ -133,6 +181,11 @@ ShovelerMaterial *shovelerMaterialTileSpriteCreate(ShovelerShaderCache *shaderCa
 	shovelerUniformMapInsert(materialData->material->uniforms, "tilesetPadding", shovelerUniformCreateIntPointer(&materialData->activeTilesetPadding));
 	shovelerUniformMapInsert(materialData->material->uniforms, "tileset", shovelerUniformCreateTexturePointer(&materialData->activeTilesetTexture, &materialData->activeTilesetSampler));
 
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "tilesetColumns", shovelerUniformCreateIntPointer(&materialData->activeTilesetColumns));
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "tilesetRows", shovelerUniformCreateIntPointer(&materialData->activeTilesetRows));
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "tilesetPadding", shovelerUniformCreateIntPointer(&materialData->activeTilesetPadding));
+	shovelerUniformMapInsert(materialData->batchMaterial->uniforms, "tileset", shovelerUniformCreateTexturePointer(&materialData->activeTilesetTexture, &materialData->activeTilesetSampler));
+
 	return materialData->material;
 }
 
@@ -174,8 +227,27 @@ void shovelerMaterialTileSpriteSetActive(ShovelerMaterial *material, const Shove
 	shovelerMaterialTileSpriteSetActiveSprite(material, spriteTile->sprite.position, spriteTile->sprite.size);
 }
 
+bool shovelerMaterialTileSpriteRenderBatch(ShovelerMaterial *material, ShovelerSpriteBatch *batch, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	MaterialData *materialData = material->data;
+
+	ShovelerShader *shader = shovelerSceneGenerateShader(scene, camera, light, model, materialData->batchMaterial, NULL);
+	if(!shovelerShaderUse(shader)) {
+		shovelerLogWarning("Failed to use batch shader for tile sprite material %p, scene %p, camera %p, light %p and model %p.", material, scene, camera, light, model);
+		return false;
+	}
+
+	if(!shovelerSpriteBatchDraw(batch)) {
+		shovelerLogWarning("Failed to draw batch of %d sprites with tile sprite material %p in scene %p for camera %p, light %p and model %p.", shovelerSpriteBatchGetNumQuads(batch), material, scene, camera, light, model);
+		return false;
+	}
+
+	return true;
+}
+
 static void freeMaterialData(ShovelerMaterial *material)
 {
 	MaterialData *materialData = material->data;
+	shovelerMaterialFree(materialData->batchMaterial);
 	free(materialData);
 }
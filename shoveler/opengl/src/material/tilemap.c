@@ -24,10 +24,8 @@ static const char *vertexShaderSource =
 	""
 	"uniform mat4 model;\n"
 	"uniform mat4 modelNormal;\n"
-	"uniform mat4 view;\n"
-	"uniform mat4 projection;\n"
-	"uniform mat4 lightView;\n"
-	"uniform mat4 lightProjection;\n"
+	SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
 	""
 	"in vec3 position;\n"
 	"in vec3 normal;\n"
@@ -0,0 +1,140 @@
+#include <stdlib.h> // malloc, free
+
+#include "shoveler/material/tiles.h"
+#include "shoveler/shader_program/tile_vertex.h"
+#include "shoveler/log.h"
+#include "shoveler/material.h"
+#include "shoveler/model.h"
+#include "shoveler/scene.h"
+#include "shoveler/shader.h"
+#include "shoveler/shader_program.h"
+#include "shoveler/texture.h"
+#include "shoveler/tileset.h"
+#include "shoveler/uniform.h"
+#include "shoveler/uniform_map.h"
+
+static const char *fragmentShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform bool sceneDebugMode;\n"
+	"uniform int tilesetColumns;\n"
+	"uniform int tilesetRows;\n"
+	"uniform int tilesetPadding;\n"
+	"uniform sampler2DArray tileset;\n"
+	"\n"
+	"in vec2 worldUv;\n"
+	"flat in vec3 fragmentTile;\n"
+	"\n"
+	"out vec4 fragmentColor;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 tile = fragmentTile.xy;\n"
+	"	vec2 tileUv = clamp(worldUv, 0.0, 1.0);\n"
+	"\n"
+	"	vec2 tilesetSize = textureSize(tileset, 0).xy;\n"
+	"	vec2 tilesetInverseDimensions = 1.0 / vec2(tilesetColumns, tilesetRows);\n"
+	"	vec2 paddedTileSize = tilesetSize * tilesetInverseDimensions;\n"
+	"	vec2 paddedTilePaddingFraction = vec2(tilesetPadding) / paddedTileSize;\n"
+	"	vec2 tilePaddingScaleFactor = vec2(1.0) - 2.0 * paddedTilePaddingFraction;\n"
+	"\n"
+	"	vec2 tilePaddedUv = paddedTilePaddingFraction + tilePaddingScaleFactor * tileUv;\n"
+	"	vec2 tilesetUv = (tile.xy + tilePaddedUv) * tilesetInverseDimensions;\n"
+	"\n"
+	"	vec4 color = texture(tileset, vec3(tilesetUv, fragmentTile.z)).rgba;\n"
+	"	if (sceneDebugMode) {\n"
+	"		fragmentColor = vec4(tilesetUv.xy, tilesetUv.y, 1.0);\n"
+	"	} else {\n"
+	"		fragmentColor = color;\n"
+	"	}\n"
+	"}\n";
+
+typedef struct {
+	ShovelerMaterial *material;
+	int activeTilesetColumns;
+	int activeTilesetRows;
+	int activeTilesetPadding;
+	ShovelerTexture *activeTilesetTexture;
+	ShovelerSampler *activeTilesetSampler;
+	/** single layer array view of the active tileset's texture if it is a 2D texture, owned by the material */
+	ShovelerTexture *activeTilesetArrayView;
+} MaterialData;
+
+static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static void freeMaterialData(ShovelerMaterial *material);
+
+ShovelerMaterial *shovelerMaterialTilesCreate(ShovelerShaderCache *shaderCache, bool screenspace)
+{
+	GLuint vertexShaderObject = shovelerShaderProgramTileVertexCreate(screenspace);
+	GLuint fragmentShaderObject = shovelerShaderProgramCompileFromString(fragmentShaderSource, GL_FRAGMENT_SHADER);
+	GLuint program = shovelerShaderProgramLink(vertexShaderObject, 0, fragmentShaderObject, true);
+
+	MaterialData *materialData = malloc(sizeof(MaterialData));
+	materialData->material = shovelerMaterialCreate(shaderCache, screenspace, program);
+	materialData->material->data = materialData;
+	materialData->material->render = render;
+	materialData->material->freeData = freeMaterialData;
+	materialData->activeTilesetColumns = 0;
+	materialData->activeTilesetRows = 0;
+	materialData->activeTilesetPadding = 0;
+	materialData->activeTilesetTexture = NULL;
+	materialData->activeTilesetSampler = NULL;
+	materialData->activeTilesetArrayView = NULL;
+
+	shovelerUniformMapInsert(materialData->material->uniforms, "tilesetColumns", shovelerUniformCreateIntPointer(&materialData->activeTilesetColumns));
+	shovelerUniformMapInsert(materialData->material->uniforms, "tilesetRows", shovelerUniformCreateIntPointer(&materialData->activeTilesetRows));
+	shovelerUniformMapInsert(materialData->material->uniforms, "tilesetPadding", shovelerUniformCreateIntPointer(&materialData->activeTilesetPadding));
+	shovelerUniformMapInsert(materialData->material->uniforms, "tileset", shovelerUniformCreateTexturePointer(&materialData->activeTilesetTexture, &materialData->activeTilesetSampler));
+
+	return materialData->material;
+}
+
+void shovelerMaterialTilesSetActiveTileset(ShovelerMaterial *material, ShovelerTileset *tileset)
+{
+	MaterialData *materialData = material->data;
+	materialData->activeTilesetColumns = tileset->columns;
+	materialData->activeTilesetRows = tileset->rows;
+	materialData->activeTilesetPadding = tileset->padding;
+	materialData->activeTilesetSampler = tileset->sampler;
+
+	shovelerTextureFree(materialData->activeTilesetArrayView);
+	materialData->activeTilesetArrayView = NULL;
+
+	if(tileset->texture->target == GL_TEXTURE_2D_ARRAY) {
+		materialData->activeTilesetTexture = tileset->texture;
+	} else {
+		materialData->activeTilesetArrayView = shovelerTextureCreateArrayView(tileset->texture);
+		materialData->activeTilesetTexture = materialData->activeTilesetArrayView;
+	}
+}
+
+static bool render(ShovelerMaterial *material, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	MaterialData *materialData = material->data;
+
+	if(materialData->activeTilesetTexture == NULL) {
+		shovelerLogWarning("Failed to render tiles material %p without an active tileset.", material);
+		return false;
+	}
+
+	ShovelerShader *shader = shovelerSceneGenerateShader(scene, camera, light, model, material, NULL);
+
+	if(!shovelerShaderUse(shader)) {
+		shovelerLogWarning("Failed to use shader for tiles material %p, scene %p, camera %p, light %p and model %p.", material, scene, camera, light, model);
+		return false;
+	}
+
+	if(!shovelerModelRender(model)) {
+		shovelerLogWarning("Failed to render model %p with tiles material %p in scene %p for camera %p and light %p.", model, material, scene, camera, light);
+		return false;
+	}
+
+	return true;
+}
+
+static void freeMaterialData(ShovelerMaterial *material)
+{
+	MaterialData *materialData = material->data;
+	shovelerTextureFree(materialData->activeTilesetArrayView);
+	free(materialData);
+}
@@ -1,6 +1,7 @@
 #include <stdbool.h> // bool
 #include <stdlib.h> // malloc, free
 
+#include "shoveler/instance_buffer.h"
 #include "shoveler/log.h"
 #include "shoveler/material.h"
 #include "shoveler/model.h"
@@ -23,8 +24,10 @@ ShovelerModel *shovelerModelCreate(ShovelerDrawable *drawable, ShovelerMaterial
 	model->visible = true;
 	model->emitter = false;
 	model->castsShadow = true;
+	model->dynamic = true;
 	model->polygonMode = GL_FILL;
 	model->uniforms = shovelerUniformMapCreate();
+	model->version = 0;
 
 	ShovelerUniform *modelUniform = shovelerUniformCreateMatrixPointer(&model->transformation);
 	shovelerUniformMapInsert(model->uniforms, "model", modelUniform);
@@ -58,6 +61,7 @@ void shovelerModelUpdateTransformation(ShovelerModel *model)
 
 	model->transformation = shovelerMatrixMultiply(translation, shovelerMatrixMultiply(rotation, scale));
 	model->normalTransformation = shovelerMatrixMultiply(rotation, scaleInverse);
+	model->version++;
 }
 
 bool shovelerModelRender(ShovelerModel *model)
@@ -72,6 +76,18 @@ bool shovelerModelRender(ShovelerModel *model)
 	return shovelerOpenGLCheckSuccess();
 }
 
+bool shovelerModelRenderInstanced(ShovelerModel *model, ShovelerInstanceBuffer *instanceBuffer)
+{
+	glPolygonMode(GL_FRONT_AND_BACK, model->polygonMode);
+
+	if(!shovelerDrawableDrawInstanced(model->drawable, instanceBuffer)) {
+		shovelerLogError("Failed to draw drawable instanced when trying to render model");
+		return false;
+	}
+
+	return shovelerOpenGLCheckSuccess();
+}
+
 void shovelerModelFree(ShovelerModel *model)
 {
 	if(model == NULL) {
@@ -0,0 +1,250 @@
+#include <assert.h> // assert
+#include <stdarg.h> // va_list va_start va_end
+#include <stdio.h> // vsnprintf
+#include <stdlib.h> // malloc free
+
+#include "shoveler/file.h"
+#include "shoveler/log.h"
+#include "shoveler/profiler.h"
+
+static ShovelerProfilerFrame *getCurrentFrame(ShovelerProfiler *profiler);
+static void resolveFrame(ShovelerProfiler *profiler, ShovelerProfilerFrame *frame);
+static void appendTraceEvent(GString *trace, const ShovelerProfilerScope *scope, bool gpu);
+static void appendEscapedString(GString *string, const char *value);
+
+ShovelerProfiler *shovelerProfilerCreate()
+{
+	ShovelerProfiler *profiler = malloc(sizeof(ShovelerProfiler));
+	profiler->enabled = false;
+	profiler->lastScopes = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerProfilerScope));
+	profiler->capturing = false;
+	profiler->recording = false;
+	profiler->nextFrame = 0;
+	profiler->openScopes = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(int));
+	profiler->traceScopes = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerProfilerScope));
+	profiler->creationTime = g_get_monotonic_time();
+
+	for(int i = 0; i < SHOVELER_PROFILER_FRAME_LATENCY; i++) {
+		ShovelerProfilerFrame *frame = &profiler->frames[i];
+		frame->scopes = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerProfilerScope));
+		frame->queries = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(GLuint));
+		frame->frame = 0;
+		frame->pending = false;
+		frame->cpuReferenceTime = 0;
+		frame->gpuReferenceTime = 0;
+	}
+
+	return profiler;
+}
+
+void shovelerProfilerBeginFrame(ShovelerProfiler *profiler)
+{
+	assert(!profiler->recording);
+
+	// the frame slot we're about to reuse was recorded the longest time ago, so its queries should be available by now
+	int frameIndex = profiler->nextFrame++;
+	ShovelerProfilerFrame *frame = &profiler->frames[frameIndex % SHOVELER_PROFILER_FRAME_LATENCY];
+	if(frame->pending) {
+		resolveFrame(profiler, frame);
+	}
+
+	profiler->recording = profiler->enabled;
+	if(!profiler->recording) {
+		return;
+	}
+
+	g_array_set_size(frame->scopes, 0);
+	g_array_set_size(profiler->openScopes, 0);
+	frame->frame = frameIndex;
+	frame->pending = true;
+	frame->cpuReferenceTime = g_get_monotonic_time() - profiler->creationTime;
+	glGetInteger64v(GL_TIMESTAMP, &frame->gpuReferenceTime);
+
+	shovelerProfilerBeginScope(profiler, "frame");
+}
+
+void shovelerProfilerBeginScope(ShovelerProfiler *profiler, const char *nameFormat, ...)
+{
+	if(profiler == NULL || !profiler->recording) {
+		return;
+	}
+
+	ShovelerProfilerFrame *frame = getCurrentFrame(profiler);
+
+	ShovelerProfilerScope scope;
+	va_list args;
+	va_start(args, nameFormat);
+	vsnprintf(scope.name, SHOVELER_PROFILER_SCOPE_NAME_LENGTH, nameFormat, args);
+	va_end(args);
+	scope.depth = (int) profiler->openScopes->len;
+	scope.frame = frame->frame;
+	scope.cpuStartTime = g_get_monotonic_time() - profiler->creationTime;
+	scope.cpuDuration = 0;
+	scope.gpuStartTime = 0;
+	scope.gpuDuration = 0;
+
+	int scopeIndex = (int) frame->scopes->len;
+	g_array_append_val(frame->scopes, scope);
+	g_array_append_val(profiler->openScopes, scopeIndex);
+
+	// queries are kept around across frames, so only generate new ones when a frame has more scopes than ever before
+	guint numQueries = 2 * frame->scopes->len;
+	if(frame->queries->len < numQueries) {
+		guint numExistingQueries = frame->queries->len;
+		g_array_set_size(frame->queries, numQueries);
+		glGenQueries((GLsizei) (numQueries - numExistingQueries), &g_array_index(frame->queries, GLuint, numExistingQueries));
+	}
+
+	glQueryCounter(g_array_index(frame->queries, GLuint, 2 * scopeIndex), GL_TIMESTAMP);
+}
+
+void shovelerProfilerEndScope(ShovelerProfiler *profiler)
+{
+	if(profiler == NULL || !profiler->recording) {
+		return;
+	}
+
+	assert(profiler->openScopes->len > 0);
+
+	ShovelerProfilerFrame *frame = getCurrentFrame(profiler);
+	int scopeIndex = g_array_index(profiler->openScopes, int, profiler->openScopes->len - 1);
+	g_array_set_size(profiler->openScopes, profiler->openScopes->len - 1);
+
+	glQueryCounter(g_array_index(frame->queries, GLuint, 2 * scopeIndex + 1), GL_TIMESTAMP);
+
+	ShovelerProfilerScope *scope = &g_array_index(frame->scopes, ShovelerProfilerScope, scopeIndex);
+	scope->cpuDuration = g_get_monotonic_time() - profiler->creationTime - scope->cpuStartTime;
+}
+
+void shovelerProfilerEndFrame(ShovelerProfiler *profiler)
+{
+	if(!profiler->recording) {
+		return;
+	}
+
+	// close the frame scope
+	assert(profiler->openScopes->len == 1);
+	shovelerProfilerEndScope(profiler);
+
+	profiler->recording = false;
+}
+
+void shovelerProfilerFormatLastFrame(ShovelerProfiler *profiler, GString *output)
+{
+	for(guint i = 0; i < profiler->lastScopes->len; i++) {
+		const ShovelerProfilerScope *scope = &g_array_index(profiler->lastScopes, ShovelerProfilerScope, i);
+		g_string_append_printf(output, "%*s%s: %.2f ms CPU, %.2f ms GPU\n", 2 * scope->depth, "", scope->name, scope->cpuDuration / 1000.0, scope->gpuDuration / 1000.0);
+	}
+}
+
+void shovelerProfilerStartCapture(ShovelerProfiler *profiler)
+{
+	g_array_set_size(profiler->traceScopes, 0);
+	profiler->capturing = true;
+}
+
+bool shovelerProfilerStopCapture(ShovelerProfiler *profiler, const char *filename)
+{
+	profiler->capturing = false;
+
+	GString *trace = g_string_new("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	g_string_append(trace, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+	g_string_append(trace, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+
+	for(guint i = 0; i < profiler->traceScopes->len; i++) {
+		const ShovelerProfilerScope *scope = &g_array_index(profiler->traceScopes, ShovelerProfilerScope, i);
+		appendTraceEvent(trace, scope, /* gpu */ false);
+		appendTraceEvent(trace, scope, /* gpu */ true);
+	}
+
+	g_string_append(trace, "\n]}\n");
+
+	bool success = shovelerFileWriteString(filename, trace->str);
+	if(success) {
+		shovelerLogInfo("Wrote Chrome trace of %u profiler scopes to '%s'.", profiler->traceScopes->len, filename);
+	} else {
+		shovelerLogError("Failed to write Chrome trace of %u profiler scopes to '%s'.", profiler->traceScopes->len, filename);
+	}
+
+	g_string_free(trace, true);
+	g_array_set_size(profiler->traceScopes, 0);
+
+	return success;
+}
+
+void shovelerProfilerFree(ShovelerProfiler *profiler)
+{
+	if(profiler == NULL) {
+		return;
+	}
+
+	for(int i = 0; i < SHOVELER_PROFILER_FRAME_LATENCY; i++) {
+		ShovelerProfilerFrame *frame = &profiler->frames[i];
+		if(frame->queries->len > 0) {
+			glDeleteQueries((GLsizei) frame->queries->len, (GLuint *) frame->queries->data);
+		}
+
+		g_array_free(frame->queries, /* freeSegment */ true);
+		g_array_free(frame->scopes, /* freeSegment */ true);
+	}
+
+	g_array_free(profiler->traceScopes, /* freeSegment */ true);
+	g_array_free(profiler->openScopes, /* freeSegment */ true);
+	g_array_free(profiler->lastScopes, /* freeSegment */ true);
+	free(profiler);
+}
+
+static ShovelerProfilerFrame *getCurrentFrame(ShovelerProfiler *profiler)
+{
+	return &profiler->frames[(profiler->nextFrame - 1) % SHOVELER_PROFILER_FRAME_LATENCY];
+}
+
+static void resolveFrame(ShovelerProfiler *profiler, ShovelerProfilerFrame *frame)
+{
+	for(guint i = 0; i < frame->scopes->len; i++) {
+		ShovelerProfilerScope *scope = &g_array_index(frame->scopes, ShovelerProfilerScope, i);
+
+		GLint64 gpuBeginTime;
+		GLint64 gpuEndTime;
+		glGetQueryObjecti64v(g_array_index(frame->queries, GLuint, 2 * i), GL_QUERY_RESULT, &gpuBeginTime);
+		glGetQueryObjecti64v(g_array_index(frame->queries, GLuint, 2 * i + 1), GL_QUERY_RESULT, &gpuEndTime);
+
+		// GPU timestamps are in nanoseconds relative to an arbitrary origin, so align them with the CPU timeline at the
+		// reference point taken when the frame began
+		scope->gpuStartTime = frame->cpuReferenceTime + (gpuBeginTime - frame->gpuReferenceTime) / 1000;
+		scope->gpuDuration = (gpuEndTime - gpuBeginTime) / 1000;
+	}
+
+	g_array_set_size(profiler->lastScopes, 0);
+	g_array_append_vals(profiler->lastScopes, frame->scopes->data, frame->scopes->len);
+
+	if(profiler->capturing) {
+		g_array_append_vals(profiler->traceScopes, frame->scopes->data, frame->scopes->len);
+	}
+
+	frame->pending = false;
+}
+
+static void appendTraceEvent(GString *trace, const ShovelerProfilerScope *scope, bool gpu)
+{
+	g_string_append(trace, ",\n{\"name\":\"");
+	appendEscapedString(trace, scope->name);
+	g_string_append_printf(trace, "\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,\"args\":{\"frame\":%d}}",
+		gpu ? "gpu" : "cpu",
+		gpu ? 2 : 1,
+		(long long) (gpu ? scope->gpuStartTime : scope->cpuStartTime),
+		(long long) (gpu ? scope->gpuDuration : scope->cpuDuration),
+		scope->frame);
+}
+
+static void appendEscapedString(GString *string, const char *value)
+{
+	for(const char *c = value; *c != '\0'; c++) {
+		if(*c == '"' || *c == '\\') {
+			g_string_append_c(string, '\\');
+			g_string_append_c(string, *c);
+		} else if((unsigned char) *c >= 0x20) {
+			g_string_append_c(string, *c);
+		}
+	}
+}
@@ -21,9 +21,12 @@ void shovelerRenderStateReset(const ShovelerRenderState *renderState)
 	glDepthMask(renderState->depthMask);
 }
 
-void shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRenderState *targetRenderState)
+int shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRenderState *targetRenderState)
 {
+	int changes = 0;
+
 	if(targetRenderState->blend != renderState->blend) {
+		changes++;
 		if(targetRenderState->blend) {
 			glEnable(GL_BLEND);
 		} else {
@@ -32,10 +35,12 @@ void shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRend
 	}
 
 	if(targetRenderState->blendSourceFactor != renderState->blendSourceFactor || targetRenderState->blendDestinationFactor != renderState->blendDestinationFactor) {
+		changes++;
 		glBlendFunc(targetRenderState->blendSourceFactor, targetRenderState->blendDestinationFactor);
 	}
 
 	if(targetRenderState->depthTest != renderState->depthTest) {
+		changes++;
 		if(targetRenderState->depthTest) {
 			glEnable(GL_DEPTH_TEST);
 		} else {
@@ -44,14 +49,18 @@ void shovelerRenderStateSet(ShovelerRenderState *renderState, const ShovelerRend
 	}
 
 	if(targetRenderState->depthFunction != renderState->depthFunction) {
+		changes++;
 		glDepthFunc(targetRenderState->depthFunction);
 	}
 
 	if(targetRenderState->depthMask != renderState->depthMask) {
+		changes++;
 		glDepthMask(targetRenderState->depthMask);
 	}
 
 	*renderState = *targetRenderState;
+
+	return changes;
 }
 
 
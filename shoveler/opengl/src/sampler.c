@@ -3,6 +3,12 @@
 #include "shoveler/opengl.h"
 #include "shoveler/sampler.h"
 
+/** Number of texture units whose sampler bindings are tracked to skip redundant binds. */
+#define SHOVELER_SAMPLER_NUM_TRACKED_UNITS 16
+
+/** sampler last bound to each of the first units, or 0 if unknown */
+static GLuint boundSamplers[SHOVELER_SAMPLER_NUM_TRACKED_UNITS];
+
 ShovelerSampler *shovelerSamplerCreate(bool interpolate, bool useMipmaps, bool clamp)
 {
 	ShovelerSampler *sampler = malloc(sizeof(ShovelerSampler));
@@ -39,12 +45,27 @@ ShovelerSampler *shovelerSamplerCreate(bool interpolate, bool useMipmaps, bool c
 
 bool shovelerSamplerUse(ShovelerSampler *sampler, GLuint unitIndex)
 {
+	if(unitIndex < SHOVELER_SAMPLER_NUM_TRACKED_UNITS) {
+		if(boundSamplers[unitIndex] == sampler->sampler) {
+			return true;
+		}
+
+		boundSamplers[unitIndex] = sampler->sampler;
+	}
+
 	glBindSampler(unitIndex, sampler->sampler);
 	return shovelerOpenGLCheckSuccess();
 }
 
 void shovelerSamplerFree(ShovelerSampler *sampler)
 {
+	// deleting a sampler unbinds it
+	for(GLuint unitIndex = 0; unitIndex < SHOVELER_SAMPLER_NUM_TRACKED_UNITS; unitIndex++) {
+		if(boundSamplers[unitIndex] == sampler->sampler) {
+			boundSamplers[unitIndex] = 0;
+		}
+	}
+
 	glDeleteSamplers(1, &sampler->sampler);
 	free(sampler);
 }
@@ -1,12 +1,23 @@
-#include <stdlib.h> // malloc, free
+#include <math.h> // fabsf, sqrtf, INFINITY
+#include <stdint.h> // uint32_t, uint64_t, uintptr_t
+#include <stdlib.h> // malloc, free, qsort
+#include <string.h> // memcpy
 
+#include "shoveler/drawable/cube.h"
+#include "shoveler/filter/depth_texture_gaussian.h"
 #include "shoveler/material/depth.h"
+#include "shoveler/camera.h"
+#include "shoveler/framebuffer.h"
+#include "shoveler/instance_buffer.h"
 #include "shoveler/light.h"
 #include "shoveler/log.h"
 #include "shoveler/model.h"
+#include "shoveler/profiler.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader.h"
 #include "shoveler/shader_cache.h"
+#include "shoveler/shadow_atlas.h"
+#include "shoveler/uniform_buffer.h"
 
 typedef enum {
 	RENDER_MODE_OCCLUDED,
@@ -15,7 +26,37 @@ typedef enum {
 	RENDER_MODE_ADDITIVE_LIGHT,
 } RenderMode;
 
+typedef struct {
+	uint64_t key;
+	ShovelerModel *model;
+	ShovelerMaterial *material;
+} DrawItem;
+
+typedef struct {
+	float screenSize;
+	/** distance from the camera, breaking ties between lights of the same screen size such as ones containing the camera */
+	float distance;
+	ShovelerLight *light;
+} VisibleLight;
+
+typedef struct {
+	GLuint query;
+	/** whether the query was issued and its result hasn't been read back yet */
+	bool pending;
+	/** whether the most recently read back result found no samples passing the depth test */
+	bool occluded;
+} OcclusionQuery;
+
 ShovelerSceneRenderPassOptions createRenderPassOptions(ShovelerScene *scene, RenderMode renderMode);
+static uint64_t computeDrawItemKey(ShovelerCamera *camera, ShovelerModel *model, ShovelerMaterial *material, bool backToFront);
+static int compareDrawItems(const void *firstDrawItemPointer, const void *secondDrawItemPointer);
+static bool canInstanceDrawItems(const DrawItem *firstDrawItem, const DrawItem *secondDrawItem);
+static uint64_t mixHash(uint64_t value);
+static void collectVisibleLights(ShovelerScene *scene, ShovelerCamera *camera);
+static int compareVisibleLights(const void *firstVisibleLightPointer, const void *secondVisibleLightPointer);
+static void updateOcclusionQueries(ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState);
+static bool isModelOccluded(ShovelerScene *scene, ShovelerModel *model);
+static void freeOcclusionQuery(void *occlusionQueryPointer);
 static void freeLight(void *lightPointer);
 static void freeModel(void *modelPointer);
 static void freeShader(void *shaderPointer);
@@ -28,11 +69,43 @@ ShovelerScene *shovelerSceneCreate(ShovelerShaderCache *shaderCache)
 	scene->depthMaterial = shovelerMaterialDepthCreate(shaderCache, /* screenspace */ false);
 	scene->debugMode = false;
 	scene->activeFramebufferSize = shovelerVector2(0.0f, 0.0f);
+	scene->instanced = false;
 	scene->lights = g_hash_table_new_full(g_direct_hash, g_direct_equal, freeLight, NULL);
 	scene->models = g_hash_table_new_full(g_direct_hash, g_direct_equal, freeModel, NULL);
+	scene->statistics.drawItems = 0;
+	scene->statistics.programSwitches = 0;
+	scene->statistics.stateChanges = 0;
+	scene->statistics.instanceBatches = 0;
+	scene->statistics.shadowMapsRendered = 0;
+	scene->statistics.shadowMapsCached = 0;
+	scene->statistics.lightsCulled = 0;
+	scene->statistics.lightsUnshadowed = 0;
+	scene->statistics.shadowAtlasEvictions = 0;
+	scene->statistics.modelsOccluded = 0;
+	scene->lightOptions.maxShadowedLights = 0;
+	scene->lightOptions.shadowMapLevels = 1;
+	scene->lightOptions.shadowMapLevelScreenSize = 0.5f;
+	scene->lightOptions.shadowFilterDownsample = 1;
+	scene->framebufferPool = shovelerFramebufferPoolCreate();
+	scene->shadowAtlas = NULL;
+	scene->shadowFilterChain = NULL;
+	scene->profiler = NULL;
+	scene->occlusionCulling = false;
+	scene->renderQueue = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(DrawItem));
+	scene->instanceBuffer = shovelerInstanceBufferCreate();
+	scene->fallbackCameraUniformBuffer = shovelerUniformBufferCreate(SHOVELER_UNIFORM_BUFFER_BINDING_CAMERA, sizeof(ShovelerCameraUniformBlock), /* fill */ NULL, /* userData */ NULL);
+	scene->fallbackLightUniformBuffer = shovelerUniformBufferCreate(SHOVELER_UNIFORM_BUFFER_BINDING_LIGHT, sizeof(ShovelerLightUniformBlock), /* fill */ NULL, /* userData */ NULL);
+	scene->staticModelsGeneration = 0;
+	scene->visibleLights = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(VisibleLight));
+	scene->occlusionQueries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeOcclusionQuery);
+	scene->occlusionProxyDrawable = NULL;
+	scene->occlusionProxyModel = NULL;
 
 	shovelerUniformMapInsert(scene->uniforms, "sceneDebugMode", shovelerUniformCreateBoolPointer(&scene->debugMode));
 	shovelerUniformMapInsert(scene->uniforms, "framebufferSize", shovelerUniformCreateVector2Pointer(&scene->activeFramebufferSize));
+	shovelerUniformMapInsert(scene->uniforms, "sceneInstanced", shovelerUniformCreateBoolPointer(&scene->instanced));
+	shovelerUniformMapInsert(scene->uniforms, "Camera", shovelerUniformCreateBuffer(scene->fallbackCameraUniformBuffer));
+	shovelerUniformMapInsert(scene->uniforms, "Light", shovelerUniformCreateBuffer(scene->fallbackLightUniformBuffer));
 
 	return scene;
 }
@@ -42,6 +115,14 @@ void shovelerSceneToggleDebugMode(ShovelerScene *scene)
 	scene->debugMode = !scene->debugMode;
 }
 
+void shovelerSceneEnableShadowAtlas(ShovelerScene *scene, int tileWidth, int tileHeight, int columns, int rows)
+{
+	shovelerShadowAtlasFree(scene->shadowAtlas);
+	scene->shadowAtlas = shovelerShadowAtlasCreate(tileWidth, tileHeight, columns, rows);
+
+	shovelerLogInfo("Enabled %dx%d shadow atlas with %dx%d tiles, layered point lights are excluded and keep their own shadow maps.", columns, rows, tileWidth, tileHeight);
+}
+
 bool shovelerSceneAddLight(ShovelerScene *scene, ShovelerLight *light)
 {
 	return g_hash_table_add(scene->lights, light);
@@ -49,22 +130,73 @@ bool shovelerSceneAddLight(ShovelerScene *scene, ShovelerLight *light)
 
 bool shovelerSceneRemoveLight(ShovelerScene *scene, ShovelerLight *light)
 {
+	// hand the light's tiles to other lights right away instead of waiting for them to age out
+	shovelerShadowAtlasReleaseOwner(scene->shadowAtlas, light);
 	return g_hash_table_remove(scene->lights, light);
 }
 
 bool shovelerSceneAddModel(ShovelerScene *scene, ShovelerModel *model)
 {
+	scene->staticModelsGeneration++;
 	return g_hash_table_add(scene->models, model);
 }
 
 bool shovelerSceneRemoveModel(ShovelerScene *scene, ShovelerModel *model)
 {
+	scene->staticModelsGeneration++;
+	g_hash_table_remove(scene->occlusionQueries, model);
 	return g_hash_table_remove(scene->models, model);
 }
 
+void shovelerSceneMarkStaticModelsChanged(ShovelerScene *scene)
+{
+	scene->staticModelsGeneration++;
+}
+
+ShovelerFilterDepthTextureGaussianChain *shovelerSceneGetShadowFilterChain(ShovelerScene *scene)
+{
+	if(scene->shadowFilterChain == NULL) {
+		scene->shadowFilterChain = shovelerFilterDepthTextureGaussianChainCreate(scene->shaderCache);
+		shovelerFilterDepthTextureGaussianChainSetDownsample(scene->shadowFilterChain, scene->lightOptions.shadowFilterDownsample);
+	}
+
+	return scene->shadowFilterChain;
+}
+
+uint64_t shovelerSceneComputeShadowCasterHash(ShovelerScene *scene, const ShovelerFrustum *frustum)
+{
+	uint64_t hash = mixHash(scene->staticModelsGeneration);
+
+	GHashTableIter iter;
+	ShovelerModel *model;
+	g_hash_table_iter_init(&iter, scene->models);
+	while(g_hash_table_iter_next(&iter, (gpointer *) &model, NULL)) {
+		if(!model->dynamic) {
+			continue;
+		}
+
+		if(!shovelerFrustumIntersectSphere(frustum, model->translation, sqrtf(shovelerVector3Dot(model->scale, model->scale)))) {
+			continue;
+		}
+
+		uint64_t modelHash = mixHash((uint64_t) (uintptr_t) model);
+		modelHash = mixHash(modelHash ^ model->version);
+		modelHash = mixHash(modelHash ^ ((uint64_t) model->visible << 0 | (uint64_t) model->castsShadow << 1 | (uint64_t) model->emitter << 2));
+
+		// hash table iteration order is unspecified, so combine model hashes commutatively
+		hash += modelHash;
+	}
+
+	return hash;
+}
+
 int shovelerSceneRenderPass(ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerSceneRenderPassOptions options, ShovelerRenderState *renderState)
 {
-	int rendered = 0;
+	// order dependent blending needs to be drawn back to front, everything else is grouped by state
+	bool backToFront = options.renderState.blend && options.renderState.blendDestinationFactor != GL_ZERO && options.renderState.blendDestinationFactor != GL_ONE;
+
+	// materials can render passes themselves, so only ever work on the part of the queue we appended
+	guint queueStart = scene->renderQueue->len;
 
 	GHashTableIter iter;
 	ShovelerModel *model;
@@ -86,16 +218,74 @@ int shovelerSceneRenderPass(ShovelerScene *scene, ShovelerCamera *camera, Shovel
 			continue;
 		}
 
-		shovelerRenderStateSet(renderState, &options.renderState);
-
-		ShovelerMaterial *material = options.overrideMaterial == NULL ? model->material : options.overrideMaterial;
-		if(!shovelerMaterialRender(material, scene, camera, light, model, renderState)) {
-			model->visible = false;
+		if(options.skipOccluded && isModelOccluded(scene, model)) {
+			scene->statistics.modelsOccluded++;
 			continue;
 		}
 
-		rendered++;
+		DrawItem drawItem;
+		drawItem.model = model;
+		drawItem.material = options.overrideMaterial == NULL ? model->material : options.overrideMaterial;
+		drawItem.key = computeDrawItemKey(camera, model, drawItem.material, backToFront);
+		g_array_append_val(scene->renderQueue, drawItem);
 	}
+
+	guint numDrawItems = scene->renderQueue->len - queueStart;
+	qsort(&g_array_index(scene->renderQueue, DrawItem, queueStart), numDrawItems, sizeof(DrawItem), compareDrawItems);
+	scene->statistics.drawItems += numDrawItems;
+
+	int rendered = 0;
+	GLuint lastProgram = 0;
+	for(guint i = 0; i < numDrawItems; ) {
+		// index again every iteration since nested passes may reallocate the queue
+		DrawItem drawItem = g_array_index(scene->renderQueue, DrawItem, queueStart + i);
+
+		guint numInstances = 1;
+		while(i + numInstances < numDrawItems && canInstanceDrawItems(&drawItem, &g_array_index(scene->renderQueue, DrawItem, queueStart + i + numInstances))) {
+			numInstances++;
+		}
+
+		if(i == 0 || drawItem.material->program != lastProgram) {
+			scene->statistics.programSwitches++;
+			lastProgram = drawItem.material->program;
+		}
+
+		scene->statistics.stateChanges += shovelerRenderStateSet(renderState, &options.renderState);
+
+		if(numInstances > 1) {
+			shovelerInstanceBufferClear(scene->instanceBuffer);
+			for(guint j = 0; j < numInstances; j++) {
+				const DrawItem *instanceDrawItem = &g_array_index(scene->renderQueue, DrawItem, queueStart + i + j);
+				ShovelerVector4 instanceColor = instanceDrawItem->material->instanceColor != NULL ? *instanceDrawItem->material->instanceColor : shovelerVector4(1.0f, 1.0f, 1.0f, 1.0f);
+				shovelerInstanceBufferAddModel(scene->instanceBuffer, instanceDrawItem->model, instanceColor);
+			}
+
+			scene->instanced = true;
+			bool success = shovelerInstanceBufferUpload(scene->instanceBuffer)
+				&& shovelerMaterialRenderInstanced(drawItem.material, scene, camera, light, drawItem.model, scene->instanceBuffer, renderState);
+			scene->instanced = false;
+
+			if(success) {
+				scene->statistics.instanceBatches++;
+				rendered += numInstances;
+			} else {
+				for(guint j = 0; j < numInstances; j++) {
+					g_array_index(scene->renderQueue, DrawItem, queueStart + i + j).model->visible = false;
+				}
+			}
+		} else {
+			if(shovelerMaterialRender(drawItem.material, scene, camera, light, drawItem.model, renderState)) {
+				rendered++;
+			} else {
+				drawItem.model->visible = false;
+			}
+		}
+
+		i += numInstances;
+	}
+
+	g_array_set_size(scene->renderQueue, queueStart);
+
 	return rendered;
 }
 
@@ -103,26 +293,80 @@ int shovelerSceneRenderFrame(ShovelerScene *scene, ShovelerCamera *camera, Shove
 {
 	int rendered = 0;
 
+	scene->statistics.drawItems = 0;
+	scene->statistics.programSwitches = 0;
+	scene->statistics.stateChanges = 0;
+	scene->statistics.instanceBatches = 0;
+	scene->statistics.shadowMapsRendered = 0;
+	scene->statistics.shadowMapsCached = 0;
+	scene->statistics.lightsCulled = 0;
+	scene->statistics.lightsUnshadowed = 0;
+	scene->statistics.shadowAtlasEvictions = 0;
+	scene->statistics.modelsOccluded = 0;
+
+	if(scene->shadowAtlas != NULL) {
+		shovelerShadowAtlasBeginFrame(scene->shadowAtlas);
+	}
+
 	shovelerFramebufferUse(framebuffer);
 	scene->activeFramebufferSize = shovelerVector2(framebuffer->width, framebuffer->height);
 
+	shovelerProfilerBeginScope(scene->profiler, "depth pass");
 	shovelerRenderStateSetDepthMask(renderState, GL_TRUE);
 	glClearDepth(1.0f);
 	glClear(GL_DEPTH_BUFFER_BIT);
 	rendered += shovelerSceneRenderPass(scene, camera, NULL, createRenderPassOptions(scene, RENDER_MODE_OCCLUDED), renderState);
 
+	if(scene->occlusionCulling && camera != NULL) {
+		updateOcclusionQueries(scene, camera, renderState);
+	}
+
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
+	shovelerProfilerEndScope(scene->profiler);
 
-	GHashTableIter iter;
-	ShovelerLight *light;
-	g_hash_table_iter_init(&iter, scene->lights);
-	while(g_hash_table_iter_next(&iter, (gpointer *) &light, NULL)) {
+	collectVisibleLights(scene, camera);
+
+	if(scene->shadowFilterChain != NULL) {
+		shovelerFilterDepthTextureGaussianChainSetDownsample(scene->shadowFilterChain, scene->lightOptions.shadowFilterDownsample);
+	}
+
+	for(guint i = 0; i < scene->visibleLights->len; i++) {
+		ShovelerLight *light = g_array_index(scene->visibleLights, VisibleLight, i).light;
+		if(!light->shadowed) {
+			continue;
+		}
+
+		shovelerProfilerBeginScope(scene->profiler, "light %p shadow map", (void *) light);
+		rendered += shovelerLightRenderShadowMap(light, scene, camera, renderState);
+		shovelerProfilerEndScope(scene->profiler);
+	}
+
+	if(scene->shadowFilterChain != NULL) {
+		shovelerProfilerBeginScope(scene->profiler, "shadow filter chain");
+		rendered += shovelerFilterDepthTextureGaussianChainRender(scene->shadowFilterChain, renderState);
+		shovelerProfilerEndScope(scene->profiler);
+	}
+
+	for(guint i = 0; i < scene->visibleLights->len; i++) {
+		ShovelerLight *light = g_array_index(scene->visibleLights, VisibleLight, i).light;
+
+		shovelerProfilerBeginScope(scene->profiler, "light %p", (void *) light);
 		rendered += shovelerLightRender(light, scene, camera, framebuffer, createRenderPassOptions(scene, RENDER_MODE_ADDITIVE_LIGHT), renderState);
+		shovelerProfilerEndScope(scene->profiler);
 	}
 
+	shovelerProfilerBeginScope(scene->profiler, "emitters pass");
 	rendered += shovelerSceneRenderPass(scene, camera, NULL, createRenderPassOptions(scene, RENDER_MODE_EMITTERS), renderState);
+	shovelerProfilerEndScope(scene->profiler);
+
+	shovelerProfilerBeginScope(scene->profiler, "screenspace pass");
 	rendered += shovelerSceneRenderPass(scene, camera, NULL, createRenderPassOptions(scene, RENDER_MODE_SCREENSPACE), renderState);
+	shovelerProfilerEndScope(scene->profiler);
+
+	if(scene->shadowAtlas != NULL) {
+		scene->statistics.shadowAtlasEvictions = scene->shadowAtlas->evictions;
+	}
 
 	return rendered;
 }
@@ -169,10 +413,23 @@ void shovelerSceneFree(ShovelerScene *scene)
 {
 	shovelerShaderCacheInvalidateScene(scene->shaderCache, scene);
 
+	g_hash_table_destroy(scene->occlusionQueries);
 	g_hash_table_destroy(scene->models);
 	g_hash_table_destroy(scene->lights);
+	shovelerShadowAtlasFree(scene->shadowAtlas);
+	shovelerFilterDepthTextureGaussianChainFree(scene->shadowFilterChain);
+	shovelerFramebufferPoolFree(scene->framebufferPool);
+	shovelerInstanceBufferFree(scene->instanceBuffer);
+	g_array_free(scene->visibleLights, /* freeSegment */ true);
+	g_array_free(scene->renderQueue, /* freeSegment */ true);
+	if(scene->occlusionProxyModel != NULL) {
+		shovelerModelFree(scene->occlusionProxyModel);
+		shovelerDrawableFree(scene->occlusionProxyDrawable);
+	}
 	shovelerMaterialFree(scene->depthMaterial);
 	shovelerUniformMapFree(scene->uniforms);
+	shovelerUniformBufferFree(scene->fallbackLightUniformBuffer);
+	shovelerUniformBufferFree(scene->fallbackCameraUniformBuffer);
 	free(scene);
 }
 
@@ -183,6 +440,7 @@ ShovelerSceneRenderPassOptions createRenderPassOptions(ShovelerScene *scene, Ren
 	options.emitters = false;
 	options.screenspace = false;
 	options.onlyShadowCasters = false;
+	options.skipOccluded = false;
 	options.renderState.blend = true;
 	options.renderState.blendSourceFactor = GL_ONE;
 	options.renderState.blendDestinationFactor = GL_ZERO;
@@ -214,6 +472,7 @@ ShovelerSceneRenderPassOptions createRenderPassOptions(ShovelerScene *scene, Ren
 			options.renderState.blendDestinationFactor = GL_ONE;
 			options.renderState.depthFunction = GL_EQUAL;
 			options.renderState.depthMask = GL_TRUE;
+			options.skipOccluded = scene->occlusionCulling;
 		break;
 	}
 
@@ -224,6 +483,252 @@ ShovelerSceneRenderPassOptions createRenderPassOptions(ShovelerScene *scene, Ren
 	return options;
 }
 
+/**
+ * Packs a draw item's state into a sortable key.
+ *
+ * The key consists of 16 bits each of program, material id, drawable id and view depth, so that models sharing material
+ * and drawable end up next to each other and can be instanced. Materials passing their color per instance leave out their id
+ * so that they only group by program and drawable. Sequential ids only collide once more than 65536 of them
+ * are alive, unlike truncated pointers, and keep the order stable across runs. If the items need to be drawn back to front, the inverted
+ * depth takes the most significant bits instead.
+ */
+static uint64_t computeDrawItemKey(ShovelerCamera *camera, ShovelerModel *model, ShovelerMaterial *material, bool backToFront)
+{
+	uint32_t depthBits = 0;
+	if(camera != NULL) {
+		ShovelerVector3 delta = shovelerVector3LinearCombination(1.0f, model->translation, -1.0f, camera->position);
+		float squaredDistance = shovelerVector3Dot(delta, delta);
+
+		// non-negative IEEE floats order the same as their bit patterns
+		uint32_t squaredDistanceBits;
+		memcpy(&squaredDistanceBits, &squaredDistance, sizeof(uint32_t));
+		depthBits = squaredDistanceBits >> 16;
+	}
+
+	uint64_t programBits = material->program & 0xffff;
+	uint64_t materialBits = material->instanceColor != NULL ? 0 : material->id & 0xffff;
+	uint64_t drawableBits = model->drawable->id & 0xffff;
+
+	if(backToFront) {
+		return ((uint64_t) (~depthBits & 0xffff) << 48) | (programBits << 32) | (materialBits << 16) | drawableBits;
+	}
+
+	return (programBits << 48) | (materialBits << 32) | (drawableBits << 16) | depthBits;
+}
+
+static int compareDrawItems(const void *firstDrawItemPointer, const void *secondDrawItemPointer)
+{
+	const DrawItem *firstDrawItem = firstDrawItemPointer;
+	const DrawItem *secondDrawItem = secondDrawItemPointer;
+
+	if(firstDrawItem->key != secondDrawItem->key) {
+		return firstDrawItem->key < secondDrawItem->key ? -1 : 1;
+	}
+
+	// break ties by model so the order stays the same across frames
+	if(firstDrawItem->model != secondDrawItem->model) {
+		return (uintptr_t) firstDrawItem->model < (uintptr_t) secondDrawItem->model ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static bool canInstanceDrawItems(const DrawItem *firstDrawItem, const DrawItem *secondDrawItem)
+{
+	bool sameMaterial = firstDrawItem->material == secondDrawItem->material
+		|| (firstDrawItem->material->instanceColor != NULL
+			&& secondDrawItem->material->instanceColor != NULL
+			&& firstDrawItem->material->program == secondDrawItem->material->program
+			&& firstDrawItem->material->screenspace == secondDrawItem->material->screenspace
+			&& firstDrawItem->material->renderInstanced == secondDrawItem->material->renderInstanced);
+
+	return sameMaterial
+		&& firstDrawItem->material->renderInstanced != NULL
+		&& firstDrawItem->model->drawable == secondDrawItem->model->drawable
+		&& firstDrawItem->model->drawable->drawInstanced != NULL
+		&& firstDrawItem->model->polygonMode == secondDrawItem->model->polygonMode;
+}
+
+static uint64_t mixHash(uint64_t value)
+{
+	// splitmix64 finalizer
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+/**
+ * Collects the lights whose range intersects the camera frustum sorted by descending screen space size, lets only up to the
+ * configured maximum number of shadowed lights cast shadows, and assigns them shadow map resolution levels by their screen size.
+ */
+static void collectVisibleLights(ShovelerScene *scene, ShovelerCamera *camera)
+{
+	g_array_set_size(scene->visibleLights, 0);
+
+	// scenes rendered without a camera, such as offscreen canvases, are unlit
+	if(camera == NULL) {
+		return;
+	}
+
+	// vertical projection scale, mapping a size at unit distance to normalized device coordinates spanning the viewport twice
+	float projectionScale = fabsf(shovelerMatrixGet(camera->projection, 1, 1));
+
+	GHashTableIter iter;
+	ShovelerLight *light;
+	g_hash_table_iter_init(&iter, scene->lights);
+	while(g_hash_table_iter_next(&iter, (gpointer *) &light, NULL)) {
+		ShovelerVector3 position = shovelerLightGetPosition(light);
+		float range = shovelerLightGetRange(light);
+		if(!shovelerFrustumIntersectSphere(&camera->frustum, position, range)) {
+			scene->statistics.lightsCulled++;
+			continue;
+		}
+
+		ShovelerVector3 cameraToLight = shovelerVector3LinearCombination(1.0f, position, -1.0f, camera->position);
+		float distance = sqrtf(shovelerVector3Dot(cameraToLight, cameraToLight));
+
+		VisibleLight visibleLight;
+		visibleLight.light = light;
+		visibleLight.distance = distance;
+		if(distance <= range) {
+			visibleLight.screenSize = INFINITY; // camera is within the light's range
+		} else {
+			visibleLight.screenSize = 0.5f * range * projectionScale / distance;
+		}
+		g_array_append_val(scene->visibleLights, visibleLight);
+	}
+
+	qsort(scene->visibleLights->data, scene->visibleLights->len, sizeof(VisibleLight), compareVisibleLights);
+
+	for(guint i = 0; i < scene->visibleLights->len; i++) {
+		VisibleLight *visibleLight = &g_array_index(scene->visibleLights, VisibleLight, i);
+
+		visibleLight->light->shadowed = scene->lightOptions.maxShadowedLights <= 0 || i < (guint) scene->lightOptions.maxShadowedLights;
+		if(!visibleLight->light->shadowed) {
+			scene->statistics.lightsUnshadowed++;
+		}
+
+		int level = 0;
+		float levelScreenSize = scene->lightOptions.shadowMapLevelScreenSize;
+		while(level < scene->lightOptions.shadowMapLevels - 1 && visibleLight->screenSize < levelScreenSize) {
+			level++;
+			levelScreenSize *= 0.5f;
+		}
+		visibleLight->light->shadowMapLevel = level;
+	}
+}
+
+static int compareVisibleLights(const void *firstVisibleLightPointer, const void *secondVisibleLightPointer)
+{
+	const VisibleLight *firstVisibleLight = firstVisibleLightPointer;
+	const VisibleLight *secondVisibleLight = secondVisibleLightPointer;
+
+	if(firstVisibleLight->screenSize > secondVisibleLight->screenSize) {
+		return -1;
+	} else if(firstVisibleLight->screenSize < secondVisibleLight->screenSize) {
+		return 1;
+	} else if(firstVisibleLight->distance < secondVisibleLight->distance) {
+		return -1;
+	} else if(firstVisibleLight->distance > secondVisibleLight->distance) {
+		return 1;
+	} else {
+		return 0;
+	}
+}
+
+/**
+ * Reads back the occlusion query results that became available since the last frame and issues new queries for all
+ * opaque models that don't have one in flight, drawing their bounding box against the depth buffer of the depth pass.
+ *
+ * Like in shovelerSceneComputeShadowCasterHash, a model's bounds are assumed to be a sphere centered at its translation
+ * with the length of its scale as radius, which fits into an axis aligned box of the same half extent.
+ */
+static void updateOcclusionQueries(ShovelerScene *scene, ShovelerCamera *camera, ShovelerRenderState *renderState)
+{
+	if(scene->occlusionProxyModel == NULL) {
+		scene->occlusionProxyDrawable = shovelerDrawableCubeCreate();
+		scene->occlusionProxyModel = shovelerModelCreate(scene->occlusionProxyDrawable, scene->depthMaterial);
+	}
+
+	// the proxy boxes only test against the depth pass without changing it, and color is cleared right after
+	ShovelerRenderState queryRenderState;
+	queryRenderState.blend = false;
+	queryRenderState.blendSourceFactor = GL_ONE;
+	queryRenderState.blendDestinationFactor = GL_ZERO;
+	queryRenderState.depthTest = true;
+	queryRenderState.depthFunction = GL_LEQUAL;
+	queryRenderState.depthMask = GL_FALSE;
+	scene->statistics.stateChanges += shovelerRenderStateSet(renderState, &queryRenderState);
+
+	// boxes reaching into the near plane would be clipped, so treat the camera as being inside them
+	ShovelerVector3 cameraToNearCorner = shovelerVector3LinearCombination(1.0f, camera->frustum.nearTopLeftVertex, -1.0f, camera->position);
+	float nearMargin = sqrtf(shovelerVector3Dot(cameraToNearCorner, cameraToNearCorner));
+
+	GHashTableIter iter;
+	ShovelerModel *model;
+	g_hash_table_iter_init(&iter, scene->models);
+	while(g_hash_table_iter_next(&iter, (gpointer *) &model, NULL)) {
+		if(!model->visible || model->emitter || model->material->screenspace) {
+			continue;
+		}
+
+		OcclusionQuery *occlusionQuery = g_hash_table_lookup(scene->occlusionQueries, model);
+		if(occlusionQuery == NULL) {
+			occlusionQuery = malloc(sizeof(OcclusionQuery));
+			glGenQueries(1, &occlusionQuery->query);
+			occlusionQuery->pending = false;
+			occlusionQuery->occluded = false;
+			g_hash_table_insert(scene->occlusionQueries, model, occlusionQuery);
+		}
+
+		if(occlusionQuery->pending) {
+			GLuint available = GL_FALSE;
+			glGetQueryObjectuiv(occlusionQuery->query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if(!available) {
+				// keep using the previous result rather than waiting for the GPU to catch up
+				continue;
+			}
+
+			GLuint anySamplesPassed = GL_TRUE;
+			glGetQueryObjectuiv(occlusionQuery->query, GL_QUERY_RESULT, &anySamplesPassed);
+			occlusionQuery->occluded = !anySamplesPassed;
+			occlusionQuery->pending = false;
+		}
+
+		float halfExtent = sqrtf(shovelerVector3Dot(model->scale, model->scale));
+		ShovelerVector3 delta = shovelerVector3LinearCombination(1.0f, camera->position, -1.0f, model->translation);
+		float insideExtent = halfExtent + nearMargin;
+		if(fabsf(delta.values[0]) <= insideExtent && fabsf(delta.values[1]) <= insideExtent && fabsf(delta.values[2]) <= insideExtent) {
+			occlusionQuery->occluded = false;
+			continue;
+		}
+
+		ShovelerModel *proxyModel = scene->occlusionProxyModel;
+		proxyModel->translation = model->translation;
+		proxyModel->scale = shovelerVector3(halfExtent, halfExtent, halfExtent);
+		shovelerModelUpdateTransformation(proxyModel);
+
+		glBeginQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, occlusionQuery->query);
+		bool success = shovelerMaterialRender(scene->depthMaterial, scene, camera, NULL, proxyModel, renderState);
+		glEndQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE);
+
+		if(success) {
+			occlusionQuery->pending = true;
+		} else {
+			occlusionQuery->occluded = false;
+		}
+	}
+}
+
+static bool isModelOccluded(ShovelerScene *scene, ShovelerModel *model)
+{
+	OcclusionQuery *occlusionQuery = g_hash_table_lookup(scene->occlusionQueries, model);
+	return occlusionQuery != NULL && occlusionQuery->occluded;
+}
+
 static void freeLight(void *lightPointer)
 {
 	ShovelerLight *light = lightPointer;
@@ -245,3 +750,10 @@ static void freeShader(void *shaderPointer)
 {
 	shovelerShaderFree(shaderPointer);
 }
+
+static void freeOcclusionQuery(void *occlusionQueryPointer)
+{
+	OcclusionQuery *occlusionQuery = occlusionQueryPointer;
+	glDeleteQueries(1, &occlusionQuery->query);
+	free(occlusionQuery);
+}
@@ -10,8 +10,11 @@
 #include "shoveler/opengl.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader.h"
+#include "shoveler/shader_cache.h"
 #include "shoveler/uniform_attachment.h"
+#include "shoveler/uniform_buffer.h"
 
+static bool attachUniformBlock(ShovelerShader *shader, const char *name, ShovelerUniform *uniform);
 static void freeAttachment(void *attachmentPointer);
 
 guint shovelerShaderKeyHash(gconstpointer shaderKeyPointer)
@@ -39,11 +42,16 @@ ShovelerShader *shovelerShaderCreate(ShovelerShaderKey shaderKey, ShovelerMateri
 	shader->key = shaderKey;
 	shader->material = material;
 	shader->attachments = g_hash_table_new_full(g_str_hash, g_str_equal, free, freeAttachment);
+	shader->attachmentList = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerUniformAttachment *));
 	return shader;
 }
 
 bool shovelerShaderAttachUniform(ShovelerShader *shader, const char *name, ShovelerUniform *uniform)
 {
+	if(uniform->type == SHOVELER_UNIFORM_TYPE_BUFFER) {
+		return attachUniformBlock(shader, name, uniform);
+	}
+
 	GLint location = glGetUniformLocation(shader->material->program, name);
 	if(!shovelerOpenGLCheckSuccess()) {
 		return false;
@@ -55,8 +63,10 @@ bool shovelerShaderAttachUniform(ShovelerShader *shader, const char *name, Shove
 		return false;
 	}
 
-	ShovelerUniformAttachment *uniformAttachment = shovelerUniformAttachmentCreate(uniform, location);
+	ShovelerUniformCacheEntry *cacheEntry = shovelerShaderCacheGetUniformCacheEntry(shader->material->shaderCache, shader->material->program, location);
+	ShovelerUniformAttachment *uniformAttachment = shovelerUniformAttachmentCreate(uniform, location, cacheEntry);
 	g_hash_table_insert(shader->attachments, strdup(name), uniformAttachment);
+	g_array_append_val(shader->attachmentList, uniformAttachment);
 
 	shovelerLogTrace("Attached uniform '%s' to material %p with shader program %d.", name, shader->material, shader->material->program);
 	return true;
@@ -64,28 +74,53 @@ bool shovelerShaderAttachUniform(ShovelerShader *shader, const char *name, Shove
 
 bool shovelerShaderUse(ShovelerShader *shader)
 {
-	glUseProgram(shader->material->program);
+	shovelerShaderCacheUseProgram(shader->material->shaderCache, shader->material->program);
 
 	GLuint textureUnitIndexCounter = 0;
-	GHashTableIter iter;
-	char *name;
-	ShovelerUniformAttachment *uniformAttachment;
-	g_hash_table_iter_init(&iter, shader->attachments);
-	while(g_hash_table_iter_next(&iter, (gpointer *) &name, (gpointer *) &uniformAttachment)) {
+	for(guint i = 0; i < shader->attachmentList->len; i++) {
+		ShovelerUniformAttachment *uniformAttachment = g_array_index(shader->attachmentList, ShovelerUniformAttachment *, i);
 		if(!shovelerUniformAttachmentUse(uniformAttachment, &textureUnitIndexCounter)) {
-			shovelerLogError("Failed to use uniform attachment '%s' when trying to use shader", name);
+			shovelerLogError("Failed to use uniform attachment at location %d when trying to use shader", uniformAttachment->location);
 			return false;
 		}
 	}
-	return shovelerOpenGLCheckSuccess();
+	return true;
 }
 
 void shovelerShaderFree(ShovelerShader *shader)
 {
+	g_array_free(shader->attachmentList, /* freeSegment */ true);
 	g_hash_table_destroy(shader->attachments);
 	free(shader);
 }
 
+static bool attachUniformBlock(ShovelerShader *shader, const char *name, ShovelerUniform *uniform)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(shader->material->program, name);
+	if(!shovelerOpenGLCheckSuccess()) {
+		return false;
+	} else if(blockIndex == GL_INVALID_INDEX) {
+		shovelerLogTrace("Material %p with shader program %d does not have a uniform block '%s', skipping.", shader->material, shader->material->program, name);
+		return false;
+	} else if(g_hash_table_contains(shader->attachments, name)) {
+		shovelerLogTrace("Material %p with shader program %d already contains an attachment for block '%s', skipping.", shader->material, shader->material->program, name);
+		return false;
+	}
+
+	// block bindings are program state, so this only needs to happen once per program and block
+	glUniformBlockBinding(shader->material->program, blockIndex, uniform->value.bufferValue->binding);
+	if(!shovelerOpenGLCheckSuccess()) {
+		return false;
+	}
+
+	ShovelerUniformAttachment *uniformAttachment = shovelerUniformAttachmentCreate(uniform, (GLint) blockIndex, NULL);
+	g_hash_table_insert(shader->attachments, strdup(name), uniformAttachment);
+	g_array_append_val(shader->attachmentList, uniformAttachment);
+
+	shovelerLogTrace("Attached uniform block '%s' to material %p with shader program %d.", name, shader->material, shader->material->program);
+	return true;
+}
+
 static void freeAttachment(void *attachmentPointer)
 {
 	shovelerUniformAttachmentFree(attachmentPointer);
@@ -1,5 +1,7 @@
 #include <assert.h> // assert
+#include <stdint.h> // uintptr_t
 #include <stdlib.h> // malloc free
+#include <string.h> // strdup
 
 #include "shoveler/camera.h"
 #include "shoveler/light.h"
@@ -10,6 +12,7 @@
 
 static void freeShader(void *shaderPointer);
 static void freeSet(void *setPointer);
+static void freeUniformCacheEntries(void *uniformCacheEntriesPointer);
 
 ShovelerShaderCache *shovelerShaderCacheCreate()
 {
@@ -26,6 +29,9 @@ ShovelerShaderCache *shovelerShaderCacheCreateWithCustomFree(ShovelerShaderCache
 	cache->modelShaderKeys = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeSet);
 	cache->materialShaderKeys = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeSet);
 	cache->userDataShaderKeys = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeSet);
+	cache->programUniformCacheEntries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeUniformCacheEntries);
+	cache->usedProgram = 0;
+	cache->sharedPrograms = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
 
 	return cache;
 }
@@ -220,8 +226,74 @@ void shovelerShaderCacheInvalidateUserData(ShovelerShaderCache *cache, void *use
 	}
 }
 
+ShovelerUniformCacheEntry *shovelerShaderCacheGetUniformCacheEntry(ShovelerShaderCache *cache, GLuint program, GLint location)
+{
+	GHashTable *uniformCacheEntries = g_hash_table_lookup(cache->programUniformCacheEntries, (gpointer) (uintptr_t) program);
+	if(uniformCacheEntries == NULL) {
+		uniformCacheEntries = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+		g_hash_table_insert(cache->programUniformCacheEntries, (gpointer) (uintptr_t) program, uniformCacheEntries);
+	}
+
+	ShovelerUniformCacheEntry *cacheEntry = g_hash_table_lookup(uniformCacheEntries, (gpointer) (intptr_t) location);
+	if(cacheEntry == NULL) {
+		cacheEntry = malloc(sizeof(ShovelerUniformCacheEntry));
+		cacheEntry->valid = false;
+		g_hash_table_insert(uniformCacheEntries, (gpointer) (intptr_t) location, cacheEntry);
+	}
+
+	return cacheEntry;
+}
+
+bool shovelerShaderCacheUseProgram(ShovelerShaderCache *cache, GLuint program)
+{
+	if(program == cache->usedProgram) {
+		return false;
+	}
+
+	glUseProgram(program);
+	cache->usedProgram = program;
+	return true;
+}
+
+void shovelerShaderCacheInvalidateProgram(ShovelerShaderCache *cache, GLuint program)
+{
+	// attachments keep pointing to the entries, so only mark them stale instead of freeing them
+	GHashTable *uniformCacheEntries = g_hash_table_lookup(cache->programUniformCacheEntries, (gpointer) (uintptr_t) program);
+	if(uniformCacheEntries != NULL) {
+		GHashTableIter iter;
+		ShovelerUniformCacheEntry *cacheEntry;
+		g_hash_table_iter_init(&iter, uniformCacheEntries);
+		while(g_hash_table_iter_next(&iter, NULL, (gpointer *) &cacheEntry)) {
+			cacheEntry->valid = false;
+		}
+	}
+
+	if(cache->usedProgram == program) {
+		cache->usedProgram = 0;
+	}
+}
+
+GLuint shovelerShaderCacheGetSharedProgram(ShovelerShaderCache *cache, const char *name)
+{
+	return (GLuint) (uintptr_t) g_hash_table_lookup(cache->sharedPrograms, name);
+}
+
+void shovelerShaderCacheSetSharedProgram(ShovelerShaderCache *cache, const char *name, GLuint program)
+{
+	assert(!g_hash_table_contains(cache->sharedPrograms, name));
+	g_hash_table_insert(cache->sharedPrograms, strdup(name), (gpointer) (uintptr_t) program);
+}
+
 void shovelerShaderCacheFree(ShovelerShaderCache *cache)
 {
+	GHashTableIter iter;
+	gpointer programPointer;
+	g_hash_table_iter_init(&iter, cache->sharedPrograms);
+	while(g_hash_table_iter_next(&iter, NULL, &programPointer)) {
+		glDeleteProgram((GLuint) (uintptr_t) programPointer);
+	}
+	g_hash_table_destroy(cache->sharedPrograms);
+
 	g_hash_table_destroy(cache->userDataShaderKeys);
 	g_hash_table_destroy(cache->materialShaderKeys);
 	g_hash_table_destroy(cache->modelShaderKeys);
@@ -229,6 +301,7 @@ void shovelerShaderCacheFree(ShovelerShaderCache *cache)
 	g_hash_table_destroy(cache->cameraShaderKeys);
 	g_hash_table_destroy(cache->sceneShaderKeys);
 	g_hash_table_destroy(cache->shaders);
+	g_hash_table_destroy(cache->programUniformCacheEntries);
 	free(cache);
 }
 
@@ -243,3 +316,9 @@ static void freeSet(void *setPointer)
 	GHashTable *set = setPointer;
 	g_hash_table_destroy(set);
 }
+
+static void freeUniformCacheEntries(void *uniformCacheEntriesPointer)
+{
+	GHashTable *uniformCacheEntries = uniformCacheEntriesPointer;
+	g_hash_table_destroy(uniformCacheEntries);
+}
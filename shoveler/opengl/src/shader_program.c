@@ -1,4 +1,8 @@
-#include <stdlib.h> // free
+#include <errno.h> // errno
+#include <stdint.h> // uint32_t uint64_t uintptr_t
+#include <stdio.h> // FILE fopen fread fwrite fclose
+#include <stdlib.h> // malloc free
+#include <string.h> // memcmp memcpy memset strdup strerror strlen
 
 #include <glib.h>
 
@@ -7,25 +11,71 @@
 #include "shoveler/opengl.h"
 #include "shoveler/shader_program.h"
 
+/** must be bumped whenever the cache file layout or the attribute bindings change to invalidate existing entries */
+#define BINARY_CACHE_VERSION 3
+#define BINARY_CACHE_MAGIC "SHVPROGB"
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t binaryFormat;
+	uint64_t key;
+	uint64_t binaryHash;
+	uint64_t binarySize;
+} BinaryCacheHeader;
+
+static bool compileShader(GLuint shader);
+static void bindAttributeLocations(GLuint program);
+static uint64_t computeProgramKey(GLuint vertexShader, GLuint geometryShader, GLuint fragmentShader);
+static uint64_t hashShaderSource(uint64_t hash, GLuint shader);
+static uint64_t hashString(uint64_t hash, const char *string);
+static uint64_t hashBytes(uint64_t hash, const void *bytes, size_t size);
+static char *getBinaryCacheFilename(uint64_t key);
+static bool isBinaryFormatSupported(GLenum binaryFormat);
+static bool loadProgramBinary(GLuint program, uint64_t key);
+static void storeProgramBinary(GLuint program, uint64_t key);
+
+static char *binaryCacheDirectory = NULL;
+/** set of shaders whose compilation was deferred until they are linked into a program */
+static GHashTable *deferredShaders = NULL;
+
+void shovelerShaderProgramEnableBinaryCache(const char *directory)
+{
+	free(binaryCacheDirectory);
+	binaryCacheDirectory = strdup(directory);
+
+	if(deferredShaders == NULL) {
+		deferredShaders = g_hash_table_new(g_direct_hash, g_direct_equal);
+	}
+
+	shovelerLogInfo("Enabled program binary cache in directory '%s'.", directory);
+}
+
+void shovelerShaderProgramDisableBinaryCache()
+{
+	free(binaryCacheDirectory);
+	binaryCacheDirectory = NULL;
+
+	// shaders created while the cache was enabled still get compiled when linked, so keep tracking them until then
+	if(deferredShaders != NULL && g_hash_table_size(deferredShaders) == 0) {
+		g_hash_table_destroy(deferredShaders);
+		deferredShaders = NULL;
+	}
+}
+
 GLuint shovelerShaderProgramCompileFromString(const char *source, GLenum type)
 {
 	GLuint shader = glCreateShader(type);
 	glShaderSource(shader, 1, &source, NULL);
-	glCompileShader(shader);
 
-	GLint status;
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-	if(status == 0) {
-		GLint length;
-		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-		char *errorstr = malloc(length * sizeof(char));
-		glGetShaderInfoLog(shader, length, NULL, errorstr);
-		shovelerLogError("Failed to compile shader: %s.", errorstr);
-		free(errorstr);
-		return 0;
+	if(binaryCacheDirectory != NULL) {
+		g_hash_table_add(deferredShaders, (gpointer) (uintptr_t) shader);
+		return shader;
 	}
 
-	if(!shovelerOpenGLCheckSuccess()) {
+	if(!compileShader(shader)) {
 		return 0;
 	}
 
@@ -60,22 +110,49 @@ GLuint shovelerShaderProgramLink(GLuint vertexShader, GLuint geometryShader, GLu
 		glAttachShader(program, fragmentShader);
 	}
 
-	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, "position");
-	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_NORMAL, "normal");
-	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, "uv");
+	bindAttributeLocations(program);
 
-	glLinkProgram(program);
+	bool useBinaryCache = binaryCacheDirectory != NULL;
+	uint64_t key = 0;
+	bool loaded = false;
+	if(useBinaryCache) {
+		key = computeProgramKey(vertexShader, geometryShader, fragmentShader);
+		loaded = loadProgramBinary(program, key);
+	}
 
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if(status == 0) {
-		GLint length;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
-		char *errorstr = malloc(length * sizeof(char));
-		glGetProgramInfoLog(program, length, NULL, errorstr);
-		shovelerLogError("Failed to link shader program: %s.", errorstr);
-		free(errorstr);
-		return 0;
+	if(!loaded) {
+		GLuint shaders[] = {vertexShader, geometryShader, fragmentShader};
+		for(int i = 0; i < 3; i++) {
+			if(shaders[i] == 0 || deferredShaders == NULL) {
+				continue;
+			}
+
+			if(g_hash_table_remove(deferredShaders, (gpointer) (uintptr_t) shaders[i]) && !compileShader(shaders[i])) {
+				return 0;
+			}
+		}
+
+		if(useBinaryCache) {
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		glLinkProgram(program);
+
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if(status == 0) {
+			GLint length;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+			char *errorstr = malloc(length * sizeof(char));
+			glGetProgramInfoLog(program, length, NULL, errorstr);
+			shovelerLogError("Failed to link shader program: %s.", errorstr);
+			free(errorstr);
+			return 0;
+		}
+
+		if(useBinaryCache) {
+			storeProgramBinary(program, key);
+		}
 	}
 
 	if(!shovelerOpenGLCheckSuccess()) {
@@ -83,6 +160,12 @@ GLuint shovelerShaderProgramLink(GLuint vertexShader, GLuint geometryShader, GLu
 	}
 
 	if(deleteShaders) {
+		if(deferredShaders != NULL) {
+			g_hash_table_remove(deferredShaders, (gpointer) (uintptr_t) vertexShader);
+			g_hash_table_remove(deferredShaders, (gpointer) (uintptr_t) geometryShader);
+			g_hash_table_remove(deferredShaders, (gpointer) (uintptr_t) fragmentShader);
+		}
+
 		glDeleteShader(vertexShader);
 		glDeleteShader(geometryShader);
 		glDeleteShader(fragmentShader);
@@ -92,3 +175,226 @@ GLuint shovelerShaderProgramLink(GLuint vertexShader, GLuint geometryShader, GLu
 
 	return program;
 }
+
+static bool compileShader(GLuint shader)
+{
+	glCompileShader(shader);
+
+	GLint status;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if(status == 0) {
+		GLint length;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+		char *errorstr = malloc(length * sizeof(char));
+		glGetShaderInfoLog(shader, length, NULL, errorstr);
+		shovelerLogError("Failed to compile shader: %s.", errorstr);
+		free(errorstr);
+		return false;
+	}
+
+	if(!shovelerOpenGLCheckSuccess()) {
+		return false;
+	}
+
+	return true;
+}
+
+static void bindAttributeLocations(GLuint program)
+{
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_POSITION, "position");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_NORMAL, "normal");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, "uv");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL, "instanceModel");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_MODEL_NORMAL, "instanceModelNormal");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_UV, "spriteUv");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_TILE, "spriteTile");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE_POSITION, "tilePosition");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_TILE, "tile");
+	glBindAttribLocation(program, SHOVELER_SHADER_PROGRAM_ATTRIBUTE_INSTANCE_COLOR, "instanceColor");
+}
+
+/** Hashes everything a linked program binary depends on: the shader sources and the driver that compiled them. */
+static uint64_t computeProgramKey(GLuint vertexShader, GLuint geometryShader, GLuint fragmentShader)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	uint32_t version = BINARY_CACHE_VERSION;
+	hash = hashBytes(hash, &version, sizeof(version));
+	hash = hashString(hash, (const char *) glGetString(GL_VENDOR));
+	hash = hashString(hash, (const char *) glGetString(GL_RENDERER));
+	hash = hashString(hash, (const char *) glGetString(GL_VERSION));
+	hash = hashString(hash, (const char *) glGetString(GL_SHADING_LANGUAGE_VERSION));
+	hash = hashShaderSource(hash, vertexShader);
+	hash = hashShaderSource(hash, geometryShader);
+	hash = hashShaderSource(hash, fragmentShader);
+	return hash;
+}
+
+static uint64_t hashShaderSource(uint64_t hash, GLuint shader)
+{
+	if(shader == 0) {
+		// still separate the stages so that moving a source to another stage changes the key
+		return hashString(hash, "");
+	}
+
+	GLint sourceLength = 0;
+	glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &sourceLength);
+
+	char *source = malloc((size_t) sourceLength + 1);
+	source[0] = '\0';
+	glGetShaderSource(shader, sourceLength + 1, NULL, source);
+	hash = hashString(hash, source);
+	free(source);
+
+	return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const char *string)
+{
+	if(string == NULL) {
+		string = "";
+	}
+
+	// include the terminator so that consecutive strings can't run into each other
+	return hashBytes(hash, string, strlen(string) + 1);
+}
+
+/** FNV-1a, see http://www.isthe.com/chongo/tech/comp/fnv/ */
+static uint64_t hashBytes(uint64_t hash, const void *bytes, size_t size)
+{
+	const unsigned char *data = bytes;
+	for(size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static char *getBinaryCacheFilename(uint64_t key)
+{
+	GString *filename = g_string_new("");
+	g_string_printf(filename, "%s/%016llx.bin", binaryCacheDirectory, (unsigned long long) key);
+	return g_string_free(filename, false);
+}
+
+static bool isBinaryFormatSupported(GLenum binaryFormat)
+{
+	GLint numBinaryFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+	if(numBinaryFormats <= 0) {
+		return false;
+	}
+
+	GLint *binaryFormats = malloc((size_t) numBinaryFormats * sizeof(GLint));
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, binaryFormats);
+
+	bool supported = false;
+	for(GLint i = 0; i < numBinaryFormats; i++) {
+		if((GLenum) binaryFormats[i] == binaryFormat) {
+			supported = true;
+			break;
+		}
+	}
+
+	free(binaryFormats);
+	return supported;
+}
+
+static bool loadProgramBinary(GLuint program, uint64_t key)
+{
+	char *filename = getBinaryCacheFilename(key);
+
+	FILE *file = fopen(filename, "rb");
+	if(file == NULL) {
+		shovelerLogTrace("Program binary cache miss for '%s'.", filename);
+		free(filename);
+		return false;
+	}
+
+	// The key only selects the file, so validate everything about it before handing it to the driver.
+	BinaryCacheHeader header;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1
+		&& memcmp(header.magic, BINARY_CACHE_MAGIC, sizeof(header.magic)) == 0
+		&& header.version == BINARY_CACHE_VERSION
+		&& header.key == key
+		&& header.binarySize > 0
+		&& header.binarySize <= INT32_MAX
+		&& isBinaryFormatSupported(header.binaryFormat);
+
+	void *binary = NULL;
+	if(valid) {
+		binary = malloc((size_t) header.binarySize);
+		valid = fread(binary, 1, (size_t) header.binarySize, file) == header.binarySize
+			&& hashBytes(FNV_OFFSET_BASIS, binary, (size_t) header.binarySize) == header.binaryHash;
+	}
+	fclose(file);
+
+	if(!valid) {
+		shovelerLogWarning("Ignoring invalid cached program binary '%s', compiling program from source instead.", filename);
+		free(binary);
+		free(filename);
+		return false;
+	}
+
+	glProgramBinary(program, header.binaryFormat, binary, (GLsizei) header.binarySize);
+	free(binary);
+
+	GLint status;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if(status == 0) {
+		shovelerLogWarning("Driver rejected cached program binary '%s', compiling program from source instead.", filename);
+		free(filename);
+		return false;
+	}
+
+	shovelerLogTrace("Loaded shader program %d from cached binary '%s'.", program, filename);
+	free(filename);
+	return true;
+}
+
+static void storeProgramBinary(GLuint program, uint64_t key)
+{
+	GLint binaryLength = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if(binaryLength <= 0) {
+		shovelerLogTrace("Driver provided no binary for shader program %d, not caching it.", program);
+		return;
+	}
+
+	void *binary = malloc((size_t) binaryLength);
+	GLsizei binarySize = 0;
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(program, binaryLength, &binarySize, &binaryFormat, binary);
+
+	BinaryCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINARY_CACHE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_CACHE_VERSION;
+	header.binaryFormat = binaryFormat;
+	header.key = key;
+	header.binaryHash = hashBytes(FNV_OFFSET_BASIS, binary, (size_t) binarySize);
+	header.binarySize = (uint64_t) binarySize;
+
+	char *filename = getBinaryCacheFilename(key);
+	FILE *file = fopen(filename, "wb");
+	if(file == NULL) {
+		shovelerLogWarning("Failed to open program binary cache file '%s' for writing: %s.", filename, strerror(errno));
+		free(filename);
+		free(binary);
+		return;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(binary, 1, (size_t) binarySize, file) == (size_t) binarySize;
+	fclose(file);
+
+	if(!written) {
+		// a truncated file fails validation when loaded, so it is simply replaced the next time around
+		shovelerLogWarning("Failed to write program binary cache file '%s': %s.", filename, strerror(errno));
+	} else {
+		shovelerLogTrace("Stored %d bytes of shader program %d binary in cache file '%s'.", binarySize, program, filename);
+	}
+
+	free(filename);
+	free(binary);
+}
@@ -1,4 +1,5 @@
 #include "shoveler/shader_program/model_vertex_screenspace.h"
+#include "shoveler/light.h"
 #include "shoveler/shader_program.h"
 
 static const char *vertexShaderSource =
@@ -6,25 +7,32 @@ static const char *vertexShaderSource =
 	"\n"
 	"uniform mat4 model;\n"
 	"uniform mat4 modelNormal;\n"
-	"uniform mat4 lightView;\n"
-	"uniform mat4 lightProjection;\n"
+	"uniform bool sceneInstanced;\n"
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
 	"\n"
 	"in vec3 position;\n"
 	"in vec3 normal;\n"
 	"in vec2 uv;\n"
+	"in mat4 instanceModel;\n"
+	"in mat4 instanceModelNormal;\n"
+	"in vec4 instanceColor;\n"
 	"\n"
 	"out vec3 worldPosition;"
 	"out vec3 worldNormal;"
 	"out vec2 worldUv;"
 	"out vec4 lightFrustumPosition4;"
+	"out vec4 modelColor;"
 	"\n"
 	"void main()\n"
 	"{\n"
-	"	vec4 worldPosition4 = model * vec4(position, 1.0);\n"
-	"	vec4 worldNormal4 = modelNormal * vec4(normal, 1.0);\n"
+	"	mat4 worldModel = sceneInstanced ? instanceModel : model;\n"
+	"	mat4 worldModelNormal = sceneInstanced ? instanceModelNormal : modelNormal;\n"
+	"	vec4 worldPosition4 = worldModel * vec4(position, 1.0);\n"
+	"	vec4 worldNormal4 = worldModelNormal * vec4(normal, 1.0);\n"
 	"	worldPosition = worldPosition4.xyz / worldPosition4.w;\n"
 	"	worldNormal = worldNormal4.xyz / worldNormal4.w;\n"
 	"	worldUv = uv;\n"
+	"	modelColor = instanceColor;\n"
 	""
 	"	lightFrustumPosition4 = lightProjection * lightView * worldPosition4;\n"
 	""
@@ -0,0 +1,80 @@
+#include "shoveler/shader_program/sprite_vertex.h"
+#include "shoveler/camera.h"
+#include "shoveler/light.h"
+#include "shoveler/shader_program.h"
+
+static const char *projectedVertexShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform mat4 model;\n"
+	"uniform mat4 modelNormal;\n"
+	SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
+	"\n"
+	"in vec2 uv;\n"
+	"in vec2 spriteUv;\n"
+	"in vec2 spriteTile;\n"
+	"\n"
+	"out vec3 worldPosition;\n"
+	"out vec3 worldNormal;\n"
+	"out vec2 worldUv;\n"
+	"out vec4 lightFrustumPosition4;\n"
+	"out vec2 fragmentSpriteUv;\n"
+	"flat out vec2 fragmentSpriteTile;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec4 worldPosition4 = model * vec4(2.0 * uv - 1.0, 0.0, 1.0);\n"
+	"	vec4 worldNormal4 = modelNormal * vec4(0.0, 0.0, 1.0, 1.0);\n"
+	"	worldPosition = worldPosition4.xyz / worldPosition4.w;\n"
+	"	worldNormal = worldNormal4.xyz / worldNormal4.w;\n"
+	"	worldUv = uv;\n"
+	"	fragmentSpriteUv = spriteUv;\n"
+	"	fragmentSpriteTile = spriteTile;\n"
+	"\n"
+	"	lightFrustumPosition4 = lightProjection * lightView * worldPosition4;\n"
+	"\n"
+	"	gl_Position = projection * view * worldPosition4;\n"
+	"	// sprite quads only cover parts of the canvas quad and interpolate its depth slightly differently, so pull\n"
+	"	// them towards the camera by a fraction of the depth resolution to keep them in front of the canvas surface\n"
+	"	gl_Position.z -= 0.00001 * gl_Position.w;\n"
+	"}\n";
+
+static const char *screenspaceVertexShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform mat4 model;\n"
+	"uniform mat4 modelNormal;\n"
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
+	"\n"
+	"in vec2 uv;\n"
+	"in vec2 spriteUv;\n"
+	"in vec2 spriteTile;\n"
+	"\n"
+	"out vec3 worldPosition;\n"
+	"out vec3 worldNormal;\n"
+	"out vec2 worldUv;\n"
+	"out vec4 lightFrustumPosition4;\n"
+	"out vec2 fragmentSpriteUv;\n"
+	"flat out vec2 fragmentSpriteTile;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec4 worldPosition4 = model * vec4(2.0 * uv - 1.0, 0.0, 1.0);\n"
+	"	vec4 worldNormal4 = modelNormal * vec4(0.0, 0.0, 1.0, 1.0);\n"
+	"	worldPosition = worldPosition4.xyz / worldPosition4.w;\n"
+	"	worldNormal = worldNormal4.xyz / worldNormal4.w;\n"
+	"	worldUv = uv;\n"
+	"	fragmentSpriteUv = spriteUv;\n"
+	"	fragmentSpriteTile = spriteTile;\n"
+	"\n"
+	"	lightFrustumPosition4 = lightProjection * lightView * worldPosition4;\n"
+	"\n"
+	"	gl_Position = vec4(worldPosition, 1.0);\n"
+	"}\n";
+
+GLuint shovelerShaderProgramSpriteVertexCreate(bool screenspace)
+{
+	const char *source = screenspace ? screenspaceVertexShaderSource : projectedVertexShaderSource;
+	return shovelerShaderProgramCompileFromString(source, GL_VERTEX_SHADER);
+}
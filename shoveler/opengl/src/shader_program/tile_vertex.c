@@ -0,0 +1,75 @@
+#include "shoveler/shader_program/tile_vertex.h"
+#include "shoveler/camera.h"
+#include "shoveler/light.h"
+#include "shoveler/shader_program.h"
+
+static const char *projectedVertexShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform mat4 model;\n"
+	"uniform mat4 modelNormal;\n"
+	SHOVELER_CAMERA_UNIFORM_BLOCK_SOURCE
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
+	"\n"
+	"in vec2 uv;\n"
+	"in ivec2 tilePosition;\n"
+	"in uvec3 tile;\n"
+	"\n"
+	"out vec3 worldPosition;\n"
+	"out vec3 worldNormal;\n"
+	"out vec2 worldUv;\n"
+	"out vec4 lightFrustumPosition4;\n"
+	"flat out vec3 fragmentTile;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 corner = tile.z == 0u ? vec2(0.0) : uv;\n"
+	"	vec4 worldPosition4 = model * vec4(vec2(tilePosition) + corner, 0.0, 1.0);\n"
+	"	vec4 worldNormal4 = modelNormal * vec4(0.0, 0.0, 1.0, 1.0);\n"
+	"	worldPosition = worldPosition4.xyz / worldPosition4.w;\n"
+	"	worldNormal = worldNormal4.xyz / worldNormal4.w;\n"
+	"	worldUv = uv;\n"
+	"	fragmentTile = vec3(tile.xy, float(tile.z) - 1.0);\n"
+	"\n"
+	"	lightFrustumPosition4 = lightProjection * lightView * worldPosition4;\n"
+	"\n"
+	"	gl_Position = projection * view * worldPosition4;\n"
+	"}\n";
+
+static const char *screenspaceVertexShaderSource =
+	"#version 400\n"
+	"\n"
+	"uniform mat4 model;\n"
+	"uniform mat4 modelNormal;\n"
+	SHOVELER_LIGHT_UNIFORM_BLOCK_SOURCE
+	"\n"
+	"in vec2 uv;\n"
+	"in ivec2 tilePosition;\n"
+	"in uvec3 tile;\n"
+	"\n"
+	"out vec3 worldPosition;\n"
+	"out vec3 worldNormal;\n"
+	"out vec2 worldUv;\n"
+	"out vec4 lightFrustumPosition4;\n"
+	"flat out vec3 fragmentTile;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 corner = tile.z == 0u ? vec2(0.0) : uv;\n"
+	"	vec4 worldPosition4 = model * vec4(vec2(tilePosition) + corner, 0.0, 1.0);\n"
+	"	vec4 worldNormal4 = modelNormal * vec4(0.0, 0.0, 1.0, 1.0);\n"
+	"	worldPosition = worldPosition4.xyz / worldPosition4.w;\n"
+	"	worldNormal = worldNormal4.xyz / worldNormal4.w;\n"
+	"	worldUv = uv;\n"
+	"	fragmentTile = vec3(tile.xy, float(tile.z) - 1.0);\n"
+	"\n"
+	"	lightFrustumPosition4 = lightProjection * lightView * worldPosition4;\n"
+	"\n"
+	"	gl_Position = vec4(worldPosition, 1.0);\n"
+	"}\n";
+
+GLuint shovelerShaderProgramTileVertexCreate(bool screenspace)
+{
+	const char *source = screenspace ? screenspaceVertexShaderSource : projectedVertexShaderSource;
+	return shovelerShaderProgramCompileFromString(source, GL_VERTEX_SHADER);
+}
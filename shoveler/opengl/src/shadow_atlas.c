@@ -0,0 +1,122 @@
+#include <assert.h> // assert
+#include <stdlib.h> // malloc, free
+
+#include "shoveler/shadow_atlas.h"
+
+ShovelerShadowAtlas *shovelerShadowAtlasCreate(int tileWidth, int tileHeight, int columns, int rows)
+{
+	ShovelerShadowAtlas *atlas = malloc(sizeof(ShovelerShadowAtlas));
+	atlas->framebuffer = shovelerFramebufferCreateColorOnly(tileWidth * columns, tileHeight * rows, /* samples */ 1, /* channels */ 1, /* bitsPerChannel */ 32);
+	atlas->tileWidth = tileWidth;
+	atlas->tileHeight = tileHeight;
+	atlas->columns = columns;
+	atlas->rows = rows;
+	atlas->evictions = 0;
+	atlas->frame = 0;
+	atlas->tiles = malloc(columns * rows * sizeof(ShovelerShadowAtlasTile));
+
+	for(int i = 0; i < columns * rows; i++) {
+		atlas->tiles[i].owner = NULL;
+		atlas->tiles[i].lastUsedFrame = 0;
+	}
+
+	return atlas;
+}
+
+void shovelerShadowAtlasBeginFrame(ShovelerShadowAtlas *atlas)
+{
+	atlas->frame++;
+	atlas->evictions = 0;
+}
+
+bool shovelerShadowAtlasUseTile(ShovelerShadowAtlas *atlas, const void *owner, int *tileIndex)
+{
+	int numTiles = atlas->columns * atlas->rows;
+
+	if(*tileIndex >= 0 && *tileIndex < numTiles && atlas->tiles[*tileIndex].owner == owner) {
+		atlas->tiles[*tileIndex].lastUsedFrame = atlas->frame;
+		return true;
+	}
+
+	// pick a free tile, or otherwise the one whose owner was visible the longest time ago, but never one that another
+	// owner already used this frame since its contents are still going to be sampled
+	int leastRecentlyUsedIndex = -1;
+	for(int i = 0; i < numTiles; i++) {
+		if(atlas->tiles[i].owner == NULL) {
+			leastRecentlyUsedIndex = i;
+			break;
+		}
+
+		if(atlas->tiles[i].lastUsedFrame == atlas->frame) {
+			continue;
+		}
+
+		if(leastRecentlyUsedIndex < 0 || atlas->tiles[i].lastUsedFrame < atlas->tiles[leastRecentlyUsedIndex].lastUsedFrame) {
+			leastRecentlyUsedIndex = i;
+		}
+	}
+
+	*tileIndex = leastRecentlyUsedIndex;
+	if(leastRecentlyUsedIndex < 0) {
+		return false;
+	}
+
+	ShovelerShadowAtlasTile *tile = &atlas->tiles[leastRecentlyUsedIndex];
+	if(tile->owner != NULL) {
+		atlas->evictions++;
+	}
+
+	tile->owner = owner;
+	tile->lastUsedFrame = atlas->frame;
+	return false;
+}
+
+void shovelerShadowAtlasReleaseOwner(ShovelerShadowAtlas *atlas, const void *owner)
+{
+	if(atlas == NULL) {
+		return;
+	}
+
+	for(int i = 0; i < atlas->columns * atlas->rows; i++) {
+		if(atlas->tiles[i].owner == owner) {
+			atlas->tiles[i].owner = NULL;
+			atlas->tiles[i].lastUsedFrame = 0;
+		}
+	}
+}
+
+void shovelerShadowAtlasGetTileViewport(ShovelerShadowAtlas *atlas, int tileIndex, GLint *x, GLint *y, GLsizei *width, GLsizei *height)
+{
+	assert(tileIndex >= 0 && tileIndex < atlas->columns * atlas->rows);
+
+	*x = (tileIndex % atlas->columns) * atlas->tileWidth;
+	*y = (tileIndex / atlas->columns) * atlas->tileHeight;
+	*width = atlas->tileWidth;
+	*height = atlas->tileHeight;
+}
+
+ShovelerVector4 shovelerShadowAtlasGetTileRegion(ShovelerShadowAtlas *atlas, int tileIndex)
+{
+	int column = tileIndex % atlas->columns;
+	int row = tileIndex / atlas->columns;
+	float texelWidth = 1.0f / atlas->framebuffer->width;
+	float texelHeight = 1.0f / atlas->framebuffer->height;
+
+	// inset by half a texel so that interpolated lookups at the tile border don't bleed into neighboring tiles
+	return shovelerVector4(
+		(column * atlas->tileWidth + 0.5f) * texelWidth,
+		(row * atlas->tileHeight + 0.5f) * texelHeight,
+		(atlas->tileWidth - 1.0f) * texelWidth,
+		(atlas->tileHeight - 1.0f) * texelHeight);
+}
+
+void shovelerShadowAtlasFree(ShovelerShadowAtlas *atlas)
+{
+	if(atlas == NULL) {
+		return;
+	}
+
+	free(atlas->tiles);
+	shovelerFramebufferFree(atlas->framebuffer, /* keepTargets */ false);
+	free(atlas);
+}
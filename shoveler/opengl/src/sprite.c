@@ -1,3 +1,4 @@
+#include "shoveler/canvas.h"
 #include "shoveler/sprite.h"
 
 void shovelerSpriteInit(ShovelerSprite *sprite, ShovelerMaterial *material, ShovelerCollider2IntersectFunction *intersect, ShovelerSpriteRenderFunction *render, ShovelerSpriteFreeFunction *free, void *data)
@@ -12,8 +13,12 @@ void shovelerSpriteInit(ShovelerSprite *sprite, ShovelerMaterial *material, Shov
 	sprite->enableCollider = true;
 	sprite->material = material;
 	sprite->render = render;
+	sprite->renderBatch = NULL;
+	sprite->batchKey = NULL;
 	sprite->free = free;
 	sprite->data = data;
+	sprite->canvas = NULL;
+	sprite->canvasLayerId = 0;
 }
 
 void shovelerSpriteUpdatePosition(ShovelerSprite *sprite, ShovelerVector2 position)
@@ -22,6 +27,10 @@ void shovelerSpriteUpdatePosition(ShovelerSprite *sprite, ShovelerVector2 positi
 	sprite->collider.boundingBox = shovelerBoundingBox2(
 		shovelerVector2LinearCombination(1.0f, sprite->position, -0.5f, sprite->size),
 		shovelerVector2LinearCombination(1.0f, sprite->position, 0.5f, sprite->size));
+
+	if(sprite->canvas != NULL) {
+		shovelerCanvasUpdateSprite(sprite->canvas, sprite);
+	}
 }
 
 void shovelerSpriteUpdateSize(ShovelerSprite *sprite, ShovelerVector2 size)
@@ -30,6 +39,10 @@ void shovelerSpriteUpdateSize(ShovelerSprite *sprite, ShovelerVector2 size)
 	sprite->collider.boundingBox = shovelerBoundingBox2(
 		shovelerVector2LinearCombination(1.0f, sprite->position, -0.5f, sprite->size),
 		shovelerVector2LinearCombination(1.0f, sprite->position, 0.5f, sprite->size));
+
+	if(sprite->canvas != NULL) {
+		shovelerCanvasUpdateSprite(sprite->canvas, sprite);
+	}
 }
 
 void shovelerSpriteSetEnableCollider(ShovelerSprite *sprite, bool enableCollider)
@@ -3,15 +3,24 @@
 
 #include "shoveler/material/text.h"
 #include "shoveler/sprite/text.h"
+#include "shoveler/font_atlas.h"
+#include "shoveler/font_atlas_texture.h"
 #include "shoveler/material.h"
+#include "shoveler/sprite_batch.h"
+#include "shoveler/texture.h"
 
 static bool renderSpriteText(ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static bool renderSpriteTextBatch(ShovelerSprite **sprites, int numSprites, ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static void addGlyphQuads(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerSpriteText *spriteText);
+static bool isSameColor(ShovelerVector4 first, ShovelerVector4 second);
 static void freeSpriteText(ShovelerSprite *sprite);
 
 ShovelerSprite *shovelerSpriteTextCreate(ShovelerMaterial *material, ShovelerFontAtlasTexture *fontAtlasTexture, float fontSize, ShovelerVector4 color)
 {
 	ShovelerSpriteText *spriteText = malloc(sizeof(ShovelerSpriteText));
 	shovelerSpriteInit(&spriteText->sprite, material, /* intersect */ NULL, renderSpriteText, freeSpriteText, spriteText);
+	spriteText->sprite.renderBatch = renderSpriteTextBatch;
+	spriteText->sprite.batchKey = fontAtlasTexture;
 	spriteText->fontAtlasTexture = fontAtlasTexture;
 	spriteText->content = "";
 	spriteText->isContentManaged = false;
@@ -49,6 +58,86 @@ static bool renderSpriteText(ShovelerSprite *sprite, ShovelerVector2 regionPosit
 	return shovelerMaterialRender(sprite->material, scene, camera, light, model, renderState);
 }
 
+static bool renderSpriteTextBatch(ShovelerSprite **sprites, int numSprites, ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	// all sprites of a run share the material and font atlas texture
+	ShovelerMaterial *material = sprites[0]->material;
+	ShovelerSpriteText *firstSpriteText = (ShovelerSpriteText *) sprites[0]->data;
+	shovelerMaterialTextSetActiveFontAtlasTexture(material, firstSpriteText->fontAtlasTexture);
+
+	// the color is passed as a uniform, so draw the glyphs of consecutive sprites with the same color together
+	for(int i = 0; i < numSprites;) {
+		ShovelerSpriteText *spriteText = (ShovelerSpriteText *) sprites[i]->data;
+
+		shovelerSpriteBatchClear(batch);
+		int end = i;
+		while(end < numSprites && isSameColor(((ShovelerSpriteText *) sprites[end]->data)->color, spriteText->color)) {
+			addGlyphQuads(batch, regionPosition, regionSize, (ShovelerSpriteText *) sprites[end]->data);
+			end++;
+		}
+
+		if(shovelerSpriteBatchGetNumQuads(batch) > 0) {
+			shovelerMaterialTextSetActiveColor(material, spriteText->color);
+			if(!shovelerMaterialTextRenderBatch(material, batch, scene, camera, light, model, renderState)) {
+				return false;
+			}
+		}
+
+		i = end;
+	}
+
+	return true;
+}
+
+/** Adds one quad per glyph of a text sprite, laid out like the unbatched text material does it. */
+static void addGlyphQuads(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerSpriteText *spriteText)
+{
+	ShovelerFontAtlas *fontAtlas = spriteText->fontAtlasTexture->fontAtlas;
+	ShovelerTexture *texture = spriteText->fontAtlasTexture->texture;
+	float textFactor = spriteText->fontSize / fontAtlas->fontSize;
+	float characterAdvance = 0.0f;
+
+	for(const char *c = spriteText->content; *c != '\0'; c++) {
+		unsigned char character = *((unsigned char *) c);
+		ShovelerFontAtlasGlyph *glyph = shovelerFontAtlasGetGlyph(fontAtlas, character);
+
+		ShovelerVector2 glyphSize = shovelerVector2(textFactor * glyph->width, textFactor * glyph->height);
+		ShovelerVector2 glyphCorner = shovelerVector2(
+			spriteText->sprite.position.values[0] + textFactor * (characterAdvance + glyph->bearingX),
+			spriteText->sprite.position.values[1] + textFactor * glyph->bearingY - glyphSize.values[1]);
+		ShovelerVector2 glyphPosition = shovelerVector2LinearCombination(1.0f, glyphCorner, 0.5f, glyphSize);
+		characterAdvance += glyph->advance / 64.0f;
+
+		if(!shovelerSpriteBatchAddQuad(batch, regionPosition, regionSize, glyphPosition, glyphSize, /* tilesetColumn */ 0, /* tilesetRow */ 0)) {
+			continue;
+		}
+
+		// turn the glyph uvs of the added vertices into font atlas uvs, which is affine and thus exact when interpolated
+		float atlasGlyphWidth = glyph->isRotated ? glyph->height : glyph->width;
+		float atlasGlyphHeight = glyph->isRotated ? glyph->width : glyph->height;
+		ShovelerSpriteBatchVertex *vertices = &g_array_index(batch->vertices, ShovelerSpriteBatchVertex, batch->vertices->len - 4);
+		for(int i = 0; i < 4; i++) {
+			float glyphU = vertices[i].spriteUv[0];
+			float glyphV = vertices[i].spriteUv[1];
+			float rotatedU = glyph->isRotated ? 1.0f - glyphV : glyphU;
+			float rotatedV = glyph->isRotated ? glyphU : glyphV;
+			vertices[i].spriteUv[0] = (glyph->minX + atlasGlyphWidth * rotatedU) / texture->width;
+			vertices[i].spriteUv[1] = (glyph->minY + atlasGlyphHeight * rotatedV) / texture->height;
+		}
+	}
+}
+
+static bool isSameColor(ShovelerVector4 first, ShovelerVector4 second)
+{
+	for(int i = 0; i < 4; i++) {
+		if(first.values[i] != second.values[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 static void freeSpriteText(ShovelerSprite *sprite)
 {
 	ShovelerSpriteText *spriteText = (ShovelerSpriteText *) sprite->data;
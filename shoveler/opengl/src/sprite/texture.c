@@ -14,10 +14,19 @@ ShovelerSprite *shovelerSpriteTextureCreate(ShovelerMaterial *material, Shoveler
 	shovelerSpriteInit(&spriteTexture->sprite, material, /* intersect */ NULL, renderSpriteTexture, freeSpriteTexture, spriteTexture);
 	spriteTexture->texture = texture;
 	spriteTexture->sampler = sampler;
+	spriteTexture->textureRegionPosition = shovelerVector2(0.0f, 0.0f);
+	spriteTexture->textureRegionSize = shovelerVector2(1.0f, 1.0f);
 
 	return &spriteTexture->sprite;
 }
 
+void shovelerSpriteTextureSetTextureRegion(ShovelerSprite *sprite, ShovelerVector2 position, ShovelerVector2 size)
+{
+	ShovelerSpriteTexture *spriteTexture = (ShovelerSpriteTexture *) sprite->data;
+	spriteTexture->textureRegionPosition = position;
+	spriteTexture->textureRegionSize = size;
+}
+
 static bool renderSpriteTexture(ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
 {
 	ShovelerSpriteTexture *spriteTexture = (ShovelerSpriteTexture *) sprite->data;
@@ -25,6 +34,7 @@ static bool renderSpriteTexture(ShovelerSprite *sprite, ShovelerVector2 regionPo
 	shovelerMaterialTextureSpriteSetActiveRegion(sprite->material, regionPosition, regionSize);
 	shovelerMaterialTextureSpriteSetActiveSprite(sprite->material, sprite->position, sprite->size);
 	shovelerMaterialTextureSpriteSetActiveTexture(sprite->material, spriteTexture->texture, spriteTexture->sampler);
+	shovelerMaterialTextureSpriteSetActiveTextureRegion(sprite->material, spriteTexture->textureRegionPosition, spriteTexture->textureRegionSize);
 
 	return shovelerMaterialRender(sprite->material, scene, camera, light, model, renderState);
 }
@@ -4,14 +4,18 @@
 #include "shoveler/sprite/tile.h"
 #include "shoveler/material.h"
 #include "shoveler/sprite.h"
+#include "shoveler/sprite_batch.h"
 
 static bool renderSpriteTile(ShovelerSprite *sprite, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
+static bool renderSpriteTileBatch(ShovelerSprite **sprites, int numSprites, ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState);
 static void freeSpriteTile(ShovelerSprite *sprite);
 
 ShovelerSprite *shovelerSpriteTileCreate(ShovelerMaterial *material, ShovelerTileset *tileset, int tilesetRow, int tilesetColumn)
 {
 	ShovelerSpriteTile *spriteTile = malloc(sizeof(ShovelerSpriteTile));
 	shovelerSpriteInit(&spriteTile->sprite, material, /* intersect */ NULL, renderSpriteTile, freeSpriteTile, spriteTile);
+	spriteTile->sprite.renderBatch = renderSpriteTileBatch;
+	spriteTile->sprite.batchKey = tileset;
 	spriteTile->tileset = tileset;
 	spriteTile->tilesetRow = tilesetRow;
 	spriteTile->tilesetColumn = tilesetColumn;
@@ -44,6 +48,23 @@ static bool renderSpriteTile(ShovelerSprite *sprite, ShovelerVector2 regionPosit
 	return shovelerMaterialRender(sprite->material, scene, camera, light, model, renderState);
 }
 
+static bool renderSpriteTileBatch(ShovelerSprite **sprites, int numSprites, ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerScene *scene, ShovelerCamera *camera, ShovelerLight *light, ShovelerModel *model, ShovelerRenderState *renderState)
+{
+	shovelerSpriteBatchClear(batch);
+	for(int i = 0; i < numSprites; i++) {
+		ShovelerSpriteTile *spriteTile = (ShovelerSpriteTile *) sprites[i]->data;
+		shovelerSpriteBatchAddSprite(batch, regionPosition, regionSize, sprites[i], spriteTile->tilesetColumn, spriteTile->tilesetRow);
+	}
+
+	// all sprites of a run share the material and tileset
+	ShovelerSprite *sprite = sprites[0];
+	ShovelerSpriteTile *spriteTile = (ShovelerSpriteTile *) sprite->data;
+	shovelerMaterialTileSpriteSetActiveRegion(sprite->material, regionPosition, regionSize);
+	shovelerMaterialTileSpriteSetActiveTileset(sprite->material, spriteTile->tileset);
+
+	return shovelerMaterialTileSpriteRenderBatch(sprite->material, batch, scene, camera, light, model, renderState);
+}
+
 static void freeSpriteTile(ShovelerSprite *sprite)
 {
 	ShovelerSpriteTile *spriteTile = (ShovelerSpriteTile *) sprite->data;
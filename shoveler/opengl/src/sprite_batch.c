@@ -0,0 +1,163 @@
+#include <stddef.h> // offsetof
+#include <stdlib.h> // malloc, free
+
+#include "shoveler/opengl.h"
+#include "shoveler/shader_program.h"
+#include "shoveler/sprite.h"
+#include "shoveler/sprite_batch.h"
+
+static void growIndexBuffer(ShovelerSpriteBatch *batch, int numQuads);
+
+ShovelerSpriteBatch *shovelerSpriteBatchCreate()
+{
+	ShovelerSpriteBatch *batch = malloc(sizeof(ShovelerSpriteBatch));
+	batch->vertexBufferSize = 0;
+	batch->indexBufferQuads = 0;
+	batch->vertices = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerSpriteBatchVertex));
+
+	glGenVertexArrays(1, &batch->vertexArrayObject);
+	glBindVertexArray(batch->vertexArrayObject);
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV);
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_UV);
+	glEnableVertexAttribArray(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_TILE);
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, 2, GL_FLOAT, GL_FALSE, offsetof(ShovelerSpriteBatchVertex, uv));
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_UV, 2, GL_FLOAT, GL_FALSE, offsetof(ShovelerSpriteBatchVertex, spriteUv));
+	glVertexAttribFormat(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_TILE, 2, GL_FLOAT, GL_FALSE, offsetof(ShovelerSpriteBatchVertex, spriteTile));
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_UV, 0);
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_UV, 0);
+	glVertexAttribBinding(SHOVELER_SHADER_PROGRAM_ATTRIBUTE_SPRITE_TILE, 0);
+
+	glGenBuffers(1, &batch->vertexBuffer);
+	glGenBuffers(1, &batch->indexBuffer);
+
+	return batch;
+}
+
+void shovelerSpriteBatchClear(ShovelerSpriteBatch *batch)
+{
+	g_array_set_size(batch->vertices, 0);
+}
+
+void shovelerSpriteBatchAddSprite(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, const ShovelerSprite *sprite, int tilesetColumn, int tilesetRow)
+{
+	// place the quad like the unbatched sprite shaders do, which don't rely on the collider being up to date
+	shovelerSpriteBatchAddQuad(batch, regionPosition, regionSize, sprite->position, sprite->size, tilesetColumn, tilesetRow);
+}
+
+bool shovelerSpriteBatchAddQuad(ShovelerSpriteBatch *batch, ShovelerVector2 regionPosition, ShovelerVector2 regionSize, ShovelerVector2 position, ShovelerVector2 size, int tilesetColumn, int tilesetRow)
+{
+	float uvMin[2];
+	float uvMax[2];
+	float spriteUvMin[2];
+	float spriteUvMax[2];
+	for(int i = 0; i < 2; i++) {
+		float regionCorner = regionPosition.values[i] - 0.5f * regionSize.values[i];
+		float spriteMin = position.values[i] - 0.5f * size.values[i];
+		float spriteMax = position.values[i] + 0.5f * size.values[i];
+		if(!shovelerSpriteBatchClipAxis(regionCorner, regionSize.values[i], spriteMin, spriteMax, &uvMin[i], &uvMax[i], &spriteUvMin[i], &spriteUvMax[i])) {
+			return false;
+		}
+	}
+
+	ShovelerSpriteBatchVertex vertices[4] = {
+		{{uvMin[0], uvMin[1]}, {spriteUvMin[0], spriteUvMin[1]}, {tilesetColumn, tilesetRow}},
+		{{uvMax[0], uvMin[1]}, {spriteUvMax[0], spriteUvMin[1]}, {tilesetColumn, tilesetRow}},
+		{{uvMin[0], uvMax[1]}, {spriteUvMin[0], spriteUvMax[1]}, {tilesetColumn, tilesetRow}},
+		{{uvMax[0], uvMax[1]}, {spriteUvMax[0], spriteUvMax[1]}, {tilesetColumn, tilesetRow}}};
+	g_array_append_vals(batch->vertices, vertices, 4);
+
+	return true;
+}
+
+bool shovelerSpriteBatchDraw(ShovelerSpriteBatch *batch)
+{
+	int numQuads = shovelerSpriteBatchGetNumQuads(batch);
+	if(numQuads == 0) {
+		return true;
+	}
+
+	size_t size = batch->vertices->len * sizeof(ShovelerSpriteBatchVertex);
+
+	glBindVertexArray(batch->vertexArrayObject);
+
+	glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer);
+	if(size > batch->vertexBufferSize) {
+		batch->vertexBufferSize = 2 * size;
+	}
+
+	// respecify the storage every time to orphan contents that previous draws might still be reading from
+	glBufferData(GL_ARRAY_BUFFER, batch->vertexBufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, batch->vertices->data);
+
+	if(numQuads > batch->indexBufferQuads) {
+		growIndexBuffer(batch, 2 * numQuads);
+	}
+
+	glBindVertexBuffer(0, batch->vertexBuffer, 0, sizeof(ShovelerSpriteBatchVertex));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->indexBuffer);
+	glDrawElements(GL_TRIANGLES, 6 * numQuads, GL_UNSIGNED_INT, NULL);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+void shovelerSpriteBatchFree(ShovelerSpriteBatch *batch)
+{
+	if(batch == NULL) {
+		return;
+	}
+
+	glDeleteVertexArrays(1, &batch->vertexArrayObject);
+	glDeleteBuffers(1, &batch->vertexBuffer);
+	glDeleteBuffers(1, &batch->indexBuffer);
+
+	g_array_free(batch->vertices, /* freeSegment */ true);
+	free(batch);
+}
+
+bool shovelerSpriteBatchClipAxis(float regionCorner, float regionSize, float spriteMin, float spriteMax, float *uvMin, float *uvMax, float *spriteUvMin, float *spriteUvMax)
+{
+	float spriteUvMinValue = (spriteMin - regionCorner) / regionSize;
+	float spriteUvMaxValue = (spriteMax - regionCorner) / regionSize;
+	float spriteUvExtent = spriteUvMaxValue - spriteUvMinValue;
+	if(!(spriteUvExtent > 0.0f) || spriteUvMaxValue <= 0.0f || spriteUvMinValue >= 1.0f) {
+		return false;
+	}
+
+	*uvMin = spriteUvMinValue;
+	*uvMax = spriteUvMaxValue;
+	*spriteUvMin = 0.0f;
+	*spriteUvMax = 1.0f;
+
+	if(*uvMin < 0.0f) {
+		*spriteUvMin = -spriteUvMinValue / spriteUvExtent;
+		*uvMin = 0.0f;
+	}
+
+	if(*uvMax > 1.0f) {
+		*spriteUvMax = (1.0f - spriteUvMinValue) / spriteUvExtent;
+		*uvMax = 1.0f;
+	}
+
+	return true;
+}
+
+static void growIndexBuffer(ShovelerSpriteBatch *batch, int numQuads)
+{
+	GLuint *indices = malloc((size_t) numQuads * 6 * sizeof(GLuint));
+	for(int quad = 0; quad < numQuads; quad++) {
+		GLuint firstVertex = (GLuint) quad * 4;
+		GLuint *quadIndices = &indices[quad * 6];
+		quadIndices[0] = firstVertex;
+		quadIndices[1] = firstVertex + 1;
+		quadIndices[2] = firstVertex + 2;
+		quadIndices[3] = firstVertex + 1;
+		quadIndices[4] = firstVertex + 3;
+		quadIndices[5] = firstVertex + 2;
+	}
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) numQuads * 6 * sizeof(GLuint), indices, GL_STATIC_DRAW);
+	batch->indexBufferQuads = numQuads;
+
+	free(indices);
+}
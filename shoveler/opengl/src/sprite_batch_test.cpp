@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "shoveler/sprite_batch.h"
+}
+
+class ShovelerSpriteBatchTest : public ::testing::Test {
+public:
+	bool clipAxis(float spriteMin, float spriteMax)
+	{
+		return shovelerSpriteBatchClipAxis(regionCorner, regionSize, spriteMin, spriteMax, &uvMin, &uvMax, &spriteUvMin, &spriteUvMax);
+	}
+
+	float regionCorner = -5.0f;
+	float regionSize = 10.0f;
+	float uvMin;
+	float uvMax;
+	float spriteUvMin;
+	float spriteUvMax;
+};
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisInside)
+{
+	ASSERT_TRUE(clipAxis(-3.0f, 2.0f));
+	ASSERT_FLOAT_EQ(uvMin, 0.2f);
+	ASSERT_FLOAT_EQ(uvMax, 0.7f);
+	ASSERT_FLOAT_EQ(spriteUvMin, 0.0f);
+	ASSERT_FLOAT_EQ(spriteUvMax, 1.0f);
+}
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisBelowRegion)
+{
+	ASSERT_TRUE(clipAxis(-7.0f, -3.0f));
+	ASSERT_FLOAT_EQ(uvMin, 0.0f);
+	ASSERT_FLOAT_EQ(uvMax, 0.2f);
+	ASSERT_FLOAT_EQ(spriteUvMin, 0.5f);
+	ASSERT_FLOAT_EQ(spriteUvMax, 1.0f);
+}
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisAboveRegion)
+{
+	ASSERT_TRUE(clipAxis(3.0f, 7.0f));
+	ASSERT_FLOAT_EQ(uvMin, 0.8f);
+	ASSERT_FLOAT_EQ(uvMax, 1.0f);
+	ASSERT_FLOAT_EQ(spriteUvMin, 0.0f);
+	ASSERT_FLOAT_EQ(spriteUvMax, 0.5f);
+}
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisSpanningRegion)
+{
+	ASSERT_TRUE(clipAxis(-10.0f, 10.0f));
+	ASSERT_FLOAT_EQ(uvMin, 0.0f);
+	ASSERT_FLOAT_EQ(uvMax, 1.0f);
+	ASSERT_FLOAT_EQ(spriteUvMin, 0.25f);
+	ASSERT_FLOAT_EQ(spriteUvMax, 0.75f);
+}
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisOutside)
+{
+	ASSERT_FALSE(clipAxis(-8.0f, -5.0f)) << "sprite ending at the region corner is skipped";
+	ASSERT_FALSE(clipAxis(5.0f, 8.0f)) << "sprite starting at the region end is skipped";
+	ASSERT_FALSE(clipAxis(12.0f, 20.0f)) << "sprite past the region is skipped";
+}
+
+TEST_F(ShovelerSpriteBatchTest, clipAxisEmpty)
+{
+	ASSERT_FALSE(clipAxis(1.0f, 1.0f)) << "zero sized sprite is skipped";
+	ASSERT_FALSE(clipAxis(2.0f, 1.0f)) << "inverted sprite is skipped";
+}
@@ -1,3 +1,5 @@
+#include <assert.h> // assert
+#include <limits.h> // UINT_MAX
 #include <math.h> // ceilf
 #include <stdlib.h> // malloc free
 #include <string.h> // strdup
@@ -8,13 +10,44 @@
 #include "shoveler/font_atlas.h"
 #include "shoveler/font_atlas_texture.h"
 #include "shoveler/framebuffer.h"
+#include "shoveler/log.h"
 #include "shoveler/model.h"
+#include "shoveler/opengl.h"
 #include "shoveler/scene.h"
 #include "shoveler/shader_cache.h"
 #include "shoveler/sprite/text.h"
 #include "shoveler/text_texture_renderer.h"
 #include "shoveler/texture.h"
 
+typedef struct {
+	/** bottom of the shelf, where all of its texts start */
+	unsigned int y;
+	/** height of the tallest padded text placed on the shelf */
+	unsigned int height;
+	/** end of the texts placed on the shelf so far, which are filled in from left to right */
+	unsigned int x;
+	/** number of cached text textures placed on the shelf, so it can be filled again once they were all evicted */
+	unsigned int numTextTextures;
+} ShovelerTextTextureAtlasShelf;
+
+struct ShovelerTextTextureAtlasStruct {
+	ShovelerFramebuffer *framebuffer;
+	/** array of (ShovelerTextTextureAtlasShelf) stacked from the bottom of the atlas up */
+	GArray *shelves;
+	/** number of cached text textures placed into the atlas, so it can be freed once they were all evicted */
+	unsigned int numTextTextures;
+};
+
+static ShovelerTextTexture *createTextTexture(ShovelerTextTextureRenderer *renderer, const char *text);
+static ShovelerTextTextureAtlas *allocateAtlasRegion(ShovelerTextTextureRenderer *renderer, unsigned int width, unsigned int height, unsigned int *outputX, unsigned int *outputY);
+static bool tryAllocateAtlasRegion(ShovelerTextTextureAtlas *atlas, unsigned int paddedWidth, unsigned int paddedHeight, unsigned int *outputX, unsigned int *outputY);
+static ShovelerTextTextureAtlasShelf *getAtlasShelf(ShovelerTextTextureAtlas *atlas, unsigned int y);
+static void renderBatch(ShovelerTextTextureRenderer *renderer, ShovelerTextTextureAtlas *atlas, unsigned int y, ShovelerRenderState *renderState);
+static void evictTextTexture(ShovelerTextTextureRenderer *renderer, ShovelerTextTexture *textTexture);
+static void freeTextTexture(void *textTexturePointer);
+static void freeAtlas(void *atlasPointer);
+static unsigned int roundUpToPowerOfTwo(unsigned int value);
+
 ShovelerTextTextureRenderer *shovelerTextTextureRendererCreate(ShovelerFontAtlasTexture *fontAtlasTexture, ShovelerShaderCache *shaderCache)
 {
 	ShovelerTextTextureRenderer *renderer = malloc(sizeof(ShovelerTextTextureRenderer));
@@ -27,14 +60,121 @@ ShovelerTextTextureRenderer *shovelerTextTextureRendererCreate(ShovelerFontAtlas
 	shovelerSceneAddModel(renderer->textScene, renderer->textModel);
 
 	renderer->textCanvas = shovelerCanvasCreate(/* numLayers */ 1);
-	renderer->textSprite = shovelerSpriteTextCreate(renderer->textMaterial, fontAtlasTexture, fontAtlasTexture->fontAtlas->fontSize, /* color */ shovelerVector4(1.0f, 1.0f, 1.0f, 1.0f));
-	shovelerCanvasAddSprite(renderer->textCanvas, /* layerId */ 0, renderer->textSprite);
 	shovelerMaterialCanvasSetActive(renderer->canvasMaterial, renderer->textCanvas);
 
+	renderer->cacheCapacity = SHOVELER_TEXT_TEXTURE_RENDERER_DEFAULT_CACHE_CAPACITY;
+	renderer->cacheHits = 0;
+	renderer->cacheMisses = 0;
+	renderer->batchesRendered = 0;
+
+	// render only the screenspace text canvas, without clearing the atlas texts already rendered around it
+	renderer->textSceneRenderPassOptions.overrideMaterial = NULL;
+	renderer->textSceneRenderPassOptions.emitters = false;
+	renderer->textSceneRenderPassOptions.screenspace = true;
+	renderer->textSceneRenderPassOptions.onlyShadowCasters = false;
+	renderer->textSceneRenderPassOptions.skipOccluded = false;
+	renderer->textSceneRenderPassOptions.renderState.blend = false;
+	renderer->textSceneRenderPassOptions.renderState.blendSourceFactor = GL_ONE;
+	renderer->textSceneRenderPassOptions.renderState.blendDestinationFactor = GL_ZERO;
+	renderer->textSceneRenderPassOptions.renderState.depthTest = false;
+	renderer->textSceneRenderPassOptions.renderState.depthFunction = GL_LESS;
+	renderer->textSceneRenderPassOptions.renderState.depthMask = GL_FALSE;
+
+	renderer->batchSprites = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerSprite *));
+	renderer->atlases = g_queue_new();
+	renderer->textTextures = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, freeTextTexture);
+	renderer->unusedTextTextures = g_queue_new();
+	renderer->pendingTextTextures = g_queue_new();
+
 	return renderer;
 }
 
-ShovelerTexture *shovelerTextTextureRendererRender(ShovelerTextTextureRenderer *renderer, const char *text, ShovelerRenderState *renderState)
+ShovelerTextTexture *shovelerTextTextureRendererRender(ShovelerTextTextureRenderer *renderer, const char *text, ShovelerRenderState *renderState)
+{
+	ShovelerTextTexture *textTexture = shovelerTextTextureRendererRequest(renderer, text);
+	shovelerTextTextureRendererFlush(renderer, renderState);
+	return textTexture;
+}
+
+ShovelerTextTexture *shovelerTextTextureRendererRequest(ShovelerTextTextureRenderer *renderer, const char *text)
+{
+	ShovelerTextTexture *textTexture = g_hash_table_lookup(renderer->textTextures, text);
+	if(textTexture != NULL) {
+		renderer->cacheHits++;
+	} else {
+		renderer->cacheMisses++;
+
+		textTexture = createTextTexture(renderer, text);
+		g_hash_table_insert(renderer->textTextures, textTexture->text, textTexture);
+		g_queue_push_tail(renderer->pendingTextTextures, textTexture);
+	}
+
+	if(textTexture->unusedLink != NULL) {
+		g_queue_delete_link(renderer->unusedTextTextures, textTexture->unusedLink);
+		textTexture->unusedLink = NULL;
+	}
+
+	textTexture->references++;
+	return textTexture;
+}
+
+bool shovelerTextTextureRendererFlush(ShovelerTextTextureRenderer *renderer, ShovelerRenderState *renderState)
+{
+	if(g_queue_is_empty(renderer->pendingTextTextures)) {
+		return true;
+	}
+
+	// glyphs were added to the atlas while measuring the requested texts
+	shovelerFontAtlasTextureUpdate(renderer->fontAtlasTexture);
+
+	while(!g_queue_is_empty(renderer->pendingTextTextures)) {
+		ShovelerTextTexture *textTexture = g_queue_peek_head(renderer->pendingTextTextures);
+		renderBatch(renderer, textTexture->atlas, textTexture->y, renderState);
+	}
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+void shovelerTextTextureRendererRelease(ShovelerTextTextureRenderer *renderer, ShovelerTextTexture *textTexture)
+{
+	assert(textTexture->references > 0);
+	textTexture->references--;
+	if(textTexture->references > 0) {
+		return;
+	}
+
+	g_queue_push_tail(renderer->unusedTextTextures, textTexture);
+	textTexture->unusedLink = renderer->unusedTextTextures->tail;
+
+	while(renderer->unusedTextTextures->length > renderer->cacheCapacity) {
+		ShovelerTextTexture *leastRecentlyUsed = g_queue_pop_head(renderer->unusedTextTextures);
+		leastRecentlyUsed->unusedLink = NULL;
+		evictTextTexture(renderer, leastRecentlyUsed);
+	}
+}
+
+void shovelerTextTextureRendererFree(ShovelerTextTextureRenderer *renderer)
+{
+	g_queue_free(renderer->pendingTextTextures);
+	g_queue_free(renderer->unusedTextTextures);
+	g_hash_table_destroy(renderer->textTextures);
+	g_queue_free_full(renderer->atlases, freeAtlas);
+
+	for(guint i = 0; i < renderer->batchSprites->len; i++) {
+		shovelerSpriteFree(g_array_index(renderer->batchSprites, ShovelerSprite *, i));
+	}
+	g_array_free(renderer->batchSprites, /* freeSegment */ true);
+
+	shovelerCanvasFree(renderer->textCanvas);
+	shovelerSceneRemoveModel(renderer->textScene, renderer->textModel);
+	shovelerDrawableFree(renderer->textQuad);
+	shovelerMaterialFree(renderer->textMaterial);
+	shovelerMaterialFree(renderer->canvasMaterial);
+	shovelerSceneFree(renderer->textScene);
+	free(renderer);
+}
+
+static ShovelerTextTexture *createTextTexture(ShovelerTextTextureRenderer *renderer, const char *text)
 {
 	float currentWidth = 0.0f;
 	float currentHeightTop = 0.0f;
@@ -66,28 +206,261 @@ ShovelerTexture *shovelerTextTextureRendererRender(ShovelerTextTextureRenderer *
 	unsigned int width = (unsigned int) ceilf(currentWidth);
 	unsigned int height = (unsigned int) ceilf(currentHeightBottom + currentHeightTop);
 
-	shovelerFontAtlasTextureUpdate(renderer->fontAtlasTexture);
-	shovelerSpriteTextSetContent(renderer->textSprite, text, false);
-	renderer->textSprite->position = shovelerVector2(0.0f, currentHeightBottom);
+	// empty or blank texts still get a valid region
+	if(width == 0) {
+		width = 1;
+	}
+	if(height == 0) {
+		height = 1;
+	}
 
-	shovelerMaterialCanvasSetActiveRegion(renderer->canvasMaterial, shovelerVector2(0.5f * width, 0.5f * height), shovelerVector2(width, height));
+	ShovelerTextTexture *textTexture = malloc(sizeof(ShovelerTextTexture));
+	textTexture->text = strdup(text);
+	textTexture->atlas = allocateAtlasRegion(renderer, width, height, &textTexture->x, &textTexture->y);
+	textTexture->texture = textTexture->atlas->framebuffer->renderTarget;
+	textTexture->width = width;
+	textTexture->height = height;
+	textTexture->baseline = currentHeightBottom;
+	textTexture->references = 0;
+	textTexture->pending = true;
+	textTexture->unusedLink = NULL;
+	textTexture->atlas->numTextTextures++;
+	getAtlasShelf(textTexture->atlas, textTexture->y)->numTextTextures++;
 
-	ShovelerFramebuffer *framebuffer = shovelerFramebufferCreateColorOnly(width, height, 1, 1, 8);
-	shovelerSceneRenderFrame(renderer->textScene, NULL, framebuffer, renderState);
+	// clear the region including its padding, which might still hold a text evicted earlier
+	unsigned int padding = SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING;
+	ShovelerTexture *texture = textTexture->texture;
+	glClearTexSubImage(texture->texture, 0, textTexture->x - padding, textTexture->y - padding, 0, width + 2 * padding, height + 2 * padding, 1, texture->format, GL_UNSIGNED_BYTE, NULL);
 
-	ShovelerTexture *texture = framebuffer->renderTarget;
-	shovelerFramebufferFree(framebuffer, /* keepTargets */ true);
-	return texture;
+	return textTexture;
 }
 
-void shovelerTextTextureRendererFree(ShovelerTextTextureRenderer *renderer)
+static ShovelerTextTextureAtlas *allocateAtlasRegion(ShovelerTextTextureRenderer *renderer, unsigned int width, unsigned int height, unsigned int *outputX, unsigned int *outputY)
 {
-	shovelerSpriteFree(renderer->textSprite);
-	shovelerCanvasFree(renderer->textCanvas);
-	shovelerSceneRemoveModel(renderer->textScene, renderer->textModel);
-	shovelerDrawableFree(renderer->textQuad);
-	shovelerMaterialFree(renderer->textMaterial);
-	shovelerMaterialFree(renderer->canvasMaterial);
-	shovelerSceneFree(renderer->textScene);
-	free(renderer);
+	unsigned int paddedWidth = width + 2 * SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING;
+	unsigned int paddedHeight = height + 2 * SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING;
+
+	// prefer space freed up by evicted texts in earlier atlases over growing the last one
+	for(GList *iter = renderer->atlases->head; iter != NULL; iter = iter->next) {
+		ShovelerTextTextureAtlas *atlas = iter->data;
+		if(tryAllocateAtlasRegion(atlas, paddedWidth, paddedHeight, outputX, outputY)) {
+			return atlas;
+		}
+	}
+
+	// start a new atlas, making it larger than usual if a single text doesn't fit
+	unsigned int atlasWidth = SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_SIZE;
+	unsigned int atlasHeight = SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_SIZE;
+	if(paddedWidth > atlasWidth) {
+		atlasWidth = roundUpToPowerOfTwo(paddedWidth);
+	}
+	if(paddedHeight > atlasHeight) {
+		atlasHeight = roundUpToPowerOfTwo(paddedHeight);
+	}
+
+	ShovelerTextTextureAtlas *atlas = malloc(sizeof(ShovelerTextTextureAtlas));
+	atlas->framebuffer = shovelerFramebufferCreateColorOnly(atlasWidth, atlasHeight, /* samples */ 1, /* channels */ 1, /* bitsPerChannel */ 8);
+	atlas->shelves = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerTextTextureAtlasShelf));
+	atlas->numTextTextures = 0;
+	g_queue_push_tail(renderer->atlases, atlas);
+
+	bool allocated = tryAllocateAtlasRegion(atlas, paddedWidth, paddedHeight, outputX, outputY);
+	assert(allocated);
+	(void) allocated;
+
+	return atlas;
+}
+
+static bool tryAllocateAtlasRegion(ShovelerTextTextureAtlas *atlas, unsigned int paddedWidth, unsigned int paddedHeight, unsigned int *outputX, unsigned int *outputY)
+{
+	unsigned int atlasWidth = (unsigned int) atlas->framebuffer->width;
+	unsigned int atlasHeight = (unsigned int) atlas->framebuffer->height;
+
+	if(paddedWidth > atlasWidth) {
+		return false;
+	}
+
+	// pick the shelf with room left that wastes the least height, where the topmost one can still grow
+	ShovelerTextTextureAtlasShelf *bestShelf = NULL;
+	unsigned int bestWastedHeight = UINT_MAX;
+	for(guint i = 0; i < atlas->shelves->len; i++) {
+		ShovelerTextTextureAtlasShelf *shelf = &g_array_index(atlas->shelves, ShovelerTextTextureAtlasShelf, i);
+		if(shelf->x + paddedWidth > atlasWidth) {
+			continue;
+		}
+
+		bool topmost = i + 1 == atlas->shelves->len;
+		unsigned int wastedHeight;
+		if(paddedHeight <= shelf->height) {
+			wastedHeight = shelf->height - paddedHeight;
+		} else if(topmost && shelf->y + paddedHeight <= atlasHeight) {
+			wastedHeight = 0;
+		} else {
+			continue;
+		}
+
+		if(wastedHeight < bestWastedHeight) {
+			bestShelf = shelf;
+			bestWastedHeight = wastedHeight;
+		}
+	}
+
+	// open a new shelf above the topmost one rather than filling less than half of the best shelf's height
+	if(bestShelf == NULL || bestWastedHeight > paddedHeight) {
+		unsigned int shelfY = 0;
+		if(atlas->shelves->len > 0) {
+			ShovelerTextTextureAtlasShelf *topShelf = &g_array_index(atlas->shelves, ShovelerTextTextureAtlasShelf, atlas->shelves->len - 1);
+			shelfY = topShelf->y + topShelf->height;
+		}
+
+		if(shelfY + paddedHeight <= atlasHeight) {
+			ShovelerTextTextureAtlasShelf shelf;
+			shelf.y = shelfY;
+			shelf.height = paddedHeight;
+			shelf.x = 0;
+			shelf.numTextTextures = 0;
+			g_array_append_val(atlas->shelves, shelf);
+			bestShelf = &g_array_index(atlas->shelves, ShovelerTextTextureAtlasShelf, atlas->shelves->len - 1);
+		}
+	}
+
+	if(bestShelf == NULL) {
+		return false;
+	}
+
+	*outputX = bestShelf->x + SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING;
+	*outputY = bestShelf->y + SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING;
+
+	bestShelf->x += paddedWidth;
+	if(paddedHeight > bestShelf->height) {
+		bestShelf->height = paddedHeight;
+	}
+
+	return true;
+}
+
+/** Returns the shelf a text starting at the passed y coordinate was placed on. */
+static ShovelerTextTextureAtlasShelf *getAtlasShelf(ShovelerTextTextureAtlas *atlas, unsigned int y)
+{
+	for(guint i = 0; i < atlas->shelves->len; i++) {
+		ShovelerTextTextureAtlasShelf *shelf = &g_array_index(atlas->shelves, ShovelerTextTextureAtlasShelf, i);
+		if(shelf->y + SHOVELER_TEXT_TEXTURE_RENDERER_ATLAS_PADDING == y) {
+			return shelf;
+		}
+	}
+
+	assert(!"text not placed on any shelf of its atlas");
+	return NULL;
+}
+
+static void renderBatch(ShovelerTextTextureRenderer *renderer, ShovelerTextTextureAtlas *atlas, unsigned int y, ShovelerRenderState *renderState)
+{
+	// place the pending texts of a single atlas shelf, which all start at the same y coordinate, at their regions
+	guint numTexts = 0;
+	unsigned int minX = UINT_MAX;
+	unsigned int maxX = 0;
+	unsigned int maxY = y;
+	GList *iter = renderer->pendingTextTextures->head;
+	while(iter != NULL) {
+		GList *next = iter->next;
+		ShovelerTextTexture *textTexture = iter->data;
+		if(textTexture->atlas != atlas || textTexture->y != y) {
+			iter = next;
+			continue;
+		}
+
+		if(numTexts == renderer->batchSprites->len) {
+			ShovelerSprite *sprite = shovelerSpriteTextCreate(renderer->textMaterial, renderer->fontAtlasTexture, renderer->fontAtlasTexture->fontAtlas->fontSize, /* color */ shovelerVector4(1.0f, 1.0f, 1.0f, 1.0f));
+			g_array_append_val(renderer->batchSprites, sprite);
+		}
+
+		ShovelerSprite *sprite = g_array_index(renderer->batchSprites, ShovelerSprite *, numTexts);
+		shovelerSpriteTextSetContent(sprite, textTexture->text, /* copyContent */ false);
+		shovelerSpriteUpdatePosition(sprite, shovelerVector2(textTexture->x, textTexture->y + textTexture->baseline));
+		shovelerCanvasAddSprite(renderer->textCanvas, /* layerId */ 0, sprite);
+		numTexts++;
+
+		if(textTexture->x < minX) {
+			minX = textTexture->x;
+		}
+		if(textTexture->x + textTexture->width > maxX) {
+			maxX = textTexture->x + textTexture->width;
+		}
+		if(textTexture->y + textTexture->height > maxY) {
+			maxY = textTexture->y + textTexture->height;
+		}
+
+		textTexture->pending = false;
+		g_queue_delete_link(renderer->pendingTextTextures, iter);
+		iter = next;
+	}
+
+	// restrict rendering to the bounds of the new regions, since a lone text is drawn with one viewport sized quad per glyph
+	unsigned int width = maxX - minX;
+	unsigned int height = maxY - y;
+	shovelerMaterialCanvasSetActiveRegion(renderer->canvasMaterial, shovelerVector2(minX + 0.5f * width, y + 0.5f * height), shovelerVector2(width, height));
+
+	// render straight into the atlas without clearing it, where glyphs blend onto their regions cleared on creation
+	shovelerFramebufferUseRegion(atlas->framebuffer, minX, y, width, height);
+	shovelerSceneRenderPass(renderer->textScene, NULL, NULL, renderer->textSceneRenderPassOptions, renderState);
+
+	for(guint i = 0; i < numTexts; i++) {
+		shovelerCanvasRemoveSprite(renderer->textCanvas, /* layerId */ 0, g_array_index(renderer->batchSprites, ShovelerSprite *, i));
+	}
+
+	renderer->batchesRendered++;
+}
+
+static void evictTextTexture(ShovelerTextTextureRenderer *renderer, ShovelerTextTexture *textTexture)
+{
+	if(textTexture->pending) {
+		g_queue_remove(renderer->pendingTextTextures, textTexture);
+	}
+
+	ShovelerTextTextureAtlas *atlas = textTexture->atlas;
+	assert(atlas->numTextTextures > 0);
+	atlas->numTextTextures--;
+
+	ShovelerTextTextureAtlasShelf *shelf = getAtlasShelf(atlas, textTexture->y);
+	assert(shelf->numTextTextures > 0);
+	shelf->numTextTextures--;
+	if(shelf->numTextTextures == 0) {
+		// refill shelves once all their texts are gone, and give back the height of empty shelves at the top
+		shelf->x = 0;
+		while(atlas->shelves->len > 0 && g_array_index(atlas->shelves, ShovelerTextTextureAtlasShelf, atlas->shelves->len - 1).numTextTextures == 0) {
+			g_array_set_size(atlas->shelves, atlas->shelves->len - 1);
+		}
+	}
+
+	if(atlas->numTextTextures == 0 && atlas != g_queue_peek_tail(renderer->atlases)) {
+		// free atlases once all their texts are gone, keeping only the one filled up last
+		g_queue_remove(renderer->atlases, atlas);
+		freeAtlas(atlas);
+	}
+
+	g_hash_table_remove(renderer->textTextures, textTexture->text);
+}
+
+static void freeTextTexture(void *textTexturePointer)
+{
+	ShovelerTextTexture *textTexture = textTexturePointer;
+	free(textTexture->text);
+	free(textTexture);
+}
+
+static void freeAtlas(void *atlasPointer)
+{
+	ShovelerTextTextureAtlas *atlas = atlasPointer;
+	g_array_free(atlas->shelves, /* freeSegment */ true);
+	shovelerFramebufferFree(atlas->framebuffer, /* keepTargets */ false);
+	free(atlas);
+}
+
+static unsigned int roundUpToPowerOfTwo(unsigned int value)
+{
+	unsigned int rounded = 1;
+	while(rounded < value) {
+		rounded *= 2;
+	}
+	return rounded;
 }
@@ -6,45 +6,55 @@
 #include "shoveler/log.h"
 #include "shoveler/opengl.h"
 #include "shoveler/texture.h"
+#include "shoveler/texture_uploader.h"
 
+/** Number of texture units whose bindings are tracked to skip redundant binds. */
+#define SHOVELER_TEXTURE_NUM_TRACKED_UNITS 16
+
+static ShovelerTexture *create2d(ShovelerImage *image, bool manageImage, bool mipmaps);
+static void setImageFormat(ShovelerTexture *texture);
+static void setRenderTargetFormat(ShovelerTexture *texture, int bitsPerChannel);
+static void clearDirty(ShovelerTexture *texture);
 static int getNumMipmapLevels(int width, int height);
 
+/** texture last bound to each of the first units, or 0 if unknown */
+static GLuint boundTextures[SHOVELER_TEXTURE_NUM_TRACKED_UNITS];
+/** unit last activated by shovelerTextureUse, which all other binds go to */
+static GLuint activeUnitIndex = 0;
+
 ShovelerTexture *shovelerTextureCreate2d(ShovelerImage *image, bool manageImage)
 {
+	return create2d(image, manageImage, /* mipmaps */ true);
+}
+
+ShovelerTexture *shovelerTextureCreate2dWithoutMipmaps(ShovelerImage *image, bool manageImage)
+{
+	return create2d(image, manageImage, /* mipmaps */ false);
+}
+
+ShovelerTexture *shovelerTextureCreate2dArray(ShovelerImage *image, unsigned int layers, bool manageImage)
+{
+	assert(layers >= 1);
+	assert(image->height % layers == 0);
 	assert(image->channels >= 1);
 	assert(image->channels <= 4);
 
 	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
 	texture->width = image->width;
-	texture->height = image->height;
+	texture->height = image->height / layers;
 	texture->channels = image->channels;
+	texture->layers = layers;
 	texture->image = image;
 	texture->manageImage = manageImage;
-	texture->target = GL_TEXTURE_2D;
+	texture->target = GL_TEXTURE_2D_ARRAY;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
 	glGenTextures(1, &texture->texture);
-	glBindTexture(texture->target, texture->texture);
+	shovelerTextureBind(texture);
 
-	switch(image->channels) {
-		case 1:
-			texture->internalFormat = GL_R8;
-			texture->format = GL_RED;
-		break;
-		case 2:
-			texture->internalFormat = GL_RG8;
-			texture->format = GL_RG;
-		break;
-		case 3:
-			texture->internalFormat = GL_RGB8;
-			texture->format = GL_RGB;
-		break;
-		case 4:
-			texture->internalFormat = GL_RGBA8;
-			texture->format = GL_RGBA;
-		break;
-	}
-
-	int numMipmapLevels = getNumMipmapLevels(texture->image->width, texture->image->width);
-	glTexStorage2D(texture->target, numMipmapLevels, texture->internalFormat, texture->image->width, texture->image->height);
+	setImageFormat(texture);
+	glTexStorage3D(texture->target, 1, texture->internalFormat, texture->width, texture->height, layers);
 
 	return texture;
 }
@@ -60,54 +70,16 @@ ShovelerTexture *shovelerTextureCreateRenderTarget(unsigned int width, unsigned
 	texture->width = width;
 	texture->height = height;
 	texture->channels = channels;
+	texture->layers = 1;
 	texture->image = NULL;
 	texture->target = samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
 	glGenTextures(1, &texture->texture);
-	glBindTexture(texture->target, texture->texture);
+	shovelerTextureBind(texture);
 
-	if(bitsPerChannel == 8) {
-		if(channels == 1) {
-			texture->internalFormat = GL_R8;
-			texture->format = GL_RED;
-		} else if(channels == 2) {
-			texture->internalFormat = GL_RG8;
-			texture->format = GL_RG;
-		} else if(channels == 3) {
-			texture->internalFormat = GL_RGB8;
-			texture->format = GL_RGB;
-		} else {
-			texture->internalFormat = GL_RGBA8;
-			texture->format = GL_RGBA;
-		}
-	} else if(bitsPerChannel == 16) {
-		if(channels == 1) {
-			texture->internalFormat = GL_R16;
-			texture->format = GL_RED;
-		} else if(channels == 2) {
-			texture->internalFormat = GL_RG16;
-			texture->format = GL_RG;
-		} else if(channels == 3) {
-			texture->internalFormat = GL_RGB16;
-			texture->format = GL_RGB;
-		} else {
-			texture->internalFormat = GL_RGBA16;
-			texture->format = GL_RGBA;
-		}
-	} else {
-		if(channels == 1) {
-			texture->internalFormat = GL_R32F;
-			texture->format = GL_RED;
-		} else if(channels == 2) {
-			texture->internalFormat = GL_RG32F;
-			texture->format = GL_RG;
-		} else if(channels == 3) {
-			texture->internalFormat = GL_RGB32F;
-			texture->format = GL_RGB;
-		} else {
-			texture->internalFormat = GL_RGBA32F;
-			texture->format = GL_RGBA;
-		}
-	}
+	setRenderTargetFormat(texture, bitsPerChannel);
 
 	if(texture->target == GL_TEXTURE_2D_MULTISAMPLE) {
 		glTexStorage2DMultisample(texture->target, samples, texture->internalFormat, width, height, false);
@@ -124,10 +96,14 @@ ShovelerTexture *shovelerTextureCreateDepthTarget(unsigned int width, unsigned i
 	texture->width = width;
 	texture->height = height;
 	texture->channels = 1;
+	texture->layers = 1;
 	texture->image = NULL;
 	texture->target = samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
 	glGenTextures(1, &texture->texture);
-	glBindTexture(texture->target, texture->texture);
+	shovelerTextureBind(texture);
 
 	texture->internalFormat = GL_DEPTH_COMPONENT32F;
 	texture->format = GL_DEPTH_COMPONENT;
@@ -141,23 +117,204 @@ ShovelerTexture *shovelerTextureCreateDepthTarget(unsigned int width, unsigned i
 	return texture;
 }
 
+ShovelerTexture *shovelerTextureCreateRenderTargetArray(unsigned int width, unsigned int height, unsigned int layers, unsigned int channels, int bitsPerChannel)
+{
+	assert(layers >= 1);
+	assert(channels >= 1);
+	assert(channels <= 4);
+	assert(bitsPerChannel == 8 || bitsPerChannel == 16 || bitsPerChannel == 32);
+
+	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
+	texture->width = width;
+	texture->height = height;
+	texture->channels = channels;
+	texture->layers = layers;
+	texture->image = NULL;
+	texture->target = GL_TEXTURE_2D_ARRAY;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
+	glGenTextures(1, &texture->texture);
+	shovelerTextureBind(texture);
+
+	setRenderTargetFormat(texture, bitsPerChannel);
+	glTexStorage3D(texture->target, 1, texture->internalFormat, width, height, layers);
+
+	return texture;
+}
+
+ShovelerTexture *shovelerTextureCreateDepthTargetArray(unsigned int width, unsigned int height, unsigned int layers)
+{
+	assert(layers >= 1);
+
+	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
+	texture->width = width;
+	texture->height = height;
+	texture->channels = 1;
+	texture->layers = layers;
+	texture->image = NULL;
+	texture->target = GL_TEXTURE_2D_ARRAY;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
+	glGenTextures(1, &texture->texture);
+	shovelerTextureBind(texture);
+
+	texture->internalFormat = GL_DEPTH_COMPONENT32F;
+	texture->format = GL_DEPTH_COMPONENT;
+	glTexStorage3D(texture->target, 1, texture->internalFormat, width, height, layers);
+
+	return texture;
+}
+
+ShovelerTexture *shovelerTextureCreateLayerView(ShovelerTexture *arrayTexture, unsigned int layer)
+{
+	assert(arrayTexture->target == GL_TEXTURE_2D_ARRAY);
+	assert(layer < arrayTexture->layers);
+
+	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
+	texture->width = arrayTexture->width;
+	texture->height = arrayTexture->height;
+	texture->channels = arrayTexture->channels;
+	texture->layers = 1;
+	texture->image = NULL;
+	texture->target = GL_TEXTURE_2D;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
+	texture->internalFormat = arrayTexture->internalFormat;
+	texture->format = arrayTexture->format;
+
+	// views need a fresh name that was never bound, so don't bind it before creating the view
+	glGenTextures(1, &texture->texture);
+	glTextureView(texture->texture, texture->target, arrayTexture->texture, texture->internalFormat, 0, 1, layer, 1);
+
+	return texture;
+}
+
+ShovelerTexture *shovelerTextureCreateArrayView(ShovelerTexture *texture2d)
+{
+	assert(texture2d->target == GL_TEXTURE_2D);
+
+	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
+	texture->width = texture2d->width;
+	texture->height = texture2d->height;
+	texture->channels = texture2d->channels;
+	texture->layers = 1;
+	texture->image = NULL;
+	texture->target = GL_TEXTURE_2D_ARRAY;
+	texture->mipmaps = false;
+	texture->uploader = NULL;
+	clearDirty(texture);
+	texture->internalFormat = texture2d->internalFormat;
+	texture->format = texture2d->format;
+
+	// the view shares all levels of the immutable storage, so uploads to the 2D texture show up in it as well
+	int numMipmapLevels = texture2d->mipmaps ? getNumMipmapLevels(texture2d->width, texture2d->height) : 1;
+	glGenTextures(1, &texture->texture);
+	glTextureView(texture->texture, texture->target, texture2d->texture, texture->internalFormat, 0, numMipmapLevels, 0, 1);
+
+	return texture;
+}
+
 bool shovelerTextureUpdate(ShovelerTexture *texture)
+{
+	return shovelerTextureUpdateRegion(texture, 0, 0, texture->width, texture->height);
+}
+
+bool shovelerTextureUpdateRegion(ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
 {
 	if(texture->image == NULL) {
 		return false;
 	}
 
-	glBindTexture(texture->target, texture->texture);
+	assert(x + width <= texture->width);
+	assert(y + height <= texture->height);
+
+	if(width == 0 || height == 0) {
+		return true;
+	}
+
+	shovelerTextureBind(texture);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glTexSubImage2D(texture->target, 0, 0, 0, texture->width, texture->height, texture->format, GL_UNSIGNED_BYTE, texture->image->data);
-	glGenerateMipmap(texture->target);
+
+	// pick the rectangle out of the full image in place instead of copying it out first
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, texture->width);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, x);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, y);
+	if(texture->target == GL_TEXTURE_2D_ARRAY) {
+		// layers are stacked vertically in the image, so the rectangle is picked out of each of them in a single call
+		glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, texture->height);
+		glTexSubImage3D(texture->target, 0, x, y, 0, width, height, texture->layers, texture->format, GL_UNSIGNED_BYTE, texture->image->data);
+		glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+	} else {
+		glTexSubImage2D(texture->target, 0, x, y, width, height, texture->format, GL_UNSIGNED_BYTE, texture->image->data);
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+	if(texture->mipmaps) {
+		glGenerateMipmap(texture->target);
+	}
+
+	clearDirty(texture);
 	return shovelerOpenGLCheckSuccess();
 }
 
+void shovelerTextureMarkDirty(ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	if(width == 0 || height == 0) {
+		return;
+	}
+
+	if(texture->dirtyWidth == 0 || texture->dirtyHeight == 0) {
+		texture->dirtyX = x;
+		texture->dirtyY = y;
+		texture->dirtyWidth = width;
+		texture->dirtyHeight = height;
+		return;
+	}
+
+	unsigned int minX = x < texture->dirtyX ? x : texture->dirtyX;
+	unsigned int minY = y < texture->dirtyY ? y : texture->dirtyY;
+	unsigned int maxX = x + width > texture->dirtyX + texture->dirtyWidth ? x + width : texture->dirtyX + texture->dirtyWidth;
+	unsigned int maxY = y + height > texture->dirtyY + texture->dirtyHeight ? y + height : texture->dirtyY + texture->dirtyHeight;
+
+	texture->dirtyX = minX;
+	texture->dirtyY = minY;
+	texture->dirtyWidth = maxX - minX;
+	texture->dirtyHeight = maxY - minY;
+}
+
+bool shovelerTextureUpdateDirty(ShovelerTexture *texture)
+{
+	if(texture->dirtyWidth == 0 || texture->dirtyHeight == 0) {
+		return true;
+	}
+
+	return shovelerTextureUpdateRegion(texture, texture->dirtyX, texture->dirtyY, texture->dirtyWidth, texture->dirtyHeight);
+}
+
+void shovelerTextureBind(ShovelerTexture *texture)
+{
+	glBindTexture(texture->target, texture->texture);
+
+	if(activeUnitIndex < SHOVELER_TEXTURE_NUM_TRACKED_UNITS) {
+		boundTextures[activeUnitIndex] = texture->texture;
+	}
+}
+
 bool shovelerTextureUse(ShovelerTexture *texture, GLuint unitIndex)
 {
+	// consecutive draws sharing a material use the same textures on the same units
+	if(unitIndex < SHOVELER_TEXTURE_NUM_TRACKED_UNITS && boundTextures[unitIndex] == texture->texture) {
+		return true;
+	}
+
 	glActiveTexture(GL_TEXTURE0 + unitIndex);
-	glBindTexture(texture->target, texture->texture);
+	activeUnitIndex = unitIndex;
+	shovelerTextureBind(texture);
 	return shovelerOpenGLCheckSuccess();
 }
 
@@ -167,14 +324,131 @@ void shovelerTextureFree(ShovelerTexture *texture)
 		return;
 	}
 
+	if(texture->uploader != NULL) {
+		shovelerTextureUploaderCancel(texture->uploader, texture);
+	}
+
 	if(texture->image != NULL && texture->manageImage) {
 		shovelerImageFree(texture->image);
 	}
 
+	// deleting a texture unbinds it
+	for(GLuint unitIndex = 0; unitIndex < SHOVELER_TEXTURE_NUM_TRACKED_UNITS; unitIndex++) {
+		if(boundTextures[unitIndex] == texture->texture) {
+			boundTextures[unitIndex] = 0;
+		}
+	}
+
 	glDeleteTextures(1, &texture->texture);
 	free(texture);
 }
 
+static ShovelerTexture *create2d(ShovelerImage *image, bool manageImage, bool mipmaps)
+{
+	assert(image->channels >= 1);
+	assert(image->channels <= 4);
+
+	ShovelerTexture *texture = malloc(sizeof(ShovelerTexture));
+	texture->width = image->width;
+	texture->height = image->height;
+	texture->channels = image->channels;
+	texture->layers = 1;
+	texture->image = image;
+	texture->manageImage = manageImage;
+	texture->target = GL_TEXTURE_2D;
+	texture->mipmaps = mipmaps;
+	texture->uploader = NULL;
+	clearDirty(texture);
+	glGenTextures(1, &texture->texture);
+	shovelerTextureBind(texture);
+
+	setImageFormat(texture);
+
+	int numMipmapLevels = mipmaps ? getNumMipmapLevels(texture->image->width, texture->image->height) : 1;
+	glTexStorage2D(texture->target, numMipmapLevels, texture->internalFormat, texture->image->width, texture->image->height);
+
+	return texture;
+}
+
+static void setImageFormat(ShovelerTexture *texture)
+{
+	switch(texture->channels) {
+		case 1:
+			texture->internalFormat = GL_R8;
+			texture->format = GL_RED;
+		break;
+		case 2:
+			texture->internalFormat = GL_RG8;
+			texture->format = GL_RG;
+		break;
+		case 3:
+			texture->internalFormat = GL_RGB8;
+			texture->format = GL_RGB;
+		break;
+		case 4:
+			texture->internalFormat = GL_RGBA8;
+			texture->format = GL_RGBA;
+		break;
+	}
+}
+
+static void setRenderTargetFormat(ShovelerTexture *texture, int bitsPerChannel)
+{
+	unsigned int channels = texture->channels;
+
+	if(bitsPerChannel == 8) {
+		if(channels == 1) {
+			texture->internalFormat = GL_R8;
+			texture->format = GL_RED;
+		} else if(channels == 2) {
+			texture->internalFormat = GL_RG8;
+			texture->format = GL_RG;
+		} else if(channels == 3) {
+			texture->internalFormat = GL_RGB8;
+			texture->format = GL_RGB;
+		} else {
+			texture->internalFormat = GL_RGBA8;
+			texture->format = GL_RGBA;
+		}
+	} else if(bitsPerChannel == 16) {
+		if(channels == 1) {
+			texture->internalFormat = GL_R16;
+			texture->format = GL_RED;
+		} else if(channels == 2) {
+			texture->internalFormat = GL_RG16;
+			texture->format = GL_RG;
+		} else if(channels == 3) {
+			texture->internalFormat = GL_RGB16;
+			texture->format = GL_RGB;
+		} else {
+			texture->internalFormat = GL_RGBA16;
+			texture->format = GL_RGBA;
+		}
+	} else {
+		if(channels == 1) {
+			texture->internalFormat = GL_R32F;
+			texture->format = GL_RED;
+		} else if(channels == 2) {
+			texture->internalFormat = GL_RG32F;
+			texture->format = GL_RG;
+		} else if(channels == 3) {
+			texture->internalFormat = GL_RGB32F;
+			texture->format = GL_RGB;
+		} else {
+			texture->internalFormat = GL_RGBA32F;
+			texture->format = GL_RGBA;
+		}
+	}
+}
+
+static void clearDirty(ShovelerTexture *texture)
+{
+	texture->dirtyX = 0;
+	texture->dirtyY = 0;
+	texture->dirtyWidth = 0;
+	texture->dirtyHeight = 0;
+}
+
 static int getNumMipmapLevels(int width, int height)
 {
 	return floor(log2(fmax(width, height))) + 1;
@@ -0,0 +1,258 @@
+#include <assert.h> // assert
+#include <stdint.h> // uintptr_t
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcpy
+
+#include "shoveler/image.h"
+#include "shoveler/log.h"
+#include "shoveler/opengl.h"
+#include "shoveler/texture.h"
+#include "shoveler/texture_uploader.h"
+
+typedef struct {
+	ShovelerTexture *texture;
+	unsigned int x;
+	unsigned int y;
+	unsigned int width;
+	unsigned int height;
+	/** first row of the region that hasn't been uploaded yet */
+	unsigned int nextRow;
+} ShovelerTextureUploaderUpload;
+
+typedef struct {
+	ShovelerTextureUploaderUpload *upload;
+	unsigned int firstRow;
+	unsigned int numRows;
+	size_t offset;
+} ShovelerTextureUploaderBand;
+
+static size_t getRowBytes(ShovelerTextureUploaderUpload *upload);
+static size_t getRemainingBytes(ShovelerTextureUploaderUpload *upload);
+static void freeUpload(void *uploadPointer);
+
+ShovelerTextureUploader *shovelerTextureUploaderCreate(size_t frameBudget)
+{
+	ShovelerTextureUploader *uploader = malloc(sizeof(ShovelerTextureUploader));
+	uploader->frameBudget = frameBudget;
+	uploader->bytesUploaded = 0;
+	uploader->bytesPending = 0;
+	uploader->nextBuffer = 0;
+	uploader->uploads = g_queue_new();
+	uploader->textureUploads = g_hash_table_new(g_direct_hash, g_direct_equal);
+	uploader->bands = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(ShovelerTextureUploaderBand));
+
+	for(int i = 0; i < SHOVELER_TEXTURE_UPLOADER_BUFFERS; i++) {
+		glGenBuffers(1, &uploader->buffers[i].buffer);
+		uploader->buffers[i].fence = NULL;
+	}
+
+	return uploader;
+}
+
+void shovelerTextureUploaderEnqueue(ShovelerTextureUploader *uploader, ShovelerTexture *texture)
+{
+	shovelerTextureUploaderEnqueueRegion(uploader, texture, 0, 0, texture->width, texture->height);
+}
+
+void shovelerTextureUploaderEnqueueRegion(ShovelerTextureUploader *uploader, ShovelerTexture *texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	assert(texture->image != NULL);
+	assert(texture->target == GL_TEXTURE_2D);
+	assert(x + width <= texture->width);
+	assert(y + height <= texture->height);
+	assert(texture->uploader == NULL || texture->uploader == uploader);
+
+	if(width == 0 || height == 0) {
+		return;
+	}
+
+	ShovelerTextureUploaderUpload *upload = g_hash_table_lookup(uploader->textureUploads, texture);
+	if(upload == NULL) {
+		upload = malloc(sizeof(ShovelerTextureUploaderUpload));
+		upload->texture = texture;
+		upload->x = x;
+		upload->y = y;
+		upload->width = width;
+		upload->height = height;
+		upload->nextRow = y;
+
+		g_queue_push_tail(uploader->uploads, upload);
+		g_hash_table_insert(uploader->textureUploads, texture, upload);
+		texture->uploader = uploader;
+	} else {
+		uploader->bytesPending -= getRemainingBytes(upload);
+
+		// grow the queued region to cover both and start it over, since rows already uploaded might have changed
+		unsigned int minX = x < upload->x ? x : upload->x;
+		unsigned int minY = y < upload->y ? y : upload->y;
+		unsigned int maxX = x + width > upload->x + upload->width ? x + width : upload->x + upload->width;
+		unsigned int maxY = y + height > upload->y + upload->height ? y + height : upload->y + upload->height;
+		upload->x = minX;
+		upload->y = minY;
+		upload->width = maxX - minX;
+		upload->height = maxY - minY;
+		upload->nextRow = minY;
+	}
+
+	uploader->bytesPending += getRemainingBytes(upload);
+}
+
+void shovelerTextureUploaderCancel(ShovelerTextureUploader *uploader, ShovelerTexture *texture)
+{
+	ShovelerTextureUploaderUpload *upload = g_hash_table_lookup(uploader->textureUploads, texture);
+	if(upload == NULL) {
+		return;
+	}
+
+	uploader->bytesPending -= getRemainingBytes(upload);
+	g_queue_remove(uploader->uploads, upload);
+	g_hash_table_remove(uploader->textureUploads, texture);
+	texture->uploader = NULL;
+	freeUpload(upload);
+}
+
+bool shovelerTextureUploaderUpdate(ShovelerTextureUploader *uploader)
+{
+	uploader->bytesUploaded = 0;
+
+	if(g_queue_is_empty(uploader->uploads)) {
+		return true;
+	}
+
+	ShovelerTextureUploaderBuffer *buffer = &uploader->buffers[uploader->nextBuffer];
+	if(buffer->fence != NULL) {
+		GLenum status = glClientWaitSync(buffer->fence, 0, 0);
+		if(status == GL_TIMEOUT_EXPIRED) {
+			return true;
+		}
+
+		glDeleteSync(buffer->fence);
+		buffer->fence = NULL;
+	}
+
+	// plan bands of whole rows from the front of the queue until the budget is used up
+	g_array_set_size(uploader->bands, 0);
+	size_t size = 0;
+	for(GList *iter = uploader->uploads->head; iter != NULL; iter = iter->next) {
+		ShovelerTextureUploaderUpload *upload = iter->data;
+		size_t rowBytes = getRowBytes(upload);
+		unsigned int remainingRows = upload->y + upload->height - upload->nextRow;
+
+		unsigned int numRows = remainingRows;
+		if(size + remainingRows * rowBytes > uploader->frameBudget) {
+			numRows = (unsigned int) ((uploader->frameBudget - size) / rowBytes);
+		}
+
+		// always make progress, even if a single row exceeds the budget
+		if(numRows == 0 && size == 0) {
+			numRows = 1;
+		}
+
+		if(numRows == 0) {
+			break;
+		}
+
+		ShovelerTextureUploaderBand band = {upload, upload->nextRow, numRows, size};
+		g_array_append_val(uploader->bands, band);
+		size += numRows * rowBytes;
+
+		if(numRows < remainingRows) {
+			break;
+		}
+	}
+
+	// orphan the buffer's previous storage instead of waiting for it, then copy the rows in
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+	unsigned char *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if(mapped == NULL) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		shovelerLogError("Failed to map texture upload buffer %u of size %zu.", buffer->buffer, size);
+		return shovelerOpenGLCheckSuccess();
+	}
+
+	for(guint i = 0; i < uploader->bands->len; i++) {
+		ShovelerTextureUploaderBand *band = &g_array_index(uploader->bands, ShovelerTextureUploaderBand, i);
+		ShovelerTextureUploaderUpload *upload = band->upload;
+		ShovelerImage *image = upload->texture->image;
+		size_t rowBytes = getRowBytes(upload);
+
+		for(unsigned int row = 0; row < band->numRows; row++) {
+			const unsigned char *source = &shovelerImageGet(image, upload->x, band->firstRow + row, 0);
+			memcpy(mapped + band->offset + row * rowBytes, source, rowBytes);
+		}
+	}
+
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for(guint i = 0; i < uploader->bands->len; i++) {
+		ShovelerTextureUploaderBand *band = &g_array_index(uploader->bands, ShovelerTextureUploaderBand, i);
+		ShovelerTextureUploaderUpload *upload = band->upload;
+		ShovelerTexture *texture = upload->texture;
+
+		shovelerTextureBind(texture);
+		glTexSubImage2D(texture->target, 0, upload->x, band->firstRow, upload->width, band->numRows, texture->format, GL_UNSIGNED_BYTE, (const void *) (uintptr_t) band->offset);
+
+		upload->nextRow += band->numRows;
+		uploader->bytesUploaded += band->numRows * getRowBytes(upload);
+
+		if(upload->nextRow == upload->y + upload->height) {
+			if(texture->mipmaps) {
+				glGenerateMipmap(texture->target);
+			}
+
+			g_queue_remove(uploader->uploads, upload);
+			g_hash_table_remove(uploader->textureUploads, texture);
+			texture->uploader = NULL;
+			freeUpload(upload);
+		}
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	buffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	uploader->nextBuffer = (uploader->nextBuffer + 1) % SHOVELER_TEXTURE_UPLOADER_BUFFERS;
+	uploader->bytesPending -= uploader->bytesUploaded;
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+void shovelerTextureUploaderFree(ShovelerTextureUploader *uploader)
+{
+	if(uploader == NULL) {
+		return;
+	}
+
+	for(GList *iter = uploader->uploads->head; iter != NULL; iter = iter->next) {
+		ShovelerTextureUploaderUpload *upload = iter->data;
+		upload->texture->uploader = NULL;
+	}
+
+	for(int i = 0; i < SHOVELER_TEXTURE_UPLOADER_BUFFERS; i++) {
+		if(uploader->buffers[i].fence != NULL) {
+			glDeleteSync(uploader->buffers[i].fence);
+		}
+		glDeleteBuffers(1, &uploader->buffers[i].buffer);
+	}
+
+	g_array_free(uploader->bands, /* freeSegment */ true);
+	g_hash_table_destroy(uploader->textureUploads);
+	g_queue_free_full(uploader->uploads, freeUpload);
+	free(uploader);
+}
+
+static size_t getRowBytes(ShovelerTextureUploaderUpload *upload)
+{
+	return (size_t) upload->width * upload->texture->image->channels;
+}
+
+static size_t getRemainingBytes(ShovelerTextureUploaderUpload *upload)
+{
+	return (upload->y + upload->height - upload->nextRow) * getRowBytes(upload);
+}
+
+static void freeUpload(void *uploadPointer)
+{
+	free(uploadPointer);
+}
@@ -14,7 +14,7 @@
 #include "shoveler/tilemap.h"
 #include "shoveler/tileset.h"
 
-ShovelerTilemap *shovelerTilemapCreate(ShovelerTexture *tiles, const bool *collidingTiles)
+ShovelerTilemap *shovelerTilemapCreate(ShovelerTexture *tiles, const unsigned char *collidingTiles)
 {
 	ShovelerTilemap *tilemap = malloc(sizeof(ShovelerTilemap));
 	tilemap->tiles = tiles;
@@ -48,7 +48,7 @@ bool shovelerTilemapIntersect(ShovelerTilemap *tilemap, const ShovelerBoundingBo
 		float rowCoordinate = boundingBox->min.values[1] + row * rowStride;
 
 		for(unsigned int column = 0; column < numColumns; column++) {
-			if(!tilemap->collidingTiles[rowIndex + column]) {
+			if(tilemap->collidingTiles[rowIndex + column] == 0) {
 				continue;
 			}
 
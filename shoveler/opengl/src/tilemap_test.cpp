@@ -12,11 +12,11 @@ class ShovelerTilemapTest : public ::testing::Test {
 public:
 	virtual void SetUp()
 	{
-		memset(collidingTiles, 0, 10 * 10 * sizeof(bool));
-		collidingTiles[1 * 10 + 1] = true;
-		collidingTiles[1 * 10 + 9] = true;
-		collidingTiles[9 * 10 + 1] = true;
-		collidingTiles[9 * 10 + 9] = true;
+		memset(collidingTiles, 0, 10 * 10 * sizeof(unsigned char));
+		collidingTiles[1 * 10 + 1] = 1;
+		collidingTiles[1 * 10 + 9] = 1;
+		collidingTiles[9 * 10 + 1] = 1;
+		collidingTiles[9 * 10 + 9] = 1;
 
 		tilesData = shovelerImageCreate(10, 10, 3);
 		tiles.width = 10;
@@ -36,7 +36,7 @@ public:
 		shovelerImageFree(tilesData);
 	}
 
-	bool collidingTiles[10 * 10];
+	unsigned char collidingTiles[10 * 10];
 	ShovelerImage *tilesData;
 	ShovelerTexture tiles;
 	ShovelerTilemap *tilemap;
@@ -81,7 +81,7 @@ TEST_F(ShovelerTilemapTest, noIntersection)
 
 TEST_F(ShovelerTilemapTest, disableThenIntersect)
 {
-	collidingTiles[1 * 10 + 1] = false;
+	collidingTiles[1 * 10 + 1] = 0;
 
 	ShovelerBoundingBox2 noLongerIntersectingBox = shovelerBoundingBox2(
 			shovelerVector2(0.0f, 0.0f),
@@ -5,9 +5,111 @@
 #include "shoveler/image.h"
 #include "shoveler/sampler.h"
 #include "shoveler/texture.h"
+#include "shoveler/texture_uploader.h"
 #include "shoveler/tileset.h"
 
+static ShovelerTileset *createPadded(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding);
+static void assertTilesetImage(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding);
+static void padImage(const ShovelerImage *image, ShovelerImage *paddedImage, unsigned int paddedImageOffsetJ, unsigned char columns, unsigned char rows, unsigned char padding);
+
 ShovelerTileset *shovelerTilesetCreate(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding)
+{
+	ShovelerTileset *tileset = createPadded(image, columns, rows, padding);
+	shovelerTextureUpdate(tileset->texture);
+	return tileset;
+}
+
+ShovelerTileset *shovelerTilesetCreateStreamed(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding, ShovelerTextureUploader *uploader)
+{
+	ShovelerTileset *tileset = createPadded(image, columns, rows, padding);
+	shovelerTextureUploaderEnqueue(uploader, tileset->texture);
+	return tileset;
+}
+
+ShovelerTileset *shovelerTilesetCreateArray(const ShovelerImage *const *images, unsigned int numImages, unsigned char columns, unsigned char rows, unsigned char padding)
+{
+	assert(numImages > 0);
+
+	const ShovelerImage *firstImage = images[0];
+	for(unsigned int i = 0; i < numImages; i++) {
+		assertTilesetImage(images[i], columns, rows, padding);
+		assert(images[i]->width == firstImage->width);
+		assert(images[i]->height == firstImage->height);
+		assert(images[i]->channels == firstImage->channels);
+	}
+
+	ShovelerTileset *tileset = malloc(sizeof(ShovelerTileset));
+	tileset->columns = columns;
+	tileset->rows = rows;
+	tileset->padding = padding;
+
+	// stack the padded images vertically, which is the layout array textures expect their image in
+	unsigned int paddedImageWidth = firstImage->width + 2 * padding * columns;
+	unsigned int paddedImageHeight = firstImage->height + 2 * padding * rows;
+	ShovelerImage *paddedImage = shovelerImageCreate(paddedImageWidth, numImages * paddedImageHeight, firstImage->channels);
+	for(unsigned int i = 0; i < numImages; i++) {
+		padImage(images[i], paddedImage, i * paddedImageHeight, columns, rows, padding);
+	}
+
+	tileset->manageTexture = true;
+	tileset->texture = shovelerTextureCreate2dArray(paddedImage, numImages, true);
+	shovelerTextureUpdate(tileset->texture);
+
+	tileset->sampler = shovelerSamplerCreate(true, false, true);
+	return tileset;
+}
+
+ShovelerTileset *shovelerTilesetCreateFromTexture(ShovelerTexture *texture, unsigned char columns, unsigned char rows, unsigned char padding)
+{
+	ShovelerTileset *tileset = malloc(sizeof(ShovelerTileset));
+	tileset->columns = columns;
+	tileset->rows = rows;
+	tileset->padding = padding;
+	tileset->manageTexture = false;
+	tileset->texture = texture;
+
+	// create a sampler without mipmapping to prevent seam artifacts between tiles
+	tileset->sampler = shovelerSamplerCreate(true, false, true);
+
+	return tileset;
+}
+
+void shovelerTilesetFree(ShovelerTileset *tileset)
+{
+	if(tileset == NULL) {
+		return;
+	}
+
+	shovelerSamplerFree(tileset->sampler);
+
+	if(tileset->manageTexture) {
+		shovelerTextureFree(tileset->texture);
+	}
+
+	free(tileset);
+}
+
+static ShovelerTileset *createPadded(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding)
+{
+	assertTilesetImage(image, columns, rows, padding);
+
+	ShovelerTileset *tileset = malloc(sizeof(ShovelerTileset));
+	tileset->columns = columns;
+	tileset->rows = rows;
+	tileset->padding = padding;
+
+	ShovelerImage *paddedImage = shovelerImageCreate(image->width + 2 * padding * columns, image->height + 2 * padding * rows, image->channels);
+	padImage(image, paddedImage, 0, columns, rows, padding);
+
+	tileset->manageTexture = true;
+	tileset->texture = shovelerTextureCreate2dWithoutMipmaps(paddedImage, true);
+
+	// create a sampler without mipmapping to prevent seam artifacts between tiles, so the texture doesn't need any
+	tileset->sampler = shovelerSamplerCreate(true, false, true);
+	return tileset;
+}
+
+static void assertTilesetImage(const ShovelerImage *image, unsigned char columns, unsigned char rows, unsigned char padding)
 {
 	assert(columns > 0);
 	assert(rows > 0);
@@ -17,17 +119,15 @@ ShovelerTileset *shovelerTilesetCreate(const ShovelerImage *image, unsigned char
 	assert(image->height <= INT_MAX);
 	assert(image->width + 2 * padding * columns <= INT_MAX);
 	assert(image->height + 2 * padding * rows <= INT_MAX);
+	assert(image->width / columns + padding <= INT_MAX);
+	assert(image->height / rows + padding <= INT_MAX);
+}
+
+static void padImage(const ShovelerImage *image, ShovelerImage *paddedImage, unsigned int paddedImageOffsetJ, unsigned char columns, unsigned char rows, unsigned char padding)
+{
 	unsigned int tileWidth = image->width / columns;
 	unsigned int tileHeight = image->height / rows;
-	assert(tileWidth + padding <= INT_MAX);
-	assert(tileHeight + padding <= INT_MAX);
-
-	ShovelerTileset *tileset = malloc(sizeof(ShovelerTileset));
-	tileset->columns = columns;
-	tileset->rows = rows;
-	tileset->padding = padding;
 
-	ShovelerImage *paddedImage = shovelerImageCreate(image->width + 2 * padding * columns, image->height + 2 * padding * rows, image->channels);
 	for(unsigned char column = 0; column < columns; column++) {
 		for(unsigned char row = 0; row < rows; row++) {
 			for(int i = -padding; i < (int) tileWidth + padding; i++) {
@@ -57,7 +157,7 @@ ShovelerTileset *shovelerTilesetCreate(const ShovelerImage *image, unsigned char
 					unsigned int imageJ = row * tileHeight + tileJ;
 					assert(imageJ < image->height);
 
-					unsigned int paddedImageJ = row * (tileHeight + 2 * padding) + padding + j;
+					unsigned int paddedImageJ = paddedImageOffsetJ + row * (tileHeight + 2 * padding) + padding + j;
 					assert(paddedImageJ < paddedImage->height);
 
 					for(unsigned int c = 0; c < image->channels; c++) {
@@ -67,42 +167,4 @@ ShovelerTileset *shovelerTilesetCreate(const ShovelerImage *image, unsigned char
 			}
 		}
 	}
-
-	tileset->manageTexture = true;
-	tileset->texture = shovelerTextureCreate2d(paddedImage, true);
-	shovelerTextureUpdate(tileset->texture);
-
-	// create a sampler without mipmapping to prevent seam artifacts between tiles
-	tileset->sampler = shovelerSamplerCreate(true, false, true);
-	return tileset;
-}
-
-ShovelerTileset *shovelerTilesetCreateFromTexture(ShovelerTexture *texture, unsigned char columns, unsigned char rows, unsigned char padding)
-{
-	ShovelerTileset *tileset = malloc(sizeof(ShovelerTileset));
-	tileset->columns = columns;
-	tileset->rows = rows;
-	tileset->padding = padding;
-	tileset->manageTexture = false;
-	tileset->texture = texture;
-
-	// create a sampler without mipmapping to prevent seam artifacts between tiles
-	tileset->sampler = shovelerSamplerCreate(true, false, true);
-
-	return tileset;
-}
-
-void shovelerTilesetFree(ShovelerTileset *tileset)
-{
-	if(tileset == NULL) {
-		return;
-	}
-
-	shovelerSamplerFree(tileset->sampler);
-
-	if(tileset->manageTexture) {
-		shovelerTextureFree(tileset->texture);
-	}
-
-	free(tileset);
 }
@@ -1,8 +1,10 @@
 #include <stdlib.h> // malloc, free
+#include <string.h> // memcmp, memcpy
 
 #include "shoveler/log.h"
 #include "shoveler/opengl.h"
 #include "shoveler/uniform.h"
+#include "shoveler/uniform_buffer.h"
 
 ShovelerUniform *shovelerUniformCreateBool(bool value)
 {
@@ -150,6 +152,14 @@ ShovelerUniform *shovelerUniformCreateTexturePointer(ShovelerTexture **texturePo
 	return uniform;
 }
 
+ShovelerUniform *shovelerUniformCreateBuffer(ShovelerUniformBuffer *buffer)
+{
+	ShovelerUniform *uniform = malloc(sizeof(ShovelerUniform));
+	uniform->type = SHOVELER_UNIFORM_TYPE_BUFFER;
+	uniform->value.bufferValue = buffer;
+	return uniform;
+}
+
 ShovelerUniform *shovelerUniformCopy(const ShovelerUniform *uniform)
 {
 	ShovelerUniform *newUniform = malloc(sizeof(ShovelerUniform));
@@ -160,54 +170,88 @@ ShovelerUniform *shovelerUniformCopy(const ShovelerUniform *uniform)
 
 bool shovelerUniformUse(ShovelerUniform *uniform, GLint location, GLuint *textureUnitIndexCounter)
 {
+	return shovelerUniformUseCached(uniform, location, textureUnitIndexCounter, NULL);
+}
+
+bool shovelerUniformUseCached(ShovelerUniform *uniform, GLint location, GLuint *textureUnitIndexCounter, ShovelerUniformCacheEntry *cacheEntry)
+{
+	// resolve pointers first so we can compare against what the program last received
+	ShovelerUniformType uploadType = uniform->type;
+	ShovelerUniformValue value;
+	size_t valueSize = 0;
 	switch(uniform->type) {
 		case SHOVELER_UNIFORM_TYPE_BOOL:
-			glUniform1i(location, uniform->value.boolValue ? 1 : 0);
+			uploadType = SHOVELER_UNIFORM_TYPE_INT;
+			value.intValue = uniform->value.boolValue ? 1 : 0;
+			valueSize = sizeof(int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_BOOL_POINTER:
-			glUniform1i(location, *uniform->value.boolPointerValue ? 1 : 0);
+			uploadType = SHOVELER_UNIFORM_TYPE_INT;
+			value.intValue = *uniform->value.boolPointerValue ? 1 : 0;
+			valueSize = sizeof(int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_INT:
-			glUniform1i(location, uniform->value.intValue);
+			value.intValue = uniform->value.intValue;
+			valueSize = sizeof(int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_INT_POINTER:
-			glUniform1i(location, *uniform->value.intPointerValue);
+			uploadType = SHOVELER_UNIFORM_TYPE_INT;
+			value.intValue = *uniform->value.intPointerValue;
+			valueSize = sizeof(int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_UNSIGNED_INT:
-			glUniform1ui(location, uniform->value.unsignedIntValue);
+			value.unsignedIntValue = uniform->value.unsignedIntValue;
+			valueSize = sizeof(unsigned int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_UNSIGNED_INT_POINTER:
-			glUniform1ui(location, *uniform->value.unsignedIntPointerValue);
+			uploadType = SHOVELER_UNIFORM_TYPE_UNSIGNED_INT;
+			value.unsignedIntValue = *uniform->value.unsignedIntPointerValue;
+			valueSize = sizeof(unsigned int);
 		break;
 		case SHOVELER_UNIFORM_TYPE_FLOAT:
-			glUniform1f(location, uniform->value.floatValue);
+			value.floatValue = uniform->value.floatValue;
+			valueSize = sizeof(float);
 		break;
 		case SHOVELER_UNIFORM_TYPE_FLOAT_POINTER:
-			glUniform1f(location, *uniform->value.floatPointerValue);
+			uploadType = SHOVELER_UNIFORM_TYPE_FLOAT;
+			value.floatValue = *uniform->value.floatPointerValue;
+			valueSize = sizeof(float);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR2:
-			glUniform2fv(location, 1, uniform->value.vector2Value.values);
+			value.vector2Value = uniform->value.vector2Value;
+			valueSize = sizeof(ShovelerVector2);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR2_POINTER:
-			glUniform2fv(location, 1, uniform->value.vector2PointerValue->values);
+			uploadType = SHOVELER_UNIFORM_TYPE_VECTOR2;
+			value.vector2Value = *uniform->value.vector2PointerValue;
+			valueSize = sizeof(ShovelerVector2);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR3:
-			glUniform3fv(location, 1, uniform->value.vector3Value.values);
+			value.vector3Value = uniform->value.vector3Value;
+			valueSize = sizeof(ShovelerVector3);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR3_POINTER:
-			glUniform3fv(location, 1, uniform->value.vector3PointerValue->values);
+			uploadType = SHOVELER_UNIFORM_TYPE_VECTOR3;
+			value.vector3Value = *uniform->value.vector3PointerValue;
+			valueSize = sizeof(ShovelerVector3);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR4:
-			glUniform4fv(location, 1, uniform->value.vector4Value.values);
+			value.vector4Value = uniform->value.vector4Value;
+			valueSize = sizeof(ShovelerVector4);
 		break;
 		case SHOVELER_UNIFORM_TYPE_VECTOR4_POINTER:
-			glUniform4fv(location, 1, uniform->value.vector4PointerValue->values);
+			uploadType = SHOVELER_UNIFORM_TYPE_VECTOR4;
+			value.vector4Value = *uniform->value.vector4PointerValue;
+			valueSize = sizeof(ShovelerVector4);
 		break;
 		case SHOVELER_UNIFORM_TYPE_MATRIX:
-			glUniformMatrix4fv(location, 1, GL_TRUE, uniform->value.matrixValue.values);
+			value.matrixValue = uniform->value.matrixValue;
+			valueSize = sizeof(ShovelerMatrix);
 		break;
 		case SHOVELER_UNIFORM_TYPE_MATRIX_POINTER:
-			glUniformMatrix4fv(location, 1, GL_TRUE, uniform->value.matrixPointerValue->values);
+			uploadType = SHOVELER_UNIFORM_TYPE_MATRIX;
+			value.matrixValue = *uniform->value.matrixPointerValue;
+			valueSize = sizeof(ShovelerMatrix);
 		break;
 		case SHOVELER_UNIFORM_TYPE_TEXTURE: {
 			GLuint textureUnitIndex = (*textureUnitIndexCounter)++;
@@ -222,7 +266,9 @@ bool shovelerUniformUse(ShovelerUniform *uniform, GLint location, GLuint *textur
 				return false;
 			}
 
-			glUniform1i(location, textureUnitIndex);
+			uploadType = SHOVELER_UNIFORM_TYPE_INT;
+			value.intValue = textureUnitIndex;
+			valueSize = sizeof(int);
 		} break;
 		case SHOVELER_UNIFORM_TYPE_TEXTURE_POINTER: {
 			GLuint textureUnitIndex = (*textureUnitIndexCounter)++;
@@ -237,8 +283,49 @@ bool shovelerUniformUse(ShovelerUniform *uniform, GLint location, GLuint *textur
 				return false;
 			}
 
-			glUniform1i(location, textureUnitIndex);
+			uploadType = SHOVELER_UNIFORM_TYPE_INT;
+			value.intValue = textureUnitIndex;
+			valueSize = sizeof(int);
 		} break;
+		case SHOVELER_UNIFORM_TYPE_BUFFER:
+			// blocks are bound to shared binding points rather than stored in the program, so there is nothing to cache
+			return shovelerUniformBufferUse(uniform->value.bufferValue);
+	}
+
+	if(cacheEntry != NULL && cacheEntry->valid && memcmp(&cacheEntry->value, &value, valueSize) == 0) {
+		return true;
+	}
+
+	switch(uploadType) {
+		case SHOVELER_UNIFORM_TYPE_INT:
+			glUniform1i(location, value.intValue);
+		break;
+		case SHOVELER_UNIFORM_TYPE_UNSIGNED_INT:
+			glUniform1ui(location, value.unsignedIntValue);
+		break;
+		case SHOVELER_UNIFORM_TYPE_FLOAT:
+			glUniform1f(location, value.floatValue);
+		break;
+		case SHOVELER_UNIFORM_TYPE_VECTOR2:
+			glUniform2fv(location, 1, value.vector2Value.values);
+		break;
+		case SHOVELER_UNIFORM_TYPE_VECTOR3:
+			glUniform3fv(location, 1, value.vector3Value.values);
+		break;
+		case SHOVELER_UNIFORM_TYPE_VECTOR4:
+			glUniform4fv(location, 1, value.vector4Value.values);
+		break;
+		case SHOVELER_UNIFORM_TYPE_MATRIX:
+			glUniformMatrix4fv(location, 1, GL_TRUE, value.matrixValue.values);
+		break;
+		default:
+			shovelerLogError("Failed to upload uniform %p of unresolved type %d at location %d.", uniform, uploadType, location);
+			return false;
+	}
+
+	if(cacheEntry != NULL) {
+		cacheEntry->valid = true;
+		memcpy(&cacheEntry->value, &value, valueSize);
 	}
 
 	return shovelerOpenGLCheckSuccess();
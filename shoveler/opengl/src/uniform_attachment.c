@@ -3,17 +3,18 @@
 
 #include "shoveler/uniform_attachment.h"
 
-ShovelerUniformAttachment *shovelerUniformAttachmentCreate(ShovelerUniform *uniform, GLint location)
+ShovelerUniformAttachment *shovelerUniformAttachmentCreate(ShovelerUniform *uniform, GLint location, ShovelerUniformCacheEntry *cacheEntry)
 {
 	ShovelerUniformAttachment *uniformAttachment = malloc(sizeof(ShovelerUniformAttachment));
 	uniformAttachment->uniform = uniform;
 	uniformAttachment->location = location;
+	uniformAttachment->cacheEntry = cacheEntry;
 	return uniformAttachment;
 }
 
 bool shovelerUniformAttachmentUse(ShovelerUniformAttachment *uniformAttachment, GLuint *textureUnitIndexCounter)
 {
-	return shovelerUniformUse(uniformAttachment->uniform, uniformAttachment->location, textureUnitIndexCounter);
+	return shovelerUniformUseCached(uniformAttachment->uniform, uniformAttachment->location, textureUnitIndexCounter, uniformAttachment->cacheEntry);
 }
 
 void shovelerUniformAttachmentFree(ShovelerUniformAttachment *uniformAttachment)
@@ -0,0 +1,53 @@
+#include <stdlib.h> // malloc, calloc, free
+#include <string.h> // memcmp, memcpy
+
+#include "shoveler/opengl.h"
+#include "shoveler/uniform_buffer.h"
+
+ShovelerUniformBuffer *shovelerUniformBufferCreate(ShovelerUniformBufferBinding binding, size_t size, ShovelerUniformBufferFillFunction *fill, void *userData)
+{
+	ShovelerUniformBuffer *uniformBuffer = malloc(sizeof(ShovelerUniformBuffer));
+	uniformBuffer->binding = binding;
+	uniformBuffer->size = size;
+	uniformBuffer->fill = fill;
+	uniformBuffer->userData = userData;
+	uniformBuffer->stagingData = calloc(1, size);
+	uniformBuffer->uploadedData = calloc(1, size);
+	uniformBuffer->uploaded = false;
+
+	glGenBuffers(1, &uniformBuffer->buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer->buffer);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+
+	return uniformBuffer;
+}
+
+bool shovelerUniformBufferUse(ShovelerUniformBuffer *uniformBuffer)
+{
+	if(uniformBuffer->fill != NULL) {
+		uniformBuffer->fill(uniformBuffer->stagingData, uniformBuffer->userData);
+	}
+
+	if(!uniformBuffer->uploaded || memcmp(uniformBuffer->stagingData, uniformBuffer->uploadedData, uniformBuffer->size) != 0) {
+		glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer->buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, uniformBuffer->size, uniformBuffer->stagingData);
+		memcpy(uniformBuffer->uploadedData, uniformBuffer->stagingData, uniformBuffer->size);
+		uniformBuffer->uploaded = true;
+	}
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, uniformBuffer->binding, uniformBuffer->buffer);
+
+	return shovelerOpenGLCheckSuccess();
+}
+
+void shovelerUniformBufferFree(ShovelerUniformBuffer *uniformBuffer)
+{
+	if(uniformBuffer == NULL) {
+		return;
+	}
+
+	glDeleteBuffers(1, &uniformBuffer->buffer);
+	free(uniformBuffer->stagingData);
+	free(uniformBuffer->uploadedData);
+	free(uniformBuffer);
+}
@@ -37,6 +37,11 @@ typedef enum {
   SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TYPE,
   SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_WIDTH,
   SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES_HEIGHT,
+  /**
+   * If type is SHOVELER_COMPONENT_DRAWABLE_TYPE_TILES, optional tilemap tiles of tiles width
+   * times tiles height to fill the drawable with.
+   */
+  SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES,
 } ShovelerComponentDrawableFieldId;
 
 typedef enum {
@@ -75,6 +80,7 @@ typedef enum {
   SHOVELER_COMPONENT_MATERIAL_TYPE_TEXTURE_SPRITE,
   SHOVELER_COMPONENT_MATERIAL_TYPE_TILE_SPRITE,
   SHOVELER_COMPONENT_MATERIAL_TYPE_TEXT,
+  SHOVELER_COMPONENT_MATERIAL_TYPE_TILES,
 } ShovelerComponentMaterialType;
 
 typedef enum {
@@ -97,6 +103,7 @@ typedef enum {
   SHOVELER_COMPONENT_MATERIAL_FIELD_ID_COLOR,
   SHOVELER_COMPONENT_MATERIAL_FIELD_ID_CANVAS_REGION_POSITION,
   SHOVELER_COMPONENT_MATERIAL_FIELD_ID_CANVAS_REGION_SIZE,
+  SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TILESET,
 } ShovelerComponentMaterialFieldId;
 
 typedef enum {
@@ -101,7 +101,7 @@ static ShovelerComponentType* shovelerComponentCreateClientType() {
 }
 
 static ShovelerComponentType* shovelerComponentCreateDrawableType() {
-  ShovelerComponentField fields[3];
+  ShovelerComponentField fields[4];
   fields[SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TYPE] = shovelerComponentField(
       "type",
       SHOVELER_COMPONENT_FIELD_TYPE_INT,
@@ -114,6 +114,11 @@ static ShovelerComponentType* shovelerComponentCreateDrawableType() {
       "tiles_height",
       SHOVELER_COMPONENT_FIELD_TYPE_INT,
       /* isOptional */ true);
+  fields[SHOVELER_COMPONENT_DRAWABLE_FIELD_ID_TILES] = shovelerComponentFieldDependency(
+      "tiles",
+      shovelerComponentTypeIdTilemapTiles,
+      /* isArray */ false,
+      /* isOptional */ true);
 
   return shovelerComponentTypeCreate(
       shovelerComponentTypeIdDrawable, sizeof(fields) / sizeof(fields[0]), fields);
@@ -173,7 +178,7 @@ static ShovelerComponentType* shovelerComponentCreateLightType() {
 }
 
 static ShovelerComponentType* shovelerComponentCreateMaterialType() {
-  ShovelerComponentField fields[10];
+  ShovelerComponentField fields[11];
   fields[SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TYPE] = shovelerComponentField(
       "type",
       SHOVELER_COMPONENT_FIELD_TYPE_INT,
@@ -218,6 +223,11 @@ static ShovelerComponentType* shovelerComponentCreateMaterialType() {
       "canvas_region_size",
       SHOVELER_COMPONENT_FIELD_TYPE_VECTOR2,
       /* isOptional */ true);
+  fields[SHOVELER_COMPONENT_MATERIAL_FIELD_ID_TILESET] = shovelerComponentFieldDependency(
+      "tileset",
+      shovelerComponentTypeIdTileset,
+      /* isArray */ false,
+      /* isOptional */ true);
 
   return shovelerComponentTypeCreate(
       shovelerComponentTypeIdMaterial, sizeof(fields) / sizeof(fields[0]), fields);
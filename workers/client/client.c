@@ -1,6 +1,7 @@
+#include <errno.h> // errno
 #include <inttypes.h> // PRId64
 #include <stdlib.h> // srand
-#include <string.h> // memset
+#include <string.h> // memset strerror
 #include <time.h> // time
 
 #include <improbable/c_schema.h>
@@ -14,9 +15,11 @@
 #include <shoveler/client_system.h>
 #include <shoveler/entity_component_id.h>
 #include <shoveler/global.h>
+#include <shoveler/light/point.h>
 #include <shoveler/log.h>
 #include <shoveler/resources/image_png.h>
 #include <shoveler/resources.h>
+#include <shoveler/shader_program.h>
 #include <shoveler/spatialos_schema.h>
 #include <shoveler/types.h>
 #include <shoveler/worker_log.h>
@@ -45,6 +48,10 @@ typedef struct {
 	int64_t lastHeartbeatPongTime;
 	double meanHeartbeatLatencyMs;
 	double meanTimeSinceLastHeartbeatPongMs;
+	/** array of (long long int) entity ids to remove in bulk at the end of the current op list */
+	GArray* pendingRemovedEntityIds;
+	/** map from (Worker_EntityId *) to one past the index of its last remove entity op in the current op list */
+	GHashTable* lastEntityRemovalOpIndices;
 } ClientContext;
 
 static const long long int bootstrapEntityId = 1;
@@ -53,11 +60,20 @@ static const int64_t clientStatusTimeoutMs = 2449;
 static const float improbablePositionUpdateDistance = 1.0f;
 static const double meanHeartbeatMovingExponentialFactor = 0.5f;
 static const double meanTimeSinceLastHeartbeatPongExponentialFactor = 0.05f;
+static const int maxShadowedLights = 4;
+static const int shadowMapLevels = 3;
+// matches the shadow map resolution of the point lights the server gives every player, so that tiles don't downsample them
+static const int shadowAtlasTileSize = 1024;
+// below the user data directory, so that linked shader programs survive restarts of the client worker
+static const char* programBinaryCacheSubdirectory = "shoveler-spatialos/ShovelerClient/program_binaries";
+
+static ShovelerClientSystem* clientSystem = NULL;
 
 static void onAddComponent(ClientContext* context, const Worker_AddComponentOp* op);
 static void onAuthorityChange(ClientContext* context, const Worker_ComponentSetAuthorityChangeOp* op);
 static void onUpdateComponent(ClientContext* context, const Worker_ComponentUpdateOp* op);
 static void onRemoveComponent(ClientContext* context, const Worker_RemoveComponentOp* op);
+static void flushRemovedEntities(ClientContext* context);
 static void updateGame(ShovelerGame* game, double dt);
 static void updateAuthoritativeWorldComponentFunction(
 	ShovelerClientSystem* clientSystem,
@@ -69,6 +85,7 @@ static void clientPingTick(void* clientContextPointer);
 static void clientStatus(void* clientContextPointer);
 static void mouseButtonEvent(ShovelerInput* input, int button, int action, int mods, void* clientContextPointer);
 static void dependencyChanged(ShovelerWorld* world, const ShovelerEntityComponentId* dependencySource, const ShovelerEntityComponentId* dependencyTarget, bool added, void* clientContextPointer);
+static void entitiesRemoved(ShovelerWorld* world, int numEntityIds, const long long int* entityIds, int numRemovedDependencies, void* clientContextPointer);
 static void updateInterest(ClientContext* context, bool absoluteInterest, ShovelerVector3 position, double edgeLength);
 static void updateEdgeLength(ClientContext* context, ShovelerVector3 position);
 static void keyHandler(ShovelerInput* input, int key, int scancode, int action, int mods, void* clientContextPointer);
@@ -85,6 +102,7 @@ int main(int argc, char** argv)
 	windowSettings.samples = 4;
 	windowSettings.windowedWidth = 640;
 	windowSettings.windowedHeight = 480;
+	windowSettings.headless = false;
 
 	shovelerLogInit("shoveler-spatialos/", SHOVELER_LOG_LEVEL_INFO_UP, stdout);
 	shovelerGlobalInit();
@@ -171,13 +189,28 @@ int main(int argc, char** argv)
 	context.lastHeartbeatPongTime = g_get_monotonic_time();
 	context.meanHeartbeatLatencyMs = 0.0;
 	context.meanTimeSinceLastHeartbeatPongMs = 0.5 * (double) clientPingTimeoutMs;
+	context.pendingRemovedEntityIds = g_array_new(/* zeroTerminated */ false, /* clear */ false, sizeof(long long int));
+	context.lastEntityRemovalOpIndices = g_hash_table_new(g_int64_hash, g_int64_equal);
+
+	char* programBinaryCacheDirectory = g_build_filename(g_get_user_data_dir(), programBinaryCacheSubdirectory, NULL);
+	if (g_mkdir_with_parents(programBinaryCacheDirectory, 0755) == 0) {
+		shovelerShaderProgramEnableBinaryCache(programBinaryCacheDirectory);
+	} else {
+		shovelerLogWarning("Failed to create program binary cache directory '%s', compiling shaders from source: %s", programBinaryCacheDirectory, strerror(errno));
+	}
+	g_free(programBinaryCacheDirectory);
 
 	ShovelerGame* game = shovelerGameCreate(updateGame, &windowSettings, &cameraSettings, &clientConfiguration.controllerSettings);
 	if (game == NULL) {
 		return EXIT_FAILURE;
 	}
+	// every player carries a point light, so only the largest ones on screen cast shadows and distant ones get smaller shadow maps
+	game->scene->lightOptions.maxShadowedLights = maxShadowedLights;
+	game->scene->lightOptions.shadowMapLevels = shadowMapLevels;
+	// one atlas row holds the faces of one shadowed point light, replacing a set of shadow maps per player
+	shovelerSceneEnableShadowAtlas(game->scene, shadowAtlasTileSize, shadowAtlasTileSize, SHOVELER_LIGHT_POINT_FACES, maxShadowedLights);
 	context.game = game;
-	ShovelerClientSystem* clientSystem = shovelerClientSystemCreate(
+	clientSystem = shovelerClientSystemCreate(
 		game,
 		updateAuthoritativeWorldComponentFunction,
 		&context);
@@ -197,11 +230,20 @@ int main(int argc, char** argv)
 	shovelerResourcesImagePngRegister(resources);
 
 	shovelerWorldAddDependencyCallback(context.world, dependencyChanged, &context);
+	shovelerWorldAddRemoveEntitiesCallback(context.world, entitiesRemoved, &context);
 
 	while (shovelerGameIsRunning(game) && !context.disconnected) {
 		context.worldDependenciesUpdated = false;
 
 		Worker_OpList* opList = Worker_Connection_GetOpList(connection, 0);
+
+		// Entities leaving our view are removed in bulk, so their individual component removals can be skipped.
+		for (size_t i = 0; i < opList->op_count; ++i) {
+			if (opList->ops[i].op_type == WORKER_OP_TYPE_REMOVE_ENTITY) {
+				g_hash_table_replace(context.lastEntityRemovalOpIndices, &opList->ops[i].op.remove_entity.entity_id, (gpointer) (i + 1));
+			}
+		}
+
 		for (size_t i = 0; i < opList->op_count; ++i) {
 			Worker_Op* op = &opList->ops[i];
 			switch (op->op_type) {
@@ -219,11 +261,14 @@ int main(int argc, char** argv)
 				shovelerLogTrace("WORKER_OP_TYPE_CRITICAL_SECTION");
 				break;
 			case WORKER_OP_TYPE_ADD_ENTITY:
+				// the entity might be re-added after a pending removal
+				flushRemovedEntities(&context);
 				shovelerWorldAddEntity(context.world, op->op.add_entity.entity_id);
 				break;
-			case WORKER_OP_TYPE_REMOVE_ENTITY:
-				shovelerWorldRemoveEntity(context.world, op->op.add_entity.entity_id);
-				break;
+			case WORKER_OP_TYPE_REMOVE_ENTITY: {
+				long long int entityId = op->op.remove_entity.entity_id;
+				g_array_append_val(context.pendingRemovedEntityIds, entityId);
+			} break;
 			case WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE:
 				shovelerLogTrace("WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE");
 				break;
@@ -239,9 +284,15 @@ int main(int argc, char** argv)
 			case WORKER_OP_TYPE_ADD_COMPONENT:
 				onAddComponent(&context, &op->op.add_component);
 				break;
-			case WORKER_OP_TYPE_REMOVE_COMPONENT:
+			case WORKER_OP_TYPE_REMOVE_COMPONENT: {
+				size_t lastEntityRemovalOpIndex = (size_t) g_hash_table_lookup(context.lastEntityRemovalOpIndices, &op->op.remove_component.entity_id);
+				if (lastEntityRemovalOpIndex > i + 1) {
+					shovelerLogTrace("Deferring removal of entity %lld component %d to bulk entity removal.", op->op.remove_component.entity_id, op->op.remove_component.component_id);
+					break;
+				}
+
 				onRemoveComponent(&context, &op->op.remove_component);
-				break;
+			} break;
 			case WORKER_OP_TYPE_COMPONENT_SET_AUTHORITY_CHANGE:
 				onAuthorityChange(&context, &op->op.component_set_authority_change);
 				break;
@@ -269,6 +320,8 @@ int main(int argc, char** argv)
 				break;
 			}
 		}
+		flushRemovedEntities(&context);
+		g_hash_table_remove_all(context.lastEntityRemovalOpIndices);
 		Worker_OpList_Destroy(opList);
 
 		shovelerGameRenderFrame(game);
@@ -286,6 +339,8 @@ int main(int argc, char** argv)
 
 	shovelerExecutorRemoveCallback(game->updateExecutor, clientStatusCallback);
 	shovelerClientSystemFree(clientSystem);
+	g_hash_table_destroy(context.lastEntityRemovalOpIndices);
+	g_array_free(context.pendingRemovedEntityIds, /* freeSegment */ true);
 	shovelerGameFree(game);
 	shovelerResourcesFree(resources);
 	shovelerGlobalUninit();
@@ -522,8 +577,21 @@ static void onRemoveComponent(ClientContext* context, const Worker_RemoveCompone
 	shovelerWorldEntityRemoveComponent(entity, componentTypeId);
 }
 
+static void flushRemovedEntities(ClientContext* context)
+{
+	if (context->pendingRemovedEntityIds->len == 0) {
+		return;
+	}
+
+	int numRemoved = shovelerWorldRemoveEntities(context->world, (int) context->pendingRemovedEntityIds->len, (const long long int*) context->pendingRemovedEntityIds->data);
+	shovelerLogTrace("Removed %d of %u entities in bulk.", numRemoved, context->pendingRemovedEntityIds->len);
+
+	g_array_set_size(context->pendingRemovedEntityIds, 0);
+}
+
 static void updateGame(ShovelerGame* game, double dt)
 {
+	shovelerClientSystemUpdate(clientSystem, dt);
 	shovelerCameraUpdateView(game->camera);
 }
 
@@ -682,6 +750,14 @@ static void dependencyChanged(ShovelerWorld* world, const ShovelerEntityComponen
 	context->worldDependenciesUpdated = true;
 }
 
+static void entitiesRemoved(ShovelerWorld* world, int numEntityIds, const long long int* entityIds, int numRemovedDependencies, void* clientContextPointer)
+{
+	ClientContext* context = (ClientContext*) clientContextPointer;
+	if (numRemovedDependencies > 0) {
+		context->worldDependenciesUpdated = true;
+	}
+}
+
 static void updateInterest(ClientContext* context, bool absoluteInterest, ShovelerVector3 position, double edgeLength)
 {
 	Schema_ComponentUpdate* componentUpdate = Schema_CreateComponentUpdate();